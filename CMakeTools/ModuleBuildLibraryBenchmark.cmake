@@ -0,0 +1,32 @@
+# This module configures how to build benchmarks for a library
+# The following arguments are valid:
+# 	CRIMILD_LIBRARY_NAME: (Required) Name of the library
+#	CRIMILD_LIBRARY_DEPENDENCIES: (Optional) Any dependencies that are required in order to build the library
+#	CRIMILD_INCLUDE_DIRECTORIES: (Optional) Additional include directories for dependencies
+#
+# Benchmarks are not registered with CTest. Run the resulting executable
+# manually, optionally passing a filter string to select benchmarks by name.
+
+MESSAGE( "   Adding benchmarks" )
+
+FILE( GLOB_RECURSE CRIMILD_BENCHMARKS_SOURCE_FILES "${CRIMILD_SOURCE_DIR}/${CRIMILD_LIBRARY_NAME}/benchmark/*.cpp" )
+
+SET( CRIMILD_BENCHMARKS_DEPENDENCIES
+	crimild_${CRIMILD_LIBRARY_NAME}
+	${CRIMILD_LIBRARY_DEPENDENCIES}
+)
+
+SET( CRIMILD_BENCHMARKS_INCLUDE_DIRECTORIES
+	${CRIMILD_SOURCE_DIR}/${CRIMILD_LIBRARY_NAME}/src
+	${CRIMILD_SOURCE_DIR}/${CRIMILD_LIBRARY_NAME}/benchmark
+	${CRIMILD_INCLUDE_DIRECTORIES}
+)
+
+INCLUDE_DIRECTORIES( ${CRIMILD_BENCHMARKS_INCLUDE_DIRECTORIES} )
+
+SET( CRIMILD_BENCHMARK_EXECUTABLE_NAME crimild_${CRIMILD_LIBRARY_NAME}_benchmark )
+
+ADD_EXECUTABLE( ${CRIMILD_BENCHMARK_EXECUTABLE_NAME} ${CRIMILD_BENCHMARKS_SOURCE_FILES} )
+
+TARGET_LINK_LIBRARIES( ${CRIMILD_BENCHMARK_EXECUTABLE_NAME} ${CRIMILD_BENCHMARKS_DEPENDENCIES} )
+
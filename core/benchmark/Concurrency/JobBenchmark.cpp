@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+#include "Utils/AllocationCounter.hpp"
+
+#include "Concurrency/Async.hpp"
+#include "Concurrency/JobScheduler.hpp"
+#include "Foundation/NamedObject.hpp"
+#include "Foundation/SharedObject.hpp"
+#include "Mathematics/Clock.hpp"
+
+#include <atomic>
+#include <sstream>
+
+using namespace crimild;
+using namespace crimild::concurrency;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		/**
+		   \brief Mimics the previous job layout, for reference
+		 */
+		class LegacyJob : public SharedObject, public NamedObject {
+		public:
+			std::function< void( void ) > callback;
+		};
+
+		void reportAllocations( Context &context, std::string const &label, size_t jobCount, std::function< void( void ) > const &frame )
+		{
+			// warm up any pools
+			for ( int i = 0; i < 5; i++ ) {
+				frame();
+			}
+
+			const int FRAME_COUNT = 10;
+
+			auto allocationsBefore = getAllocationCount();
+			auto t = context.time( [ &frame, FRAME_COUNT ] {
+				for ( int i = 0; i < FRAME_COUNT; i++ ) {
+					frame();
+				}
+			});
+			auto allocations = getAllocationCount() - allocationsBefore;
+
+			auto totalJobs = FRAME_COUNT * jobCount;
+			context.report( label + " allocations", double( allocations ) / totalJobs, "allocs/job" );
+			context.report( label + " time", 1.0e9 * t / totalJobs, "ns/job" );
+		}
+
+	}
+
+}
+
+CRIMILD_BENCHMARK( Job, allocations )
+{
+	const size_t JOB_COUNT = 10000;
+
+	JobScheduler scheduler;
+	scheduler.configure( std::thread::hardware_concurrency() - 1 );
+	scheduler.start();
+
+	const Clock clock;
+	std::atomic< int > count( 0 );
+
+	// previous implementation: one shared object and one std::function per job
+	benchmark::reportAllocations( context, "legacy create", JOB_COUNT, [ &count, &clock, JOB_COUNT ] {
+		for ( size_t i = 0; i < JOB_COUNT; i++ ) {
+			auto job = crimild::alloc< benchmark::LegacyJob >();
+			void *component = &job;
+			job->callback = [ component, &clock, &count ] {
+				count++;
+			};
+			job->callback();
+		}
+	});
+
+	benchmark::reportAllocations( context, "pooled create", JOB_COUNT, [ &count, &clock, JOB_COUNT ] {
+		for ( size_t i = 0; i < JOB_COUNT; i++ ) {
+			auto job = Job::create();
+			void *component = &job;
+			job->reset( [ component, &clock, &count ] {
+				count++;
+			});
+			job->execute();
+		}
+	});
+
+	benchmark::reportAllocations( context, "pooled async/wait", JOB_COUNT, [ &count, &clock, JOB_COUNT ] {
+		auto parent = crimild::concurrency::async();
+		for ( size_t i = 0; i < JOB_COUNT; i++ ) {
+			crimild::concurrency::async( parent, [ &count, &clock ] {
+				count++;
+			});
+		}
+		crimild::concurrency::wait( parent );
+	});
+
+	scheduler.stop();
+}
+
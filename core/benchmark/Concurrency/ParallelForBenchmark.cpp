@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+
+#include "Concurrency/Async.hpp"
+#include "Concurrency/JobScheduler.hpp"
+
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+using namespace crimild;
+using namespace crimild::concurrency;
+
+CRIMILD_BENCHMARK( ParallelFor, grainSize )
+{
+	const size_t COUNT = 1 << 20;
+
+	JobScheduler scheduler;
+	scheduler.configure( std::thread::hardware_concurrency() - 1 );
+	scheduler.start();
+
+	std::vector< float > values( COUNT, 1.0f );
+
+	auto kernel = [ &values ]( size_t i ) {
+		values[ i ] = std::sqrt( values[ i ] + 1.0f );
+	};
+
+	context.measure( "serial loop", COUNT, [ &values, &kernel ] {
+		for ( size_t i = 0; i < values.size(); i++ ) {
+			kernel( i );
+		}
+	});
+
+	// one job per element, which is what call sites used to do
+	context.measure( "one job per element", COUNT, [ &kernel, COUNT ] {
+		auto parent = crimild::concurrency::async();
+		for ( size_t i = 0; i < COUNT; i++ ) {
+			crimild::concurrency::async( parent, [ &kernel, i ] {
+				kernel( i );
+			});
+		}
+		crimild::concurrency::wait( parent );
+	}, 3 );
+
+	for ( size_t grain = 1; grain <= COUNT; grain *= 8 ) {
+		std::stringstream label;
+		label << "parallel_for grain=" << grain;
+		context.measure( label.str(), COUNT, [ &kernel, grain, COUNT ] {
+			parallel_for( size_t( 0 ), COUNT, grain, kernel );
+		});
+	}
+
+	std::stringstream label;
+	label << "parallel_for adaptive grain=" << computeGrainSize( COUNT );
+	context.measure( label.str(), COUNT, [ &kernel, COUNT ] {
+		parallel_for( size_t( 0 ), COUNT, kernel );
+	});
+
+	scheduler.stop();
+}
+
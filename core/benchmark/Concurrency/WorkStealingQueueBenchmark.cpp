@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+
+#include "Concurrency/WorkStealingDeque.hpp"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		/**
+		   \brief The previous mutex-based implementation, used as reference
+		 */
+		template< class T >
+		class LockedWorkStealingQueue {
+			using Lock = std::lock_guard< std::mutex >;
+
+		public:
+			explicit LockedWorkStealingQueue( size_t = 0 ) { }
+
+			bool empty( void )
+			{
+				Lock lock( _mutex );
+				return _elems.empty();
+			}
+
+			void push( T const &elem )
+			{
+				Lock lock( _mutex );
+				_elems.push_back( elem );
+			}
+
+			T pop( void )
+			{
+				Lock lock( _mutex );
+				if ( _elems.empty() ) {
+					return T();
+				}
+				auto e = _elems.back();
+				_elems.pop_back();
+				return e;
+			}
+
+			T steal( void )
+			{
+				Lock lock( _mutex );
+				if ( _elems.empty() ) {
+					return T();
+				}
+				auto e = _elems.front();
+				_elems.pop_front();
+				return e;
+			}
+
+		private:
+			std::list< T > _elems;
+			std::mutex _mutex;
+		};
+
+		template< class QueueType >
+		void ownerOnly( Context &context, std::string const &name, std::vector< int > &values )
+		{
+			QueueType queue( 1024 );
+
+			context.measure( name + " push/pop (owner only)", values.size(), [ &queue, &values ] {
+				for ( auto &v : values ) {
+					queue.push( &v );
+					if ( ( v & 7 ) == 0 ) {
+						// drain in batches, like a worker executing its own jobs
+						while ( queue.pop() != nullptr ) { }
+					}
+				}
+				while ( queue.pop() != nullptr ) { }
+			});
+		}
+
+		template< class QueueType >
+		void contended( Context &context, std::string const &name, std::vector< int > &values, int thiefCount )
+		{
+			std::stringstream label;
+			label << name << " push/pop/steal (" << thiefCount << " thieves)";
+
+			context.measure( label.str(), values.size(), [ &values, thiefCount ] {
+				QueueType queue( 1024 );
+				std::atomic< size_t > consumed( 0 );
+				const auto total = values.size();
+
+				std::vector< std::thread > thieves;
+				for ( int i = 0; i < thiefCount; i++ ) {
+					thieves.push_back( std::thread( [ &queue, &consumed, total ] {
+						while ( consumed.load( std::memory_order_relaxed ) < total ) {
+							if ( queue.steal() != nullptr ) {
+								consumed++;
+							}
+						}
+					}));
+				}
+
+				for ( auto &v : values ) {
+					queue.push( &v );
+					if ( ( v & 1 ) == 0 && queue.pop() != nullptr ) {
+						consumed++;
+					}
+				}
+
+				while ( consumed.load( std::memory_order_relaxed ) < total ) {
+					if ( queue.pop() != nullptr ) {
+						consumed++;
+					}
+				}
+
+				for ( auto &t : thieves ) {
+					t.join();
+				}
+			}, 3 );
+		}
+
+	}
+
+}
+
+CRIMILD_BENCHMARK( WorkStealingQueue, ownerOnly )
+{
+	std::vector< int > values( 1000000 );
+	for ( size_t i = 0; i < values.size(); i++ ) {
+		values[ i ] = i;
+	}
+
+	benchmark::ownerOnly< benchmark::LockedWorkStealingQueue< int * >>( context, "mutex+list", values );
+	benchmark::ownerOnly< WorkStealingQueue< int * >>( context, "lock-free", values );
+}
+
+CRIMILD_BENCHMARK( WorkStealingQueue, contended )
+{
+	std::vector< int > values( 1000000 );
+	for ( size_t i = 0; i < values.size(); i++ ) {
+		values[ i ] = i;
+	}
+
+	int maxThieves = std::max( 1, static_cast< int >( std::thread::hardware_concurrency() ) - 1 );
+	for ( int thieves = 1; thieves <= maxThieves; thieves *= 2 ) {
+		benchmark::contended< benchmark::LockedWorkStealingQueue< int * >>( context, "mutex+list", values, thieves );
+		benchmark::contended< WorkStealingQueue< int * >>( context, "lock-free", values, thieves );
+	}
+}
+
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+
+#include "Foundation/SmallObjectAllocator.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		/**
+		   \brief Each thread allocates a batch of blocks of mixed sizes and frees them
+
+		   This mimics objects being created and destroyed by jobs during a frame
+		 */
+		void allocateAndFree( Context &context, std::string const &label, size_t opCount, int threadCount, std::function< void *( size_t ) > const &allocate, std::function< void( void *, size_t ) > const &deallocate )
+		{
+			const size_t BATCH_SIZE = 256;
+
+			context.measure( label, opCount, [ &, opCount, threadCount ] {
+				std::vector< std::thread > threads;
+				for ( int t = 0; t < threadCount; t++ ) {
+					threads.push_back( std::thread( [ &, t ] {
+						void *blocks[ BATCH_SIZE ];
+						auto batchCount = opCount / ( threadCount * BATCH_SIZE );
+						for ( size_t b = 0; b < batchCount; b++ ) {
+							for ( size_t i = 0; i < BATCH_SIZE; i++ ) {
+								blocks[ i ] = allocate( 16 + 8 * ( ( i + t ) % 16 ) );
+							}
+							for ( size_t i = 0; i < BATCH_SIZE; i++ ) {
+								deallocate( blocks[ i ], 16 + 8 * ( ( i + t ) % 16 ) );
+							}
+						}
+					}));
+				}
+
+				for ( auto &t : threads ) {
+					t.join();
+				}
+			}, 3 );
+		}
+
+	}
+
+}
+
+CRIMILD_BENCHMARK( SmallObjectAllocator, allocateAndFree )
+{
+	const size_t OP_COUNT = 1 << 20;
+
+	SmallObjectAllocator allocator;
+
+	auto maxThreadCount = std::max( 4u, std::thread::hardware_concurrency() );
+	for ( unsigned int threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2 ) {
+		std::stringstream mallocLabel;
+		mallocLabel << "malloc/free (" << threadCount << " threads)";
+		benchmark::allocateAndFree(
+			context,
+			mallocLabel.str(),
+			OP_COUNT,
+			threadCount,
+			[]( size_t size ) { return std::malloc( size ); },
+			[]( void *p, size_t ) { std::free( p ); }
+		);
+
+		std::stringstream allocatorLabel;
+		allocatorLabel << "small object allocator (" << threadCount << " threads)";
+		benchmark::allocateAndFree(
+			context,
+			allocatorLabel.str(),
+			OP_COUNT,
+			threadCount,
+			[ &allocator ]( size_t size ) { return allocator.allocate( size ); },
+			[ &allocator ]( void *p, size_t size ) { allocator.deallocate( p, size ); }
+		);
+	}
+}
+
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+
+#include "Mathematics/Random.hpp"
+
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+
+CRIMILD_BENCHMARK( Random, generators )
+{
+	const crimild::Size COUNT = 1 << 20;
+
+	std::vector< crimild::Real32 > values( COUNT );
+
+	// what Random::Generator used before
+	std::mt19937_64 mt( 42 );
+	std::uniform_real_distribution< double > distribution( 0, 1 );
+	context.measure( "mt19937_64", COUNT, [ &values, &mt, &distribution, COUNT ] {
+		for ( crimild::Size i = 0; i < COUNT; i++ ) {
+			values[ i ] = static_cast< crimild::Real32 >( distribution( mt ) );
+		}
+	});
+
+	context.measure( "Random::generate (thread generator)", COUNT, [ &values, COUNT ] {
+		for ( crimild::Size i = 0; i < COUNT; i++ ) {
+			values[ i ] = Random::generate< crimild::Real32 >( 0.0f, 1.0f );
+		}
+	});
+
+	Random::Generator random( 42 );
+	context.measure( "Generator::nextReal32", COUNT, [ &values, &random, COUNT ] {
+		for ( crimild::Size i = 0; i < COUNT; i++ ) {
+			values[ i ] = random.nextReal32();
+		}
+	});
+
+	context.measure( "Generator::fill", COUNT, [ &values, &random, COUNT ] {
+		random.fill( values.data(), COUNT, 0.0f, 1.0f );
+	});
+
+	std::vector< Vector3f > vectors( COUNT );
+	context.measure( "Generator::fill (Vector3f)", COUNT, [ &vectors, &random, COUNT ] {
+		random.fill( vectors.data(), COUNT, -Vector3f::ONE, Vector3f::ONE );
+	});
+}
+
+CRIMILD_BENCHMARK( Random, concurrent )
+{
+	const crimild::Size COUNT = 1 << 20;
+	const auto threadCount = std::max( 2u, std::thread::hardware_concurrency() );
+
+	// every thread uses its own generator, so there is no shared state
+	context.measure( "Random::generate from all threads", threadCount * COUNT, [ threadCount, COUNT ] {
+		std::vector< std::thread > threads;
+		for ( unsigned int t = 0; t < threadCount; t++ ) {
+			threads.push_back( std::thread( [ COUNT ] {
+				volatile crimild::Real32 sum = 0.0f;
+				for ( crimild::Size i = 0; i < COUNT; i++ ) {
+					sum = sum + Random::generate< crimild::Real32 >( 0.0f, 1.0f );
+				}
+			}));
+		}
+		for ( auto &t : threads ) {
+			t.join();
+		}
+	}, 3 );
+}
+
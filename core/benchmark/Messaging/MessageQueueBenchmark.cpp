@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+#include "Utils/AllocationCounter.hpp"
+
+#include "Messaging/MessageQueue.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		struct BroadcastBenchmarkMessage {
+			int value;
+		};
+
+		struct DeferredBenchmarkMessage {
+			int value;
+		};
+
+		struct ConcurrentBenchmarkMessage {
+			int value;
+		};
+
+		/**
+		   \brief The previous mutex-based deferred queue, used as reference
+		 */
+		template< class T >
+		class LockedDeferredQueue {
+			using Lock = std::lock_guard< std::mutex >;
+
+		public:
+			void pushMessage( T const &message )
+			{
+				Lock lock( _mutex );
+				_messages.push_back( message );
+			}
+
+			void dispatchDeferredMessages( void )
+			{
+				std::vector< T > ms;
+				{
+					Lock lock( _mutex );
+					std::swap( _messages, ms );
+				}
+
+				for ( auto &m : ms ) {
+					MessageQueue::getInstance()->broadcastMessage( m );
+				}
+			}
+
+		private:
+			std::vector< T > _messages;
+			std::mutex _mutex;
+		};
+
+		/**
+		   \brief Posts messages from several threads while the main thread dispatches them
+		 */
+		void concurrentPush( Context &context, std::string const &label, size_t messageCount, int threadCount, std::function< void( void ) > const &push, std::function< void( void ) > const &dispatch )
+		{
+			context.measure( label, messageCount, [ &push, &dispatch, messageCount, threadCount ] {
+				std::atomic< int > running( threadCount );
+				std::vector< std::thread > threads;
+				for ( int i = 0; i < threadCount; i++ ) {
+					threads.push_back( std::thread( [ &push, &running, messageCount, threadCount ] {
+						auto count = messageCount / threadCount;
+						for ( size_t j = 0; j < count; j++ ) {
+							push();
+						}
+						--running;
+					}));
+				}
+
+				while ( running > 0 ) {
+					dispatch();
+				}
+				dispatch();
+
+				for ( auto &t : threads ) {
+					t.join();
+				}
+			}, 3 );
+		}
+
+	}
+
+}
+
+CRIMILD_BENCHMARK( MessageQueue, broadcast )
+{
+	const size_t MESSAGE_COUNT = 100000;
+
+	for ( auto handlerCount : { 1, 10, 100 } ) {
+		int sum = 0;
+
+		std::vector< std::unique_ptr< Messenger >> messengers;
+		for ( int i = 0; i < handlerCount; i++ ) {
+			messengers.push_back( std::unique_ptr< Messenger >( new Messenger() ) );
+			messengers.back()->registerMessageHandler< benchmark::BroadcastBenchmarkMessage >( [ &sum ]( benchmark::BroadcastBenchmarkMessage const &m ) {
+				sum += m.value;
+			});
+		}
+
+		auto broadcaster = messengers.front().get();
+		auto broadcast = [ broadcaster, MESSAGE_COUNT ] {
+			for ( size_t i = 0; i < MESSAGE_COUNT; i++ ) {
+				broadcaster->broadcastMessage( benchmark::BroadcastBenchmarkMessage { 1 } );
+			}
+		};
+
+		std::stringstream label;
+		label << "broadcast with " << handlerCount << " handlers";
+		context.measure( label.str(), MESSAGE_COUNT, broadcast );
+
+		auto allocationsBefore = benchmark::getAllocationCount();
+		broadcast();
+		auto allocations = benchmark::getAllocationCount() - allocationsBefore;
+		context.report( label.str() + " allocations", double( allocations ) / MESSAGE_COUNT, "allocs/msg" );
+	}
+}
+
+CRIMILD_BENCHMARK( MessageQueue, dispatchDeferredMessages )
+{
+	const size_t FRAME_COUNT = 100000;
+
+	auto queue = MessageQueue::getInstance();
+
+	Messenger messenger;
+	messenger.registerMessageHandler< benchmark::DeferredBenchmarkMessage >( []( benchmark::DeferredBenchmarkMessage const & ) { } );
+
+	// make sure the dispatcher exists, but nothing is pending
+	queue->pushMessage( benchmark::DeferredBenchmarkMessage { 0 } );
+	queue->dispatchDeferredMessages();
+
+	context.measure( "dispatch with no pending messages", FRAME_COUNT, [ queue, FRAME_COUNT ] {
+		for ( size_t i = 0; i < FRAME_COUNT; i++ ) {
+			queue->dispatchDeferredMessages();
+		}
+	});
+
+	context.measure( "push and dispatch one message", FRAME_COUNT, [ queue, FRAME_COUNT ] {
+		for ( size_t i = 0; i < FRAME_COUNT; i++ ) {
+			queue->pushMessage( benchmark::DeferredBenchmarkMessage { 1 } );
+			queue->dispatchDeferredMessages();
+		}
+	});
+
+	auto allocationsBefore = benchmark::getAllocationCount();
+	for ( size_t i = 0; i < FRAME_COUNT; i++ ) {
+		queue->pushMessage( benchmark::DeferredBenchmarkMessage { 1 } );
+		queue->dispatchDeferredMessages();
+	}
+	auto allocations = benchmark::getAllocationCount() - allocationsBefore;
+	context.report( "push and dispatch allocations", double( allocations ) / FRAME_COUNT, "allocs/frame" );
+}
+
+CRIMILD_BENCHMARK( MessageQueue, concurrentPush )
+{
+	const size_t MESSAGE_COUNT = 400000;
+
+	auto queue = MessageQueue::getInstance();
+	queue->configureDeferredMessages< benchmark::ConcurrentBenchmarkMessage >( 4096, DeferredMessageOverflowPolicy::SPILL );
+
+	std::atomic< size_t > received( 0 );
+	Messenger messenger;
+	messenger.registerMessageHandler< benchmark::ConcurrentBenchmarkMessage >( [ &received ]( benchmark::ConcurrentBenchmarkMessage const & ) {
+		received++;
+	});
+
+	auto maxThreadCount = std::max( 4u, std::thread::hardware_concurrency() );
+	for ( unsigned int threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2 ) {
+		benchmark::LockedDeferredQueue< benchmark::ConcurrentBenchmarkMessage > lockedQueue;
+
+		std::stringstream lockedLabel;
+		lockedLabel << "locked vector push (" << threadCount << " threads)";
+		benchmark::concurrentPush(
+			context,
+			lockedLabel.str(),
+			MESSAGE_COUNT,
+			threadCount,
+			[ &lockedQueue ] { lockedQueue.pushMessage( benchmark::ConcurrentBenchmarkMessage { 1 } ); },
+			[ &lockedQueue ] { lockedQueue.dispatchDeferredMessages(); }
+		);
+
+		std::stringstream ringLabel;
+		ringLabel << "ring buffer push (" << threadCount << " threads)";
+		benchmark::concurrentPush(
+			context,
+			ringLabel.str(),
+			MESSAGE_COUNT,
+			threadCount,
+			[ queue ] { queue->pushMessage( benchmark::ConcurrentBenchmarkMessage { 1 } ); },
+			[ queue ] { queue->dispatchDeferredMessages(); }
+		);
+	}
+}
+
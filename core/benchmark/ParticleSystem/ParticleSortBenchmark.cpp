@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+
+#include "ParticleSystem/ParticleData.hpp"
+#include "ParticleSystem/Updaters/ZSortParticleUpdater.hpp"
+#include "ParticleSystem/Updaters/CameraSortParticleUpdater.hpp"
+#include "SceneGraph/Camera.hpp"
+#include "SceneGraph/Group.hpp"
+#include "Mathematics/Random.hpp"
+
+#include <sstream>
+#include <vector>
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		static SharedPointer< ParticleData > createParticles( crimild::Size count )
+		{
+			auto particles = crimild::alloc< ParticleData >( count );
+			particles->createAttribArray< Vector3f >( ParticleAttrib::POSITION );
+			particles->createAttribArray< Vector3f >( ParticleAttrib::VELOCITY );
+			particles->createAttribArray< Vector3f >( ParticleAttrib::ACCELERATION );
+			particles->createAttribArray< RGBAColorf >( ParticleAttrib::COLOR );
+			particles->createAttribArray< crimild::Real32 >( ParticleAttrib::UNIFORM_SCALE );
+			particles->createAttribArray< crimild::Real32 >( ParticleAttrib::TIME );
+			particles->generate();
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				particles->wake( i );
+			}
+			return particles;
+		}
+
+		static void shufflePositions( ParticleData *particles, std::vector< Vector3f > const &positions )
+		{
+			auto ps = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+			for ( crimild::Size i = 0; i < particles->getAliveCount(); i++ ) {
+				ps[ i ] = positions[ i ];
+			}
+		}
+
+	}
+
+}
+
+CRIMILD_BENCHMARK( ParticleSystem, depthSort )
+{
+	auto node = crimild::alloc< Group >();
+
+	auto camera = crimild::alloc< Camera >();
+	camera->local().setTranslate( 0.0f, 0.0f, 50.0f );
+	camera->world() = camera->local();
+	auto previousMainCamera = Camera::getMainCamera();
+	Camera::setMainCamera( camera );
+
+	for ( crimild::Size count : { 1000, 10000, 100000 } ) {
+		auto particles = benchmark::createParticles( count );
+
+		std::vector< Vector3f > positions( count );
+		for ( auto &p : positions ) {
+			p = Vector3f( Random::generate< float >( -10.0f, 10.0f ), Random::generate< float >( -10.0f, 10.0f ), Random::generate< float >( -10.0f, 10.0f ) );
+		}
+
+		std::stringstream label;
+		label << count << " particles";
+
+		if ( count <= 1000 ) {
+			// reference: what ZSortParticleUpdater used to do. Too slow for bigger emitters
+			context.measure( label.str() + ", bubble sort (reference)", count, [ &particles, &positions ] {
+				benchmark::shufflePositions( crimild::get_ptr( particles ), positions );
+				const auto pCount = particles->getAliveCount();
+				const auto ps = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+				for ( crimild::Size i = 1; i < pCount; i++ ) {
+					for ( crimild::Size j = 0; j < pCount - i; j++ ) {
+						if ( ps[ j ].z() > ps[ j + 1 ].z() ) {
+							particles->swap( j, j + 1 );
+						}
+					}
+				}
+			}, 1 );
+		}
+
+		auto zSort = crimild::alloc< ZSortParticleUpdater >();
+		zSort->configure( crimild::get_ptr( node ), crimild::get_ptr( particles ) );
+		context.measure( label.str() + ", z sort", count, [ &particles, &positions, &zSort, &node ] {
+			benchmark::shufflePositions( crimild::get_ptr( particles ), positions );
+			zSort->update( crimild::get_ptr( node ), 0.0, crimild::get_ptr( particles ) );
+		});
+
+		auto cameraSort = crimild::alloc< CameraSortParticleUpdater >();
+		cameraSort->configure( crimild::get_ptr( node ), crimild::get_ptr( particles ) );
+		context.measure( label.str() + ", camera sort", count, [ &particles, &positions, &cameraSort, &node ] {
+			benchmark::shufflePositions( crimild::get_ptr( particles ), positions );
+			cameraSort->update( crimild::get_ptr( node ), 0.0, crimild::get_ptr( particles ) );
+		});
+	}
+
+	Camera::setMainCamera( previousMainCamera );
+}
+
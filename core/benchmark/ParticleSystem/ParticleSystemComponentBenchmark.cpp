@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+
+#include "ParticleSystem/ParticleSystemComponent.hpp"
+#include "ParticleSystem/Updaters/EulerParticleUpdater.hpp"
+#include "ParticleSystem/Updaters/AttractorParticleUpdater.hpp"
+#include "ParticleSystem/Updaters/TimeParticleUpdater.hpp"
+#include "ParticleSystem/Updaters/ColorParticleUpdater.hpp"
+#include "Concurrency/JobScheduler.hpp"
+#include "Mathematics/Random.hpp"
+#include "SceneGraph/Group.hpp"
+
+#include <sstream>
+#include <thread>
+
+using namespace crimild;
+using namespace crimild::concurrency;
+
+CRIMILD_BENCHMARK( ParticleSystem, parallelUpdate )
+{
+	const crimild::Size PARTICLE_COUNT = 200000;
+
+	auto group = crimild::alloc< Group >();
+
+	auto ps = crimild::alloc< ParticleSystemComponent >( PARTICLE_COUNT + 1 );
+	ps->setEmitRate( 0 );
+
+	auto euler = crimild::alloc< EulerParticleUpdater >();
+	euler->setGlobalAcceleration( Vector3f( 0.0f, -9.8f, 0.0f ) );
+	ps->addUpdater( euler );
+
+	auto attractor = crimild::alloc< AttractorParticleUpdater >();
+	attractor->setAttractor( Sphere3f( Vector3f::ZERO, 8.0f ) );
+	ps->addUpdater( attractor );
+
+	ps->addUpdater( crimild::alloc< TimeParticleUpdater >() );
+	ps->addUpdater( crimild::alloc< ColorParticleUpdater >() );
+
+	group->attachComponent( ps );
+	ps->start();
+
+	auto particles = ps->getParticles();
+	auto positions = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	auto velocities = particles->getAttrib( ParticleAttrib::VELOCITY )->getData< Vector3f >();
+	auto accelerations = particles->getAttrib( ParticleAttrib::ACCELERATION )->getData< Vector3f >();
+	auto times = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+	auto lifetimes = particles->getAttrib( ParticleAttrib::LIFE_TIME )->getData< crimild::Real32 >();
+	for ( crimild::Size i = 0; i < particles->getParticleCount(); i++ ) {
+		positions[ i ] = Vector3f( Random::generate< float >( -10.0f, 10.0f ), Random::generate< float >( -10.0f, 10.0f ), Random::generate< float >( -10.0f, 10.0f ) );
+		velocities[ i ] = Vector3f::ZERO;
+		accelerations[ i ] = Vector3f::ZERO;
+		// long enough so no particle dies during the benchmark
+		times[ i ] = 1.0e6f;
+		lifetimes[ i ] = 2.0e6f;
+	}
+	for ( crimild::Size i = 0; i < PARTICLE_COUNT; i++ ) {
+		particles->wake( i );
+	}
+
+	Clock c( 0.001 );
+
+	// without a scheduler, every chunk is updated in the calling thread
+	auto serial = context.measure( "serial", PARTICLE_COUNT, [ &ps, &c ] {
+		ps->update( c );
+	});
+
+	const auto maxWorkers = std::max( 2u, std::thread::hardware_concurrency() ) - 1;
+	for ( auto workers = 1u; workers <= maxWorkers; workers *= 2 ) {
+		JobScheduler scheduler;
+		scheduler.configure( workers );
+		scheduler.start();
+
+		std::stringstream label;
+		label << "workers=" << workers;
+		auto best = context.measure( label.str(), PARTICLE_COUNT, [ &ps, &c ] {
+			ps->update( c );
+		});
+		context.report( label.str() + " speedup", serial / best, "x" );
+
+		scheduler.stop();
+	}
+}
+
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+
+#include "ParticleSystem/ParticleData.hpp"
+#include "ParticleSystem/Updaters/EulerParticleUpdater.hpp"
+#include "ParticleSystem/Updaters/AttractorParticleUpdater.hpp"
+#include "ParticleSystem/Updaters/TimeParticleUpdater.hpp"
+#include "ParticleSystem/Updaters/ColorParticleUpdater.hpp"
+#include "Mathematics/SIMD.hpp"
+#include "Mathematics/Random.hpp"
+#include "SceneGraph/Group.hpp"
+
+#include <sstream>
+#include <vector>
+
+using namespace crimild;
+
+CRIMILD_BENCHMARK( ParticleSystem, updaters )
+{
+	const crimild::Size PARTICLE_COUNT = 100000;
+
+	auto node = crimild::alloc< Group >();
+
+	auto particles = crimild::alloc< ParticleData >( PARTICLE_COUNT );
+	particles->createAttribArray< Vector3f >( ParticleAttrib::POSITION );
+	particles->createAttribArray< Vector3f >( ParticleAttrib::VELOCITY );
+	particles->createAttribArray< Vector3f >( ParticleAttrib::ACCELERATION );
+	particles->createAttribArray< RGBAColorf >( ParticleAttrib::START_COLOR );
+	particles->createAttribArray< RGBAColorf >( ParticleAttrib::END_COLOR );
+	particles->createAttribArray< RGBAColorf >( ParticleAttrib::COLOR );
+	particles->createAttribArray< crimild::Real32 >( ParticleAttrib::TIME );
+	particles->createAttribArray< crimild::Real32 >( ParticleAttrib::LIFE_TIME );
+	particles->generate();
+
+	auto ps = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	auto ts = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+	auto ls = particles->getAttrib( ParticleAttrib::LIFE_TIME )->getData< crimild::Real32 >();
+	for ( crimild::Size i = 0; i < PARTICLE_COUNT; i++ ) {
+		particles->wake( i );
+		ps[ i ] = Vector3f( Random::generate< float >( -10.0f, 10.0f ), Random::generate< float >( -10.0f, 10.0f ), Random::generate< float >( -10.0f, 10.0f ) );
+		// long enough so no particle dies during the benchmark
+		ts[ i ] = 1.0e6f;
+		ls[ i ] = 2.0e6f;
+	}
+
+	auto euler = crimild::alloc< EulerParticleUpdater >();
+	euler->setGlobalAcceleration( Vector3f( 0.0f, -9.8f, 0.0f ) );
+
+	auto attractor = crimild::alloc< AttractorParticleUpdater >();
+	attractor->setAttractor( Sphere3f( Vector3f::ZERO, 8.0f ) );
+
+	std::vector< std::pair< std::string, SharedPointer< ParticleSystemComponent::ParticleUpdater >>> updaters = {
+		{ "euler", euler },
+		{ "attractor", attractor },
+		{ "time", crimild::alloc< TimeParticleUpdater >() },
+		{ "color", crimild::alloc< ColorParticleUpdater >() },
+	};
+
+	for ( auto &updater : updaters ) {
+		updater.second->configure( crimild::get_ptr( node ), crimild::get_ptr( particles ) );
+	}
+
+	for ( auto instructionSet : { simd::InstructionSet::SCALAR, simd::InstructionSet::SSE, simd::InstructionSet::AVX } ) {
+		if ( static_cast< int >( instructionSet ) > static_cast< int >( simd::getSupportedInstructionSet() ) ) {
+			continue;
+		}
+		simd::setInstructionSet( instructionSet );
+
+		for ( auto &updater : updaters ) {
+			std::stringstream label;
+			label << updater.first << " (" << simd::getInstructionSetName( instructionSet ) << ")";
+
+			auto u = crimild::get_ptr( updater.second );
+			auto best = context.measure( label.str(), PARTICLE_COUNT, [ u, &node, &particles ] {
+				u->update( crimild::get_ptr( node ), 0.001, crimild::get_ptr( particles ) );
+			});
+			context.report( label.str() + " throughput", 1.0e-6 * PARTICLE_COUNT / best, "Mparticles/s" );
+		}
+	}
+
+	simd::setInstructionSet( simd::getSupportedInstructionSet() );
+}
+
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+#include "Utils/AllocationCounter.hpp"
+
+#include "ParticleSystem/Renderers/ParticleVertexStream.hpp"
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		static void fillQuads( VertexBufferObject *vbo, crimild::Size count )
+		{
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				const auto p = Vector3f( static_cast< float >( i ), 0.0f, 0.0f );
+				for ( crimild::Size j = 0; j < 4; j++ ) {
+					vbo->setPositionAt( 4 * i + j, p );
+					vbo->setTextureCoordAt( 4 * i + j, Vector2f( 0.0f, 1.0f ) );
+				}
+			}
+		}
+
+	}
+
+}
+
+CRIMILD_BENCHMARK( ParticleSystem, vertexStream )
+{
+	const crimild::Size PARTICLE_COUNT = 10000;
+	const crimild::Size FRAME_COUNT = 100;
+
+	auto primitive = crimild::alloc< Primitive >( Primitive::Type::TRIANGLES );
+
+	// what renderers used to do: new buffers every frame
+	auto perFrameBuffers = [ primitive, PARTICLE_COUNT, FRAME_COUNT ] {
+		for ( crimild::Size frame = 0; frame < FRAME_COUNT; frame++ ) {
+			auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_UV2, 4 * PARTICLE_COUNT );
+			auto ibo = crimild::alloc< IndexBufferObject >( 6 * PARTICLE_COUNT );
+			benchmark::fillQuads( crimild::get_ptr( vbo ), PARTICLE_COUNT );
+			for ( crimild::Size i = 0; i < PARTICLE_COUNT; i++ ) {
+				const IndexPrecision pattern[] = { 0, 1, 2, 0, 2, 3 };
+				for ( crimild::Size j = 0; j < 6; j++ ) {
+					ibo->setIndexAt( 6 * i + j, static_cast< IndexPrecision >( 4 * i + pattern[ j ] ) );
+				}
+			}
+			primitive->setVertexBuffer( vbo );
+			primitive->setIndexBuffer( ibo );
+		}
+	};
+
+	auto stream = crimild::alloc< ParticleVertexStream >( VertexFormat::VF_P3_UV2, 4, std::vector< IndexPrecision > { 0, 1, 2, 0, 2, 3 } );
+	auto streamBuffers = [ primitive, stream, PARTICLE_COUNT, FRAME_COUNT ] {
+		for ( crimild::Size frame = 0; frame < FRAME_COUNT; frame++ ) {
+			auto vbo = stream->beginFrame( PARTICLE_COUNT );
+			benchmark::fillQuads( vbo, stream->getParticleCount() );
+			stream->endFrame( primitive );
+		}
+	};
+
+	context.measure( "per-frame buffers", FRAME_COUNT * PARTICLE_COUNT, perFrameBuffers );
+	context.measure( "vertex stream", FRAME_COUNT * PARTICLE_COUNT, streamBuffers );
+
+	// both are warm at this point
+	auto allocationsBefore = benchmark::getAllocationCount();
+	perFrameBuffers();
+	auto allocations = benchmark::getAllocationCount() - allocationsBefore;
+	context.report( "per-frame buffers allocations", double( allocations ) / FRAME_COUNT, "allocs/frame" );
+
+	allocationsBefore = benchmark::getAllocationCount();
+	streamBuffers();
+	allocations = benchmark::getAllocationCount() - allocationsBefore;
+	context.report( "vertex stream allocations", double( allocations ) / FRAME_COUNT, "allocs/frame" );
+}
+
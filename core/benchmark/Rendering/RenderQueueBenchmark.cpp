@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+#include "Utils/AllocationCounter.hpp"
+
+#include "Rendering/RenderQueue.hpp"
+#include "Foundation/FrameArena.hpp"
+#include "Components/RenderStateComponent.hpp"
+#include "Mathematics/Random.hpp"
+
+#include <list>
+#include <vector>
+
+using namespace crimild;
+
+CRIMILD_BENCHMARK( RenderQueue, push )
+{
+	const size_t GEOMETRY_COUNT = 20000;
+	const size_t MATERIAL_COUNT = 32;
+
+	auto camera = crimild::alloc< Camera >();
+
+	std::vector< SharedPointer< Material >> materials;
+	for ( size_t i = 0; i < MATERIAL_COUNT; i++ ) {
+		materials.push_back( crimild::alloc< Material >() );
+	}
+
+	std::vector< SharedPointer< Geometry >> geometries;
+	for ( size_t i = 0; i < GEOMETRY_COUNT; i++ ) {
+		auto geometry = crimild::alloc< Geometry >();
+		geometry->world().setTranslate( Random::generate< float >( -100.0f, 100.0f ), Random::generate< float >( -100.0f, 100.0f ), Random::generate< float >( -100.0f, 100.0f ) );
+		geometry->attachComponent< RenderStateComponent >()->attachMaterial( materials[ i % MATERIAL_COUNT ] );
+		geometries.push_back( geometry );
+	}
+
+	// reference: renderables inserted in distance order into linked lists,
+	// retaining both geometry and material, which is what we used to do
+	struct LegacyRenderable {
+		SharedPointer< Geometry > geometry;
+		SharedPointer< Material > material;
+		Matrix4f modelTransform;
+		double distanceFromCamera;
+	};
+
+	context.measure( "sorted list insertion (reference)", GEOMETRY_COUNT, [ &geometries, &materials, &camera ] {
+		std::list< LegacyRenderable > opaque;
+		std::list< LegacyRenderable > casters;
+		for ( size_t i = 0; i < geometries.size(); i++ ) {
+			auto geometry = geometries[ i ];
+			auto renderable = LegacyRenderable {
+				geometry,
+				materials[ i % materials.size() ],
+				geometry->getWorld().computeModelMatrix(),
+				Distance::computeSquared( geometry->getWorld().getTranslate(), camera->getWorld().getTranslate() ),
+			};
+			for ( auto queue : { &opaque, &casters } ) {
+				auto it = queue->begin();
+				while ( it != queue->end() && ( *it ).distanceFromCamera <= renderable.distanceFromCamera ) {
+					it++;
+				}
+				queue->insert( it, renderable );
+			}
+		}
+	}, 1 );
+
+	auto renderQueue = crimild::alloc< RenderQueue >();
+	context.measure( "push and radix sort", GEOMETRY_COUNT, [ &geometries, &camera, &renderQueue ] {
+		renderQueue->reset();
+		renderQueue->setCamera( crimild::get_ptr( camera ) );
+		for ( auto &geometry : geometries ) {
+			renderQueue->push( crimild::get_ptr( geometry ) );
+		}
+		renderQueue->sort();
+	});
+}
+
+CRIMILD_BENCHMARK( RenderQueue, frameArena )
+{
+	const size_t GEOMETRY_COUNT = 20000;
+	const size_t MATERIAL_COUNT = 32;
+	const size_t FRAME_COUNT = 20;
+
+	auto camera = crimild::alloc< Camera >();
+
+	std::vector< SharedPointer< Material >> materials;
+	for ( size_t i = 0; i < MATERIAL_COUNT; i++ ) {
+		materials.push_back( crimild::alloc< Material >() );
+	}
+
+	std::vector< SharedPointer< Geometry >> geometries;
+	for ( size_t i = 0; i < GEOMETRY_COUNT; i++ ) {
+		auto geometry = crimild::alloc< Geometry >();
+		geometry->world().setTranslate( Random::generate< float >( -100.0f, 100.0f ), Random::generate< float >( -100.0f, 100.0f ), Random::generate< float >( -100.0f, 100.0f ) );
+		geometry->attachComponent< RenderStateComponent >()->attachMaterial( materials[ i % MATERIAL_COUNT ] );
+		geometries.push_back( geometry );
+	}
+
+	// a new queue is created every frame, like the update system does
+	auto computeQueue = [ &geometries, &camera ]( LinearArenaPtr const &arena ) {
+		auto renderQueue = crimild::alloc< RenderQueue >( arena );
+		renderQueue->setCamera( crimild::get_ptr( camera ) );
+		for ( auto &geometry : geometries ) {
+			renderQueue->push( crimild::get_ptr( geometry ) );
+		}
+		renderQueue->sort();
+	};
+
+	auto allocationsBefore = benchmark::getAllocationCount();
+	context.measure( "new queue per frame, heap (reference)", GEOMETRY_COUNT, [ &computeQueue ] {
+		computeQueue( nullptr );
+	}, FRAME_COUNT );
+	auto allocations = benchmark::getAllocationCount() - allocationsBefore;
+	context.report( "heap allocations", double( allocations ) / FRAME_COUNT, "allocs/frame" );
+
+	FrameArena frameArena;
+	allocationsBefore = benchmark::getAllocationCount();
+	context.measure( "new queue per frame, frame arena", GEOMETRY_COUNT, [ &computeQueue, &frameArena ] {
+		frameArena.beginFrame();
+		computeQueue( frameArena.getCurrentArena() );
+	}, FRAME_COUNT );
+	allocations = benchmark::getAllocationCount() - allocationsBefore;
+	context.report( "frame arena allocations", double( allocations ) / FRAME_COUNT, "allocs/frame" );
+	frameArena.beginFrame();
+	context.report( "frame arena blocks requested in last frame", double( frameArena.getLastFrameHeapAllocationCount() ), "blocks" );
+}
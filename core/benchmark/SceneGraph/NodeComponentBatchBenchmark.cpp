@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+
+#include "Components/RotationComponent.hpp"
+#include "Concurrency/Async.hpp"
+#include "Concurrency/JobScheduler.hpp"
+#include "SceneGraph/Group.hpp"
+#include "Visitors/Apply.hpp"
+
+#include <algorithm>
+#include <thread>
+
+using namespace crimild;
+using namespace crimild::concurrency;
+
+CRIMILD_BENCHMARK( NodeComponent, batchUpdate )
+{
+	const size_t NODE_COUNT = 100000;
+
+	JobScheduler scheduler;
+	scheduler.configure( std::thread::hardware_concurrency() - 1 );
+	scheduler.start();
+
+	auto scene = crimild::alloc< Group >();
+	for ( size_t i = 0; i < NODE_COUNT; i++ ) {
+		auto node = crimild::alloc< Node >();
+		node->attachComponent< RotationComponent >( Vector3f( 0.0f, 1.0f, 0.0f ), 0.01f * ( i % 100 ) );
+		scene->attachNode( node );
+	}
+
+	std::vector< NodeComponent * > components;
+	scene->perform( Apply( [ &components ]( Node *node ) {
+		node->forEachComponent( [ &components ]( NodeComponent *component ) {
+			components.push_back( component );
+		});
+	}));
+
+	const Clock clock( 1.0 / 60.0 );
+
+	// previous behavior: one virtual call per component
+	context.measure( "virtual update (100k rotating nodes)", NODE_COUNT, [ &components, &clock ] {
+		crimild::concurrency::parallel_for( size_t( 0 ), components.size(), [ &components, &clock ]( size_t i ) {
+			components[ i ]->update( clock );
+		});
+	});
+
+	auto updater = NodeComponent::getBatchUpdater( NodeComponent::getTypeId< RotationComponent >() );
+	context.measure( "batch update (100k rotating nodes)", NODE_COUNT, [ &components, &clock, updater ] {
+		auto count = components.size();
+		auto grain = crimild::concurrency::computeGrainSize( count );
+		auto chunkCount = ( count + grain - 1 ) / grain;
+		crimild::concurrency::parallel_for( size_t( 0 ), chunkCount, size_t( 1 ), [ &components, &clock, updater, count, grain ]( size_t chunk ) {
+			auto begin = chunk * grain;
+			auto end = std::min( begin + grain, count );
+			updater( components.data() + begin, end - begin, clock );
+		});
+	});
+
+	scheduler.stop();
+}
+
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+
+#include "SceneGraph/Node.hpp"
+#include "Components/MaterialComponent.hpp"
+#include "Components/RenderStateComponent.hpp"
+#include "Components/RotationComponent.hpp"
+#include "Components/BillboardComponent.hpp"
+
+#include <map>
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		/**
+		   \brief Mimics the previous name-based component storage, for reference
+		 */
+		class LegacyComponentMap {
+		public:
+			void attach( SharedPointer< NodeComponent > const &component )
+			{
+				_components[ component->getComponentName() ] = component;
+			}
+
+			template< class T >
+			T *getComponent( void )
+			{
+				return static_cast< T * >( crimild::get_ptr( _components[ T::__CLASS_NAME ] ) );
+			}
+
+		private:
+			std::map< std::string, SharedPointer< NodeComponent >> _components;
+		};
+
+	}
+
+}
+
+CRIMILD_BENCHMARK( Node, getComponent )
+{
+	const size_t LOOKUP_COUNT = 1000000;
+
+	auto components = std::vector< SharedPointer< NodeComponent >> {
+		crimild::alloc< MaterialComponent >(),
+		crimild::alloc< RenderStateComponent >(),
+		crimild::alloc< RotationComponent >( Vector3f( 0.0f, 1.0f, 0.0f ), 1.0f ),
+		crimild::alloc< BillboardComponent >(),
+	};
+
+	benchmark::LegacyComponentMap legacy;
+	auto node = crimild::alloc< Node >();
+	for ( auto &cmp : components ) {
+		legacy.attach( cmp );
+		node->attachComponent( cmp );
+	}
+
+	size_t found = 0;
+
+	context.measure( "map by name (4 components)", LOOKUP_COUNT, [ &legacy, &found, LOOKUP_COUNT ] {
+		for ( size_t i = 0; i < LOOKUP_COUNT; i++ ) {
+			found += legacy.getComponent< RenderStateComponent >() != nullptr;
+		}
+	});
+
+	context.measure( "type id (4 components)", LOOKUP_COUNT, [ &node, &found, LOOKUP_COUNT ] {
+		for ( size_t i = 0; i < LOOKUP_COUNT; i++ ) {
+			found += node->getComponent< RenderStateComponent >() != nullptr;
+		}
+	});
+
+	context.measure( "by name, slow path (4 components)", LOOKUP_COUNT, [ &node, &found, LOOKUP_COUNT ] {
+		for ( size_t i = 0; i < LOOKUP_COUNT; i++ ) {
+			found += node->getComponentWithName( RenderStateComponent::__CLASS_NAME ) != nullptr;
+		}
+	});
+
+	context.measure( "type id, missing component", LOOKUP_COUNT, [ &node, &found, LOOKUP_COUNT ] {
+		for ( size_t i = 0; i < LOOKUP_COUNT; i++ ) {
+			found += node->getComponent< NodeComponent >() != nullptr;
+		}
+	});
+}
+
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+
+#include "Streaming/MemoryStream.hpp"
+#include "SceneGraph/Group.hpp"
+#include "SceneGraph/Geometry.hpp"
+#include "Primitives/Primitive.hpp"
+#include "Concurrency/JobScheduler.hpp"
+
+#include <sstream>
+#include <thread>
+
+using namespace crimild;
+
+CRIMILD_BENCHMARK( Stream, saveAndLoadScene )
+{
+	const size_t GROUP_COUNT = 100;
+	const size_t NODES_PER_GROUP = 1000;
+	const size_t NODE_COUNT = GROUP_COUNT * NODES_PER_GROUP;
+
+	auto scene = crimild::alloc< Group >( "scene" );
+	for ( size_t i = 0; i < GROUP_COUNT; i++ ) {
+		auto group = crimild::alloc< Group >( "group" );
+		for ( size_t j = 0; j < NODES_PER_GROUP; j++ ) {
+			auto node = crimild::alloc< Node >( "node" );
+			node->local().setTranslate( i, j, 0.0f );
+			group->attachNode( node );
+		}
+		scene->attachNode( group );
+	}
+
+	std::vector< unsigned char > buffer;
+	context.measure( "save 100k nodes", NODE_COUNT, [ &scene, &buffer ] {
+		MemoryStream os;
+		os.addObject( scene );
+		os.flush();
+		buffer = os.getBuffer();
+	}, 3 );
+
+	context.report( "stream size", double( buffer.size() ) / NODE_COUNT, "bytes/node" );
+
+	// loaded scenes are released after measuring, since tearing down
+	// 100k nodes is dominated by the small object allocator
+	std::vector< SharedPointer< Node >> loaded;
+	context.measure( "load 100k nodes", NODE_COUNT, [ &buffer, &loaded ] {
+		MemoryStream is( buffer );
+		is.load();
+		loaded.push_back( is.getObjectAt< Node >( 0 ) );
+	}, 3 );
+}
+
+CRIMILD_BENCHMARK( Stream, parallelLoad )
+{
+	const size_t GEOMETRY_COUNT = 2000;
+	const size_t VERTEX_COUNT = 1000;
+
+	std::vector< VertexPrecision > vertices( VERTEX_COUNT * VertexFormat::VF_P3_N3_UV2.getVertexSize(), 1.0f );
+	std::vector< IndexPrecision > indices( VERTEX_COUNT );
+	for ( size_t i = 0; i < VERTEX_COUNT; i++ ) {
+		indices[ i ] = i;
+	}
+
+	auto scene = crimild::alloc< Group >( "scene" );
+	for ( size_t i = 0; i < GEOMETRY_COUNT; i++ ) {
+		auto primitive = crimild::alloc< Primitive >();
+		primitive->setVertexBuffer( crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_N3_UV2, VERTEX_COUNT, &vertices[ 0 ] ) );
+		primitive->setIndexBuffer( crimild::alloc< IndexBufferObject >( VERTEX_COUNT, &indices[ 0 ] ) );
+
+		auto geometry = crimild::alloc< Geometry >( "geometry" );
+		geometry->attachPrimitive( primitive );
+		scene->attachNode( geometry );
+	}
+
+	MemoryStream os;
+	os.addObject( scene );
+	os.flush();
+	auto &buffer = os.getBuffer();
+
+	context.report( "stream size", double( buffer.size() ) / ( 1024 * 1024 ), "MB" );
+
+	context.measure( "sequential", GEOMETRY_COUNT, [ &buffer ] {
+		MemoryStream is( buffer );
+		is.load();
+	});
+
+	std::vector< int > workerCounts = { 1 };
+	int maxWorkers = std::thread::hardware_concurrency() - 1;
+	for ( int workers = 2; workers < maxWorkers; workers *= 2 ) {
+		workerCounts.push_back( workers );
+	}
+	if ( maxWorkers > 1 ) {
+		workerCounts.push_back( maxWorkers );
+	}
+
+	for ( auto workers : workerCounts ) {
+		concurrency::JobScheduler scheduler;
+		scheduler.configure( workers );
+		scheduler.start();
+
+		std::stringstream label;
+		label << "parallel workers=" << workers;
+		context.measure( label.str(), GEOMETRY_COUNT, [ &buffer ] {
+			MemoryStream is( buffer );
+			is.setLoadMode( Stream::LoadMode::PARALLEL );
+			is.load();
+		});
+
+		scheduler.stop();
+	}
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic< std::size_t > allocationCount( 0 );
+
+std::size_t crimild::benchmark::getAllocationCount( void )
+{
+	return allocationCount.load( std::memory_order_relaxed );
+}
+
+void *operator new( std::size_t size )
+{
+	allocationCount.fetch_add( 1, std::memory_order_relaxed );
+
+	if ( auto ptr = std::malloc( size > 0 ? size : 1 ) ) {
+		return ptr;
+	}
+
+	throw std::bad_alloc();
+}
+
+void *operator new[]( std::size_t size )
+{
+	return ::operator new( size );
+}
+
+void operator delete( void *ptr ) noexcept
+{
+	std::free( ptr );
+}
+
+void operator delete[]( void *ptr ) noexcept
+{
+	std::free( ptr );
+}
+
+void operator delete( void *ptr, std::size_t ) noexcept
+{
+	std::free( ptr );
+}
+
+void operator delete[]( void *ptr, std::size_t ) noexcept
+{
+	std::free( ptr );
+}
+
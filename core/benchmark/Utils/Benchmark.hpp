@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_CORE_BENCHMARK_UTILS_BENCHMARK_
+#define CRIMILD_CORE_BENCHMARK_UTILS_BENCHMARK_
+
+#include "Foundation/Macros.hpp"
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace crimild {
+
+	namespace benchmark {
+
+		/**
+		   \brief Timing and reporting helpers passed to each benchmark
+		 */
+		class Context {
+		public:
+			using Clock = std::chrono::high_resolution_clock;
+
+			/**
+			   \brief Invokes the callback and returns the elapsed time in seconds
+			 */
+			double time( std::function< void( void ) > const &callback ) const
+			{
+				auto start = Clock::now();
+				callback();
+				auto end = Clock::now();
+				return std::chrono::duration< double >( end - start ).count();
+			}
+
+			/**
+			   \brief Runs the callback several times and reports the best throughput
+
+			   The callback is expected to process opCount operations on each run
+			 */
+			double measure( std::string const &label, size_t opCount, std::function< void( void ) > const &callback, int runs = 5 ) const
+			{
+				double best = -1.0;
+				for ( int i = 0; i < runs; i++ ) {
+					auto t = time( callback );
+					if ( best < 0.0 || t < best ) {
+						best = t;
+					}
+				}
+
+				report( label, 1.0e9 * best / opCount, "ns/op" );
+				return best;
+			}
+
+			void report( std::string const &label, double value, std::string const &unit ) const
+			{
+				std::cout << "  " << std::left << std::setw( 56 ) << label
+						  << std::right << std::setw( 14 ) << std::fixed << std::setprecision( 2 ) << value
+						  << " " << unit << std::endl;
+			}
+		};
+
+		using BenchmarkCallback = std::function< void( Context & ) >;
+
+		struct BenchmarkInfo {
+			std::string name;
+			BenchmarkCallback callback;
+		};
+
+		inline std::vector< BenchmarkInfo > &getBenchmarks( void )
+		{
+			static std::vector< BenchmarkInfo > benchmarks;
+			return benchmarks;
+		}
+
+		class BenchmarkRegistrar {
+		public:
+			BenchmarkRegistrar( std::string const &group, std::string const &name, BenchmarkCallback const &callback )
+			{
+				getBenchmarks().push_back( BenchmarkInfo { group + "." + name, callback } );
+			}
+		};
+
+	}
+
+}
+
+/**
+   \brief Declares a benchmark
+
+   Usage is similar to gtest's TEST macro:
+
+   CRIMILD_BENCHMARK( Group, name )
+   {
+	   context.measure( "label", count, [] { ... } );
+   }
+ */
+#define CRIMILD_BENCHMARK( GROUP, NAME ) \
+	static void GROUP##_##NAME##_Benchmark( crimild::benchmark::Context &context ); \
+	static crimild::benchmark::BenchmarkRegistrar GROUP##_##NAME##_BenchmarkRegistrar( #GROUP, #NAME, GROUP##_##NAME##_Benchmark ); \
+	static void GROUP##_##NAME##_Benchmark( crimild::benchmark::Context &context )
+
+#endif
+
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Utils/Benchmark.hpp"
+
+#include "Visitors/ComputeRenderQueue.hpp"
+#include "Visitors/UpdateWorldState.hpp"
+#include "Rendering/RenderQueue.hpp"
+#include "Components/RenderStateComponent.hpp"
+#include "SceneGraph/Group.hpp"
+#include "SceneGraph/Geometry.hpp"
+#include "SceneGraph/Camera.hpp"
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace benchmark {
+
+		/**
+		   \brief Counts how many nodes are visited by the culling traversal
+		 */
+		class CountingComputeRenderQueue : public ComputeRenderQueue {
+		public:
+			CountingComputeRenderQueue( Camera *camera, RenderQueue *result, bool hierarchical )
+				: ComputeRenderQueue( camera, result ),
+				  _hierarchical( hierarchical )
+			{
+			}
+
+			virtual void visitGroup( Group *group ) override
+			{
+				++visitedNodes;
+				if ( _hierarchical ) {
+					ComputeRenderQueue::visitGroup( group );
+				}
+				else {
+					// reference: groups are never culled
+					NodeVisitor::visitGroup( group );
+				}
+			}
+
+			virtual void visitGeometry( Geometry *geometry ) override
+			{
+				++visitedNodes;
+				ComputeRenderQueue::visitGeometry( geometry );
+			}
+
+			size_t visitedNodes = 0;
+
+		private:
+			bool _hierarchical;
+		};
+
+		/**
+		   \brief Builds an octree-like hierarchy of groups with geometries at the leaves
+		 */
+		static SharedPointer< Node > buildScene( int depth, float size, SharedPointer< Material > const &material )
+		{
+			if ( depth == 0 ) {
+				auto geometry = crimild::alloc< Geometry >();
+				geometry->localBound()->computeFrom( Vector3f( -1.0f, -1.0f, -1.0f ), Vector3f( 1.0f, 1.0f, 1.0f ) );
+				geometry->attachComponent< RenderStateComponent >()->attachMaterial( material );
+				return geometry;
+			}
+
+			auto group = crimild::alloc< Group >();
+			const float offset = 0.5f * size;
+			for ( int i = 0; i < 8; i++ ) {
+				auto child = buildScene( depth - 1, offset, material );
+				child->local().setTranslate(
+					( i & 1 ? 0.5f : -0.5f ) * offset,
+					( i & 2 ? 0.5f : -0.5f ) * offset,
+					( i & 4 ? 0.5f : -0.5f ) * offset );
+				group->attachNode( child );
+			}
+			return group;
+		}
+
+	}
+
+}
+
+CRIMILD_BENCHMARK( Culling, hierarchical )
+{
+	const int DEPTH = 5;
+
+	auto material = crimild::alloc< Material >();
+	auto scene = benchmark::buildScene( DEPTH, 800.0f, material );
+	scene->perform( UpdateWorldState() );
+
+	auto camera = crimild::alloc< Camera >();
+	auto renderQueue = crimild::alloc< RenderQueue >();
+
+	for ( auto hierarchical : { false, true } ) {
+		const std::string label = hierarchical ? "hierarchical culling" : "per geometry culling (reference)";
+
+		size_t visitedNodes = 0;
+		size_t visibleGeometries = 0;
+		context.measure( label, 1, [ & ] {
+			benchmark::CountingComputeRenderQueue visitor( crimild::get_ptr( camera ), crimild::get_ptr( renderQueue ), hierarchical );
+			scene->perform( visitor );
+			visitedNodes = visitor.visitedNodes;
+			visibleGeometries = renderQueue->getRenderables( RenderQueue::RenderableType::OPAQUE )->size();
+		});
+		context.report( label + " nodes visited", visitedNodes, "nodes/frame" );
+		context.report( label + " visible geometries", visibleGeometries, "geometries/frame" );
+	}
+}
+
@@ -31,6 +31,8 @@
 #include "SceneGraph/Camera.hpp"
 #include "Simulation/Simulation.hpp"
 
+CRIMILD_REGISTER_COMPONENT_BATCH_UPDATER( crimild::BillboardComponent, crimild::BillboardComponent::updateBatch )
+
 using namespace crimild;
 
 BillboardComponent::BillboardComponent( void )
@@ -56,3 +58,21 @@ void BillboardComponent::update( const Clock &c )
 	}
 }
 
+void BillboardComponent::updateBatch( NodeComponent *const *components, crimild::Size count, const Clock &c )
+{
+	auto camera = Simulation::getInstance()->getMainCamera();
+	if ( camera == nullptr ) {
+		return;
+	}
+
+	const auto &cameraRot = camera->getWorld().getRotate();
+
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		auto node = components[ i ]->getNode();
+		if ( node->hasParent() ) {
+			auto invParentRot = node->getParent()->getWorld().getRotate().getInverse();
+			node->local().setRotate( invParentRot * cameraRot );
+		}
+	}
+}
+
@@ -37,11 +37,20 @@ namespace crimild {
 	   \brief Makes sure the target node always faces the camera
 	 */
 	class BillboardComponent : public NodeComponent {
+		CRIMILD_IMPLEMENT_RTTI( crimild::BillboardComponent )
+
 	public:
         BillboardComponent( void );
         virtual ~BillboardComponent( void );
 
         virtual void update( const Clock &c ) override;
+
+        /**
+           \brief Updates many billboards at once, fetching the main camera only once
+
+           \see NodeComponent::BatchUpdater
+         */
+        static void updateBatch( NodeComponent *const *components, crimild::Size count, const Clock &c );
 	};
 
 }
@@ -29,8 +29,100 @@
 
 #include "SceneGraph/Node.hpp"
 
+#include <map>
+#include <mutex>
+#include <vector>
+
 using namespace crimild;
 
+namespace crimild {
+
+    namespace internal {
+
+        class NodeComponentTypeRegistry {
+        private:
+            using Mutex = std::mutex;
+            using Lock = std::lock_guard< Mutex >;
+
+        public:
+            static NodeComponentTypeRegistry &getInstance( void )
+            {
+                static NodeComponentTypeRegistry instance;
+                return instance;
+            }
+
+            NodeComponent::TypeId getTypeId( std::string const &name )
+            {
+                Lock lock( _mutex );
+
+                auto it = _typeIds.find( name );
+                if ( it != _typeIds.end() ) {
+                    return it->second;
+                }
+
+                // ids start at 1, since 0 is reserved for INVALID_TYPE_ID
+                auto typeId = static_cast< NodeComponent::TypeId >( _typeIds.size() + 1 );
+                _typeIds[ name ] = typeId;
+                return typeId;
+            }
+
+            NodeComponent::TypeId findTypeId( std::string const &name )
+            {
+                Lock lock( _mutex );
+
+                auto it = _typeIds.find( name );
+                return it != _typeIds.end() ? it->second : NodeComponent::INVALID_TYPE_ID;
+            }
+
+            void setBatchUpdater( NodeComponent::TypeId typeId, NodeComponent::BatchUpdater updater )
+            {
+                Lock lock( _mutex );
+
+                if ( _batchUpdaters.size() <= typeId ) {
+                    _batchUpdaters.resize( typeId + 1, nullptr );
+                }
+                _batchUpdaters[ typeId ] = updater;
+            }
+
+            NodeComponent::BatchUpdater getBatchUpdater( NodeComponent::TypeId typeId )
+            {
+                Lock lock( _mutex );
+
+                return typeId < _batchUpdaters.size() ? _batchUpdaters[ typeId ] : nullptr;
+            }
+
+        private:
+            std::map< std::string, NodeComponent::TypeId > _typeIds;
+            std::vector< NodeComponent::BatchUpdater > _batchUpdaters;
+            Mutex _mutex;
+        };
+
+    }
+
+}
+
+constexpr NodeComponent::TypeId NodeComponent::INVALID_TYPE_ID;
+
+NodeComponent::TypeId NodeComponent::getTypeIdForName( std::string const &name )
+{
+    return internal::NodeComponentTypeRegistry::getInstance().getTypeId( name );
+}
+
+NodeComponent::TypeId NodeComponent::findTypeIdForName( std::string const &name )
+{
+    return internal::NodeComponentTypeRegistry::getInstance().findTypeId( name );
+}
+
+void NodeComponent::registerBatchUpdater( TypeId typeId, BatchUpdater updater )
+{
+    internal::NodeComponentTypeRegistry::getInstance().setBatchUpdater( typeId, updater );
+}
+
+NodeComponent::BatchUpdater NodeComponent::getBatchUpdater( TypeId typeId )
+{
+    return internal::NodeComponentTypeRegistry::getInstance().getBatchUpdater( typeId );
+}
+
 NodeComponent::NodeComponent( void )
     : _node( nullptr )
 {
@@ -51,6 +143,15 @@ NodeComponent *NodeComponent::getComponentWithName( std::string name )
     return getNode()->getComponentWithName( name );
 }
 
+NodeComponent *NodeComponent::getComponentWithTypeId( TypeId typeId )
+{
+    if ( getNode() == nullptr ) {
+        return nullptr;
+    }
+    
+    return getNode()->getComponentWithTypeId( typeId );
+}
+
 void NodeComponent::onAttach( void )
 {
 
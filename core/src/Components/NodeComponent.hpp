@@ -40,6 +40,9 @@ namespace crimild {
     class NodeComponent : public StreamObject {
     	CRIMILD_IMPLEMENT_RTTI( crimild::NodeComponent )
         
+    public:
+        using TypeId = crimild::UInt32;
+        
 	protected:
 		NodeComponent( void );
 
@@ -73,11 +76,104 @@ namespace crimild {
     public:
         NodeComponent *getComponentWithName( std::string name );
         
+        NodeComponent *getComponentWithTypeId( TypeId typeId );
+        
         template< class NODE_COMPONENT_CLASS >
         NODE_COMPONENT_CLASS *getComponent( void )
         {
-            return static_cast< NODE_COMPONENT_CLASS * >( getComponentWithName( NODE_COMPONENT_CLASS::__CLASS_NAME ) );
+            return static_cast< NODE_COMPONENT_CLASS * >( getComponentWithTypeId( getTypeId< NODE_COMPONENT_CLASS >() ) );
+        }
+        
+        /**
+            \name Component type ids
+         
+            Every component name is mapped to a small integer id the first
+            time it is seen. Ids are dense and stable for the duration of
+            the program, but they are not persistent. Use names when
+            saving components.
+        */
+        //@{
+        
+    public:
+        static constexpr TypeId INVALID_TYPE_ID = 0;
+        
+        /**
+            \brief Get the id for a given component name, registering it if needed
+         
+            This is the slow path, requiring a lock and a map lookup.
+         */
+        static TypeId getTypeIdForName( std::string const &name );
+        
+        /**
+            \brief Get the id for a given component name
+         
+            \returns INVALID_TYPE_ID if no component with that name has been registered
+         */
+        static TypeId findTypeIdForName( std::string const &name );
+        
+        /**
+            \brief Get the id for a component class
+         
+            The id is resolved only once per class, so this is the preferred
+            way to identify components in hot paths.
+         */
+        template< class NODE_COMPONENT_CLASS >
+        static TypeId getTypeId( void )
+        {
+            static const TypeId typeId = getTypeIdForName( NODE_COMPONENT_CLASS::__CLASS_NAME );
+            return typeId;
         }
+        
+        /**
+            \brief Id for this component's name
+         
+            \remarks Only valid once the component has been attached to a node
+         */
+        TypeId getComponentTypeId( void ) const { return _componentTypeId; }
+        
+        // internal use only
+        void setComponentTypeId( TypeId typeId ) { _componentTypeId = typeId; }
+        
+    private:
+        TypeId _componentTypeId = INVALID_TYPE_ID;
+        
+        //@}
+        
+        /**
+            \name Batch updates
+         
+            Component types may register a function updating many components
+            of that type at once. Instead of invoking the virtual update()
+            method for each component, the UpdateSystem gathers components
+            of the same type into contiguous arrays and passes them to the
+            batch updater in chunks, which are processed in parallel.
+         
+            Batch updaters must behave exactly like update() does for each
+            of the given components and may be invoked from any thread.
+         
+            \see CRIMILD_REGISTER_COMPONENT_BATCH_UPDATER
+        */
+        //@{
+        
+    public:
+        using BatchUpdater = void (*)( NodeComponent *const *components, crimild::Size count, const Clock &clock );
+        
+        static void registerBatchUpdater( TypeId typeId, BatchUpdater updater );
+        
+        /**
+            \returns nullptr if no batch updater has been registered for the given type id
+         */
+        static BatchUpdater getBatchUpdater( TypeId typeId );
+        
+        class BatchUpdaterRegistrar {
+        public:
+            BatchUpdaterRegistrar( const char *componentName, BatchUpdater updater )
+            {
+                registerBatchUpdater( getTypeIdForName( componentName ), updater );
+            }
+        };
+        
+        //@}
 
 	public:
 		/**
@@ -121,5 +217,15 @@ namespace crimild {
 
 }
 
+/**
+    \brief Registers a batch updater for a component class
+
+    \code
+        CRIMILD_REGISTER_COMPONENT_BATCH_UPDATER( crimild::RotationComponent, RotationComponent::updateBatch )
+    \endcode
+ */
+#define CRIMILD_REGISTER_COMPONENT_BATCH_UPDATER( X, UPDATER ) \
+    static crimild::NodeComponent::BatchUpdaterRegistrar CRIMILD_RANDOM_VARIABLE_NAME( __componentBatchUpdater__ )( #X, UPDATER );
+
 #endif
 
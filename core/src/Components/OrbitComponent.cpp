@@ -30,6 +30,8 @@
 #include "Mathematics/Numeric.hpp"
 #include "SceneGraph/Node.hpp"
 
+CRIMILD_REGISTER_COMPONENT_BATCH_UPDATER( crimild::OrbitComponent, crimild::OrbitComponent::updateBatch )
+
 using namespace crimild;
 
 OrbitComponent::OrbitComponent( float x0, float y0, float major, float minor, float speed, float gamma )
@@ -56,3 +58,23 @@ void OrbitComponent::update( const Clock &c )
 	_t += _speed * c.getDeltaTime();
 }
 
+void OrbitComponent::updateBatch( NodeComponent *const *components, crimild::Size count, const Clock &c )
+{
+	const auto dt = c.getDeltaTime();
+
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		auto cmp = static_cast< OrbitComponent * >( components[ i ] );
+
+		const auto cosT = std::cos( cmp->_t );
+		const auto sinT = std::sin( cmp->_t );
+		const auto cosGamma = std::cos( cmp->_gamma );
+		const auto sinGamma = std::sin( cmp->_gamma );
+
+		auto &translate = cmp->getNode()->local().translate();
+		translate[ 0 ] = cmp->_x0 + cmp->_major * cosT * cosGamma - cmp->_minor * sinT * sinGamma;
+		translate[ 1 ] = cmp->_y0 + cmp->_major * cosT * sinGamma + cmp->_minor * sinT * cosGamma;
+
+		cmp->_t += cmp->_speed * dt;
+	}
+}
+
@@ -43,6 +43,13 @@ namespace crimild {
 
 		virtual void update( const Clock &c ) override;
 
+		/**
+		   \brief Updates many orbit components at once
+
+		   \see NodeComponent::BatchUpdater
+		 */
+		static void updateBatch( NodeComponent *const *components, crimild::Size count, const Clock &c );
+
 	private:
 		float _x0;
 		float _y0;
@@ -31,6 +31,8 @@
 #include "SceneGraph/Node.hpp"
 #include "Visitors/UpdateWorldState.hpp"
 
+CRIMILD_REGISTER_COMPONENT_BATCH_UPDATER( crimild::RotationComponent, crimild::RotationComponent::updateBatch )
+
 using namespace crimild;
 
 RotationComponent::RotationComponent( const Vector3f &axis, float speed )
@@ -52,3 +54,15 @@ void RotationComponent::update( const Clock &c )
 	_time += _speed * c.getDeltaTime();
 }
 
+void RotationComponent::updateBatch( NodeComponent *const *components, crimild::Size count, const Clock &c )
+{
+	const auto dt = c.getDeltaTime();
+	const auto TWO_PI = 2.0f * Numericf::PI;
+
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		auto cmp = static_cast< RotationComponent * >( components[ i ] );
+		cmp->getNode()->local().rotate().fromAxisAngle( cmp->_axis, cmp->_time * TWO_PI );
+		cmp->_time += cmp->_speed * dt;
+	}
+}
+
@@ -42,6 +42,13 @@ namespace crimild {
 
 		virtual void update( const Clock &c ) override;
 
+		/**
+		   \brief Updates many rotation components at once
+
+		   \see NodeComponent::BatchUpdater
+		 */
+		static void updateBatch( NodeComponent *const *components, crimild::Size count, const Clock &c );
+
 	private:
 		Vector3f _axis;
 		float _speed;
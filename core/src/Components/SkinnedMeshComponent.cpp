@@ -34,6 +34,7 @@
 #include "Foundation/Log.hpp"
 
 CRIMILD_REGISTER_STREAM_OBJECT_BUILDER( crimild::SkinnedMeshComponent )
+CRIMILD_REGISTER_COMPONENT_BATCH_UPDATER( crimild::SkinnedMeshComponent, crimild::SkinnedMeshComponent::updateBatch )
 
 using namespace crimild;
 
@@ -142,6 +143,16 @@ void SkinnedMeshComponent::update( const Clock &c )
 	}));		
 }
 
+void SkinnedMeshComponent::updateBatch( NodeComponent *const *components, crimild::Size count, const Clock &c )
+{
+	// Evaluating animations is expensive enough that there's little to
+	// gain from sharing state between components, but skipping virtual
+	// dispatch still lets us process them in type-homogeneous chunks
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		static_cast< SkinnedMeshComponent * >( components[ i ] )->SkinnedMeshComponent::update( c );
+	}
+}
+
 void SkinnedMeshComponent::setAnimationParams( 
 	float firstFrame, 
 	float lastFrame, 
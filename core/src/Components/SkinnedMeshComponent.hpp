@@ -49,6 +49,13 @@ namespace crimild {
 
 		virtual void start( void ) override;
 		virtual void update( const Clock &c ) override;
+
+		/**
+		   \brief Updates many skinned meshes at once
+
+		   \see NodeComponent::BatchUpdater
+		 */
+		static void updateBatch( NodeComponent *const *components, crimild::Size count, const Clock &c );
 		virtual void renderDebugInfo( Renderer *renderer, Camera *camera ) override;
 
 		void setSkinnedMesh( SharedPointer< SkinnedMesh > const &mesh ) { _skinnedMesh = mesh; }
@@ -33,30 +33,14 @@ using namespace crimild::concurrency;
 
 JobPtr crimild::concurrency::async( void )
 {
-    auto job = crimild::alloc< Job >();
+    auto job = Job::create();
 	job->reset();
 	return job;
 }
 
-JobPtr crimild::concurrency::async( JobCallback const &callback )
-{
-    auto job = crimild::alloc< Job >();
-	job->reset( callback );
-	JobScheduler::getInstance()->schedule( job );
-	return job;
-}
-
-JobPtr crimild::concurrency::async( JobPtr const &parent, JobCallback const &callback )
-{
-    auto child = crimild::alloc< Job >();
-	child->reset( parent, callback );
-	JobScheduler::getInstance()->schedule( child );
-	return child;
-}
-
 JobPtr crimild::concurrency::sync_frame( JobCallback const &callback )
 {
-    auto job = crimild::alloc< Job >();
+    auto job = Job::create();
     job->reset( callback );
     JobScheduler::getInstance()->delaySync( job );
     return job;
@@ -64,7 +48,7 @@ JobPtr crimild::concurrency::sync_frame( JobCallback const &callback )
 
 JobPtr crimild::concurrency::async_frame( JobCallback const &callback )
 {
-    auto job = crimild::alloc< Job >();
+    auto job = Job::create();
     job->reset( callback );
     JobScheduler::getInstance()->delayAsync( job );
     return job;
@@ -75,3 +59,13 @@ void crimild::concurrency::wait( JobPtr const &job )
 	JobScheduler::getInstance()->wait( job );
 }
 
+size_t crimild::concurrency::computeGrainSize( size_t count )
+{
+	// main thread counts as a worker too
+	const size_t CHUNKS_PER_WORKER = 8;
+	auto workerCount = JobScheduler::hasInstance() ? static_cast< size_t >( JobScheduler::getInstance()->getNumWorkers() + 1 ) : size_t( 1 );
+
+	auto grain = count / ( CHUNKS_PER_WORKER * workerCount );
+	return grain > 0 ? grain : 1;
+}
+
@@ -29,6 +29,9 @@
 #define CRIMILD_CORE_ASYNC_
 
 #include "Job.hpp"
+#include "JobScheduler.hpp"
+
+#include <vector>
 
 namespace crimild {
 
@@ -47,16 +50,34 @@ namespace crimild {
         /**
             \brief Creates and dispatches an async job
          
+            The job is allocated from the current worker's pool and the
+            callback is stored inline if small enough, so no memory is
+            allocated in the common case.
+
             \remarks The job will be executed in a background thread
          */
-		JobPtr async( JobCallback const &callback );
+		template< typename Fn >
+		JobPtr async( Fn &&callback )
+		{
+			auto job = Job::create();
+			job->reset( std::forward< Fn >( callback ) );
+			JobScheduler::getInstance()->schedule( job );
+			return job;
+		}
 
         /**
             \brief Creates and dispatches an async job linked to a parent
          
             \remarks The job will be executed in a background thread
          */
-		JobPtr async( JobPtr const &parent, JobCallback const &callback );
+		template< typename Fn >
+		JobPtr async( JobPtr const &parent, Fn &&callback )
+		{
+			auto child = Job::create();
+			child->reset( parent, std::forward< Fn >( callback ) );
+			JobScheduler::getInstance()->schedule( child );
+			return child;
+		}
 
         /**
             \brief Creates and dispatches a job in the main thread
@@ -87,6 +108,133 @@ namespace crimild {
          */
 		void wait( JobPtr const &job );
 
+		/**
+		   \name Parallel algorithms
+		 */
+		//@{
+
+		/**
+		   \brief Computes a grain size for a range of the given length
+
+		   Aims for several chunks per worker, so idle workers
+		   have something to steal if chunks are unbalanced
+		 */
+		size_t computeGrainSize( size_t count );
+
+		namespace internal {
+
+			template< typename Index, typename Fn >
+			void parallel_for_range( JobPtr const *parent, Index begin, Index end, Index grain, Fn const *fn )
+			{
+				// keep splitting the range in halves, dispatching the upper
+				// half to other workers and processing the lower one here
+				while ( end - begin > grain ) {
+					auto mid = begin + ( end - begin ) / 2;
+					async( *parent, [ parent, mid, end, grain, fn ] {
+						parallel_for_range( parent, mid, end, grain, fn );
+					});
+					end = mid;
+				}
+
+				for ( auto i = begin; i < end; i++ ) {
+					( *fn )( i );
+				}
+			}
+
+		}
+
+		/**
+		   \brief Invokes fn( i ) for every i in [begin, end) in parallel
+
+		   The range is split recursively until chunks are no bigger than
+		   grain, so only a logarithmic number of jobs are created by each
+		   worker and job overhead is amortized across grain elements.
+
+		   \param grain Maximum number of elements processed by a single job.
+		   If zero, an adaptive grain size is computed based on the number
+		   of workers.
+
+		   \remarks Blocks until all elements have been processed. The
+		   calling thread will execute jobs in the meantime. If there is no
+		   scheduler, all elements are processed in the calling thread.
+		 */
+		template< typename Index, typename Fn >
+		void parallel_for( Index begin, Index end, Index grain, Fn const &fn )
+		{
+			if ( end <= begin ) {
+				return;
+			}
+
+			if ( grain <= 0 ) {
+				grain = static_cast< Index >( computeGrainSize( static_cast< size_t >( end - begin ) ) );
+			}
+
+			if ( end - begin <= grain || !JobScheduler::hasInstance() ) {
+				// not worth dispatching jobs (or there's no one to dispatch them to)
+				for ( auto i = begin; i < end; i++ ) {
+					fn( i );
+				}
+				return;
+			}
+
+			auto parent = async();
+			internal::parallel_for_range( &parent, begin, end, grain, &fn );
+			wait( parent );
+		}
+
+		/**
+		   \brief Same as above, using an adaptive grain size
+		 */
+		template< typename Index, typename Fn >
+		void parallel_for( Index begin, Index end, Fn const &fn )
+		{
+			parallel_for( begin, end, Index( 0 ), fn );
+		}
+
+		/**
+		   \brief Reduces the range [begin, end) in parallel
+
+		   The range is divided into chunks of at most grain elements. Each
+		   chunk is computed as map( chunkBegin, chunkEnd, identity ) and
+		   partial results are combined using reduce( a, b ) in chunk order,
+		   so the result is deterministic for a given grain size even if
+		   reduce is not commutative.
+
+		   \param grain Maximum number of elements per chunk. If zero, an
+		   adaptive grain size is computed based on the number of workers.
+		 */
+		template< typename Index, typename T, typename MapFn, typename ReduceFn >
+		T parallel_reduce( Index begin, Index end, Index grain, T const &identity, MapFn const &map, ReduceFn const &reduce )
+		{
+			if ( end <= begin ) {
+				return identity;
+			}
+
+			if ( grain <= 0 ) {
+				grain = static_cast< Index >( computeGrainSize( static_cast< size_t >( end - begin ) ) );
+			}
+
+			auto chunkCount = static_cast< size_t >( ( end - begin + grain - 1 ) / grain );
+			if ( chunkCount == 1 ) {
+				return map( begin, end, identity );
+			}
+
+			std::vector< T > partials( chunkCount, identity );
+			parallel_for( size_t( 0 ), chunkCount, size_t( 1 ), [ &partials, &map, begin, end, grain ]( size_t chunk ) {
+				auto chunkBegin = begin + static_cast< Index >( chunk ) * grain;
+				auto chunkEnd = chunkBegin + grain < end ? chunkBegin + grain : end;
+				partials[ chunk ] = map( chunkBegin, chunkEnd, partials[ chunk ] );
+			});
+
+			auto result = identity;
+			for ( auto &partial : partials ) {
+				result = reduce( result, partial );
+			}
+			return result;
+		}
+
+		//@}
+
 	}
 
 }
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_CORE_CONCURRENCY_EVENT_COUNT_
+#define CRIMILD_CORE_CONCURRENCY_EVENT_COUNT_
+
+#include "Foundation/NonCopyable.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace crimild {
+
+	namespace concurrency {
+
+		/**
+		   \brief A condition variable that does not require locking on the notifying side
+
+		   Waiting is a two-step process in order to avoid lost wake-ups:
+
+		   auto key = event.prepareWait();
+		   if ( conditionIsMet() ) {
+		       event.cancelWait();
+		   }
+		   else {
+		       event.wait( key );
+		   }
+
+		   Any notification issued after prepareWait() returns will cause
+		   wait() to return immediately. Notifying is cheap when there are
+		   no waiters, since it only involves a couple of atomic operations.
+		 */
+		class EventCount : public NonCopyable {
+		public:
+			using Key = uint64_t;
+
+		public:
+			EventCount( void )
+				: _epoch( 0 ),
+				  _waiters( 0 )
+			{
+
+			}
+
+			virtual ~EventCount( void )
+			{
+
+			}
+
+			Key prepareWait( void )
+			{
+				_waiters.fetch_add( 1, std::memory_order_seq_cst );
+				return _epoch.load( std::memory_order_seq_cst );
+			}
+
+			void cancelWait( void )
+			{
+				_waiters.fetch_sub( 1, std::memory_order_seq_cst );
+			}
+
+			/**
+			   \brief Blocks until a notification is issued after the key was obtained
+			 */
+			void wait( Key key )
+			{
+				std::unique_lock< std::mutex > lock( _mutex );
+				while ( _epoch.load( std::memory_order_seq_cst ) == key ) {
+					_condition.wait( lock );
+				}
+				_waiters.fetch_sub( 1, std::memory_order_seq_cst );
+			}
+
+			void notifyOne( void )
+			{
+				if ( advance() ) {
+					_condition.notify_one();
+				}
+			}
+
+			void notifyAll( void )
+			{
+				if ( advance() ) {
+					_condition.notify_all();
+				}
+			}
+
+			unsigned int getWaiterCount( void ) const { return _waiters.load( std::memory_order_relaxed ); }
+
+		private:
+			/**
+			   \returns true if there are threads that should be notified
+			 */
+			bool advance( void )
+			{
+				_epoch.fetch_add( 1, std::memory_order_seq_cst );
+				if ( _waiters.load( std::memory_order_seq_cst ) == 0 ) {
+					return false;
+				}
+
+				// acquiring the lock guarantees that any thread that
+				// already checked the epoch is blocked in wait()
+				std::lock_guard< std::mutex > lock( _mutex );
+				return true;
+			}
+
+		private:
+			std::atomic< Key > _epoch;
+			std::atomic< unsigned int > _waiters;
+			std::mutex _mutex;
+			std::condition_variable _condition;
+		};
+
+	}
+
+}
+
+#endif
+
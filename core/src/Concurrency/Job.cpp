@@ -31,8 +31,7 @@ using namespace crimild;
 using namespace crimild::concurrency;
 
 Job::Job( void )
-	: _callback( nullptr ),
-      _parent( nullptr ),
+	: _parent( nullptr ),
 	  _childCount( 0 )
 {
 
@@ -45,39 +44,23 @@ Job::~Job( void )
 
 void Job::reset( void )
 {
-	_callback = nullptr;
+	_callback.reset();
 	_parent = nullptr;
 	_childCount = 0;
 }
 
-void Job::reset( JobCallback const &callback )
-{
-	_callback = callback;
-	_parent = nullptr;
-	_childCount = 1;
-}
-
-void Job::reset( JobPtr const &parent, JobCallback const &callback )
-{
-	_callback = callback;
-    _parent = crimild::get_ptr( parent );
-	_childCount = 1;
-
-	if ( _parent != nullptr ) {
-		_parent->increaseChildCount();
-	}
-}
-
 void Job::increaseChildCount( void )
 {
 	++_childCount;
 }
 
-void Job::decreaseChildCount( void )
+size_t Job::decreaseChildCount( void )
 {
-	if ( _childCount > 0 ) {
-		--_childCount;
+	auto count = _childCount.load();
+	while ( count > 0 && !_childCount.compare_exchange_weak( count, count - 1 ) ) {
+		// retry
 	}
+	return count > 0 ? count - 1 : 0;
 }
 
 void Job::attachContinuation( JobContinuationCallback const &callback )
@@ -87,8 +70,11 @@ void Job::attachContinuation( JobContinuationCallback const &callback )
 
 void Job::execute( void )
 {
-	if ( _callback != nullptr ) {
+	if ( _callback ) {
 		_callback();
+
+		// release any captured state before notifying completion
+		_callback.reset();
 	}
 
 	finish();
@@ -96,12 +82,11 @@ void Job::execute( void )
 
 void Job::finish( void )
 {
-	decreaseChildCount();
-	if ( isCompleted() ) {
-		if ( _parent != nullptr ) {
-			_parent->finish();
-		}
-        _callback = nullptr;
+	// once the counter reaches zero, waiting threads may release
+	// this job, so it must not be accessed after decreasing it
+	auto parent = _parent;
+	if ( decreaseChildCount() == 0 && parent != nullptr ) {
+		parent->finish();
 	}
 }
 
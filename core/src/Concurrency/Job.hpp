@@ -28,11 +28,15 @@
 #ifndef CRIMILD_CORE_CONCURRENCY_JOB_
 #define CRIMILD_CORE_CONCURRENCY_JOB_
 
-#include "Foundation/NamedObject.hpp"
-#include "Foundation/SharedObject.hpp"
+#include "JobFunction.hpp"
+#include "JobPool.hpp"
+
+#include "Foundation/Memory.hpp"
+#include "Foundation/NonCopyable.hpp"
 
 #include <atomic>
 #include <functional>
+#include <vector>
 
 namespace crimild {
 
@@ -44,6 +48,10 @@ namespace crimild {
 
 		/**
 		   \brief Callback for a job
+
+		   \remarks Jobs accept any callable object, which is stored inline
+		   if small enough. Passing a JobCallback is still supported, but
+		   copying a std::function may allocate memory.
 		 */
 		using JobCallback = std::function< void( void ) >;
 
@@ -54,15 +62,46 @@ namespace crimild {
 
 		/**
 		   \brief Describes a job that can be executed concurrently
+
+		   Jobs are allocated from the JobPool of the calling thread, together
+		   with their shared pointer control block. Use Job::create() instead
+		   of allocating jobs directly.
 		 */
-		class Job : public SharedObject, public NamedObject {
+		class Job : public NonCopyable {
+		public:
+			/**
+			   \brief Creates a new job using the current thread's pool
+			 */
+			static JobPtr create( void )
+			{
+				return std::allocate_shared< Job >( JobPoolAllocator< Job >() );
+			}
+
 		public:
 			Job( void );
 			virtual ~Job( void );
 
 			void reset( void );
-			void reset( JobCallback const &callback );
-			void reset( JobPtr const &parent, JobCallback const &callback );
+
+			template< typename Fn >
+			void reset( Fn &&callback )
+			{
+				_callback.assign( std::forward< Fn >( callback ) );
+				_parent = nullptr;
+				_childCount = 1;
+			}
+
+			template< typename Fn >
+			void reset( JobPtr const &parent, Fn &&callback )
+			{
+				_callback.assign( std::forward< Fn >( callback ) );
+				_parent = crimild::get_ptr( parent );
+				_childCount = 1;
+
+				if ( _parent != nullptr ) {
+					_parent->increaseChildCount();
+				}
+			}
 			
 			void execute( void );
 			void finish( void );
@@ -70,12 +109,19 @@ namespace crimild {
 			bool isCompleted( void ) const { return _childCount == 0; }
 
 		private:
-			JobCallback _callback;
+			JobFunction _callback;
 
 		public:
 			Job *getParent( void ) const { return _parent; }
 
 		private:
+			/**
+			   \brief Intrusive link to the parent job
+
+			   No reference is kept, since the parent cannot complete
+			   (and therefore should not be released) until all of
+			   its children have finished.
+			 */
 			Job *_parent = nullptr;
 
 			/**
@@ -83,7 +129,11 @@ namespace crimild {
 			 */
 		public:
 			void increaseChildCount( void );
-			void decreaseChildCount( void );
+
+			/**
+			   \returns The number of pending children after decreasing the counter
+			 */
+			size_t decreaseChildCount( void );
 			size_t getChildCount( void ) const { return _childCount; }
 
 		private:
@@ -110,6 +160,23 @@ namespace crimild {
 			std::vector< JobContinuationCallback > _continuations;
 
 			//@}
+
+			/**
+			   \name Scheduling support
+
+			   Worker queues only store raw pointers, so a scheduled job
+			   keeps a reference to itself until a worker dequeues it
+			*/
+			//@{
+
+		public:
+			void retainScheduled( JobPtr const &self ) { _scheduled = self; }
+			JobPtr releaseScheduled( void ) { return std::move( _scheduled ); }
+
+		private:
+			JobPtr _scheduled;
+
+			//@}
 		};
 
 	}
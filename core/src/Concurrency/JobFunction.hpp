@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_CORE_CONCURRENCY_JOB_FUNCTION_
+#define CRIMILD_CORE_CONCURRENCY_JOB_FUNCTION_
+
+#include "Foundation/NonCopyable.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace crimild {
+
+	namespace concurrency {
+
+		/**
+		   \brief A type-erased callable stored inline
+
+		   Unlike std::function, callables up to STORAGE_SIZE bytes are
+		   stored within the object itself, so assigning a lambda does
+		   not allocate memory. Bigger callables are still supported,
+		   but they are moved to the heap.
+
+		   Instances cannot be copied, since they are meant to live
+		   inside a job for as long as it is alive.
+		 */
+		class JobFunction : public NonCopyable {
+		public:
+			static constexpr std::size_t STORAGE_SIZE = 96;
+
+		public:
+			JobFunction( void ) { }
+
+			virtual ~JobFunction( void )
+			{
+				reset();
+			}
+
+			explicit operator bool( void ) const { return _invoke != nullptr; }
+
+			bool isStoredInline( void ) const { return _inline; }
+
+			template< typename Fn >
+			void assign( Fn &&fn )
+			{
+				using Callable = typename std::decay< Fn >::type;
+
+				reset();
+
+				if ( isEmpty( fn ) ) {
+					// nothing to invoke, so the function remains unset
+					return;
+				}
+
+				assign( std::forward< Fn >( fn ), std::integral_constant< bool, fitsInline< Callable >() >() );
+			}
+
+			void reset( void )
+			{
+				if ( _destroy != nullptr ) {
+					_destroy( &_storage );
+				}
+
+				_invoke = nullptr;
+				_destroy = nullptr;
+				_inline = false;
+			}
+
+			void operator()( void )
+			{
+				_invoke( &_storage );
+			}
+
+		private:
+			template< typename Callable >
+			static bool isEmpty( Callable const & ) { return false; }
+
+			template< typename Signature >
+			static bool isEmpty( std::function< Signature > const &fn ) { return !fn; }
+
+			template< typename Callable >
+			static constexpr bool fitsInline( void )
+			{
+				return sizeof( Callable ) <= STORAGE_SIZE && alignof( Callable ) <= alignof( Storage );
+			}
+
+			template< typename Fn >
+			void assign( Fn &&fn, std::true_type )
+			{
+				using Callable = typename std::decay< Fn >::type;
+
+				new ( &_storage ) Callable( std::forward< Fn >( fn ) );
+				_invoke = []( void *storage ) {
+					( *static_cast< Callable * >( storage ) )();
+				};
+				_destroy = []( void *storage ) {
+					static_cast< Callable * >( storage )->~Callable();
+				};
+				_inline = true;
+			}
+
+			template< typename Fn >
+			void assign( Fn &&fn, std::false_type )
+			{
+				using Callable = typename std::decay< Fn >::type;
+
+				*reinterpret_cast< Callable ** >( &_storage ) = new Callable( std::forward< Fn >( fn ) );
+				_invoke = []( void *storage ) {
+					( **static_cast< Callable ** >( storage ) )();
+				};
+				_destroy = []( void *storage ) {
+					delete *static_cast< Callable ** >( storage );
+				};
+				_inline = false;
+			}
+
+		private:
+			using Storage = typename std::aligned_storage< STORAGE_SIZE, alignof( std::max_align_t ) >::type;
+
+			Storage _storage;
+			void ( *_invoke )( void * ) = nullptr;
+			void ( *_destroy )( void * ) = nullptr;
+			bool _inline = false;
+		};
+
+	}
+
+}
+
+#endif
+
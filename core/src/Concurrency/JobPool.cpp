@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "JobPool.hpp"
+
+#include <cassert>
+#include <mutex>
+
+using namespace crimild;
+using namespace crimild::concurrency;
+
+constexpr std::size_t JobPool::BLOCK_SIZE;
+constexpr std::size_t JobPool::BLOCKS_PER_CHUNK;
+constexpr std::size_t JobPool::HEADER_SIZE;
+
+std::atomic< std::size_t > JobPool::_totalChunkCount( 0 );
+
+namespace crimild {
+
+	namespace concurrency {
+
+		/**
+		   \brief Keeps track of pools that are not owned by any thread
+		 */
+		class JobPoolRegistry {
+		public:
+			static JobPoolRegistry *getInstance( void )
+			{
+				// intentionally leaked, since jobs may be released during static destruction
+				static auto instance = new JobPoolRegistry();
+				return instance;
+			}
+
+			JobPool *acquire( void )
+			{
+				std::lock_guard< std::mutex > lock( _mutex );
+
+				if ( _availablePools.empty() ) {
+					return new JobPool();
+				}
+
+				auto pool = _availablePools.back();
+				_availablePools.pop_back();
+				return pool;
+			}
+
+			void release( JobPool *pool )
+			{
+				std::lock_guard< std::mutex > lock( _mutex );
+				_availablePools.push_back( pool );
+			}
+
+		private:
+			std::mutex _mutex;
+			std::vector< JobPool * > _availablePools;
+		};
+
+		/**
+		   \brief Binds a pool to the current thread and returns it to the registry on exit
+		 */
+		class JobPoolBinding {
+		public:
+			~JobPoolBinding( void )
+			{
+				if ( pool != nullptr ) {
+					JobPoolRegistry::getInstance()->release( pool );
+					pool = nullptr;
+				}
+			}
+
+			JobPool *pool = nullptr;
+		};
+
+		static thread_local JobPoolBinding tls_jobPoolBinding;
+
+	}
+
+}
+
+JobPool *JobPool::getInstance( void )
+{
+	auto &binding = tls_jobPoolBinding;
+	if ( binding.pool == nullptr ) {
+		binding.pool = JobPoolRegistry::getInstance()->acquire();
+	}
+	return binding.pool;
+}
+
+void *JobPool::allocate( std::size_t size )
+{
+	assert( size <= BLOCK_SIZE && "Requested size is too big for a job block" );
+
+	return getInstance()->allocateBlock();
+}
+
+void JobPool::deallocate( void *ptr )
+{
+	if ( ptr == nullptr ) {
+		return;
+	}
+
+	auto block = reinterpret_cast< Block * >( static_cast< char * >( ptr ) - HEADER_SIZE );
+	block->owner->releaseBlock( block );
+}
+
+std::size_t JobPool::getTotalChunkCount( void )
+{
+	return _totalChunkCount.load( std::memory_order_relaxed );
+}
+
+JobPool::JobPool( void )
+	: _remoteFreeBlocks( nullptr )
+{
+
+}
+
+JobPool::~JobPool( void )
+{
+
+}
+
+void *JobPool::allocateBlock( void )
+{
+	if ( _freeBlocks == nullptr ) {
+		// reclaim all blocks released by other threads at once
+		_freeBlocks = _remoteFreeBlocks.exchange( nullptr, std::memory_order_acquire );
+	}
+
+	if ( _freeBlocks == nullptr ) {
+		allocateChunk();
+	}
+
+	auto block = _freeBlocks;
+	_freeBlocks = block->next;
+	block->next = nullptr;
+
+	return reinterpret_cast< char * >( block ) + HEADER_SIZE;
+}
+
+void JobPool::releaseBlock( Block *block )
+{
+	if ( tls_jobPoolBinding.pool == this ) {
+		block->next = _freeBlocks;
+		_freeBlocks = block;
+		return;
+	}
+
+	auto head = _remoteFreeBlocks.load( std::memory_order_relaxed );
+	do {
+		block->next = head;
+	} while ( !_remoteFreeBlocks.compare_exchange_weak( head, block, std::memory_order_release, std::memory_order_relaxed ) );
+}
+
+void JobPool::allocateChunk( void )
+{
+	const auto stride = HEADER_SIZE + BLOCK_SIZE;
+
+	auto chunk = std::unique_ptr< char[] >( new char[ stride * BLOCKS_PER_CHUNK ] );
+	for ( std::size_t i = 0; i < BLOCKS_PER_CHUNK; i++ ) {
+		auto block = reinterpret_cast< Block * >( chunk.get() + i * stride );
+		block->owner = this;
+		block->next = _freeBlocks;
+		_freeBlocks = block;
+	}
+
+	_chunks.push_back( std::move( chunk ) );
+	_totalChunkCount.fetch_add( 1, std::memory_order_relaxed );
+}
+
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_CORE_CONCURRENCY_JOB_POOL_
+#define CRIMILD_CORE_CONCURRENCY_JOB_POOL_
+
+#include "Foundation/Macros.hpp"
+#include "Foundation/NonCopyable.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace crimild {
+
+	namespace concurrency {
+
+		/**
+		   \brief Per-thread pool of fixed-size blocks used for allocating jobs
+
+		   Each thread allocates from its own pool, without locking. Blocks
+		   released by the owner thread go back to a private free list,
+		   while blocks released from any other thread are pushed into a
+		   lock-free list that the owner reclaims once its private list is
+		   exhausted. Memory is only allocated in chunks when both lists
+		   are empty, so once the pool is warm allocating a job does not
+		   touch the heap.
+
+		   Pools are never destroyed. When a thread exits, its pool is
+		   returned to a global registry and adopted by the next thread
+		   requesting one, so jobs outliving their thread remain valid.
+		 */
+		class JobPool : public NonCopyable {
+		public:
+			static constexpr std::size_t BLOCK_SIZE = 256;
+			static constexpr std::size_t BLOCKS_PER_CHUNK = 256;
+
+			/**
+			   \brief Get the pool for the current thread
+			 */
+			static JobPool *getInstance( void );
+
+			/**
+			   \brief Allocates a block from the current thread's pool
+
+			   \remarks size must not exceed BLOCK_SIZE
+			 */
+			static void *allocate( std::size_t size );
+
+			/**
+			   \brief Returns a block to the pool that allocated it
+
+			   \remarks This method can be invoked from any thread
+			 */
+			static void deallocate( void *ptr );
+
+			/**
+			   \brief Total number of chunks allocated by all pools
+
+			   Useful for checking that no allocations happen once pools are warm
+			 */
+			static std::size_t getTotalChunkCount( void );
+
+		public:
+			JobPool( void );
+			virtual ~JobPool( void );
+
+		private:
+			struct Block {
+				JobPool *owner;
+				Block *next;
+			};
+
+			static constexpr std::size_t HEADER_SIZE = alignof( std::max_align_t ) > sizeof( Block ) ? alignof( std::max_align_t ) : sizeof( Block );
+
+			void *allocateBlock( void );
+			void releaseBlock( Block *block );
+			void allocateChunk( void );
+
+		private:
+			Block *_freeBlocks = nullptr;
+			char _padding[ CRIMILD_CACHE_LINE_SIZE ];
+			std::atomic< Block * > _remoteFreeBlocks;
+
+			std::vector< std::unique_ptr< char[] >> _chunks;
+
+			static std::atomic< std::size_t > _totalChunkCount;
+
+			friend class JobPoolRegistry;
+		};
+
+		/**
+		   \brief STL allocator using the current thread's JobPool
+
+		   Meant to be used with std::allocate_shared, so both the
+		   job and the shared pointer control block live in a single block
+		 */
+		template< typename T >
+		class JobPoolAllocator {
+		public:
+			using value_type = T;
+
+			JobPoolAllocator( void ) { }
+
+			template< typename U >
+			JobPoolAllocator( JobPoolAllocator< U > const & ) { }
+
+			T *allocate( std::size_t n )
+			{
+				static_assert( sizeof( T ) <= JobPool::BLOCK_SIZE, "Type is too big for JobPool blocks" );
+				return static_cast< T * >( JobPool::allocate( n * sizeof( T ) ) );
+			}
+
+			void deallocate( T *ptr, std::size_t )
+			{
+				JobPool::deallocate( ptr );
+			}
+
+			template< typename U >
+			bool operator==( JobPoolAllocator< U > const & ) const { return true; }
+
+			template< typename U >
+			bool operator!=( JobPoolAllocator< U > const & ) const { return false; }
+		};
+
+	}
+
+}
+
+#endif
+
@@ -32,8 +32,35 @@
 using namespace crimild;
 using namespace crimild::concurrency;
 
+constexpr JobScheduler::WorkerId JobScheduler::MAIN_WORKER_ID;
+constexpr JobScheduler::WorkerId JobScheduler::INVALID_WORKER_ID;
+
+namespace crimild {
+
+	namespace concurrency {
+
+		/**
+		   \brief Id of the worker running in the current thread
+		 */
+		static thread_local JobScheduler::WorkerId tls_workerId = JobScheduler::INVALID_WORKER_ID;
+
+		/**
+		   \brief State for a per-thread xorshift generator used to pick victims
+		 */
+		static thread_local uint32_t tls_victimSeed = 0;
+
+		/**
+		   \brief Source of seeds for threads that are not workers (i.e. the main thread)
+		 */
+		static std::atomic< uint32_t > s_victimSeedCounter( 0 );
+
+	}
+
+}
+
 JobScheduler::JobScheduler( void )
-	: _numWorkers( std::thread::hardware_concurrency() )
+	: _numWorkers( std::thread::hardware_concurrency() ),
+	  _externalJobCount( 0 )
 {
 
 }
@@ -55,13 +82,22 @@ bool JobScheduler::start( void )
 {
 	_state = JobScheduler::State::INITIALIZING;
 
+	// queues and stats must be allocated before any worker is spawned
+	// since they are accessed without locking afterwards
+	auto workerCount = getNumWorkers() + 1;
+	_workerJobQueues.resize( workerCount );
+	_workerStats.reset( new PaddedWorkerStat[ workerCount ] );
+	_workerStatCount = workerCount;
+
 	// initialize the main thread as another worker
-    initWorker( true );
+    initWorker( MAIN_WORKER_ID );
 
     Log::info( CRIMILD_CURRENT_CLASS_NAME, "Initializing job scheduler with ", getNumWorkers(), " workers" );
 
 	for ( int i = 0; i < getNumWorkers(); i++ ) {
-		_workers.push_back( std::thread( std::bind( &JobScheduler::worker, this ) ) );
+		auto workerId = MAIN_WORKER_ID + 1 + i;
+		_workerJobQueues[ workerId ] = crimild::alloc< WorkerJobQueue >();
+		_workers.push_back( std::thread( std::bind( &JobScheduler::worker, this, workerId ) ) );
 	}
 
 	_state = JobScheduler::State::RUNNING;
@@ -73,6 +109,9 @@ void JobScheduler::stop( void )
 {
 	_state = JobScheduler::State::STOPPING;
 
+	// wake up parked workers so they can exit
+	_idleEvent.notifyAll();
+
 	for ( auto &w : _workers ) {
 		if ( w.joinable() ) {
 			w.join();
@@ -80,56 +119,139 @@ void JobScheduler::stop( void )
 	}
 
 	_workers.clear();
+
+	// release any jobs that were never executed
+	for ( auto &queue : _workerJobQueues ) {
+		if ( queue != nullptr ) {
+			while ( auto job = queue->pop() ) {
+				job->releaseScheduled();
+			}
+		}
+	}
     _workerJobQueues.clear();
 
+	Job *job = nullptr;
+	while ( _externalJobs.tryPop( job ) ) {
+		job->releaseScheduled();
+	}
+	_externalJobCount = 0;
+
+	if ( isMainWorker() ) {
+		tls_workerId = INVALID_WORKER_ID;
+	}
+
 	_state = JobScheduler::State::STOPPED;
 }
 
-void JobScheduler::worker( void )
+void JobScheduler::worker( WorkerId workerId )
 {
-    initWorker();
+    initWorker( workerId );
 
 	while ( getState() == JobScheduler::State::INITIALIZING ) {
 		// wait for startup to complete
 		yield();
 	}
 	
+	unsigned int idleCount = 0;
 	while ( getState() == JobScheduler::State::RUNNING ) {
-		executeNextJob();
+		if ( executeNextJob() ) {
+			idleCount = 0;
+		}
+		else if ( getIdleStrategy() == IdleStrategy::SPIN_THEN_PARK && ++idleCount >= getIdleSpinCount() ) {
+			park();
+			idleCount = 0;
+		}
 	}
+
+	tls_workerId = INVALID_WORKER_ID;
 }
 
-void JobScheduler::initWorker( bool mainWorker )
+void JobScheduler::park( void )
 {
-    std::lock_guard< std::mutex > lock( _mutex );
-    
-    if ( mainWorker ) {
-        _mainWorkerId = getWorkerId();
-    }
+	auto key = _idleEvent.prepareWait();
+
+	// check again after preparing to wait, since a job may have been
+	// scheduled after the last attempt to get one
+	if ( hasPendingJobs() || getState() != JobScheduler::State::RUNNING ) {
+		_idleEvent.cancelWait();
+		return;
+	}
+
+	_idleEvent.wait( key );
+}
+
+bool JobScheduler::hasPendingJobs( void ) const
+{
+	if ( _externalJobCount > 0 ) {
+		return true;
+	}
+
+	for ( auto &queue : _workerJobQueues ) {
+		if ( queue != nullptr && !queue->empty() ) {
+			return true;
+		}
+	}
 
-    _workerStats[ getWorkerId() ].jobCount = 0;
-	_workerJobQueues[ getWorkerId() ] = crimild::alloc< WorkerJobQueue >();
+	return false;
+}
+
+void JobScheduler::initWorker( WorkerId workerId )
+{
+	tls_workerId = workerId;
+	tls_victimSeed = 2463534242u + 7919u * workerId;
+
+	if ( _workerJobQueues[ workerId ] == nullptr ) {
+		_workerJobQueues[ workerId ] = crimild::alloc< WorkerJobQueue >();
+	}
 }	
 
 JobScheduler::WorkerId JobScheduler::getWorkerId( void ) const
 {
-	return std::this_thread::get_id();
+	return tls_workerId;
 }
 
 JobScheduler::WorkerJobQueue *JobScheduler::getWorkerJobQueue( void )
 {
-	return crimild::get_ptr( _workerJobQueues[ getWorkerId() ] );
+	auto workerId = getWorkerId();
+	if ( workerId < 0 || workerId >= static_cast< WorkerId >( _workerJobQueues.size() ) ) {
+		return nullptr;
+	}
+
+	return crimild::get_ptr( _workerJobQueues[ workerId ] );
 }
 
 JobScheduler::WorkerJobQueue *JobScheduler::getRandomJobQueue( void )
 {
-	if ( _workerJobQueues.size() == 0 ) {
+	auto queueCount = static_cast< uint32_t >( _workerJobQueues.size() );
+	if ( queueCount == 0 ) {
 		return nullptr;
 	}
 
-	for ( auto &it : _workerJobQueues ) {
-		if ( it.second != nullptr && !it.second->empty() ) {
-			return crimild::get_ptr( it.second );
+	// pick a random victim and visit the rest in round-robin order
+	// so thieves do not pile up on the same queue
+	auto &seed = tls_victimSeed;
+	if ( seed == 0 ) {
+		// xorshift never leaves zero, so seed any thread that is not a worker on first use
+		seed = 2463534242u + 7919u * static_cast< uint32_t >( _workerJobQueues.size() + s_victimSeedCounter++ );
+		if ( seed == 0 ) {
+			seed = 2463534242u;
+		}
+	}
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	auto first = seed % queueCount;
+
+	auto self = getWorkerId();
+	for ( uint32_t i = 0; i < queueCount; i++ ) {
+		auto victim = ( first + i ) % queueCount;
+		if ( static_cast< WorkerId >( victim ) == self ) {
+			continue;
+		}
+
+		auto queue = crimild::get_ptr( _workerJobQueues[ victim ] );
+		if ( queue != nullptr && !queue->empty() ) {
+			return queue;
 		}
 	}
 
@@ -148,8 +270,18 @@ void JobScheduler::schedule( JobPtr const &job )
         return;
     }
     
+	job->retainScheduled( job );
+
 	auto queue = getWorkerJobQueue();
-	queue->push( job );
+	if ( queue != nullptr ) {
+		queue->push( crimild::get_ptr( job ) );
+	}
+	else {
+		_externalJobs.push( crimild::get_ptr( job ) );
+		++_externalJobCount;
+	}
+
+	_idleEvent.notifyOne();
 }
 
 JobPtr JobScheduler::getJob( void )
@@ -159,18 +291,27 @@ JobPtr JobScheduler::getJob( void )
 	if ( queue != nullptr && !queue->empty() ) {
 		auto job = queue->pop();
 		if ( job != nullptr ) {
-			return job;
+			return job->releaseScheduled();
 		}
 	}
 
+	if ( _externalJobCount > 0 ) {
+		Job *job = nullptr;
+		if ( _externalJobs.tryPop( job ) ) {
+			--_externalJobCount;
+			return job->releaseScheduled();
+		}
+	}
+
+	// getRandomJobQueue() never returns our own queue
 	auto stealQueue = getRandomJobQueue();
-	if ( stealQueue == nullptr || stealQueue == queue ) {
-		// do not steal from ourselves
+	if ( stealQueue == nullptr ) {
 		return nullptr;
 	}
 
-	if ( !stealQueue->empty() ) {
-		return stealQueue->steal();
+	auto job = stealQueue->steal();
+	if ( job != nullptr ) {
+		return job->releaseScheduled();
 	}
 
 	return nullptr;
@@ -181,7 +322,11 @@ bool JobScheduler::executeNextJob( void )
 	auto job = getJob();
 	if ( job != nullptr ) {
 		execute( job );
-		_workerStats[ getWorkerId() ].jobCount++;
+
+		auto workerId = getWorkerId();
+		if ( workerId >= 0 && workerId < _workerStatCount ) {
+			_workerStats[ workerId ].jobCount.fetch_add( 1, std::memory_order_relaxed );
+		}
 		return true;
 	}
 
@@ -237,17 +382,15 @@ void JobScheduler::executeDelayedJobs( void )
 
 void JobScheduler::eachWorkerStat( std::function< void( WorkerId, const WorkerStat & ) > const &callback ) const
 {
-	for ( const auto &it : _workerStats ) {
-		callback( it.first, it.second );
+	for ( WorkerId i = 0; i < _workerStatCount; i++ ) {
+		callback( i, _workerStats[ i ] );
 	}
 }
 
 void JobScheduler::clearWorkerStats( void )
 {
-	std::lock_guard< std::mutex > lock( _mutex );
-
-	for ( auto &it : _workerStats ) {
-		it.second.jobCount = 0;
+	for ( WorkerId i = 0; i < _workerStatCount; i++ ) {
+		_workerStats[ i ].jobCount.store( 0, std::memory_order_relaxed );
 	}
 }
 
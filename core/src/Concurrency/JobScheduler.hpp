@@ -30,14 +30,16 @@
 
 #include "Job.hpp"
 #include "WorkStealingDeque.hpp"
+#include "EventCount.hpp"
 
 #include "Foundation/Singleton.hpp"
 #include "Foundation/ConcurrentList.hpp"
+#include "Foundation/ConcurrentQueue.hpp"
 
+#include <atomic>
 #include <vector>
 #include <thread>
 #include <mutex>
-#include <map>
 
 namespace crimild {
 
@@ -93,33 +95,109 @@ namespace crimild {
 			State getState( void ) const { return _state; }
 
 		private:
-			State _state = State::INITIALIZING;
+			std::atomic< State > _state { State::INITIALIZING };
+
+		public:
+			/**
+			   \brief Describes what background workers do when they run out of jobs
+			 */
+			enum class IdleStrategy {
+				/**
+				   \brief Keep polling for jobs, yielding between attempts
+
+				   Lowest wake-up latency, but workers use a full core each
+				   even if there is no work to do.
+				 */
+				YIELD,
+
+				/**
+				   \brief Poll for a while and then park the worker
+
+				   Parked workers are blocked until a new job is scheduled,
+				   so idle workers do not consume CPU.
+				 */
+				SPIN_THEN_PARK,
+			};
+
+			void setIdleStrategy( IdleStrategy strategy ) { _idleStrategy = strategy; }
+			IdleStrategy getIdleStrategy( void ) const { return _idleStrategy; }
+
+			/**
+			   \brief Number of failed attempts to get a job before parking a worker
+
+			   Only used with IdleStrategy::SPIN_THEN_PARK
+			 */
+			void setIdleSpinCount( unsigned int count ) { _idleSpinCount = count; }
+			unsigned int getIdleSpinCount( void ) const { return _idleSpinCount; }
+
+			/**
+			   \brief Number of background workers currently parked
+			 */
+			unsigned int getParkedWorkerCount( void ) const { return _idleEvent.getWaiterCount(); }
+
+		private:
+			void park( void );
+			bool hasPendingJobs( void ) const;
+
+		private:
+			IdleStrategy _idleStrategy = IdleStrategy::SPIN_THEN_PARK;
+			unsigned int _idleSpinCount = 128;
+			EventCount _idleEvent;
 
         public:
-            using WorkerId = std::thread::id;
-            
+            /**
+                \brief Dense index identifying a worker
+
+                The main thread is always the worker with id MAIN_WORKER_ID,
+                while background workers are numbered from 1 to getNumWorkers().
+             */
+            using WorkerId = int;
+
+            static constexpr WorkerId MAIN_WORKER_ID = 0;
+            static constexpr WorkerId INVALID_WORKER_ID = -1;
+
+            /**
+                \brief Get the id of the worker running in the current thread
+
+                \returns INVALID_WORKER_ID if the current thread is not
+                managed by the scheduler
+             */
             WorkerId getWorkerId( void ) const;
             
 			int getNumWorkers( void ) const { return _numWorkers; }
             
-            bool isMainWorker( void ) const { return getWorkerId() == _mainWorkerId; }
+            bool isMainWorker( void ) const { return getWorkerId() == MAIN_WORKER_ID; }
 
 		private:
             int _numWorkers;
 			std::vector< std::thread > _workers;
-            WorkerId _mainWorkerId;
 
 		private:
-			using WorkerJobQueue = WorkStealingQueue< JobPtr >;
+			using WorkerJobQueue = WorkStealingQueue< Job * >;
 
-			void initWorker( bool mainWorker = false );
+			void initWorker( WorkerId workerId );
 			WorkerJobQueue *getWorkerJobQueue( void );
 			WorkerJobQueue *getRandomJobQueue( void );
 
-			void worker( void );
+			void worker( WorkerId workerId );
 
 		private:
-			std::map< WorkerId, SharedPointer< WorkerJobQueue >> _workerJobQueues;
+			/**
+			   \brief Job queues indexed by worker id
+
+			   The array is only resized in start() and stop(), while
+			   no background workers are running
+			 */
+			std::vector< SharedPointer< WorkerJobQueue >> _workerJobQueues;
+
+			/**
+			   \brief Jobs scheduled from threads not managed by the scheduler
+
+			   Worker queues can only be pushed by their owners, so jobs
+			   coming from any other thread are stored here instead
+			 */
+			ConcurrentQueue< Job * > _externalJobs;
+			std::atomic< size_t > _externalJobCount;
 
 		public:
 			void schedule( JobPtr const &job );
@@ -135,7 +213,7 @@ namespace crimild {
 
 		public:
 			struct WorkerStat {
-				size_t jobCount = 0;
+				std::atomic< size_t > jobCount { 0 };
 			};
 			
 			void eachWorkerStat( std::function< void( WorkerId, const WorkerStat & ) > const &callback ) const;
@@ -143,10 +221,18 @@ namespace crimild {
 			void clearWorkerStats( void );
 
 		private:
-			std::map< WorkerId, WorkerStat > _workerStats;
-            
-        private:
-            std::mutex _mutex;
+			/**
+			   \brief Per-worker stats padded to a cache line
+
+			   Each worker only updates its own entry, so padding
+			   prevents false sharing between workers
+			 */
+			struct PaddedWorkerStat : public WorkerStat {
+				char padding[ CRIMILD_CACHE_LINE_SIZE - sizeof( WorkerStat ) ];
+			};
+
+			std::unique_ptr< PaddedWorkerStat[] > _workerStats;
+			int _workerStatCount = 0;
             
         public:
             void delaySync( JobPtr const &job );
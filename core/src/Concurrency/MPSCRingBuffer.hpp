@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_CORE_CONCURRENCY_MPSC_RING_BUFFER_
+#define CRIMILD_CORE_CONCURRENCY_MPSC_RING_BUFFER_
+
+#include "Foundation/Macros.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace crimild {
+
+	/**
+	   \brief A bounded lock-free queue for many producers and a single consumer
+
+	   Based on Dmitry Vyukov's bounded queue. Each slot keeps a sequence
+	   number indicating whether it is ready to be written or read, so producers
+	   only contend on a single compare-and-swap when claiming a slot and never
+	   block each other while copying elements.
+
+	   Any thread may invoke tryPush(). Only one thread at a time may invoke
+	   tryPop() and clear().
+
+	   \remarks T must be default-constructible and move-assignable.
+	 */
+	template< class T >
+	class MPSCRingBuffer {
+		static_assert( std::is_default_constructible< T >::value, "MPSCRingBuffer elements must be default-constructible" );
+
+		using Index = size_t;
+
+		struct Slot {
+			std::atomic< Index > sequence;
+			T elem;
+		};
+
+	public:
+		/**
+		   \param capacity Maximum number of elements. Rounded up to a power of two
+		 */
+		explicit MPSCRingBuffer( Index capacity = 1024 )
+			: _capacity( roundUpToPowerOfTwo( capacity ) ),
+			  _mask( _capacity - 1 ),
+			  _slots( new Slot[ _capacity ] ),
+			  _head( 0 ),
+			  _tail( 0 )
+		{
+			for ( Index i = 0; i < _capacity; i++ ) {
+				_slots[ i ].sequence.store( i, std::memory_order_relaxed );
+			}
+		}
+
+		~MPSCRingBuffer( void )
+		{
+
+		}
+
+		size_t getCapacity( void ) const { return _capacity; }
+
+		/**
+		   \brief Number of elements in the queue
+
+		   \remarks The result is only an estimate if other threads are accessing the queue
+		 */
+		size_t size( void ) const
+		{
+			auto t = _tail.load( std::memory_order_acquire );
+			auto h = _head.load( std::memory_order_acquire );
+			return t > h ? static_cast< size_t >( t - h ) : 0;
+		}
+
+		bool empty( void ) const
+		{
+			return size() == 0;
+		}
+
+		/**
+		   \brief Adds an element at the end of the queue
+
+		   \returns false if the queue is full
+
+		   \remarks This method can be invoked from any thread
+		 */
+		template< class U >
+		bool tryPush( U &&elem )
+		{
+			auto pos = _tail.load( std::memory_order_relaxed );
+			while ( true ) {
+				auto &slot = _slots[ pos & _mask ];
+				auto seq = slot.sequence.load( std::memory_order_acquire );
+				auto diff = static_cast< std::intptr_t >( seq ) - static_cast< std::intptr_t >( pos );
+				if ( diff == 0 ) {
+					// slot is free. Try to claim it
+					if ( _tail.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+						slot.elem = std::forward< U >( elem );
+						slot.sequence.store( pos + 1, std::memory_order_release );
+						return true;
+					}
+					// pos has been updated with the current tail. Try again
+				}
+				else if ( diff < 0 ) {
+					// slot has not been consumed yet. Queue is full
+					return false;
+				}
+				else {
+					// another producer claimed this slot first
+					pos = _tail.load( std::memory_order_relaxed );
+				}
+			}
+		}
+
+		/**
+		   \brief Removes the element at the front of the queue
+
+		   \returns false if the queue is empty or if the producer that claimed
+		   the front slot has not finished writing it yet
+
+		   \remarks Only the consumer thread may invoke this method
+		 */
+		bool tryPop( T &result )
+		{
+			auto pos = _head.load( std::memory_order_relaxed );
+			auto &slot = _slots[ pos & _mask ];
+			auto seq = slot.sequence.load( std::memory_order_acquire );
+			if ( seq != pos + 1 ) {
+				return false;
+			}
+
+			result = std::move( slot.elem );
+			slot.elem = T();
+			slot.sequence.store( pos + _capacity, std::memory_order_release );
+			_head.store( pos + 1, std::memory_order_release );
+			return true;
+		}
+
+		/**
+		   \brief Discards all elements that are ready to be consumed
+
+		   \remarks Only the consumer thread may invoke this method
+		 */
+		void clear( void )
+		{
+			T discarded;
+			while ( tryPop( discarded ) ) { }
+		}
+
+	private:
+		static Index roundUpToPowerOfTwo( Index value )
+		{
+			Index result = 2;
+			while ( result < value ) {
+				result <<= 1;
+			}
+			return result;
+		}
+
+	private:
+		Index _capacity;
+		Index _mask;
+		std::unique_ptr< Slot[] > _slots;
+
+		// head is only written by the consumer and tail by producers, so keep
+		// them in separate cache lines to avoid false sharing
+		char _headPadding[ CRIMILD_CACHE_LINE_SIZE ];
+		std::atomic< Index > _head;
+		char _tailPadding[ CRIMILD_CACHE_LINE_SIZE - sizeof( std::atomic< Index > ) ];
+		std::atomic< Index > _tail;
+		char _endPadding[ CRIMILD_CACHE_LINE_SIZE - sizeof( std::atomic< Index > ) ];
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "TaskGraph.hpp"
+#include "Async.hpp"
+
+#include "Foundation/Log.hpp"
+
+#include <algorithm>
+
+using namespace crimild;
+using namespace crimild::concurrency;
+
+constexpr TaskGraph::TaskId TaskGraph::INVALID_TASK_ID;
+
+TaskGraph::TaskGraph( void )
+	: _executing( false )
+{
+
+}
+
+TaskGraph::~TaskGraph( void )
+{
+
+}
+
+TaskGraph::TaskId TaskGraph::addTask( std::string const &name, TaskCallback const &callback )
+{
+	if ( _executing ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot add tasks while executing: ", name );
+		return INVALID_TASK_ID;
+	}
+
+	if ( getTaskId( name ) != INVALID_TASK_ID ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Task already exists: ", name );
+		return INVALID_TASK_ID;
+	}
+
+	auto task = std::unique_ptr< Task >( new Task() );
+	task->name = name;
+	task->callback = callback;
+	task->pendingDependencies = 0;
+
+	_tasks.push_back( std::move( task ) );
+	_sorted = false;
+
+	return _tasks.size() - 1;
+}
+
+bool TaskGraph::removeTask( std::string const &name )
+{
+	if ( _executing ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot remove tasks while executing: ", name );
+		return false;
+	}
+
+	auto removed = getTaskId( name );
+	if ( removed == INVALID_TASK_ID ) {
+		return false;
+	}
+
+	auto &dependencies = _tasks[ removed ]->dependencies;
+	auto &dependents = _tasks[ removed ]->dependents;
+
+	auto addUnique = []( std::vector< TaskId > &ids, TaskId id ) {
+		if ( std::find( ids.begin(), ids.end(), id ) == ids.end() ) {
+			ids.push_back( id );
+		}
+	};
+
+	// bridge dependents and dependencies of the removed task
+	for ( auto dependent : dependents ) {
+		for ( auto dependency : dependencies ) {
+			addUnique( _tasks[ dependent ]->dependencies, dependency );
+			addUnique( _tasks[ dependency ]->dependents, dependent );
+		}
+	}
+
+	_tasks.erase( _tasks.begin() + removed );
+
+	// drop references to the removed task and shift the ids after it
+	auto fixIds = [ removed ]( std::vector< TaskId > &ids ) {
+		ids.erase( std::remove( ids.begin(), ids.end(), removed ), ids.end() );
+		for ( auto &id : ids ) {
+			if ( id > removed ) {
+				id--;
+			}
+		}
+	};
+
+	for ( auto &task : _tasks ) {
+		fixIds( task->dependencies );
+		fixIds( task->dependents );
+	}
+
+	_sortedTasks.clear();
+	_sorted = false;
+
+	return true;
+}
+
+TaskGraph::TaskId TaskGraph::getTaskId( std::string const &name ) const
+{
+	for ( TaskId i = 0; i < _tasks.size(); i++ ) {
+		if ( _tasks[ i ]->name == name ) {
+			return i;
+		}
+	}
+
+	return INVALID_TASK_ID;
+}
+
+bool TaskGraph::addDependency( TaskId task, TaskId dependency )
+{
+	if ( _executing ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot add dependencies while executing" );
+		return false;
+	}
+
+	if ( task >= _tasks.size() || dependency >= _tasks.size() || task == dependency ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid dependency" );
+		return false;
+	}
+
+	_tasks[ task ]->dependencies.push_back( dependency );
+	_tasks[ dependency ]->dependents.push_back( task );
+	_sorted = false;
+
+	return true;
+}
+
+bool TaskGraph::addDependency( std::string const &task, std::string const &dependency )
+{
+	return addDependency( getTaskId( task ), getTaskId( dependency ) );
+}
+
+bool TaskGraph::attachContinuation( TaskId task, TaskCallback const &continuation )
+{
+	if ( _executing ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot attach continuations while executing" );
+		return false;
+	}
+
+	if ( task >= _tasks.size() ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid task" );
+		return false;
+	}
+
+	_tasks[ task ]->continuations.push_back( continuation );
+	return true;
+}
+
+bool TaskGraph::attachContinuation( std::string const &task, TaskCallback const &continuation )
+{
+	return attachContinuation( getTaskId( task ), continuation );
+}
+
+void TaskGraph::clear( void )
+{
+	if ( _executing ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot clear graph while executing" );
+		return;
+	}
+
+	_tasks.clear();
+	_sortedTasks.clear();
+	_sorted = false;
+}
+
+bool TaskGraph::sort( void )
+{
+	if ( _sorted ) {
+		return true;
+	}
+
+	// Kahn's algorithm
+	std::vector< size_t > pending( _tasks.size() );
+	_sortedTasks.clear();
+	for ( TaskId i = 0; i < _tasks.size(); i++ ) {
+		pending[ i ] = _tasks[ i ]->dependencies.size();
+		if ( pending[ i ] == 0 ) {
+			_sortedTasks.push_back( i );
+		}
+	}
+
+	for ( size_t i = 0; i < _sortedTasks.size(); i++ ) {
+		for ( auto dependent : _tasks[ _sortedTasks[ i ] ]->dependents ) {
+			if ( --pending[ dependent ] == 0 ) {
+				_sortedTasks.push_back( dependent );
+			}
+		}
+	}
+
+	if ( _sortedTasks.size() != _tasks.size() ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Task graph contains cycles" );
+		_sortedTasks.clear();
+		return false;
+	}
+
+	_sorted = true;
+	return true;
+}
+
+bool TaskGraph::execute( void )
+{
+	if ( !sort() ) {
+		return false;
+	}
+
+	if ( _tasks.empty() ) {
+		return true;
+	}
+
+	for ( auto &task : _tasks ) {
+		task->pendingDependencies = task->dependencies.size();
+		task->stat = TaskStat();
+	}
+
+	_executing = true;
+	_executionStart = std::chrono::steady_clock::now();
+
+	// the parent job is alive until wait() returns, so tasks can safely keep a pointer to it
+	auto parent = crimild::concurrency::async();
+	auto parentPtr = &parent;
+	for ( auto taskId : _sortedTasks ) {
+		if ( _tasks[ taskId ]->dependencies.empty() ) {
+			crimild::concurrency::async( parent, [ this, taskId, parentPtr ] {
+				run( taskId, parentPtr );
+			});
+		}
+	}
+	crimild::concurrency::wait( parent );
+
+	_executing = false;
+
+	return true;
+}
+
+void TaskGraph::run( TaskId taskId, JobPtr const *parent )
+{
+	auto task = _tasks[ taskId ].get();
+
+	auto now = [ this ] {
+		return std::chrono::duration< double >( std::chrono::steady_clock::now() - _executionStart ).count();
+	};
+
+	task->stat.workerId = JobScheduler::getInstance()->getWorkerId();
+	task->stat.startTime = now();
+
+	if ( task->callback != nullptr ) {
+		task->callback();
+	}
+
+	for ( auto &continuation : task->continuations ) {
+		continuation();
+	}
+
+	task->stat.endTime = now();
+
+	// this job is still pending, so the parent cannot complete
+	// while we dispatch dependents
+	for ( auto dependent : task->dependents ) {
+		if ( --_tasks[ dependent ]->pendingDependencies == 0 ) {
+			crimild::concurrency::async( *parent, [ this, dependent, parent ] {
+				run( dependent, parent );
+			});
+		}
+	}
+}
+
+std::vector< TaskGraph::TaskId > TaskGraph::computeCriticalPath( void ) const
+{
+	std::vector< TaskId > path;
+
+	if ( !_sorted || _sortedTasks.empty() ) {
+		return path;
+	}
+
+	// longest path in a DAG, visiting tasks in topological order
+	std::vector< double > cost( _tasks.size(), 0.0 );
+	std::vector< TaskId > previous( _tasks.size(), INVALID_TASK_ID );
+	TaskId last = INVALID_TASK_ID;
+
+	for ( auto taskId : _sortedTasks ) {
+		auto &task = _tasks[ taskId ];
+		for ( auto dependency : task->dependencies ) {
+			if ( previous[ taskId ] == INVALID_TASK_ID || cost[ dependency ] > cost[ previous[ taskId ] ] ) {
+				previous[ taskId ] = dependency;
+			}
+		}
+
+		cost[ taskId ] = task->stat.getDuration() + ( previous[ taskId ] != INVALID_TASK_ID ? cost[ previous[ taskId ] ] : 0.0 );
+		if ( last == INVALID_TASK_ID || cost[ taskId ] > cost[ last ] ) {
+			last = taskId;
+		}
+	}
+
+	for ( auto taskId = last; taskId != INVALID_TASK_ID; taskId = previous[ taskId ] ) {
+		path.insert( path.begin(), taskId );
+	}
+
+	return path;
+}
+
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_CORE_CONCURRENCY_TASK_GRAPH_
+#define CRIMILD_CORE_CONCURRENCY_TASK_GRAPH_
+
+#include "Job.hpp"
+#include "JobScheduler.hpp"
+
+#include "Foundation/NonCopyable.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace crimild {
+
+	namespace concurrency {
+
+		/**
+		   \brief A graph of named tasks with explicit dependencies
+
+		   Tasks are registered once and executed as many times as needed
+		   (usually once per frame). Every time the graph is executed, each
+		   task is dispatched to the JobScheduler as soon as all of its
+		   dependencies are completed, so independent tasks run concurrently.
+
+		   Continuations attached to a task are executed right after the
+		   task itself, in the same worker, before any of its dependents
+		   are dispatched.
+
+		   The duration of each task is recorded during execution, which
+		   is useful for finding the critical path of the graph.
+
+		   \remarks The graph cannot be modified while it is being executed.
+		   Adding tasks, dependencies or continuations from within a task
+		   (or from any other thread while execute() is running) fails
+		 */
+		class TaskGraph : public NonCopyable {
+		public:
+			using TaskId = size_t;
+			using TaskCallback = std::function< void( void ) >;
+
+			static constexpr TaskId INVALID_TASK_ID = std::numeric_limits< TaskId >::max();
+
+			struct TaskStat {
+				/**
+				   \brief Start and end time in seconds, relative to the start of the execution
+				 */
+				double startTime = 0.0;
+				double endTime = 0.0;
+
+				JobScheduler::WorkerId workerId = JobScheduler::INVALID_WORKER_ID;
+
+				double getDuration( void ) const { return endTime - startTime; }
+			};
+
+		public:
+			TaskGraph( void );
+			virtual ~TaskGraph( void );
+
+			/**
+			   \brief Registers a new task
+
+			   \returns INVALID_TASK_ID if a task with the same name already exists
+			   or if the graph is being executed
+			 */
+			TaskId addTask( std::string const &name, TaskCallback const &callback );
+
+			/**
+			   \brief Removes a task from the graph
+
+			   Tasks depending on the removed one inherit its dependencies,
+			   so the relative order of the remaining tasks is preserved.
+
+			   \remarks Ids of tasks registered after the removed one change
+			 */
+			bool removeTask( std::string const &name );
+
+			TaskId getTaskId( std::string const &name ) const;
+
+			std::string const &getTaskName( TaskId task ) const { return _tasks[ task ]->name; }
+
+			size_t getTaskCount( void ) const { return _tasks.size(); }
+
+			/**
+			   \brief Indicates that task must not start until dependency is completed
+			 */
+			bool addDependency( TaskId task, TaskId dependency );
+			bool addDependency( std::string const &task, std::string const &dependency );
+
+			/**
+			   \brief Attaches a callback to be executed after the task completes
+			 */
+			bool attachContinuation( TaskId task, TaskCallback const &continuation );
+			bool attachContinuation( std::string const &task, TaskCallback const &continuation );
+
+			void clear( void );
+
+			bool isExecuting( void ) const { return _executing; }
+
+			/**
+			   \brief Executes all tasks and waits for them to complete
+
+			   \returns false if the graph contains cycles, in which
+			   case no task is executed
+			 */
+			bool execute( void );
+
+			/**
+			   \brief Stats for a task, as recorded during the last execution
+			 */
+			TaskStat const &getTaskStat( TaskId task ) const { return _tasks[ task ]->stat; }
+
+			/**
+			   \brief Computes the longest chain of dependent tasks, based on durations from the last execution
+
+			   \returns The ids of all tasks in the critical path, in execution order
+			 */
+			std::vector< TaskId > computeCriticalPath( void ) const;
+
+		private:
+			struct Task {
+				std::string name;
+				TaskCallback callback;
+				std::vector< TaskCallback > continuations;
+				std::vector< TaskId > dependencies;
+				std::vector< TaskId > dependents;
+				std::atomic< size_t > pendingDependencies;
+				TaskStat stat;
+			};
+
+			bool sort( void );
+			void run( TaskId taskId, JobPtr const *parent );
+
+		private:
+			std::vector< std::unique_ptr< Task >> _tasks;
+
+			/**
+			   \brief Tasks in topological order, updated when the graph changes
+			 */
+			std::vector< TaskId > _sortedTasks;
+			bool _sorted = false;
+
+			std::chrono::steady_clock::time_point _executionStart;
+			std::atomic< bool > _executing;
+		};
+
+	}
+
+}
+
+#endif
+
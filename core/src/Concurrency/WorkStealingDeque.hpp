@@ -30,98 +30,215 @@
 
 #include "Foundation/SharedObject.hpp"
 
+#include <atomic>
+#include <memory>
+#include <type_traits>
 #include <vector>
-#include <list>
-#include <mutex>
 
 namespace crimild {
 
 	/**
-	   \brief A double-ended queue implemeting the work stealing pattern
+	   \brief A lock-free double-ended queue implementing the work stealing pattern
+
+	   This is an implementation of the Chase-Lev deque using C++11 atomics. Only
+	   the thread owning the queue may invoke push() and pop(), which operate on
+	   the bottom end of the queue in LIFO order. Any other thread may invoke steal(),
+	   which removes elements from the top end of the queue in FIFO order.
+
+	   Elements are stored in a circular buffer that grows as needed. Buffers
+	   replaced during growth are retired instead of deleted, since thieves may still
+	   be reading from them. They are released when the queue is destroyed.
+
+	   \remarks T must be trivially copyable (i.e. raw pointers). A default-constructed
+	   T is returned when the queue is empty, so T() must not be pushed.
 	 */
 	template< class T >
     class WorkStealingQueue : public SharedObject {
-		using Mutex = std::mutex;
-		using Lock = std::lock_guard< Mutex >;
-		
+		static_assert( std::is_trivially_copyable< T >::value, "WorkStealingQueue elements must be trivially copyable" );
+
+		using Index = int64_t;
+
+		class CircularArray {
+		public:
+			explicit CircularArray( Index capacity )
+				: _capacity( capacity ),
+				  _mask( capacity - 1 ),
+				  _elems( new std::atomic< T >[ capacity ] )
+			{
+
+			}
+
+			Index getCapacity( void ) const { return _capacity; }
+
+			T get( Index i ) const
+			{
+				return _elems[ i & _mask ].load( std::memory_order_relaxed );
+			}
+
+			void put( Index i, T const &elem )
+			{
+				_elems[ i & _mask ].store( elem, std::memory_order_relaxed );
+			}
+
+			CircularArray *grow( Index bottom, Index top ) const
+			{
+				auto result = new CircularArray( 2 * _capacity );
+				for ( Index i = top; i < bottom; i++ ) {
+					result->put( i, get( i ) );
+				}
+				return result;
+			}
+
+		private:
+			Index _capacity;
+			Index _mask;
+			std::unique_ptr< std::atomic< T >[] > _elems;
+		};
+
 	public:
-		WorkStealingQueue( void )
+		/**
+		   \param capacity Initial capacity. Must be a power of two
+		 */
+		explicit WorkStealingQueue( Index capacity = 1024 )
+			: _top( 0 ),
+			  _bottom( 0 ),
+			  _array( new CircularArray( capacity ) )
 		{
-
+			_retiredArrays.push_back( std::unique_ptr< CircularArray >( _array.load( std::memory_order_relaxed ) ) );
 		}
 
 		~WorkStealingQueue( void )
 		{
 
 		}
-        
-		size_t size( void )
+
+		/**
+		   \brief Number of elements in the queue
+
+		   \remarks The result is only an estimate if other threads are accessing the queue
+		 */
+		size_t size( void ) const
 		{
-			Lock lock( _mutex );
-			return _elems.size();
+			auto b = _bottom.load( std::memory_order_relaxed );
+			auto t = _top.load( std::memory_order_relaxed );
+			return b > t ? static_cast< size_t >( b - t ) : 0;
 		}
 
-		bool empty( void )
+		bool empty( void ) const
 		{
 			return size() == 0;
 		}
 
+		/**
+		   \brief Removes all elements from the queue
+
+		   \remarks Only the owner thread may invoke this method
+		 */
 		void clear( void )
 		{
-			Lock lock( _mutex );
+			while ( !empty() ) {
+				pop();
+			}
+		}
 
-			_elems.clear();
+		size_t getCapacity( void ) const
+		{
+			return _array.load( std::memory_order_relaxed )->getCapacity();
 		}
 
 		/**
 		   \brief Adds an element to the private end of the queue (LIFO)
 
+		   \remarks Only the owner thread may invoke this method
 		 */
 		void push( T const &elem )
 		{
-			Lock lock( _mutex );
-			_elems.push_back( elem );
+			auto b = _bottom.load( std::memory_order_relaxed );
+			auto t = _top.load( std::memory_order_acquire );
+			auto a = _array.load( std::memory_order_relaxed );
+
+			if ( b - t > a->getCapacity() - 1 ) {
+				a = a->grow( b, t );
+				_retiredArrays.push_back( std::unique_ptr< CircularArray >( a ) );
+				_array.store( a, std::memory_order_release );
+			}
+
+			a->put( b, elem );
+			std::atomic_thread_fence( std::memory_order_release );
+			_bottom.store( b + 1, std::memory_order_relaxed );
 		}
 
 		/**
 		   \brief Retrieves an element from the private end of the queue (LIFO)
 
-		   \warning You should check if the collection is empty before calling this method.
+		   \returns A default-constructed T if the queue is empty
+
+		   \remarks Only the owner thread may invoke this method
 		 */
 		T pop( void )
 		{
-			Lock lock( _mutex );
-
-            if ( _elems.size() == 0 ) {
-                return nullptr;
-            }
-            
-			auto e = _elems.back();
-			_elems.pop_back();
-			return e;
+			auto b = _bottom.load( std::memory_order_relaxed ) - 1;
+			auto a = _array.load( std::memory_order_relaxed );
+			_bottom.store( b, std::memory_order_relaxed );
+			std::atomic_thread_fence( std::memory_order_seq_cst );
+			auto t = _top.load( std::memory_order_relaxed );
+
+			if ( t > b ) {
+				// queue was already empty
+				_bottom.store( b + 1, std::memory_order_relaxed );
+				return T();
+			}
+
+			auto elem = a->get( b );
+			if ( t == b ) {
+				// last element. Race against thieves
+				if ( !_top.compare_exchange_strong( t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) ) {
+					elem = T();
+				}
+				_bottom.store( b + 1, std::memory_order_relaxed );
+			}
+
+			return elem;
 		}
 
 		/**
 		   \brief Retrieves an element from the public end of the queue (FIFO)
 
-		   \warning You should check if the collection is empty before calling this method
+		   \returns A default-constructed T if the queue is empty or if
+		   another thread won the race for the element
+
+		   \remarks This method can be invoked from any thread
 		 */
 		T steal( void )
 		{
-			Lock lock( _mutex );
-            
-            if ( _elems.size() == 0 ) {
-                return nullptr;
-            }
-
-			auto e = _elems.front();
-			_elems.pop_front();
-			return e;
+			auto t = _top.load( std::memory_order_acquire );
+			std::atomic_thread_fence( std::memory_order_seq_cst );
+			auto b = _bottom.load( std::memory_order_acquire );
+
+			if ( t >= b ) {
+				return T();
+			}
+
+			auto a = _array.load( std::memory_order_acquire );
+			auto elem = a->get( t );
+			if ( !_top.compare_exchange_strong( t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) ) {
+				return T();
+			}
+
+			return elem;
 		}
 
 	private:
-        std::list< T > _elems;
-		std::mutex _mutex;
+		// top and bottom are modified by different threads, so keep
+		// them in separate cache lines to avoid false sharing
+		std::atomic< Index > _top;
+		char _topPadding[ CRIMILD_CACHE_LINE_SIZE - sizeof( std::atomic< Index > ) ];
+		std::atomic< Index > _bottom;
+		char _bottomPadding[ CRIMILD_CACHE_LINE_SIZE - sizeof( std::atomic< Index > ) ];
+		std::atomic< CircularArray * > _array;
+
+		// only accessed by the owner thread
+		std::vector< std::unique_ptr< CircularArray >> _retiredArrays;
 	};
 
 }
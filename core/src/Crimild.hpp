@@ -90,6 +90,7 @@
 #include "Concurrency/Job.hpp"
 #include "Concurrency/JobScheduler.hpp"
 #include "Concurrency/WorkStealingDeque.hpp"
+#include "Concurrency/TaskGraph.hpp"
 
 #include "Visitors/Apply.hpp"
 #include "Visitors/ApplyToGeometries.hpp"
@@ -197,6 +198,7 @@
 
 #include "Streaming/Stream.hpp"
 #include "Streaming/FileStream.hpp"
+#include "Streaming/MappedFileStream.hpp"
 #include "Streaming/MemoryStream.hpp"
 #include "Streaming/SceneBuilder.hpp"
 
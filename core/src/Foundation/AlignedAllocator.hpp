@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_FOUNDATION_ALIGNED_ALLOCATOR_
+#define CRIMILD_FOUNDATION_ALIGNED_ALLOCATOR_
+
+#include "Macros.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef CRIMILD_PLATFORM_WIN32
+#include <malloc.h>
+#endif
+
+namespace crimild {
+
+	/**
+	   \brief STL-compatible allocator returning memory with a given alignment
+
+	   \remarks Alignment must be a power of two and a multiple of sizeof( void * )
+	 */
+	template< typename T, std::size_t Alignment >
+	class AlignedAllocator {
+		static_assert( Alignment >= sizeof( void * ) && ( Alignment & ( Alignment - 1 ) ) == 0, "Invalid alignment" );
+
+	public:
+		using value_type = T;
+
+		template< typename U >
+		struct rebind {
+			using other = AlignedAllocator< U, Alignment >;
+		};
+
+		AlignedAllocator( void ) noexcept { }
+
+		template< typename U >
+		AlignedAllocator( AlignedAllocator< U, Alignment > const & ) noexcept { }
+
+		T *allocate( std::size_t count )
+		{
+			void *p = nullptr;
+#ifdef CRIMILD_PLATFORM_WIN32
+			p = _aligned_malloc( count * sizeof( T ), Alignment );
+#else
+			if ( posix_memalign( &p, Alignment, count * sizeof( T ) ) != 0 ) {
+				p = nullptr;
+			}
+#endif
+			if ( p == nullptr ) {
+				throw std::bad_alloc();
+			}
+			return static_cast< T * >( p );
+		}
+
+		void deallocate( T *p, std::size_t ) noexcept
+		{
+#ifdef CRIMILD_PLATFORM_WIN32
+			_aligned_free( p );
+#else
+			free( p );
+#endif
+		}
+	};
+
+	template< typename T, typename U, std::size_t Alignment >
+	bool operator==( AlignedAllocator< T, Alignment > const &, AlignedAllocator< U, Alignment > const & ) noexcept
+	{
+		return true;
+	}
+
+	template< typename T, typename U, std::size_t Alignment >
+	bool operator!=( AlignedAllocator< T, Alignment > const &, AlignedAllocator< U, Alignment > const & ) noexcept
+	{
+		return false;
+	}
+
+}
+
+#endif
+
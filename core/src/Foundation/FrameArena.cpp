@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "FrameArena.hpp"
+
+using namespace crimild;
+
+FrameArena::FrameArena( void )
+{
+
+}
+
+FrameArena::~FrameArena( void )
+{
+
+}
+
+void FrameArena::beginFrame( void )
+{
+	std::lock_guard< std::mutex > lock( _mutex );
+
+	_frameIndex++;
+
+	auto &arena = _arenas[ _frameIndex % _arenas.size() ];
+	if ( arena == nullptr ) {
+		arena = crimild::alloc< LinearArena >();
+		return;
+	}
+
+	_lastFrameAllocationCount = arena->getAllocationCount();
+	_lastFrameAllocatedBytes = arena->getAllocatedBytes();
+	_lastFrameHeapAllocationCount = arena->getHeapAllocationCount();
+
+	if ( arena.use_count() == 1 ) {
+		arena->reset();
+	}
+	else {
+		// someone is still using data from this arena
+		arena = crimild::alloc< LinearArena >();
+	}
+}
+
+LinearArenaPtr FrameArena::getCurrentArena( void )
+{
+	std::lock_guard< std::mutex > lock( _mutex );
+
+	auto &arena = _arenas[ _frameIndex % _arenas.size() ];
+	if ( arena == nullptr ) {
+		arena = crimild::alloc< LinearArena >();
+	}
+	return arena;
+}
+
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_FOUNDATION_FRAME_ARENA_
+#define CRIMILD_FOUNDATION_FRAME_ARENA_
+
+#include "LinearArena.hpp"
+#include "Singleton.hpp"
+
+#include <array>
+#include <mutex>
+
+#ifndef CRIMILD_FRAME_ARENA_COUNT
+#define CRIMILD_FRAME_ARENA_COUNT 3
+#endif
+
+namespace crimild {
+
+	/**
+	   \brief Arenas for data that only lives for a few frames
+
+	   Keeps a ring of linear arenas. Every call to beginFrame() moves to
+	   the next one, which is reset and reused. Data allocated during a
+	   frame is therefore valid while the following frames are processed
+	   (i.e. render queues computed by the update thread and consumed by
+	   the renderer one frame later).
+
+	   Objects allocating from an arena should hold a reference to it. If
+	   an arena is still referenced when its turn comes, it is not reset
+	   and a new one takes its place instead, so data is never discarded
+	   while in use.
+	 */
+	class FrameArena : public StaticSingleton< FrameArena > {
+	public:
+		FrameArena( void );
+		virtual ~FrameArena( void );
+
+		/**
+		   \brief Starts a new frame, recycling the oldest arena
+		 */
+		void beginFrame( void );
+
+		/**
+		   \brief Arena for allocations in the current frame
+		 */
+		LinearArenaPtr getCurrentArena( void );
+
+		crimild::Size getFrameIndex( void ) const { return _frameIndex; }
+
+		/**
+		   \name Statistics for the last recycled arena
+		 */
+		//@{
+
+		crimild::Size getLastFrameAllocationCount( void ) const { return _lastFrameAllocationCount; }
+		crimild::Size getLastFrameAllocatedBytes( void ) const { return _lastFrameAllocatedBytes; }
+
+		/**
+		   \brief Number of times the arena requested memory from the heap
+
+		   Should be zero once the arena has grown enough for the workload
+		 */
+		crimild::Size getLastFrameHeapAllocationCount( void ) const { return _lastFrameHeapAllocationCount; }
+
+		//@}
+
+	private:
+		std::array< LinearArenaPtr, CRIMILD_FRAME_ARENA_COUNT > _arenas;
+		crimild::Size _frameIndex = 0;
+		std::mutex _mutex;
+
+		crimild::Size _lastFrameAllocationCount = 0;
+		crimild::Size _lastFrameAllocatedBytes = 0;
+		crimild::Size _lastFrameHeapAllocationCount = 0;
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "LinearArena.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace crimild;
+
+LinearArena::LinearArena( crimild::Size blockSize )
+	: _blockSize( blockSize ),
+	  _current( nullptr ),
+	  _allocationCount( 0 ),
+	  _allocatedBytes( 0 ),
+	  _heapAllocationCount( 0 )
+{
+
+}
+
+LinearArena::~LinearArena( void )
+{
+
+}
+
+crimild::Size LinearArena::getCapacity( void ) const
+{
+	std::lock_guard< std::mutex > lock( _blocksMutex );
+
+	crimild::Size capacity = 0;
+	for ( auto &block : _blocks ) {
+		capacity += block->capacity;
+	}
+	return capacity;
+}
+
+void *LinearArena::tryAllocate( Block *block, crimild::Size size, crimild::Size alignment )
+{
+	auto base = reinterpret_cast< std::uintptr_t >( block->data.get() );
+	auto offset = block->offset.load( std::memory_order_relaxed );
+	while ( true ) {
+		auto start = ( ( base + offset + alignment - 1 ) & ~( alignment - 1 ) ) - base;
+		auto end = start + size;
+		if ( end > block->capacity ) {
+			return nullptr;
+		}
+
+		if ( block->offset.compare_exchange_weak( offset, end, std::memory_order_relaxed ) ) {
+			return block->data.get() + start;
+		}
+		// offset now holds the current value. Try again
+	}
+}
+
+LinearArena::Block *LinearArena::addBlock( crimild::Size minCapacity )
+{
+	auto block = new Block();
+	block->capacity = std::max( _blockSize, minCapacity );
+	block->data.reset( new unsigned char[ block->capacity ] );
+	block->offset.store( 0, std::memory_order_relaxed );
+
+	_blocks.push_back( std::unique_ptr< Block >( block ) );
+	++_heapAllocationCount;
+
+	return block;
+}
+
+void *LinearArena::allocate( crimild::Size size, crimild::Size alignment )
+{
+	assert( alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0 && "Alignment must be a power of two" );
+
+	++_allocationCount;
+	_allocatedBytes += size;
+
+	auto block = _current.load( std::memory_order_acquire );
+	if ( block != nullptr ) {
+		auto p = tryAllocate( block, size, alignment );
+		if ( p != nullptr ) {
+			return p;
+		}
+	}
+
+	std::lock_guard< std::mutex > lock( _blocksMutex );
+
+	// another thread may have added a block already
+	block = _current.load( std::memory_order_acquire );
+	if ( block != nullptr ) {
+		auto p = tryAllocate( block, size, alignment );
+		if ( p != nullptr ) {
+			return p;
+		}
+	}
+
+	block = addBlock( size + alignment );
+	_current.store( block, std::memory_order_release );
+
+	auto p = tryAllocate( block, size, alignment );
+	assert( p != nullptr );
+	return p;
+}
+
+void LinearArena::reset( void )
+{
+	std::lock_guard< std::mutex > lock( _blocksMutex );
+
+	if ( _blocks.size() > 1 ) {
+		// merge all blocks into a single one, so next time the
+		// same amount of data fits without additional allocations
+		crimild::Size capacity = 0;
+		for ( auto &block : _blocks ) {
+			capacity += block->capacity;
+		}
+		_blocks.clear();
+		_current.store( addBlock( capacity ), std::memory_order_release );
+	}
+	else if ( !_blocks.empty() ) {
+		_blocks.front()->offset.store( 0, std::memory_order_relaxed );
+	}
+
+	_allocationCount = 0;
+	_allocatedBytes = 0;
+	_heapAllocationCount = 0;
+}
+
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_FOUNDATION_LINEAR_ARENA_
+#define CRIMILD_FOUNDATION_LINEAR_ARENA_
+
+#include "SharedObject.hpp"
+#include "Types.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#ifndef CRIMILD_DEFAULT_LINEAR_ARENA_BLOCK_SIZE
+#define CRIMILD_DEFAULT_LINEAR_ARENA_BLOCK_SIZE 65536
+#endif
+
+namespace crimild {
+
+	/**
+	   \brief A bump allocator for short-lived data
+
+	   Allocations are served by advancing an offset in a memory block.
+	   Individual allocations are never released. Instead, all of them
+	   are discarded at once by reset().
+
+	   When the current block is exhausted a new one is requested from
+	   the heap. On reset, blocks are merged into a single one big enough
+	   to hold everything allocated since the previous reset, so an arena
+	   used for similar workloads stops touching the heap after a few
+	   iterations.
+
+	   \remarks allocate() is thread-safe and lock-free as long as the
+	   current block has enough room. reset() must not be invoked while
+	   other threads are allocating.
+	 */
+	class LinearArena : public SharedObject {
+	public:
+		explicit LinearArena( crimild::Size blockSize = CRIMILD_DEFAULT_LINEAR_ARENA_BLOCK_SIZE );
+		virtual ~LinearArena( void );
+
+		void *allocate( crimild::Size size, crimild::Size alignment = alignof( std::max_align_t ) );
+
+		template< typename T >
+		T *allocateArray( crimild::Size count )
+		{
+			return static_cast< T * >( allocate( count * sizeof( T ), alignof( T ) ) );
+		}
+
+		/**
+		   \brief Discards all allocations
+
+		   \warning Destructors are not invoked
+		 */
+		void reset( void );
+
+		/**
+		   \name Statistics
+
+		   All values are counted since the last reset
+		 */
+		//@{
+
+		crimild::Size getAllocationCount( void ) const { return _allocationCount; }
+		crimild::Size getAllocatedBytes( void ) const { return _allocatedBytes; }
+
+		/**
+		   \brief Number of memory blocks requested from the heap
+		 */
+		crimild::Size getHeapAllocationCount( void ) const { return _heapAllocationCount; }
+
+		/**
+		   \brief Total size of all memory blocks owned by the arena
+		 */
+		crimild::Size getCapacity( void ) const;
+
+		//@}
+
+	private:
+		struct Block {
+			std::unique_ptr< unsigned char[] > data;
+			crimild::Size capacity;
+			std::atomic< crimild::Size > offset;
+		};
+
+		static void *tryAllocate( Block *block, crimild::Size size, crimild::Size alignment );
+
+		Block *addBlock( crimild::Size minCapacity );
+
+	private:
+		crimild::Size _blockSize;
+
+		std::atomic< Block * > _current;
+		std::vector< std::unique_ptr< Block >> _blocks;
+		mutable std::mutex _blocksMutex;
+
+		std::atomic< crimild::Size > _allocationCount;
+		std::atomic< crimild::Size > _allocatedBytes;
+		std::atomic< crimild::Size > _heapAllocationCount;
+	};
+
+	using LinearArenaPtr = SharedPointer< LinearArena >;
+
+	/**
+	   \brief STL-compatible allocator backed by a LinearArena
+
+	   Deallocation is a no-op, since memory is reclaimed when the arena
+	   is reset. If no arena is provided, the global heap is used instead,
+	   so containers using this allocator behave like regular ones by default.
+
+	   \warning Containers must be destroyed before their arena is reset
+	 */
+	template< typename T >
+	class ArenaAllocator {
+	public:
+		using value_type = T;
+
+		// containers must carry the arena around when moved or copied
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		ArenaAllocator( LinearArena *arena = nullptr ) noexcept : _arena( arena ) { }
+
+		template< typename U >
+		ArenaAllocator( ArenaAllocator< U > const &other ) noexcept : _arena( other.getArena() ) { }
+
+		LinearArena *getArena( void ) const noexcept { return _arena; }
+
+		T *allocate( std::size_t count )
+		{
+			if ( _arena != nullptr ) {
+				return _arena->allocateArray< T >( count );
+			}
+
+			return static_cast< T * >( ::operator new( count * sizeof( T ) ) );
+		}
+
+		void deallocate( T *p, std::size_t ) noexcept
+		{
+			if ( _arena == nullptr ) {
+				::operator delete( p );
+			}
+		}
+
+	private:
+		LinearArena *_arena;
+	};
+
+	template< typename T, typename U >
+	bool operator==( ArenaAllocator< T > const &a, ArenaAllocator< U > const &b ) noexcept
+	{
+		return a.getArena() == b.getArena();
+	}
+
+	template< typename T, typename U >
+	bool operator!=( ArenaAllocator< T > const &a, ArenaAllocator< U > const &b ) noexcept
+	{
+		return !( a == b );
+	}
+
+}
+
+#endif
+
@@ -79,6 +79,10 @@ namespace crimild {
     }
 }
 
+#ifndef CRIMILD_CACHE_LINE_SIZE
+	#define CRIMILD_CACHE_LINE_SIZE 64
+#endif
+
 #define CRIMILD_CURRENT_CLASS_NAME ::crimild::getClassName( CRIMILD_CURRENT_FUNCTION )
 
 #define CRIMILD_TO_STRING( A ) #A
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_FOUNDATION_RADIX_SORT_
+#define CRIMILD_FOUNDATION_RADIX_SORT_
+
+#include "Types.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace crimild {
+
+	/**
+	   \brief Least-significant-digit radix sort for unsigned integer keys
+
+	   Values are sorted in ascending key order, processing 8 bits per pass.
+	   The sort is stable, so values with the same key keep their relative
+	   order. Passes in which every key shares the same digit are skipped.
+
+	   Since values are moved around once per pass, it is usually better
+	   to sort small (key, index) pairs and then reorder the actual data.
+	 */
+	class RadixSort {
+	public:
+		/**
+		   \param values Values to sort. Sorted results are stored here
+		   \param scratch Temporary buffer with room for at least count values
+		   \param getKey Returns an unsigned integer key for a given value
+		 */
+		template< typename T, typename KeyFn >
+		static void sort( T *values, T *scratch, size_t count, KeyFn getKey )
+		{
+			using KeyType = typename std::decay< decltype( getKey( *values ) ) >::type;
+			static_assert( std::is_unsigned< KeyType >::value, "Radix sort keys must be unsigned integers" );
+
+			if ( count < 2 ) {
+				return;
+			}
+
+			static constexpr size_t PASS_COUNT = sizeof( KeyType );
+			size_t histograms[ PASS_COUNT ][ 256 ];
+			std::memset( histograms, 0, sizeof( histograms ) );
+
+			// compute all histograms at once
+			for ( size_t i = 0; i < count; i++ ) {
+				auto key = getKey( values[ i ] );
+				for ( size_t pass = 0; pass < PASS_COUNT; pass++ ) {
+					histograms[ pass ][ ( key >> ( pass * 8 ) ) & 0xFF ]++;
+				}
+			}
+
+			auto src = values;
+			auto dst = scratch;
+
+			for ( size_t pass = 0; pass < PASS_COUNT; pass++ ) {
+				auto &histogram = histograms[ pass ];
+
+				auto shift = pass * 8;
+				if ( histogram[ ( getKey( src[ 0 ] ) >> shift ) & 0xFF ] == count ) {
+					// all keys have the same digit
+					continue;
+				}
+
+				size_t offset = 0;
+				for ( size_t digit = 0; digit < 256; digit++ ) {
+					auto n = histogram[ digit ];
+					histogram[ digit ] = offset;
+					offset += n;
+				}
+
+				for ( size_t i = 0; i < count; i++ ) {
+					auto digit = ( getKey( src[ i ] ) >> shift ) & 0xFF;
+					dst[ histogram[ digit ]++ ] = src[ i ];
+				}
+
+				std::swap( src, dst );
+			}
+
+			if ( src != values ) {
+				for ( size_t i = 0; i < count; i++ ) {
+					values[ i ] = src[ i ];
+				}
+			}
+		}
+
+		template< typename T, typename A, typename KeyFn >
+		static void sort( std::vector< T, A > &values, std::vector< T, A > &scratch, KeyFn getKey )
+		{
+			if ( scratch.size() < values.size() ) {
+				scratch.resize( values.size() );
+			}
+			sort( values.data(), scratch.data(), values.size(), getKey );
+		}
+
+		/**
+		   \brief Maps a float to an unsigned key preserving order
+
+		   Negative values are ordered before positive ones.
+		 */
+		static crimild::UInt32 toKey( float value )
+		{
+			crimild::UInt32 bits;
+			std::memcpy( &bits, &value, sizeof( bits ) );
+			return ( bits & 0x80000000u ) ? ~bits : ( bits | 0x80000000u );
+		}
+	};
+
+}
+
+#endif
+
@@ -138,7 +138,12 @@ namespace crimild {
             
         void forEach( std::function< void( ObjectType * ) > callback, bool ignoreNulls = true )
         {
-            forEach( [callback]( ObjectType *obj, int index ) { callback( obj ); }, ignoreNulls );
+            // iterate directly instead of wrapping the callback, which would allocate
+            for ( auto &o : _objects ) {
+                if ( !ignoreNulls || o != nullptr ) {
+                    callback( crimild::get_ptr( o ) );
+                }
+            }
         }
             
     private:
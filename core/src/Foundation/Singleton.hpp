@@ -63,6 +63,11 @@ namespace crimild {
 			return _instance;
 		}
 
+		static bool hasInstance( void )
+		{
+			return _instance != nullptr;
+		}
+
 	protected:
 		SingletonHeapStoragePolicy( void )
 		{
@@ -32,33 +32,27 @@
 #include "NonCopyable.hpp"
 #include "SmallObjectAllocator.hpp"
 
-#include <thread>
-#include <mutex>
-
 namespace crimild {
 
+	/**
+	   \brief Base class for objects allocated with a small object allocator
+
+	   \remarks The allocator is thread-safe, so objects can be created
+	   and destroyed from any thread.
+	 */
 	template< class Allocator = DefaultSmallObjectAllocator >
 	class SmallObject : public NonCopyable {
-	private:
-		using Mutex = std::mutex;
-		using Lock = std::lock_guard< Mutex >;
-
 	public:
 		static void *operator new( std::size_t size )
 		{
-			Lock lock( _mutex );
 			return Allocator::getInstance()->allocate( size );
 		}
 
 		static void operator delete( void *p, std::size_t size )
 		{
-			Lock lock( _mutex );
 			Allocator::getInstance()->deallocate( p, size );
 		}
 
-	private:
-		static Mutex _mutex;
-
 	protected:
 		SmallObject( void )
 		{
@@ -72,9 +66,6 @@ namespace crimild {
 		}
 	};
 
-	template< typename Allocator >
-	typename SmallObject< Allocator >::Mutex SmallObject< Allocator >::_mutex;
-
 }
 
 #endif
@@ -25,14 +25,119 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+
 #include "SmallObjectAllocator.hpp"
 #include "Log.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 
 using namespace crimild;
 using namespace crimild::internal;
 
+namespace crimild {
+
+	namespace internal {
+
+		/**
+		   \brief Free blocks of a single size class cached by one thread
+		 */
+		struct SmallObjectMagazine {
+			std::vector< void * > blocks;
+			std::size_t capacity = 0;
+		};
+
+		/**
+		   \brief Magazines owned by a single thread for a given allocator
+		 */
+		class SmallObjectThreadCache {
+		public:
+			SmallObjectThreadCache( SmallObjectAllocator *allocator, crimild::UInt64 allocatorId, std::size_t poolCount )
+				: allocator( allocator ),
+				  allocatorId( allocatorId ),
+				  magazines( poolCount )
+			{
+
+			}
+
+			/**
+			   \brief Owner allocator, or nullptr if it has been destroyed
+
+			   \remarks Guarded by the thread cache registry mutex
+			 */
+			SmallObjectAllocator *allocator;
+			crimild::UInt64 allocatorId;
+			std::vector< SmallObjectMagazine > magazines;
+		};
+
+		static std::mutex &getThreadCacheRegistryMutex( void )
+		{
+			static std::mutex mutex;
+			return mutex;
+		}
+
+		/**
+		   \brief Set once the calling thread's cache table has been destroyed
+
+		   Objects may still be deallocated after that (i.e. static objects
+		   being destroyed at exit), in which case the shared pools are
+		   used directly. Being trivially destructible, this flag is valid
+		   for the whole lifetime of the thread.
+		 */
+		static thread_local bool t_threadCacheTableDestroyed = false;
+
+		/**
+		   \brief Thread caches for every allocator used by a thread
+		 */
+		class SmallObjectThreadCacheTable {
+		public:
+			~SmallObjectThreadCacheTable( void )
+			{
+				t_threadCacheTableDestroyed = true;
+
+				std::lock_guard< std::mutex > lock( getThreadCacheRegistryMutex() );
+				for ( auto cache : caches ) {
+					if ( cache->allocator != nullptr ) {
+						cache->allocator->releaseThreadCache( cache );
+					}
+					delete cache;
+				}
+				caches.clear();
+			}
+
+			SmallObjectThreadCache *find( crimild::UInt64 allocatorId )
+			{
+				if ( last != nullptr && last->allocatorId == allocatorId ) {
+					return last;
+				}
+
+				for ( auto cache : caches ) {
+					if ( cache->allocatorId == allocatorId ) {
+						last = cache;
+						return cache;
+					}
+				}
+
+				return nullptr;
+			}
+
+			std::vector< SmallObjectThreadCache * > caches;
+			SmallObjectThreadCache *last = nullptr;
+		};
+
+		static thread_local SmallObjectThreadCacheTable t_threadCacheTable;
+
+		static crimild::UInt64 nextAllocatorId( void )
+		{
+			static std::atomic< crimild::UInt64 > nextId( 0 );
+			return ++nextId;
+		}
+
+	}
+
+}
+
 std::size_t SmallObjectAllocator::getOffset( std::size_t numBytes, std::size_t alignment )
 {
     const std::size_t alignExtra = alignment - 1;
@@ -52,12 +157,14 @@ void SmallObjectAllocator::defaultDealloc( void *p )
 
 SmallObjectAllocator::SmallObjectAllocator( std::size_t pageSize, std::size_t maxObjectSize, std::size_t objectAlignSize )
 	: _pool( nullptr ),
+	  _pageSize( pageSize ),
 	  _maxObjectSize( maxObjectSize ),
-	  _objectAlignSize( objectAlignSize )
+	  _objectAlignSize( objectAlignSize ),
+	  _id( nextAllocatorId() )
 {
 	assert( 0 != _objectAlignSize );
 
-	const std::size_t allocCount = getOffset( _maxObjectSize, _objectAlignSize );
+	const std::size_t allocCount = getPoolCount();
 	assert( allocCount > 0 );
 	_pool = new FixedAllocator[ allocCount ];
 	for ( std::size_t i = 0; i < allocCount; i++ ) {
@@ -67,17 +174,45 @@ SmallObjectAllocator::SmallObjectAllocator( std::size_t pageSize, std::size_t ma
 
 SmallObjectAllocator::~SmallObjectAllocator( void )
 {
+	{
+		// blocks still cached by other threads belong to chunks that
+		// are about to be released, so just forget about them
+		std::lock_guard< std::mutex > lock( getThreadCacheRegistryMutex() );
+		for ( auto cache : _threadCaches ) {
+			cache->allocator = nullptr;
+			for ( auto &magazine : cache->magazines ) {
+				magazine.blocks.clear();
+			}
+		}
+		_threadCaches.clear();
+	}
+
 	if ( _pool != nullptr ) {
 		delete [] _pool;
 		_pool = nullptr;
 	}
 }
 
+std::size_t SmallObjectAllocator::getMagazineCapacity( std::size_t numBytes ) const
+{
+	const std::size_t MIN_MAGAZINE_SIZE = 4;
+
+	if ( numBytes == 0 ) numBytes = 1;
+	const std::size_t blockSize = getOffset( numBytes, getAlignment() ) * getAlignment();
+
+	return std::max( MIN_MAGAZINE_SIZE, std::min< std::size_t >( CRIMILD_MAX_SMALL_OBJECT_MAGAZINE_SIZE, _pageSize / blockSize ) );
+}
+
+std::size_t SmallObjectAllocator::getPoolCount( void ) const
+{
+	return getOffset( getMaxObjectSize(), getAlignment() );
+}
+
 bool SmallObjectAllocator::trimExcessMemory( void )
 {
 	bool found = false;
 
-	const std::size_t allocCount = getOffset( getMaxObjectSize(), getAlignment() );
+	const std::size_t allocCount = getPoolCount();
 
 	for ( std::size_t i = 0; i < allocCount; i++ ) {
 		if ( _pool[ i ].trimEmptyChunk() ) {
@@ -94,6 +229,93 @@ bool SmallObjectAllocator::trimExcessMemory( void )
 	return found;
 }
 
+void *SmallObjectAllocator::allocateFromPool( std::size_t index )
+{
+	assert( _pool != nullptr );
+	assert( index < getPoolCount() );
+
+	FixedAllocator &allocator = _pool[ index ];
+	void *place = allocator.allocate();
+
+	if ( ( place == nullptr ) && trimExcessMemory() ) {
+		place = allocator.allocate();
+	}
+
+	// shall we throw on error?
+	assert( place != nullptr );
+
+	return place;
+}
+
+void SmallObjectAllocator::deallocateToPool( void *p, std::size_t index )
+{
+	assert( _pool != nullptr );
+	assert( index < getPoolCount() );
+
+	const bool found = _pool[ index ].deallocate( p, nullptr );
+	assert( found );
+}
+
+SmallObjectThreadCache *SmallObjectAllocator::getThreadCache( void )
+{
+	if ( t_threadCacheTableDestroyed ) {
+		return nullptr;
+	}
+
+	auto &table = t_threadCacheTable;
+	auto cache = table.find( _id );
+	if ( cache != nullptr ) {
+		return cache;
+	}
+
+	cache = new SmallObjectThreadCache( this, _id, getPoolCount() );
+	{
+		std::lock_guard< std::mutex > lock( getThreadCacheRegistryMutex() );
+		_threadCaches.push_back( cache );
+	}
+	table.caches.push_back( cache );
+	table.last = cache;
+
+	return cache;
+}
+
+void SmallObjectAllocator::releaseThreadCache( SmallObjectThreadCache *cache )
+{
+	// the registry mutex is already locked
+	{
+		std::lock_guard< std::mutex > lock( _poolMutex );
+		for ( std::size_t i = 0; i < cache->magazines.size(); i++ ) {
+			for ( auto p : cache->magazines[ i ].blocks ) {
+				deallocateToPool( p, i );
+			}
+			cache->magazines[ i ].blocks.clear();
+		}
+	}
+
+	_threadCaches.erase( std::remove( _threadCaches.begin(), _threadCaches.end(), cache ), _threadCaches.end() );
+	cache->allocator = nullptr;
+}
+
+void SmallObjectAllocator::flushThreadCache( void )
+{
+	if ( t_threadCacheTableDestroyed ) {
+		return;
+	}
+
+	auto cache = t_threadCacheTable.find( _id );
+	if ( cache == nullptr ) {
+		return;
+	}
+
+	std::lock_guard< std::mutex > lock( _poolMutex );
+	for ( std::size_t i = 0; i < cache->magazines.size(); i++ ) {
+		for ( auto p : cache->magazines[ i ].blocks ) {
+			deallocateToPool( p, i );
+		}
+		cache->magazines[ i ].blocks.clear();
+	}
+}
+
 void *SmallObjectAllocator::allocate( std::size_t numBytes )
 {
 	if ( numBytes > getMaxObjectSize() ) {
@@ -105,21 +327,34 @@ void *SmallObjectAllocator::allocate( std::size_t numBytes )
 	if ( numBytes == 0 ) numBytes = 1;
 
 	const std::size_t index = getOffset( numBytes, getAlignment() ) - 1;
-	const std::size_t allocCount = getOffset( getMaxObjectSize(), getAlignment() );
-	assert( index < allocCount );
-
-	FixedAllocator &allocator = _pool[ index ];
-	assert( allocator.getBlockSize() >= numBytes );
-	assert( allocator.getBlockSize() < numBytes + getAlignment() );
-	void *place = allocator.allocate();
+	assert( index < getPoolCount() );
+	assert( _pool[ index ].getBlockSize() >= numBytes );
+	assert( _pool[ index ].getBlockSize() < numBytes + getAlignment() );
 
-	if ( ( place == nullptr ) && trimExcessMemory() ) {
-		place = allocator.allocate();
+	auto cache = getThreadCache();
+	if ( cache == nullptr ) {
+		std::lock_guard< std::mutex > lock( _poolMutex );
+		return allocateFromPool( index );
 	}
 
-	// shall we throw on error?
-	assert( place != nullptr );
+	auto &magazine = cache->magazines[ index ];
+	if ( magazine.blocks.empty() ) {
+		// refill half of the magazine, leaving room for deallocations
+		if ( magazine.capacity == 0 ) {
+			magazine.capacity = getMagazineCapacity( numBytes );
+			magazine.blocks.reserve( magazine.capacity );
+		}
 
+		const std::size_t count = std::max< std::size_t >( 1, magazine.capacity / 2 );
+
+		std::lock_guard< std::mutex > lock( _poolMutex );
+		for ( std::size_t i = 0; i < count; i++ ) {
+			magazine.blocks.push_back( allocateFromPool( index ) );
+		}
+	}
+
+	auto place = magazine.blocks.back();
+	magazine.blocks.pop_back();
 	return place;
 }
 
@@ -129,29 +364,44 @@ void SmallObjectAllocator::deallocate( void *p, std::size_t size )
 		return;
 	}
 
+	if ( size > getMaxObjectSize() ) {
+		defaultDealloc( p );
+		return;
+	}
+
 	assert( _pool != nullptr );
 
-	FixedAllocator *allocator = nullptr;
-	const std::size_t allocCount = getOffset( getMaxObjectSize(), getAlignment() );
+	if ( size == 0 ) size = 1;
 
-	Chunk *chunk = nullptr;
+	const std::size_t index = getOffset( size, getAlignment() ) - 1;
+	assert( index < getPoolCount() );
 
-	for ( std::size_t i = 0; i < allocCount; i++ ) {
-		chunk = _pool[ i ].hasBlock( p );
-		if ( chunk != nullptr ) {
-			allocator = &_pool[ i ];
-			break;
-		}
+	auto cache = getThreadCache();
+	if ( cache == nullptr ) {
+		std::lock_guard< std::mutex > lock( _poolMutex );
+		deallocateToPool( p, index );
+		return;
 	}
 
-	if ( allocator == nullptr ) {
-		defaultDealloc( p );
-		return;
+	auto &magazine = cache->magazines[ index ];
+	if ( magazine.capacity == 0 ) {
+		magazine.capacity = getMagazineCapacity( size );
+		magazine.blocks.reserve( magazine.capacity );
 	}
 
-	assert( chunk != nullptr );
-	const bool found = allocator->deallocate( p, chunk );
-	assert( found );
-}
+	if ( magazine.blocks.size() >= magazine.capacity ) {
+		// return the oldest half of the magazine to the shared pool,
+		// keeping the most recently used blocks around
+		const std::size_t count = std::max< std::size_t >( 1, magazine.capacity / 2 );
+		{
+			std::lock_guard< std::mutex > lock( _poolMutex );
+			for ( std::size_t i = 0; i < count; i++ ) {
+				deallocateToPool( magazine.blocks[ i ], index );
+			}
+		}
+		magazine.blocks.erase( magazine.blocks.begin(), magazine.blocks.begin() + count );
+	}
 
+	magazine.blocks.push_back( p );
+}
 
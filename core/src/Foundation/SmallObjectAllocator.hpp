@@ -30,8 +30,11 @@
 
 #include "FixedAllocator.hpp"
 #include "Singleton.hpp"
+#include "Types.hpp"
 
 #include <iostream>
+#include <mutex>
+#include <vector>
 
 #ifndef CRIMILD_DEFAULT_CHUNK_SIZE
 #define CRIMILD_DEFAULT_CHUNK_SIZE 4096
@@ -45,8 +48,34 @@
 #define CRIMILD_DEFAULT_OBJECT_ALIGNMENT 4
 #endif
 
+#ifndef CRIMILD_MAX_SMALL_OBJECT_MAGAZINE_SIZE
+#define CRIMILD_MAX_SMALL_OBJECT_MAGAZINE_SIZE 64
+#endif
+
 namespace crimild {
 
+	namespace internal {
+
+		class SmallObjectThreadCache;
+		class SmallObjectThreadCacheTable;
+
+	}
+
+	/**
+	   \brief Allocates small objects from pools of fixed-size blocks
+
+	   Blocks are kept in shared pools, one for each size class, which are
+	   protected by a mutex. In front of them, every thread keeps a small
+	   cache of free blocks (a magazine) for each size class. Most
+	   allocations and deallocations are served by the calling thread's
+	   magazine without any locking. The shared pools are only accessed
+	   to refill an empty magazine or to return half of a full one, so
+	   the cost of locking is amortized over several blocks.
+
+	   Blocks may be deallocated from a different thread than the one
+	   that allocated them. Cached blocks are returned to the shared
+	   pools when their thread exits.
+	 */
     class SmallObjectAllocator : public StaticSingleton< SmallObjectAllocator > {
 	private:
         inline static std::size_t getOffset( std::size_t numBytes, std::size_t alignment );
@@ -59,20 +88,74 @@ namespace crimild {
 							  std::size_t objectAlignSize = CRIMILD_DEFAULT_OBJECT_ALIGNMENT );
 		~SmallObjectAllocator( void );
 
+		/**
+		   \remarks Thread-safe
+		 */
 		void *allocate( std::size_t numBytes );
+
+		/**
+		   \remarks Thread-safe. Size must be the same one used when
+		   allocating p, since it determines the block's pool
+		 */
 		void deallocate( void *p, std::size_t size );
 
+		/**
+		   \brief Returns all blocks cached by the calling thread to the shared pools
+		 */
+		void flushThreadCache( void );
+
 		const std::size_t getMaxObjectSize( void ) const { return _maxObjectSize; }
 		const std::size_t getAlignment( void ) const { return _objectAlignSize; }
 
+		/**
+		   \brief Maximum number of free blocks cached per thread for a given object size
+
+		   Larger blocks are cached in smaller quantities, so each magazine
+		   holds about a page worth of memory at most.
+		 */
+		std::size_t getMagazineCapacity( std::size_t numBytes ) const;
+
 	private:
 		bool trimExcessMemory( void );
 
+		std::size_t getPoolCount( void ) const;
+
+		/**
+		   \name Shared pools
+
+		   \remarks Must be called with _poolMutex locked
+		 */
+		//@{
+
+		void *allocateFromPool( std::size_t index );
+		void deallocateToPool( void *p, std::size_t index );
+
+		//@}
+
+		internal::SmallObjectThreadCache *getThreadCache( void );
+		void releaseThreadCache( internal::SmallObjectThreadCache *cache );
+
+		friend class internal::SmallObjectThreadCacheTable;
+
 	private:
 		internal::FixedAllocator *_pool = nullptr;
+		std::mutex _poolMutex;
 
+		std::size_t _pageSize;
 		std::size_t _maxObjectSize;
 		std::size_t _objectAlignSize;
+
+		/**
+		   \brief Unique id, used to match thread caches with this allocator
+		 */
+		crimild::UInt64 _id;
+
+		/**
+		   \brief Caches created by each thread for this allocator
+
+		   \remarks Guarded by the global thread cache registry mutex
+		 */
+		std::vector< internal::SmallObjectThreadCache * > _threadCaches;
 	};
 
 	using DefaultSmallObjectAllocator = SmallObjectAllocator;
@@ -27,23 +27,42 @@
 
 #include "Random.hpp"
 
+#include <atomic>
+
 using namespace crimild;
 
+namespace crimild {
+
+	namespace random {
+
+		/**
+		   \brief SplitMix64, used to expand seeds into generator states
+		 */
+		static crimild::UInt64 splitMix64( crimild::UInt64 &x )
+		{
+			auto z = ( x += 0x9e3779b97f4a7c15ULL );
+			z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+			z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+			return z ^ ( z >> 31 );
+		}
+
+		static std::atomic< crimild::UInt64 > s_generatorCount( 0 );
+
+	}
+
+}
+
 Random::Generator::Generator( void )
-	: _distribution( 0, 1 )
 {
-	// initialize the random number generator with time-dependent seed
-	uint64_t timeSeed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-	std::seed_seq ss { uint32_t( timeSeed & 0xffffffff ), uint32_t( timeSeed >> 32 ) };
-	
-	_generator.seed( ss );	
+	// time-dependent seed, plus a counter so generators created at
+	// the same time (i.e. by different threads) are still different
+	const crimild::UInt64 timeSeed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	seed( timeSeed, random::s_generatorCount.fetch_add( 1, std::memory_order_relaxed ) );
 }
 
-Random::Generator::Generator( crimild::UInt32 seed )
-	: _distribution( 0, 1 ),
-	  _generator( seed )
+Random::Generator::Generator( crimild::UInt64 seed, crimild::UInt64 stream )
 {
-
+	this->seed( seed, stream );
 }
 
 Random::Generator::~Generator( void )
@@ -51,9 +70,28 @@ Random::Generator::~Generator( void )
 
 }
 
+void Random::Generator::seed( crimild::UInt64 seed, crimild::UInt64 stream )
+{
+	// hash the stream so consecutive streams start far apart
+	auto s = stream;
+	auto x = seed ^ random::splitMix64( s );
+
+	const auto a = random::splitMix64( x );
+	const auto b = random::splitMix64( x );
+	_state[ 0 ] = static_cast< crimild::UInt32 >( a );
+	_state[ 1 ] = static_cast< crimild::UInt32 >( a >> 32 );
+	_state[ 2 ] = static_cast< crimild::UInt32 >( b );
+	_state[ 3 ] = static_cast< crimild::UInt32 >( b >> 32 );
+
+	if ( ( _state[ 0 ] | _state[ 1 ] | _state[ 2 ] | _state[ 3 ] ) == 0 ) {
+		// all-zero state is not allowed
+		_state[ 0 ] = 1;
+	}
+}
+
 crimild::Real64 Random::Generator::generate( void )
 {
-	return _distribution( _generator );
+	return nextReal64();
 }
 
 crimild::Real64 Random::Generator::generate( crimild::Real64 max )
@@ -66,3 +104,22 @@ crimild::Real64 Random::Generator::generate( crimild::Real64 min, crimild::Real6
 	return min + generate() * ( max - min );
 }
 
+void Random::Generator::fill( crimild::Real32 *values, crimild::Size count, crimild::Real32 min, crimild::Real32 max )
+{
+	const auto range = max - min;
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		values[ i ] = min + nextReal32() * range;
+	}
+}
+
+Random::Generator &Random::getThreadGenerator( void )
+{
+	static thread_local Random::Generator t_generator;
+	return t_generator;
+}
+
+void Random::setSeed( crimild::UInt64 seed )
+{
+	getThreadGenerator().seed( seed );
+}
+
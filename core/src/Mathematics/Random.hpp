@@ -48,21 +48,106 @@ namespace crimild {
 
 	class Random {
 	public:
+		/**
+		   \brief Fast pseudo-random number generator
+
+		   Based on xoshiro128+, which only needs 16 bytes of state, so
+		   generators can be created per thread, per emitter or even per
+		   pixel without contention. Generators created with the same seed
+		   and stream produce the same sequence on every platform,
+		   regardless of which thread is using them.
+		 */
 		class Generator {
 		public:
+			/**
+			   \brief Creates a generator with a unique, time-dependent seed
+			 */
 			Generator( void );
-			Generator( crimild::UInt32 seed );
+
+			/**
+			   \brief Creates a generator with an explicit seed
+
+			   \param stream Selects one of many independent sequences for
+			   the same seed (i.e. one per emitter or per pixel)
+			 */
+			explicit Generator( crimild::UInt64 seed, crimild::UInt64 stream = 0 );
+
 			~Generator( void );
 
+			void seed( crimild::UInt64 seed, crimild::UInt64 stream = 0 );
+
+			inline crimild::UInt32 nextUInt32( void )
+			{
+				const auto result = _state[ 0 ] + _state[ 3 ];
+				const auto t = _state[ 1 ] << 9;
+
+				_state[ 2 ] ^= _state[ 0 ];
+				_state[ 3 ] ^= _state[ 1 ];
+				_state[ 1 ] ^= _state[ 2 ];
+				_state[ 0 ] ^= _state[ 3 ];
+				_state[ 2 ] ^= t;
+				_state[ 3 ] = ( _state[ 3 ] << 11 ) | ( _state[ 3 ] >> 21 );
+
+				return result;
+			}
+
+			/**
+			   \brief Generates a value in [0, 1) using the upper 24 bits
+			 */
+			inline crimild::Real32 nextReal32( void )
+			{
+				return static_cast< crimild::Real32 >( nextUInt32() >> 8 ) * ( 1.0f / 16777216.0f );
+			}
+
+			/**
+			   \brief Generates a value in [0, 1) with 53 bits of precision
+			 */
+			inline crimild::Real64 nextReal64( void )
+			{
+				const auto hi = static_cast< crimild::UInt64 >( nextUInt32() );
+				const auto lo = static_cast< crimild::UInt64 >( nextUInt32() );
+				return static_cast< crimild::Real64 >( ( ( hi << 32 ) | lo ) >> 11 ) * ( 1.0 / 9007199254740992.0 );
+			}
+
 			crimild::Real64 generate( void );
 			crimild::Real64 generate( crimild::Real64 max );
 			crimild::Real64 generate( crimild::Real64 min, crimild::Real64 max );
 
+			/**
+			   \brief Fills count values in [min, max)
+
+			   Produces the same values as calling Random::generate( *this, min, max )
+			   count times, but it can be used to fill whole attribute arrays
+			   at once.
+			 */
+			void fill( crimild::Real32 *values, crimild::Size count, crimild::Real32 min, crimild::Real32 max );
+
+			template< typename T >
+			void fill( T *values, crimild::Size count, const T &min, const T &max )
+			{
+				for ( crimild::Size i = 0; i < count; i++ ) {
+					Random::generateImpl( *this, values[ i ], min, max );
+				}
+			}
+
 		private:
-			std::mt19937_64 _generator;
-			std::uniform_real_distribution< double > _distribution;
+			crimild::UInt32 _state[ 4 ];
 		};
 
+		/**
+		   \brief Gets the generator for the calling thread
+
+		   Each thread has its own generator, so no locks are required.
+		   Since results depend on how work is scheduled, use explicitly
+		   seeded generators when reproducible results are needed.
+		 */
+		static Generator &getThreadGenerator( void );
+
+		/**
+		   \brief Seeds the generator for the calling thread
+		 */
+		static void setSeed( crimild::UInt64 seed );
+
 	public:
 		template< typename PRECISION >
 		inline static PRECISION generate( void )
@@ -78,47 +163,41 @@ namespace crimild {
 
 		template< typename T >
 		inline static T generate( const T &min, const T &max )
+		{
+			return generate< T >( getThreadGenerator(), min, max );
+		}
+
+		/**
+		   \brief Generates a value using the given generator instead of the thread's one
+		 */
+		template< typename T >
+		inline static T generate( Generator &generator, const T &min, const T &max )
 		{
 			T result;
-			generateImpl( result, min, max );
+			generateImpl( generator, result, min, max );
 			return result;
 		}
 
 	private:
 		template< crimild::Size SIZE, typename PRECISION >
-		inline static void generateImpl( Vector< SIZE, PRECISION > &result, const Vector< SIZE, PRECISION > &min, const Vector< SIZE, PRECISION > &max )
+		inline static void generateImpl( Generator &generator, Vector< SIZE, PRECISION > &result, const Vector< SIZE, PRECISION > &min, const Vector< SIZE, PRECISION > &max )
 		{
-			if ( SIZE == 2 ) {
-				result = Vector< SIZE, PRECISION >(
-					Random::generate< PRECISION >( min[ 0 ], max[ 0 ] ),
-					Random::generate< PRECISION >( min[ 1 ], max[ 1 ] ) );
-			}
-			else if ( SIZE == 3 ) {
-				result = Vector< SIZE, PRECISION >(
-					Random::generate< PRECISION >( min[ 0 ], max[ 0 ] ),
-					Random::generate< PRECISION >( min[ 1 ], max[ 1 ] ),
-					Random::generate< PRECISION >( min[ 2 ], max[ 2 ] ) );
-			}
-			else if ( SIZE == 4 ) {
-				result = Vector< SIZE, PRECISION >(
-					Random::generate< PRECISION >( min[ 0 ], max[ 0 ] ),
-					Random::generate< PRECISION >( min[ 1 ], max[ 1 ] ),
-					Random::generate< PRECISION >( min[ 2 ], max[ 2 ] ),
-					Random::generate< PRECISION >( min[ 3 ], max[ 3 ] ) );
-			}
-			else {
-				for ( crimild::Size i = 0; i < SIZE; i++ ) {
-					result[ i ] = Random::generate< PRECISION >( min[ i ], max[ i ] );
-				}
+			// components are generated in order, so results do not depend on
+			// the evaluation order of constructor arguments
+			for ( crimild::Size i = 0; i < SIZE; i++ ) {
+				generateImpl( generator, result[ i ], min[ i ], max[ i ] );
 			}
 		}
 
-		template< typename PRECISION >
-		inline static void generateImpl( PRECISION &result, const PRECISION &min, const PRECISION &max )
+		inline static void generateImpl( Generator &generator, crimild::Real32 &result, const crimild::Real32 &min, const crimild::Real32 &max )
 		{
-			static Random::Generator defaultGenerator;
+			result = min + generator.nextReal32() * ( max - min );
+		}
 
-			crimild::Real64 r = defaultGenerator.generate();
+		template< typename PRECISION >
+		inline static void generateImpl( Generator &generator, PRECISION &result, const PRECISION &min, const PRECISION &max )
+		{
+			crimild::Real64 r = generator.nextReal64();
             result = min + r * ( max - min );
         }
 
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "SIMD.hpp"
+
+#include <atomic>
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace simd {
+
+		static InstructionSet detectInstructionSet( void )
+		{
+#ifdef CRIMILD_SIMD_X86
+			__builtin_cpu_init();
+			if ( __builtin_cpu_supports( "avx" ) ) {
+				return InstructionSet::AVX;
+			}
+			if ( __builtin_cpu_supports( "sse2" ) ) {
+				return InstructionSet::SSE;
+			}
+#endif
+			return InstructionSet::SCALAR;
+		}
+
+		static std::atomic< int > &getActiveInstructionSet( void )
+		{
+			static std::atomic< int > instructionSet( static_cast< int >( getSupportedInstructionSet() ) );
+			return instructionSet;
+		}
+
+	}
+
+}
+
+simd::InstructionSet simd::getSupportedInstructionSet( void )
+{
+	static const auto supported = detectInstructionSet();
+	return supported;
+}
+
+simd::InstructionSet simd::getInstructionSet( void )
+{
+	return static_cast< InstructionSet >( getActiveInstructionSet().load( std::memory_order_relaxed ) );
+}
+
+void simd::setInstructionSet( InstructionSet value )
+{
+	if ( static_cast< int >( value ) > static_cast< int >( getSupportedInstructionSet() ) ) {
+		value = getSupportedInstructionSet();
+	}
+	getActiveInstructionSet().store( static_cast< int >( value ), std::memory_order_relaxed );
+}
+
+const char *simd::getInstructionSetName( InstructionSet value )
+{
+	switch ( value ) {
+		case InstructionSet::AVX:
+			return "AVX";
+		case InstructionSet::SSE:
+			return "SSE";
+		default:
+			return "Scalar";
+	}
+}
+
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_MATHEMATICS_SIMD_
+#define CRIMILD_MATHEMATICS_SIMD_
+
+/**
+   \brief Alignment (in bytes) for data processed by SIMD kernels
+
+   Big enough for AVX registers
+ */
+#ifndef CRIMILD_SIMD_ALIGNMENT
+#define CRIMILD_SIMD_ALIGNMENT 32
+#endif
+
+// SIMD kernels are compiled using per-function target attributes,
+// so no special compiler flags are required. Define CRIMILD_DISABLE_SIMD
+// to use scalar code only.
+#if !defined( CRIMILD_DISABLE_SIMD ) && ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define CRIMILD_SIMD_X86
+#define CRIMILD_SIMD_TARGET_SSE __attribute__(( target( "sse2" ) ))
+#define CRIMILD_SIMD_TARGET_AVX __attribute__(( target( "avx" ) ))
+#endif
+
+namespace crimild {
+
+	namespace simd {
+
+		enum class InstructionSet {
+			SCALAR,
+			SSE,
+			AVX,
+		};
+
+		/**
+		   \brief Best instruction set available in this machine
+
+		   Detected at runtime the first time it's requested
+		 */
+		InstructionSet getSupportedInstructionSet( void );
+
+		/**
+		   \brief Instruction set used by SIMD kernels
+
+		   Defaults to the supported one
+		 */
+		InstructionSet getInstructionSet( void );
+
+		/**
+		   \brief Forces kernels to use a given instruction set
+
+		   Values not supported by this machine are clamped to the
+		   supported one. Mostly useful for testing and benchmarking.
+		 */
+		void setInstructionSet( InstructionSet value );
+
+		const char *getInstructionSetName( InstructionSet value );
+
+	}
+
+}
+
+#endif
+
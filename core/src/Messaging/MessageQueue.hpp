@@ -31,9 +31,12 @@
 #include "Foundation/Macros.hpp"
 #include "Foundation/Singleton.hpp"
 #include "Foundation/Log.hpp"
+#include "Concurrency/MPSCRingBuffer.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
-#include <map>
+#include <memory>
 #include <vector>
 #include <mutex>
 
@@ -44,6 +47,21 @@ namespace crimild {
     template< class MessageType >
     using MessageHandler = std::function< void( MessageType const & ) >;
     
+    /**
+        \brief What to do with deferred messages pushed while the queue is full
+     */
+    enum class DeferredMessageOverflowPolicy {
+        /**
+            \brief Keep messages in a secondary, mutex-protected, buffer
+         */
+        SPILL,
+        
+        /**
+            \brief Discard new messages until the queue is dispatched
+         */
+        DISCARD,
+    };
+    
     class MessageQueueDispatcher : public NonCopyable {
     protected:
         MessageQueueDispatcher( void )
@@ -64,6 +82,14 @@ namespace crimild {
         virtual void clear( void ) = 0;
     };
     
+    /**
+        \brief Dispatches messages of a single type
+
+        Registered handlers are kept in an immutable array that is replaced
+        (copy-on-write) whenever a handler is registered or unregistered.
+        Broadcasting only takes a snapshot of the current array, so it never
+        copies handlers or blocks while other threads modify the registry.
+     */
     template< class MessageType >
     class MessageQueueDispatcherImpl :
     public MessageQueueDispatcher,
@@ -73,82 +99,323 @@ namespace crimild {
         using Mutex = std::mutex;
         using Lock = std::lock_guard< Mutex >;
         
+        struct HandlerEntry {
+            Messenger *target;
+            MessageHandler< MessageType > handler;
+        };
+        
+        using HandlerArray = std::vector< HandlerEntry >;
+        using HandlerArrayPtr = std::shared_ptr< const HandlerArray >;
+        
+    public:
+        static constexpr size_t DEFAULT_DEFERRED_MESSAGE_CAPACITY = 256;
+        
     public:
         MessageQueueDispatcherImpl( void );
         
-        virtual ~MessageQueueDispatcherImpl( void ) { }
+        virtual ~MessageQueueDispatcherImpl( void )
+        {
+            delete _deferredMessages.load( std::memory_order_acquire );
+        }
         
         void registerHandler( Messenger *target, MessageHandler< MessageType > handler )
         {
             Lock lock( _handlersMutex );
             
-            _handlers[ target ] = handler;
+            auto current = std::atomic_load( &_handlers );
+            auto hs = std::make_shared< HandlerArray >();
+            hs->reserve( current->size() + 1 );
+            
+            bool replaced = false;
+            for ( auto &entry : *current ) {
+                if ( entry.target == target ) {
+                    hs->push_back( HandlerEntry { target, handler } );
+                    replaced = true;
+                }
+                else {
+                    hs->push_back( entry );
+                }
+            }
+            
+            if ( !replaced ) {
+                hs->push_back( HandlerEntry { target, handler } );
+            }
+            
+            std::atomic_store( &_handlers, HandlerArrayPtr( hs ) );
         }
         
-        virtual void unregisterHandler( Messenger *handler ) override
+        virtual void unregisterHandler( Messenger *target ) override
         {
             Lock lock( _handlersMutex );
             
-            auto it = _handlers.find( handler );
-            if ( it != _handlers.end() ) {
-                _handlers.erase( it );
+            auto current = std::atomic_load( &_handlers );
+            auto it = std::find_if( current->begin(), current->end(), [ target ]( HandlerEntry const &entry ) {
+                return entry.target == target;
+            });
+            
+            if ( it == current->end() ) {
+                // nothing to remove. Keep the current array
+                return;
+            }
+            
+            auto hs = std::make_shared< HandlerArray >();
+            hs->reserve( current->size() - 1 );
+            for ( auto &entry : *current ) {
+                if ( entry.target != target ) {
+                    hs->push_back( entry );
+                }
             }
+            
+            std::atomic_store( &_handlers, HandlerArrayPtr( hs ) );
+        }
+        
+        size_t getHandlerCount( void ) const
+        {
+            return std::atomic_load( &_handlers )->size();
         }
         
     private:
-        std::map< Messenger *, MessageHandler< MessageType >> _handlers;
+        HandlerArrayPtr _handlers = std::make_shared< HandlerArray >();
+        
+        /**
+            \brief Serializes writers only. Broadcasting never locks it
+         */
         Mutex _handlersMutex;
         
     public:
         void broadcastMessage( MessageType const &message )
         {
-            std::map< Messenger *, MessageHandler< MessageType >> hs;
+            // Handlers registered or unregistered while broadcasting will
+            // not affect the snapshot, which is kept alive until we're done
+            auto hs = std::atomic_load( &_handlers );
             
-            {
-                Lock lock( _handlersMutex );
-                hs = _handlers;
-            }
-            
-            for ( auto it : hs ) {
-                if ( it.first != nullptr && it.second != nullptr ) {
-                    it.second( message );
+            for ( auto &entry : *hs ) {
+                if ( entry.target != nullptr && entry.handler != nullptr ) {
+                    entry.handler( message );
                 }
             }
         }
         
     public:
-        void pushMessage( MessageType const &message )
+        /**
+            \brief Queues a message to be broadcasted by dispatchDeferredMessages()
+
+            This method can be invoked from any thread. Messages are stored
+            in a bounded lock-free ring, so posting from many threads at the
+            same time does not serialize them. What happens when the ring is
+            full depends on the current overflow policy.
+
+            \remarks The ring is created when the first message is pushed,
+            which requires messages to be default-constructible and
+            copy-assignable. Message types that are only broadcasted
+            don't have such requirements.
+
+            \returns false if the message was discarded
+         */
+        bool pushMessage( MessageType const &message )
         {
-            Lock lock( _deferredMessagesMutex );
-            
-            _deferredMessages.push_back( message );
+            return getDeferredMessages()->push( message );
+        }
+        
+        bool hasPendingMessages( void ) const
+        {
+            auto deferred = _deferredMessages.load( std::memory_order_acquire );
+            return deferred != nullptr && deferred->hasPendingMessages();
         }
         
+        /**
+            \brief Dispatches all messages queued so far
+
+            Messages pushed by handlers during dispatch are delivered on the
+            next invocation. Messages that overflowed the ring are delivered
+            after the ones in it.
+
+            \remarks Only one thread at a time may invoke this method
+         */
         virtual void dispatchDeferredMessages( void ) override
         {
-            std::vector< MessageType > ms;
+            // Most message types are never deferred, so they
+            // don't even have storage for it
+            auto deferred = _deferredMessages.load( std::memory_order_acquire );
+            if ( deferred != nullptr && deferred->hasPendingMessages() ) {
+                deferred->dispatch();
+            }
+        }
+        
+        /**
+            \brief Configures storage for deferred messages
+
+            Pending messages are discarded.
+
+            \remarks Must not be invoked while other threads are pushing messages
+         */
+        void configureDeferredMessages( size_t capacity, DeferredMessageOverflowPolicy overflowPolicy )
+        {
+            auto deferred = new DeferredMessages( this, capacity, overflowPolicy );
+            delete _deferredMessages.exchange( deferred, std::memory_order_acq_rel );
+        }
+        
+        size_t getDeferredMessageCapacity( void ) const
+        {
+            auto deferred = _deferredMessages.load( std::memory_order_acquire );
+            return deferred != nullptr ? deferred->getCapacity() : DEFAULT_DEFERRED_MESSAGE_CAPACITY;
+        }
+        
+        DeferredMessageOverflowPolicy getDeferredMessageOverflowPolicy( void ) const
+        {
+            auto deferred = _deferredMessages.load( std::memory_order_acquire );
+            return deferred != nullptr ? deferred->getOverflowPolicy() : DeferredMessageOverflowPolicy::SPILL;
+        }
+        
+        /**
+            \brief Number of messages discarded because the ring was full
+         */
+        size_t getDiscardedMessageCount( void ) const { return _discardedMessageCount; }
+        
+    public:
+        virtual void clear( void ) override
+        {
+            auto deferred = _deferredMessages.load( std::memory_order_acquire );
+            if ( deferred != nullptr ) {
+                deferred->clear();
+            }
+        }
+        
+    private:
+        /**
+            \brief Storage for deferred messages
+
+            Only the derived class depends on the ring, so it's instantiated
+            just for message types that are actually deferred.
+         */
+        class DeferredMessageStorage {
+        public:
+            virtual ~DeferredMessageStorage( void ) { }
+            
+            virtual bool hasPendingMessages( void ) const = 0;
+            virtual void dispatch( void ) = 0;
+            virtual void clear( void ) = 0;
             
+            virtual size_t getCapacity( void ) const = 0;
+            virtual DeferredMessageOverflowPolicy getOverflowPolicy( void ) const = 0;
+        };
+        
+        class DeferredMessages : public DeferredMessageStorage {
+        public:
+            DeferredMessages( MessageQueueDispatcherImpl *dispatcher, size_t capacity, DeferredMessageOverflowPolicy overflowPolicy )
+                : _dispatcher( dispatcher ),
+                  _ring( capacity ),
+                  _overflowPolicy( overflowPolicy )
             {
-                Lock lock( _deferredMessagesMutex );
-                std::swap( _deferredMessages, ms );
+                
             }
             
-            for ( auto &m : ms ) {
-                broadcastMessage( m );
+            virtual ~DeferredMessages( void ) { }
+            
+            bool push( MessageType const &message )
+            {
+                if ( _ring.tryPush( message ) ) {
+                    return true;
+                }
+                
+                if ( _overflowPolicy == DeferredMessageOverflowPolicy::DISCARD ) {
+                    ++_dispatcher->_discardedMessageCount;
+                    return false;
+                }
+                
+                Lock lock( _overflowMutex );
+                _overflowMessages.push_back( message );
+                _hasOverflowMessages.store( true, std::memory_order_release );
+                return true;
             }
-        }
+            
+            virtual bool hasPendingMessages( void ) const override
+            {
+                return !_ring.empty() || _hasOverflowMessages.load( std::memory_order_acquire );
+            }
+            
+            virtual void dispatch( void ) override
+            {
+                auto count = _ring.size();
+                MessageType message;
+                while ( count-- > 0 && _ring.tryPop( message ) ) {
+                    _dispatcher->broadcastMessage( message );
+                }
+                
+                if ( !_hasOverflowMessages.load( std::memory_order_acquire ) ) {
+                    return;
+                }
+                
+                // Reuse the buffer from the previous dispatch to avoid
+                // allocations. Taking it out of the member keeps this safe
+                // if a handler dispatches deferred messages again
+                std::vector< MessageType > ms;
+                std::swap( ms, _dispatchBuffer );
+                
+                {
+                    Lock lock( _overflowMutex );
+                    std::swap( _overflowMessages, ms );
+                    _hasOverflowMessages.store( false, std::memory_order_relaxed );
+                }
+                
+                for ( auto &m : ms ) {
+                    _dispatcher->broadcastMessage( m );
+                }
+                
+                ms.clear();
+                std::swap( ms, _dispatchBuffer );
+            }
+            
+            virtual void clear( void ) override
+            {
+                _ring.clear();
+                
+                Lock lock( _overflowMutex );
+                _overflowMessages.clear();
+                _hasOverflowMessages.store( false, std::memory_order_relaxed );
+            }
+            
+            virtual size_t getCapacity( void ) const override { return _ring.getCapacity(); }
+            
+            virtual DeferredMessageOverflowPolicy getOverflowPolicy( void ) const override { return _overflowPolicy; }
+            
+        private:
+            MessageQueueDispatcherImpl *_dispatcher = nullptr;
+            
+            MPSCRingBuffer< MessageType > _ring;
+            DeferredMessageOverflowPolicy _overflowPolicy;
+            
+            std::vector< MessageType > _overflowMessages;
+            std::vector< MessageType > _dispatchBuffer;
+            std::atomic< bool > _hasOverflowMessages { false };
+            Mutex _overflowMutex;
+        };
         
-    public:
-        virtual void clear( void ) override
+        /**
+            \brief Gets storage for deferred messages, creating it if needed
+
+            Several threads may try to create it at the same time, but only
+            the first one to publish it wins.
+         */
+        DeferredMessages *getDeferredMessages( void )
         {
-            Lock lock( _deferredMessagesMutex );
+            auto deferred = _deferredMessages.load( std::memory_order_acquire );
+            if ( deferred != nullptr ) {
+                return static_cast< DeferredMessages * >( deferred );
+            }
+            
+            auto created = new DeferredMessages( this, DEFAULT_DEFERRED_MESSAGE_CAPACITY, DeferredMessageOverflowPolicy::SPILL );
+            if ( _deferredMessages.compare_exchange_strong( deferred, created, std::memory_order_acq_rel, std::memory_order_acquire ) ) {
+                return created;
+            }
             
-            _deferredMessages.clear();
+            delete created;
+            return static_cast< DeferredMessages * >( deferred );
         }
         
     private:
-        std::vector< MessageType > _deferredMessages;
-        Mutex _deferredMessagesMutex;
+        std::atomic< DeferredMessageStorage * > _deferredMessages { nullptr };
+        std::atomic< size_t > _discardedMessageCount { 0 };
     };
     
     class MessageQueue : public StaticSingleton< MessageQueue > {
@@ -181,14 +448,9 @@ namespace crimild {
         
         void unregisterHandler( Messenger *target )
         {
-            std::vector< MessageQueueDispatcher * > ds;
+            auto ds = std::atomic_load( &_dispatchers );
             
-            {
-                Lock lock( _mutex );
-                ds = _dispatchers;
-            }
-            
-            for ( auto d : ds ) {
+            for ( auto d : *ds ) {
                 if ( d != nullptr ) {
                     d->unregisterHandler( target );
                 }
@@ -207,26 +469,34 @@ namespace crimild {
         {
             Lock lock( _mutex );
             
-            _dispatchers.push_back( dispatcher );
+            auto ds = std::make_shared< DispatcherArray >( *std::atomic_load( &_dispatchers ) );
+            ds->push_back( dispatcher );
+            std::atomic_store( &_dispatchers, DispatcherArrayPtr( ds ) );
         }
         
     public:
         template< class MessageType >
-        void pushMessage( MessageType const &message )
+        bool pushMessage( MessageType const &message )
         {
-            MessageQueueDispatcherImpl< MessageType >::getInstance()->pushMessage( message );
+            return MessageQueueDispatcherImpl< MessageType >::getInstance()->pushMessage( message );
+        }
+        
+        /**
+            \brief Configures storage for deferred messages of a given type
+            
+            \see MessageQueueDispatcherImpl::configureDeferredMessages
+         */
+        template< class MessageType >
+        void configureDeferredMessages( size_t capacity, DeferredMessageOverflowPolicy overflowPolicy )
+        {
+            MessageQueueDispatcherImpl< MessageType >::getInstance()->configureDeferredMessages( capacity, overflowPolicy );
         }
         
         void dispatchDeferredMessages( void )
         {
-            std::vector< MessageQueueDispatcher * > ds;
-            
-            {
-                Lock lock( _mutex );
-                ds = _dispatchers;
-            }
+            auto ds = std::atomic_load( &_dispatchers );
             
-            for ( auto d : ds ) {
+            for ( auto d : *ds ) {
                 if ( d != nullptr ) {
                     d->dispatchDeferredMessages();
                 }
@@ -236,14 +506,9 @@ namespace crimild {
     public:
         void clear( void )
         {
-            std::vector< MessageQueueDispatcher * > ds;
+            auto ds = std::atomic_load( &_dispatchers );
             
-            {
-                Lock lock( _mutex );
-                ds = _dispatchers;
-            }
-            
-            for ( auto d : ds ) {
+            for ( auto d : *ds ) {
                 if ( d != nullptr ) {
                     d->clear();
                 }
@@ -251,10 +516,19 @@ namespace crimild {
         }
         
     private:
-        std::vector< MessageQueueDispatcher * > _dispatchers;
+        using DispatcherArray = std::vector< MessageQueueDispatcher * >;
+        using DispatcherArrayPtr = std::shared_ptr< const DispatcherArray >;
+        
+        /**
+            \brief Copy-on-write array of dispatchers, one per message type
+         */
+        DispatcherArrayPtr _dispatchers = std::make_shared< DispatcherArray >();
         Mutex _mutex;
     };
     
+    template< class T >
+    constexpr size_t MessageQueueDispatcherImpl< T >::DEFAULT_DEFERRED_MESSAGE_CAPACITY;
+    
     template< class T >
     MessageQueueDispatcherImpl< T >::MessageQueueDispatcherImpl( void )
     {
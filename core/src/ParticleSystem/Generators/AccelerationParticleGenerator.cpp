@@ -52,8 +52,6 @@ void AccelerationParticleGenerator::generate( Node *node, crimild::Real64 dt, Pa
 {
 	auto as = _accelerations->getData< Vector3f >();
 
-    for ( ParticleId i = startId; i < endId; i++ ) {
-		as[ i ] = Random::generate< Vector3f >( _minAcceleration, _maxAcceleration );
-    }
+	particles->getRandom().fill( as + startId, endId - startId, _minAcceleration, _maxAcceleration );
 }
 
@@ -56,21 +56,9 @@ void ColorParticleGenerator::generate( Node *node, crimild::Real64 dt, ParticleD
 	auto sc = _startColors->getData< RGBAColorf >();
 	auto ec = _endColors->getData< RGBAColorf >();
 	
-	for ( ParticleId i = startId; i < endId; i++ ) {
-		auto r = Random::generate< Real32 >( _minStartColor.r(), _maxStartColor.r() );
-		auto g = Random::generate< Real32 >( _minStartColor.g(), _maxStartColor.g() );
-		auto b = Random::generate< Real32 >( _minStartColor.b(), _maxStartColor.b() );
-		auto a = Random::generate< Real32 >( _minStartColor.a(), _maxStartColor.a() );
-		sc[ i ] = RGBAColorf( r, g, b, a );
-	}
-
-	for ( ParticleId i = startId; i < endId; i++ ) {
-		auto r = Random::generate< Real32 >( _minEndColor.r(), _maxEndColor.r() );
-		auto g = Random::generate< Real32 >( _minEndColor.g(), _maxEndColor.g() );
-		auto b = Random::generate< Real32 >( _minEndColor.b(), _maxEndColor.b() );
-		auto a = Random::generate< Real32 >( _minEndColor.a(), _maxEndColor.a() );
-		ec[ i ] = RGBAColorf( r, g, b, a );
-	}
+	auto &random = particles->getRandom();
+	random.fill( sc + startId, endId - startId, _minStartColor, _maxStartColor );
+	random.fill( ec + startId, endId - startId, _minEndColor, _maxEndColor );
 
     for ( ParticleId i = startId; i < endId; i++ ) {
         cs[ i ] = sc[ i ];
@@ -70,19 +70,12 @@ void NodePositionParticleGenerator::generate( Node *node, crimild::Real64 dt, Pa
     const auto posMin = origin - _size;
     const auto posMax = origin + _size;
 
-	// TODO: use random vectors
-    for ( ParticleId i = startId; i < endId; i++ ) {
-        auto x = Random::generate< Real32 >( posMin.x(), posMax.x() );
-        auto y = Random::generate< Real32 >( posMin.y(), posMax.y() );
-        auto z = Random::generate< Real32 >( posMin.z(), posMax.z() );
-		if ( particles->shouldComputeInWorldSpace() ) {
-			auto p = Vector3f( x, y, z );
-			node->getWorld().applyToPoint( p, p );
-			ps[ i ] = p;
-		}
-		else {
-			ps[ i ] = Vector3f( x, y, z );
+	particles->getRandom().fill( ps + startId, endId - startId, posMin, posMax );
+
+	if ( particles->shouldComputeInWorldSpace() ) {
+		for ( ParticleId i = startId; i < endId; i++ ) {
+			node->getWorld().applyToPoint( ps[ i ], ps[ i ] );
 		}
-    }
+	}
 }
 
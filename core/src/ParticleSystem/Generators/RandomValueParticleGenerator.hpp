@@ -54,7 +54,7 @@ namespace crimild {
 		}
 
 		inline void setParticleAttribType( const ParticleAttribType &type ) { _attribType = type; }
-		inline const ParticleAttribType &ParticleAttribType( void ) const { return _attribType; }
+		inline const ParticleAttribType &getParticleAttribType( void ) const { return _attribType; }
 
         inline void setMinValue( const T &value ) { _minValue = value; }
         inline const T &getMinValue( void ) const { return _minValue; }
@@ -70,10 +70,8 @@ namespace crimild {
         virtual void generate( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId startId, ParticleId endId ) override
 		{
 			auto as = _attribs->getData< T >();
-			
-			for ( ParticleId i = startId; i < endId; i++ ) {
-				as[ i ] = Random::generate< T >( _minValue, _maxValue );
-			}
+
+			particles->getRandom().fill( as + startId, endId - startId, _minValue, _maxValue );
 		}
 
     private:
@@ -55,11 +55,10 @@ void SpherePositionParticleGenerator::generate( Node *node, crimild::Real64 dt,
     const auto posMin = -Vector3f::ONE;
     const auto posMax = Vector3f::ONE;
 
+	particles->getRandom().fill( ps + startId, endId - startId, posMin, posMax );
+
     for ( ParticleId i = startId; i < endId; i++ ) {
-        auto x = Random::generate< Real32 >( posMin.x(), posMax.x() );
-        auto y = Random::generate< Real32 >( posMin.y(), posMax.y() );
-        auto z = Random::generate< Real32 >( posMin.z(), posMax.z() );
-        ps[ i ] = _origin + Vector3f( x, y, z ).getNormalized().times( _size );
+        ps[ i ] = _origin + ps[ i ].getNormalized().times( _size );
 		if ( particles->shouldComputeInWorldSpace() ) {
 			node->getWorld().applyToPoint( ps[ i ], ps[ i ] );
 		}
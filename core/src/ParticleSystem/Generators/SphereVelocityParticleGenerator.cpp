@@ -55,8 +55,10 @@ void SphereVelocityParticleGenerator::generate( Node *node, crimild::Real64 dt,
     const auto posMin = -Vector3f::ONE;
     const auto posMax = Vector3f::ONE;
 
+	particles->getRandom().fill( vs + startId, endId - startId, posMin, posMax );
+
     for ( ParticleId i = startId; i < endId; i++ ) {
-        vs[ i ] = Random::generate< Vector3f >( posMin, posMax ).getNormalized().times( _magnitude );
+        vs[ i ] = vs[ i ].getNormalized().times( _magnitude );
     }
 }
 
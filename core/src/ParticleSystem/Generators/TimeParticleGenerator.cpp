@@ -54,10 +54,10 @@ void TimeParticleGenerator::generate( Node *node, crimild::Real64 dt, ParticleDa
 	auto ts = _times->getData< crimild::Real32 >();
 	auto lts = _lifeTimes->getData< crimild::Real32 >();
 	
+	particles->getRandom().fill( ts + startId, endId - startId, _minTime, _maxTime );
+
     for ( ParticleId i = startId; i < endId; i++ ) {
-		auto t = Random::generate< crimild::Real32 >( _minTime, _maxTime );
-		ts[ i ] = t;
-		lts[ i ] = t;
+		lts[ i ] = ts[ i ];
     }
 }
 
@@ -52,11 +52,6 @@ void VelocityParticleGenerator::generate( Node *node, crimild::Real64 dt, Partic
 {
 	auto vs = _velocities->getData< Vector3f >();
 	
-    for ( ParticleId i = startId; i < endId; i++ ) {
-        auto x = Random::generate< Real32 >( _minVelocity.x(), _maxVelocity.x() );
-        auto y = Random::generate< Real32 >( _minVelocity.y(), _maxVelocity.y() );
-        auto z = Random::generate< Real32 >( _minVelocity.z(), _maxVelocity.z() );
-        vs[ i ] = Vector3f( x, y, z );
-    }
+	particles->getRandom().fill( vs + startId, endId - startId, _minVelocity, _maxVelocity );
 }
 
@@ -33,7 +33,17 @@
 #include "Foundation/Array.hpp"
 #include "Foundation/Map.hpp"
 #include "Foundation/Memory.hpp"
+#include "Foundation/AlignedAllocator.hpp"
 #include "Mathematics/Vector.hpp"
+#include "Mathematics/SIMD.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#ifndef CRIMILD_PARTICLE_ATTRIB_PADDING
+#define CRIMILD_PARTICLE_ATTRIB_PADDING 8
+#endif
 
 namespace crimild {
 
@@ -85,6 +95,14 @@ namespace crimild {
 		 */
         virtual void swap( ParticleId a, ParticleId b ) = 0;
 
+		/**
+		   \brief Rearranges the first count elements
+
+		   After this call, the element at index i is the one that was
+		   previously stored at permutation[ i ]
+		 */
+        virtual void reorder( const ParticleId *permutation, crimild::Size count ) = 0;
+
 		/**
 		   \brief Gets the number of elements in the array
 		 */
@@ -144,6 +162,11 @@ namespace crimild {
 
 	   \remarks Attribute data is stored such as active elements are at
 	   the very begining of the array. 
+
+	   \remarks Data is aligned to CRIMILD_SIMD_ALIGNMENT bytes and
+	   storage is padded to a multiple of CRIMILD_PARTICLE_ATTRIB_PADDING
+	   elements, so SIMD kernels can use full registers. Padding elements
+	   are value-initialized and never reported as part of the array.
 	 */
     template< typename T >
     class ParticleAttribArrayImpl : public ParticleAttribArray {
@@ -160,22 +183,24 @@ namespace crimild {
 
         virtual crimild::Size getCount( void ) const override
         {
-            return _data.size();
+            return _count;
         }
 
         virtual void *getRawData( void ) override
         {
-            return _data.getData();
+            return _data.data();
         }
 
         virtual const void *getRawData( void ) const override
         {
-            return _data.getData();
+            return _data.data();
         }
 
         virtual void reset( crimild::Size count ) override
         {
-            _data.resize( count );
+            const auto padding = CRIMILD_PARTICLE_ATTRIB_PADDING;
+            _count = count;
+            _data.resize( ( ( count + padding - 1 ) / padding ) * padding );
         }
 
         virtual void swap( ParticleId a, ParticleId b ) override
@@ -185,13 +210,33 @@ namespace crimild {
         	_data[ b ] = temp;
         }
 
+        virtual void reorder( const ParticleId *permutation, crimild::Size count ) override
+        {
+            assert( count <= _count );
+
+            _reorderBuffer.resize( count );
+            auto data = _data.data();
+            for ( crimild::Size i = 0; i < count; i++ ) {
+                _reorderBuffer[ i ] = data[ permutation[ i ] ];
+            }
+            std::copy( _reorderBuffer.begin(), _reorderBuffer.end(), data );
+        }
+
     private:
 		/**
 		   \brief Holds the data for the attributes
 
 		   \remarks This member is NOT thread safe. 
 		 */
-        Array< T > _data;
+        std::vector< T, AlignedAllocator< T, CRIMILD_SIMD_ALIGNMENT >> _data;
+        crimild::Size _count = 0;
+
+        /**
+           \brief Temporary storage used when reordering elements
+
+           Kept around to avoid allocations on every sort
+         */
+        std::vector< T > _reorderBuffer;
     };
 
     using Vector3fParticleAttribArray = ParticleAttribArrayImpl< Vector3f >;
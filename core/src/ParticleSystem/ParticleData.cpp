@@ -27,10 +27,13 @@
 
 #include "ParticleData.hpp"
 
+#include "Foundation/RadixSort.hpp"
+
 using namespace crimild;
 
 ParticleData::ParticleData( crimild::Size count )
-	: _count( count )
+	: _count( count ),
+	  _hasDeferredKills( false )
 {
 
 }
@@ -55,23 +58,84 @@ void ParticleData::generate( void )
 	// reset alive flags for all particles (all dead)
 	_alive.resize( count );
 	for ( auto i = 0; i < count; i++ ) {
-		_alive[ i ] = false;
+		_alive[ i ] = 0;
 	}
+	_hasDeferredKills = false;
 }
 
 void ParticleData::kill( ParticleId pid )
 {
 	assert( _aliveCount > 0 );
 
-	_alive[ pid ] = false;
+	_alive[ pid ] = 0;
 	swap( pid, --_aliveCount );
 }
 
+void ParticleData::killDeferred( ParticleId pid )
+{
+	assert( pid < _aliveCount );
+
+	_alive[ pid ] = 0;
+	_hasDeferredKills.store( true, std::memory_order_relaxed );
+}
+
+void ParticleData::compact( void )
+{
+	if ( !_hasDeferredKills.exchange( false ) ) {
+		return;
+	}
+
+	const auto count = getAliveCount();
+	const auto chunkSize = static_cast< crimild::Size >( CRIMILD_PARTICLE_CHUNK_SIZE );
+	const auto chunkCount = ( count + chunkSize - 1 ) / chunkSize;
+
+	// count survivors in each chunk
+	_chunkOffsets.resize( chunkCount + 1 );
+	_chunkOffsets[ 0 ] = 0;
+	forEachAliveChunk( [ this, chunkSize ]( crimild::Size begin, crimild::Size end ) {
+		crimild::Size survivors = 0;
+		for ( auto i = begin; i < end; i++ ) {
+			survivors += _alive[ i ];
+		}
+		_chunkOffsets[ begin / chunkSize + 1 ] = survivors;
+	});
+
+	// exclusive scan, so each chunk knows where its survivors go
+	for ( crimild::Size i = 0; i < chunkCount; i++ ) {
+		_chunkOffsets[ i + 1 ] += _chunkOffsets[ i ];
+	}
+
+	const auto survivorCount = _chunkOffsets[ chunkCount ];
+	if ( survivorCount == count ) {
+		return;
+	}
+
+	_permutation.resize( survivorCount );
+	forEachAliveChunk( [ this, chunkSize ]( crimild::Size begin, crimild::Size end ) {
+		auto offset = _chunkOffsets[ begin / chunkSize ];
+		for ( auto i = begin; i < end; i++ ) {
+			if ( _alive[ i ] ) {
+				_permutation[ offset++ ] = i;
+			}
+		}
+	});
+
+	_aliveCount = survivorCount;
+	reorder( _permutation.data() );
+
+	for ( crimild::Size i = 0; i < survivorCount; i++ ) {
+		_alive[ i ] = 1;
+	}
+	for ( auto i = survivorCount; i < count; i++ ) {
+		_alive[ i ] = 0;
+	}
+}
+
 void ParticleData::wake( ParticleId pid )
 {
 	assert( _aliveCount < _count );
 	
-	_alive[ pid ] = true;
+	_alive[ pid ] = 1;
 	swap( pid, _aliveCount++ );
 }
 
@@ -82,7 +146,58 @@ void ParticleData::swap( ParticleId a, ParticleId b )
             attr->swap( a, b );
         });
 
-		std::swap( _alive[ a ], _alive[ b ] );
+		auto tmp = _alive[ a ];
+		_alive[ a ] = _alive[ b ];
+		_alive[ b ] = tmp;
     }
 }
 
+void ParticleData::sort( const crimild::Real32 *keys )
+{
+	const auto count = getAliveCount();
+	if ( count < 2 ) {
+		return;
+	}
+
+	_sortEntries.resize( count );
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		_sortEntries[ i ] = SortEntry { RadixSort::toKey( keys[ i ] ), static_cast< crimild::UInt32 >( i ) };
+	}
+
+	RadixSort::sort( _sortEntries, _sortScratch, []( SortEntry const &entry ) { return entry.key; } );
+
+	_permutation.resize( count );
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		_permutation[ i ] = _sortEntries[ i ].index;
+	}
+
+	reorder( _permutation.data() );
+}
+
+void ParticleData::reorder( const ParticleId *permutation )
+{
+	// only alive particles are affected, so alive flags remain the same
+	const auto count = getAliveCount();
+
+	_attribArrays.clear();
+	_attribs.foreach( [ this ]( const ParticleAttribType &, ParticleAttribArrayPtr &attr, unsigned int ) {
+		if ( attr != nullptr ) {
+			_attribArrays.push_back( crimild::get_ptr( attr ) );
+		}
+	});
+
+	// attribute arrays are independent from each other
+	auto reorderAttrib = [ this, permutation, count ]( crimild::Size i ) {
+		_attribArrays[ i ]->reorder( permutation, count );
+	};
+
+	if ( count >= CRIMILD_PARTICLE_CHUNK_SIZE && concurrency::JobScheduler::hasInstance() && concurrency::JobScheduler::getInstance()->isRunning() ) {
+		concurrency::parallel_for( crimild::Size( 0 ), _attribArrays.size(), crimild::Size( 1 ), reorderAttrib );
+	}
+	else {
+		for ( crimild::Size i = 0; i < _attribArrays.size(); i++ ) {
+			reorderAttrib( i );
+		}
+	}
+}
+
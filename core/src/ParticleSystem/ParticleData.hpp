@@ -30,6 +30,23 @@
 
 #include "ParticleAttribArray.hpp"
 
+#include "Concurrency/Async.hpp"
+#include "Concurrency/JobScheduler.hpp"
+#include "Mathematics/Random.hpp"
+
+#include <atomic>
+#include <vector>
+
+/**
+   \brief Number of particles processed by a single job
+
+   Must be a multiple of CRIMILD_PARTICLE_ATTRIB_PADDING, so chunks
+   start at aligned addresses
+ */
+#ifndef CRIMILD_PARTICLE_CHUNK_SIZE
+#define CRIMILD_PARTICLE_CHUNK_SIZE 4096
+#endif
+
 namespace crimild {
 
 	/**
@@ -62,7 +79,7 @@ namespace crimild {
 
 		inline crimild::Size getAliveCount( void ) const { return _aliveCount; }
 
-		inline crimild::Bool isAlive( ParticleId pid ) { return _alive[ pid ]; }
+		inline crimild::Bool isAlive( ParticleId pid ) { return _alive[ pid ] != 0; }
 
 		/**
 		   \brief Set the array for a particular attribute
@@ -96,6 +113,25 @@ namespace crimild {
 		 */
         void kill( ParticleId pid );
 
+		/**
+		   \brief Flags a particle as dead without moving it
+
+		   The particle is removed from the alive range on the next call
+		   to compact(). Unlike kill(), this method can be invoked from
+		   several threads at once, as long as they work on different
+		   particles.
+		 */
+		void killDeferred( ParticleId pid );
+
+		/**
+		   \brief Removes all particles flagged by killDeferred()
+
+		   Surviving particles keep their relative order, so the result
+		   is the same regardless of how many workers are used. Chunks of
+		   particles are processed in parallel when possible.
+		 */
+		void compact( void );
+
 		/**
 		   \brief Activates a particle
 		 */
@@ -108,6 +144,55 @@ namespace crimild {
 		 */
         void swap( ParticleId a, ParticleId b );
 
+		/**
+		   \brief Sorts alive particles in ascending key order
+
+		   \param keys One key per alive particle
+
+		   Keys are sorted together with particle indices using a radix
+		   sort and then all attribute arrays are rearranged with a single
+		   gather pass. This is much faster than swapping particles around,
+		   since every swap touches each attribute array. The sort is stable.
+		 */
+		void sort( const crimild::Real32 *keys );
+
+		/**
+		   \brief Rearranges alive particles
+
+		   After this call, the alive particle at index i is the one that
+		   was previously stored at permutation[ i ]
+		 */
+		void reorder( const ParticleId *permutation );
+
+		/**
+		   \brief Invokes fn( begin, end ) for consecutive chunks of alive particles
+
+		   Chunks are at most CRIMILD_PARTICLE_CHUNK_SIZE particles long and
+		   they are processed in parallel if the job scheduler is running.
+		   Blocks until all chunks are done.
+		 */
+		template< typename Fn >
+		void forEachAliveChunk( Fn const &fn )
+		{
+			const auto count = getAliveCount();
+			const auto chunkSize = static_cast< crimild::Size >( CRIMILD_PARTICLE_CHUNK_SIZE );
+			const auto chunkCount = ( count + chunkSize - 1 ) / chunkSize;
+
+			auto processChunk = [ &fn, count, chunkSize ]( crimild::Size chunk ) {
+				const auto begin = chunk * chunkSize;
+				fn( begin, std::min( begin + chunkSize, count ) );
+			};
+
+			if ( chunkCount > 1 && concurrency::JobScheduler::hasInstance() && concurrency::JobScheduler::getInstance()->isRunning() ) {
+				concurrency::parallel_for( crimild::Size( 0 ), chunkCount, crimild::Size( 1 ), processChunk );
+			}
+			else {
+				for ( crimild::Size chunk = 0; chunk < chunkCount; chunk++ ) {
+					processChunk( chunk );
+				}
+			}
+		}
+
 		inline void setComputeInWorldSpace( crimild::Bool value ) { _computeInWorldSpace = value; }
 		inline crimild::Bool shouldComputeInWorldSpace( void ) const { return _computeInWorldSpace; }
 
@@ -117,10 +202,65 @@ namespace crimild {
         crimild::Size _count = 0;
         crimild::Size _aliveCount = 0;
 		
-		std::vector< crimild::Bool > _alive; // replace this for a custom array
+		/**
+		   \brief Alive flags for all particles
+
+		   Bytes are used instead of std::vector< bool > so flags for different
+		   particles can be written concurrently
+		 */
+		std::vector< crimild::UInt8 > _alive;
+		std::atomic< crimild::Bool > _hasDeferredKills;
 
 		crimild::Bool _computeInWorldSpace = false;
 
+		/**
+		   \name Random numbers
+		 */
+		//@{
+
+	public:
+		/**
+		   \brief Random number stream used by all generators of this emitter
+
+		   Each emitter has its own generator, so emitters updated in
+		   different workers do not share state. Use seed() to get the
+		   same particles on every run.
+		 */
+		inline Random::Generator &getRandom( void ) { return _random; }
+
+	private:
+		Random::Generator _random;
+
+		//@}
+
+		/**
+		   \name Sorting
+
+		   Buffers are kept around to avoid allocations on every frame
+		 */
+		//@{
+
+		struct SortEntry {
+			crimild::UInt32 key;
+			crimild::UInt32 index;
+		};
+
+		std::vector< SortEntry > _sortEntries;
+		std::vector< SortEntry > _sortScratch;
+		std::vector< ParticleId > _permutation;
+
+		/**
+		   \brief Number of survivors before each chunk, used for compaction
+		 */
+		std::vector< crimild::Size > _chunkOffsets;
+
+		/**
+		   \brief Attribute arrays, so they can be reordered in parallel
+		 */
+		std::vector< ParticleAttribArray * > _attribArrays;
+
+		//@}
+
 	public:
 		/**
 		   \brief Get the raw data for an attribute
@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ParticleKernels.hpp"
+
+#include "Mathematics/SIMD.hpp"
+
+#include <cmath>
+
+#ifdef CRIMILD_SIMD_X86
+#include <immintrin.h>
+#endif
+
+using namespace crimild;
+
+static_assert( sizeof( Vector3f ) == 3 * sizeof( crimild::Real32 ), "Vector3f must be tightly packed" );
+static_assert( sizeof( RGBAColorf ) == 4 * sizeof( crimild::Real32 ), "RGBAColorf must be tightly packed" );
+
+namespace crimild {
+
+	namespace kernels {
+
+		static inline crimild::Real32 *flat( Vector3f *v ) { return reinterpret_cast< crimild::Real32 * >( v ); }
+		static inline const crimild::Real32 *flat( const Vector3f *v ) { return reinterpret_cast< const crimild::Real32 * >( v ); }
+		static inline crimild::Real32 *flat( RGBAColorf *v ) { return reinterpret_cast< crimild::Real32 * >( v ); }
+		static inline const crimild::Real32 *flat( const RGBAColorf *v ) { return reinterpret_cast< const crimild::Real32 * >( v ); }
+
+		/**
+		   \name Scalar
+		 */
+		//@{
+
+		static void addScaledScalar( crimild::Real32 *dst, const crimild::Real32 *src, crimild::Real32 scale, crimild::Size begin, crimild::Size end )
+		{
+			for ( auto i = begin; i < end; i++ ) {
+				dst[ i ] += scale * src[ i ];
+			}
+		}
+
+		static void addScalar( crimild::Real32 *dst, crimild::Real32 value, crimild::Size begin, crimild::Size end )
+		{
+			for ( auto i = begin; i < end; i++ ) {
+				dst[ i ] += value;
+			}
+		}
+
+		static void addScalar( Vector3f *dst, const Vector3f &value, crimild::Size begin, crimild::Size end )
+		{
+			for ( auto i = begin; i < end; i++ ) {
+				dst[ i ] += value;
+			}
+		}
+
+		static void attractScalar( const Vector3f *ps, Vector3f *as, const Vector3f &center, crimild::Real32 radius, crimild::Real32 scale, crimild::Size begin, crimild::Size end )
+		{
+			for ( auto i = begin; i < end; i++ ) {
+				const auto direction = center - ps[ i ];
+				const auto d = direction.getMagnitude();
+				if ( d > 0.0f && d <= radius ) {
+					as[ i ] += ( scale * ( 1.0f - d / radius ) / d ) * direction;
+				}
+			}
+		}
+
+		static void interpolateColorsScalar( RGBAColorf *cs, const RGBAColorf *s0, const RGBAColorf *s1, const crimild::Real32 *ts, const crimild::Real32 *ls, crimild::Size begin, crimild::Size end )
+		{
+			for ( auto i = begin; i < end; i++ ) {
+				const auto t = 1.0f - ( ts[ i ] / ls[ i ] );
+				cs[ i ] = s0[ i ] + t * ( s1[ i ] - s0[ i ] );
+			}
+		}
+
+		//@}
+
+#ifdef CRIMILD_SIMD_X86
+
+		/**
+		   \name SSE
+		 */
+		//@{
+
+		CRIMILD_SIMD_TARGET_SSE
+		static crimild::Size addScaledSSE( crimild::Real32 *dst, const crimild::Real32 *src, crimild::Real32 scale, crimild::Size count )
+		{
+			const auto s = _mm_set1_ps( scale );
+			crimild::Size i = 0;
+			for ( ; i + 4 <= count; i += 4 ) {
+				_mm_storeu_ps( dst + i, _mm_add_ps( _mm_loadu_ps( dst + i ), _mm_mul_ps( s, _mm_loadu_ps( src + i ) ) ) );
+			}
+			return i;
+		}
+
+		CRIMILD_SIMD_TARGET_SSE
+		static crimild::Size addSSE( crimild::Real32 *dst, crimild::Real32 value, crimild::Size count )
+		{
+			const auto v = _mm_set1_ps( value );
+			crimild::Size i = 0;
+			for ( ; i + 4 <= count; i += 4 ) {
+				_mm_storeu_ps( dst + i, _mm_add_ps( _mm_loadu_ps( dst + i ), v ) );
+			}
+			return i;
+		}
+
+		/**
+		   \brief Returns the number of processed vectors
+		 */
+		CRIMILD_SIMD_TARGET_SSE
+		static crimild::Size addSSE( Vector3f *dst, const Vector3f &value, crimild::Size count )
+		{
+			// 4 vectors fit exactly in 3 registers
+			const auto x = value[ 0 ];
+			const auto y = value[ 1 ];
+			const auto z = value[ 2 ];
+			const auto v0 = _mm_setr_ps( x, y, z, x );
+			const auto v1 = _mm_setr_ps( y, z, x, y );
+			const auto v2 = _mm_setr_ps( z, x, y, z );
+
+			auto data = flat( dst );
+			crimild::Size i = 0;
+			for ( ; i + 4 <= count; i += 4 ) {
+				auto p = data + 3 * i;
+				_mm_storeu_ps( p + 0, _mm_add_ps( _mm_loadu_ps( p + 0 ), v0 ) );
+				_mm_storeu_ps( p + 4, _mm_add_ps( _mm_loadu_ps( p + 4 ), v1 ) );
+				_mm_storeu_ps( p + 8, _mm_add_ps( _mm_loadu_ps( p + 8 ), v2 ) );
+			}
+			return i;
+		}
+
+		CRIMILD_SIMD_TARGET_SSE
+		static crimild::Size attractSSE( const Vector3f *ps, Vector3f *as, const Vector3f &center, crimild::Real32 radius, crimild::Real32 scale, crimild::Size count )
+		{
+			const auto cx = _mm_set1_ps( center[ 0 ] );
+			const auto cy = _mm_set1_ps( center[ 1 ] );
+			const auto cz = _mm_set1_ps( center[ 2 ] );
+			const auto r = _mm_set1_ps( radius );
+			const auto s = _mm_set1_ps( scale );
+			const auto zero = _mm_setzero_ps();
+			const auto one = _mm_set1_ps( 1.0f );
+
+			auto src = flat( ps );
+			auto dst = flat( as );
+
+			crimild::Size i = 0;
+			for ( ; i + 4 <= count; i += 4 ) {
+				// load 4 positions and transpose them (AoS to SoA)
+				const auto a = _mm_loadu_ps( src + 3 * i + 0 ); // x0 y0 z0 x1
+				const auto b = _mm_loadu_ps( src + 3 * i + 4 ); // y1 z1 x2 y2
+				const auto c = _mm_loadu_ps( src + 3 * i + 8 ); // z2 x3 y3 z3
+
+				const auto px = _mm_shuffle_ps( a, _mm_shuffle_ps( b, c, _MM_SHUFFLE( 1, 1, 2, 2 ) ), _MM_SHUFFLE( 2, 0, 3, 0 ) );
+				const auto py = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 0, 0, 1, 1 ) ), _mm_shuffle_ps( b, c, _MM_SHUFFLE( 2, 2, 3, 3 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+				const auto pz = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 1, 1, 2, 2 ) ), c, _MM_SHUFFLE( 3, 0, 2, 0 ) );
+
+				const auto dx = _mm_sub_ps( cx, px );
+				const auto dy = _mm_sub_ps( cy, py );
+				const auto dz = _mm_sub_ps( cz, pz );
+				const auto d = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) ) );
+
+				// particles outside the radius (or at the center) are not affected
+				const auto mask = _mm_and_ps( _mm_cmpgt_ps( d, zero ), _mm_cmple_ps( d, r ) );
+				const auto f = _mm_and_ps( mask, _mm_div_ps( _mm_mul_ps( s, _mm_sub_ps( one, _mm_div_ps( d, r ) ) ), d ) );
+
+				const auto fx = _mm_mul_ps( f, dx );
+				const auto fy = _mm_mul_ps( f, dy );
+				const auto fz = _mm_mul_ps( f, dz );
+
+				// back to AoS
+				const auto oa = _mm_shuffle_ps( _mm_shuffle_ps( fx, fy, _MM_SHUFFLE( 0, 0, 0, 0 ) ), _mm_shuffle_ps( fz, fx, _MM_SHUFFLE( 1, 1, 0, 0 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+				const auto ob = _mm_shuffle_ps( _mm_shuffle_ps( fy, fz, _MM_SHUFFLE( 1, 1, 1, 1 ) ), _mm_shuffle_ps( fx, fy, _MM_SHUFFLE( 2, 2, 2, 2 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+				const auto oc = _mm_shuffle_ps( _mm_shuffle_ps( fz, fx, _MM_SHUFFLE( 3, 3, 2, 2 ) ), _mm_shuffle_ps( fy, fz, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+
+				auto p = dst + 3 * i;
+				_mm_storeu_ps( p + 0, _mm_add_ps( _mm_loadu_ps( p + 0 ), oa ) );
+				_mm_storeu_ps( p + 4, _mm_add_ps( _mm_loadu_ps( p + 4 ), ob ) );
+				_mm_storeu_ps( p + 8, _mm_add_ps( _mm_loadu_ps( p + 8 ), oc ) );
+			}
+			return i;
+		}
+
+		CRIMILD_SIMD_TARGET_SSE
+		static crimild::Size interpolateColorsSSE( RGBAColorf *cs, const RGBAColorf *s0, const RGBAColorf *s1, const crimild::Real32 *ts, const crimild::Real32 *ls, crimild::Size count )
+		{
+			const auto one = _mm_set1_ps( 1.0f );
+
+			auto dst = flat( cs );
+			auto from = flat( s0 );
+			auto to = flat( s1 );
+
+			crimild::Size i = 0;
+			for ( ; i + 4 <= count; i += 4 ) {
+				// compute 4 interpolation factors at once
+				float t[ 4 ];
+				_mm_storeu_ps( t, _mm_sub_ps( one, _mm_div_ps( _mm_loadu_ps( ts + i ), _mm_loadu_ps( ls + i ) ) ) );
+
+				// one color per register
+				for ( crimild::Size j = 0; j < 4; j++ ) {
+					const auto k = 4 * ( i + j );
+					const auto a = _mm_loadu_ps( from + k );
+					const auto b = _mm_loadu_ps( to + k );
+					_mm_storeu_ps( dst + k, _mm_add_ps( a, _mm_mul_ps( _mm_set1_ps( t[ j ] ), _mm_sub_ps( b, a ) ) ) );
+				}
+			}
+			return i;
+		}
+
+		//@}
+
+		/**
+		   \name AVX
+		 */
+		//@{
+
+		CRIMILD_SIMD_TARGET_AVX
+		static crimild::Size addScaledAVX( crimild::Real32 *dst, const crimild::Real32 *src, crimild::Real32 scale, crimild::Size count )
+		{
+			const auto s = _mm256_set1_ps( scale );
+			crimild::Size i = 0;
+			for ( ; i + 8 <= count; i += 8 ) {
+				_mm256_storeu_ps( dst + i, _mm256_add_ps( _mm256_loadu_ps( dst + i ), _mm256_mul_ps( s, _mm256_loadu_ps( src + i ) ) ) );
+			}
+			return i;
+		}
+
+		CRIMILD_SIMD_TARGET_AVX
+		static crimild::Size addAVX( crimild::Real32 *dst, crimild::Real32 value, crimild::Size count )
+		{
+			const auto v = _mm256_set1_ps( value );
+			crimild::Size i = 0;
+			for ( ; i + 8 <= count; i += 8 ) {
+				_mm256_storeu_ps( dst + i, _mm256_add_ps( _mm256_loadu_ps( dst + i ), v ) );
+			}
+			return i;
+		}
+
+		CRIMILD_SIMD_TARGET_AVX
+		static crimild::Size addAVX( Vector3f *dst, const Vector3f &value, crimild::Size count )
+		{
+			// 8 vectors fit exactly in 3 registers
+			const auto x = value[ 0 ];
+			const auto y = value[ 1 ];
+			const auto z = value[ 2 ];
+			const auto v0 = _mm256_setr_ps( x, y, z, x, y, z, x, y );
+			const auto v1 = _mm256_setr_ps( z, x, y, z, x, y, z, x );
+			const auto v2 = _mm256_setr_ps( y, z, x, y, z, x, y, z );
+
+			auto data = flat( dst );
+			crimild::Size i = 0;
+			for ( ; i + 8 <= count; i += 8 ) {
+				auto p = data + 3 * i;
+				_mm256_storeu_ps( p + 0, _mm256_add_ps( _mm256_loadu_ps( p + 0 ), v0 ) );
+				_mm256_storeu_ps( p + 8, _mm256_add_ps( _mm256_loadu_ps( p + 8 ), v1 ) );
+				_mm256_storeu_ps( p + 16, _mm256_add_ps( _mm256_loadu_ps( p + 16 ), v2 ) );
+			}
+			return i;
+		}
+
+		CRIMILD_SIMD_TARGET_AVX
+		static crimild::Size interpolateColorsAVX( RGBAColorf *cs, const RGBAColorf *s0, const RGBAColorf *s1, const crimild::Real32 *ts, const crimild::Real32 *ls, crimild::Size count )
+		{
+			const auto one = _mm256_set1_ps( 1.0f );
+
+			auto dst = flat( cs );
+			auto from = flat( s0 );
+			auto to = flat( s1 );
+
+			crimild::Size i = 0;
+			for ( ; i + 8 <= count; i += 8 ) {
+				// compute 8 interpolation factors at once
+				float t[ 8 ];
+				_mm256_storeu_ps( t, _mm256_sub_ps( one, _mm256_div_ps( _mm256_loadu_ps( ts + i ), _mm256_loadu_ps( ls + i ) ) ) );
+
+				// two colors per register
+				for ( crimild::Size j = 0; j < 8; j += 2 ) {
+					const auto k = 4 * ( i + j );
+					const auto a = _mm256_loadu_ps( from + k );
+					const auto b = _mm256_loadu_ps( to + k );
+					const auto f = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_set1_ps( t[ j ] ) ), _mm_set1_ps( t[ j + 1 ] ), 1 );
+					_mm256_storeu_ps( dst + k, _mm256_add_ps( a, _mm256_mul_ps( f, _mm256_sub_ps( b, a ) ) ) );
+				}
+			}
+			return i;
+		}
+
+		//@}
+
+#endif
+
+	}
+
+}
+
+using namespace crimild::kernels;
+
+void ParticleKernels::addScaled( Vector3f *dst, const Vector3f *src, crimild::Real32 scale, crimild::Size count )
+{
+	// component-wise, so vectors are handled as a flat array of floats
+	const auto n = 3 * count;
+	crimild::Size processed = 0;
+
+#ifdef CRIMILD_SIMD_X86
+	switch ( simd::getInstructionSet() ) {
+		case simd::InstructionSet::AVX:
+			processed = addScaledAVX( flat( dst ), flat( src ), scale, n );
+			break;
+		case simd::InstructionSet::SSE:
+			processed = addScaledSSE( flat( dst ), flat( src ), scale, n );
+			break;
+		default:
+			break;
+	}
+#endif
+
+	addScaledScalar( flat( dst ), flat( src ), scale, processed, n );
+}
+
+void ParticleKernels::add( Vector3f *dst, const Vector3f &value, crimild::Size count )
+{
+	crimild::Size processed = 0;
+
+#ifdef CRIMILD_SIMD_X86
+	switch ( simd::getInstructionSet() ) {
+		case simd::InstructionSet::AVX:
+			processed = addAVX( dst, value, count );
+			break;
+		case simd::InstructionSet::SSE:
+			processed = addSSE( dst, value, count );
+			break;
+		default:
+			break;
+	}
+#endif
+
+	addScalar( dst, value, processed, count );
+}
+
+void ParticleKernels::add( crimild::Real32 *dst, crimild::Real32 value, crimild::Size count )
+{
+	crimild::Size processed = 0;
+
+#ifdef CRIMILD_SIMD_X86
+	switch ( simd::getInstructionSet() ) {
+		case simd::InstructionSet::AVX:
+			processed = addAVX( dst, value, count );
+			break;
+		case simd::InstructionSet::SSE:
+			processed = addSSE( dst, value, count );
+			break;
+		default:
+			break;
+	}
+#endif
+
+	addScalar( dst, value, processed, count );
+}
+
+void ParticleKernels::attract( const Vector3f *positions, Vector3f *accelerations, const Vector3f &center, crimild::Real32 radius, crimild::Real32 scale, crimild::Size count )
+{
+	crimild::Size processed = 0;
+
+#ifdef CRIMILD_SIMD_X86
+	// the SSE kernel is used for AVX too, since transposing 8 vectors
+	// at once costs more than what we gain from wider registers
+	if ( simd::getInstructionSet() != simd::InstructionSet::SCALAR ) {
+		processed = attractSSE( positions, accelerations, center, radius, scale, count );
+	}
+#endif
+
+	attractScalar( positions, accelerations, center, radius, scale, processed, count );
+}
+
+void ParticleKernels::interpolateColors( RGBAColorf *colors, const RGBAColorf *start, const RGBAColorf *end, const crimild::Real32 *times, const crimild::Real32 *lifetimes, crimild::Size count )
+{
+	crimild::Size processed = 0;
+
+#ifdef CRIMILD_SIMD_X86
+	switch ( simd::getInstructionSet() ) {
+		case simd::InstructionSet::AVX:
+			processed = interpolateColorsAVX( colors, start, end, times, lifetimes, count );
+			break;
+		case simd::InstructionSet::SSE:
+			processed = interpolateColorsSSE( colors, start, end, times, lifetimes, count );
+			break;
+		default:
+			break;
+	}
+#endif
+
+	interpolateColorsScalar( colors, start, end, times, lifetimes, processed, count );
+}
+
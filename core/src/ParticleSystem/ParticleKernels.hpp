@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_PARTICLE_SYSTEM_KERNELS_
+#define CRIMILD_PARTICLE_SYSTEM_KERNELS_
+
+#include "Foundation/Types.hpp"
+#include "Mathematics/Vector.hpp"
+
+namespace crimild {
+
+	/**
+	   \brief Vectorized operations over particle attribute arrays
+
+	   Each kernel has scalar, SSE and AVX implementations. The one to
+	   use is chosen at runtime based on simd::getInstructionSet().
+
+	   Vector attributes are stored as contiguous arrays of floats, so
+	   component-wise operations process them as flat streams without
+	   any layout change.
+	 */
+	class ParticleKernels {
+	public:
+		/**
+		   \brief dst[ i ] += scale * src[ i ]
+		 */
+		static void addScaled( Vector3f *dst, const Vector3f *src, crimild::Real32 scale, crimild::Size count );
+
+		/**
+		   \brief dst[ i ] += value
+		 */
+		static void add( Vector3f *dst, const Vector3f &value, crimild::Size count );
+
+		/**
+		   \brief dst[ i ] += value
+		 */
+		static void add( crimild::Real32 *dst, crimild::Real32 value, crimild::Size count );
+
+		/**
+		   \brief Accelerates particles towards a center
+
+		   Only particles inside the radius are affected, proportionally
+		   to their distance to the center:
+
+		   accelerations[ i ] += scale * ( 1 - d / radius ) * direction
+		 */
+		static void attract( const Vector3f *positions, Vector3f *accelerations, const Vector3f &center, crimild::Real32 radius, crimild::Real32 scale, crimild::Size count );
+
+		/**
+		   \brief Interpolates colors based on the remaining life of each particle
+
+		   colors[ i ] = lerp( start[ i ], end[ i ], 1 - times[ i ] / lifetimes[ i ] )
+		 */
+		static void interpolateColors( RGBAColorf *colors, const RGBAColorf *start, const RGBAColorf *end, const crimild::Real32 *times, const crimild::Real32 *lifetimes, crimild::Size count );
+	};
+
+}
+
+#endif
+
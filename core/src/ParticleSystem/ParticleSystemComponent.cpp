@@ -127,11 +127,37 @@ void ParticleSystemComponent::updateGenerators( Node *node, crimild::Real64 dt,
 void ParticleSystemComponent::updateUpdaters( Node *node, crimild::Real64 dt, ParticleData *particles )
 {
 	const auto uCount = _updaters.getCount();
-	for ( int i = 0; i < uCount; i++ ) {
-		_updaters[ i ]->update( node, dt, particles );
+	crimild::Size i = 0;
+	while ( i < uCount ) {
+		auto updater = crimild::get_ptr( _updaters[ i++ ] );
+		if ( !updater->isDataParallel() ) {
+			updater->update( node, dt, particles );
+			continue;
+		}
+
+		// group consecutive data-parallel updaters
+		_dataParallelUpdaters.clear();
+		_dataParallelUpdaters.push_back( updater );
+		while ( i < uCount && _updaters[ i ]->isDataParallel() ) {
+			_dataParallelUpdaters.push_back( crimild::get_ptr( _updaters[ i++ ] ) );
+		}
+
+		updateDataParallelUpdaters( node, dt, particles, _dataParallelUpdaters.data(), _dataParallelUpdaters.size() );
+
+		// remove particles killed by any of the updaters
+		particles->compact();
 	}
 }
 
+void ParticleSystemComponent::updateDataParallelUpdaters( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleUpdater *const *updaters, crimild::Size count )
+{
+	particles->forEachAliveChunk( [ node, dt, particles, updaters, count ]( ParticleId begin, ParticleId end ) {
+		for ( crimild::Size i = 0; i < count; i++ ) {
+			updaters[ i ]->updateRange( node, dt, particles, begin, end );
+		}
+	});
+}
+
 void ParticleSystemComponent::updateRenderers( Node *node, crimild::Real64 dt, ParticleData *particles )
 {
 	const auto rCount = _renderers.getCount();
@@ -151,10 +151,50 @@ namespace crimild {
 
 			virtual void configure( Node *node, ParticleData *particles ) = 0;
             virtual void update( Node *node, crimild::Real64 dt, ParticleData *particles ) = 0;
+
+			/**
+			   \brief Indicates if each particle can be updated independently
+
+			   If true, the particle system splits alive particles in chunks
+			   and invokes updateRange() for them in parallel instead of
+			   calling update()
+
+			   \see DataParallelParticleUpdater
+			 */
+			virtual crimild::Bool isDataParallel( void ) const { return false; }
+
+			/**
+			   \brief Updates alive particles in the range [begin, end)
+
+			   Only invoked for data-parallel updaters
+			 */
+			virtual void updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end ) { }
         };
 
         using ParticleUpdaterPtr =  SharedPointer< ParticleUpdater >;
 
+		/**
+		   \brief Base class for updaters processing each particle independently
+
+		   Implementations must only access data for particles in the given
+		   range. Particles cannot be killed directly, since that moves other
+		   particles around. Use ParticleData::killDeferred() instead.
+		 */
+		class DataParallelParticleUpdater : public ParticleUpdater {
+		public:
+			virtual ~DataParallelParticleUpdater( void ) { }
+
+			virtual void update( Node *node, crimild::Real64 dt, ParticleData *particles ) override
+			{
+				updateRange( node, dt, particles, 0, particles->getAliveCount() );
+				particles->compact();
+			}
+
+			virtual crimild::Bool isDataParallel( void ) const override { return true; }
+
+			virtual void updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end ) override = 0;
+		};
+
         inline void addUpdater( ParticleUpdaterPtr const &updater )
 		{
 			_updaters.add( updater );
@@ -163,9 +203,18 @@ namespace crimild {
 	private:
 		void configureUpdaters( Node *node, ParticleData *particles );
 		void updateUpdaters( Node *node, crimild::Real64 dt, ParticleData *particles );
+
+		/**
+		   \brief Runs consecutive data-parallel updaters over chunks of particles
+
+		   Each chunk goes through all updaters before moving to the next
+		   one, while its data is still in cache
+		 */
+		void updateDataParallelUpdaters( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleUpdater *const *updaters, crimild::Size count );
 		
     private:
         ThreadSafeArray< ParticleUpdaterPtr > _updaters;
+		std::vector< ParticleUpdater * > _dataParallelUpdaters;
 
 		//@}
 
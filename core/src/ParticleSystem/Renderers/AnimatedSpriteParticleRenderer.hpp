@@ -29,6 +29,7 @@
 #define CRIMILD_PARTICLE_RENDERER_ANIMATED_SPRITE_
 
 #include "../ParticleSystemComponent.hpp"
+#include "ParticleVertexStream.hpp"
 
 #include "Rendering/Material.hpp"
 
@@ -56,6 +57,7 @@ namespace crimild {
 	private:
 		MaterialPtr _material;
 		PrimitivePtr _primitive;
+		ParticleVertexStreamPtr _vertexStream;
 		GeometryPtr _geometry;
 		Vector2f _spriteSheetSize;
 
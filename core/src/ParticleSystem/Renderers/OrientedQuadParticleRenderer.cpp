@@ -35,8 +35,6 @@
 
 #include "SceneGraph/Camera.hpp"
 
-#include "Concurrency/Async.hpp"
-
 using namespace crimild;
 
 OrientedQuadParticleRenderer::OrientedQuadParticleRenderer( void )
@@ -67,18 +65,20 @@ void OrientedQuadParticleRenderer::configure( Node *node, ParticleData *particle
 
     _primitive = crimild::alloc< Primitive >( Primitive::Type::TRIANGLES );
 
+	// two triangles per particle
+	_vertexStream = crimild::alloc< ParticleVertexStream >( VertexFormat::VF_P3_UV2, 4, std::vector< IndexPrecision > { 0, 1, 2, 0, 2, 3 } );
+
 	_geometry->attachPrimitive( _primitive );
 }
 
 void OrientedQuadParticleRenderer::update( Node *node, crimild::Real64 dt, ParticleData *particles )
 {
-    const auto pCount = particles->getAliveCount();
-    if ( pCount == 0 ) {
+    if ( particles->getAliveCount() == 0 ) {
         return;
     }
-    
-    auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_UV2, 4 * pCount );
-	auto ibo = crimild::alloc< IndexBufferObject >( 6 * pCount );
+
+    auto vbo = _vertexStream->beginFrame( particles->getAliveCount() );
+    const auto pCount = _vertexStream->getParticleCount();
 
 	const auto camera = Camera::getMainCamera();
 	auto cameraUp = camera->getWorld().computeUp();
@@ -126,21 +126,6 @@ void OrientedQuadParticleRenderer::update( Node *node, crimild::Real64 dt, Parti
 		vbo->setTextureCoordAt( idx + 3, uv3 );
 	}
 
-	for ( auto i = 0; i < pCount; i++ ) {
-		const auto idx = i * 6;
-		const auto vdx = i * 4;
-		ibo->setIndexAt( idx + 0, vdx + 0 );
-		ibo->setIndexAt( idx + 1, vdx + 1 );
-		ibo->setIndexAt( idx + 2, vdx + 2 );
-		ibo->setIndexAt( idx + 3, vdx + 0 );
-		ibo->setIndexAt( idx + 4, vdx + 2 );
-		ibo->setIndexAt( idx + 5, vdx + 3 );
-	}
-
-    crimild::concurrency::sync_frame( [this, vbo, ibo] {
-        _primitive->setVertexBuffer( vbo );
-        _primitive->setIndexBuffer( ibo );
-    });
+	_vertexStream->endFrame( _primitive );
 }
 
-
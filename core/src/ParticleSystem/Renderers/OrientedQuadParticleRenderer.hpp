@@ -29,6 +29,7 @@
 #define CRIMILD_PARTICLE_RENDERER_ORIENTED_QUAD_
 
 #include "../ParticleSystemComponent.hpp"
+#include "ParticleVertexStream.hpp"
 
 #include "Rendering/Material.hpp"
 
@@ -50,6 +51,7 @@ namespace crimild {
 	private:
 		MaterialPtr _material;
 		PrimitivePtr _primitive;
+		ParticleVertexStreamPtr _vertexStream;
 		GeometryPtr _geometry;
 		
 		ParticleAttribArray *_positions = nullptr;
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ParticleVertexStream.hpp"
+
+#include "Concurrency/Async.hpp"
+#include "Concurrency/JobScheduler.hpp"
+
+#include <limits>
+
+using namespace crimild;
+
+ParticleVertexStream::ParticleVertexStream( const VertexFormat &format, crimild::Size verticesPerParticle, std::vector< IndexPrecision > const &indexPattern )
+	: _format( format ),
+	  _verticesPerParticle( verticesPerParticle ),
+	  _indexPattern( indexPattern )
+{
+	assert( _verticesPerParticle > 0 );
+}
+
+ParticleVertexStream::~ParticleVertexStream( void )
+{
+
+}
+
+crimild::Size ParticleVertexStream::getMaxParticleCount( void ) const
+{
+	const auto maxVertexCount = static_cast< crimild::Size >( std::numeric_limits< IndexPrecision >::max() ) + 1;
+	return maxVertexCount / _verticesPerParticle;
+}
+
+VertexBufferObject *ParticleVertexStream::beginFrame( crimild::Size particleCount )
+{
+	_particleCount = std::min( particleCount, getMaxParticleCount() );
+	if ( _particleCount > _capacity ) {
+		grow( _particleCount );
+	}
+
+	_currentVertexBuffer = ( _currentVertexBuffer + 1 ) % CRIMILD_PARTICLE_VERTEX_STREAM_RING_SIZE;
+
+	auto &vbo = _vertexBuffers[ _currentVertexBuffer ];
+	if ( vbo == nullptr || vbo->getVertexCount() < _capacity * _verticesPerParticle ) {
+		// previous buffer (if any) is released once the renderer is done with it
+		vbo = crimild::alloc< VertexBufferObject >( _format, _capacity * _verticesPerParticle );
+		vbo->setUsage( VertexBufferObject::Usage::STREAM );
+		++_bufferAllocationCount;
+	}
+
+	return crimild::get_ptr( vbo );
+}
+
+void ParticleVertexStream::endFrame( SharedPointer< Primitive > const &primitive )
+{
+	auto vbo = _vertexBuffers[ _currentVertexBuffer ];
+	auto ibo = _indexBuffer;
+
+	// only vertices for alive particles need to be uploaded
+	const auto valueCount = _particleCount * _verticesPerParticle * _format.getVertexSize();
+	vbo->setUsedCount( valueCount );
+	vbo->markDirty( 0, valueCount );
+
+	const auto indexCount = _particleCount * _indexPattern.size();
+
+	auto assignBuffers = [ primitive, vbo, ibo, indexCount ] {
+		ibo->setUsedCount( indexCount );
+		primitive->setVertexBuffer( vbo );
+		primitive->setIndexBuffer( ibo );
+	};
+
+	if ( concurrency::JobScheduler::hasInstance() && concurrency::JobScheduler::getInstance()->isRunning() ) {
+		crimild::concurrency::sync_frame( assignBuffers );
+	}
+	else {
+		assignBuffers();
+	}
+}
+
+void ParticleVertexStream::grow( crimild::Size particleCount )
+{
+	// grow geometrically to avoid reallocating buffers on every new particle
+	_capacity = std::min( std::max( particleCount, 2 * _capacity ), getMaxParticleCount() );
+
+	const auto patternSize = _indexPattern.size();
+	_indexBuffer = crimild::alloc< IndexBufferObject >( _capacity * patternSize );
+	auto indices = _indexBuffer->data();
+	for ( crimild::Size i = 0; i < _capacity; i++ ) {
+		const auto base = static_cast< IndexPrecision >( i * _verticesPerParticle );
+		for ( crimild::Size j = 0; j < patternSize; j++ ) {
+			indices[ i * patternSize + j ] = base + _indexPattern[ j ];
+		}
+	}
+	++_bufferAllocationCount;
+}
+
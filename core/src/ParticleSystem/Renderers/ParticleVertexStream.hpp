@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_PARTICLE_RENDERER_VERTEX_STREAM_
+#define CRIMILD_PARTICLE_RENDERER_VERTEX_STREAM_
+
+#include "Foundation/SharedObject.hpp"
+#include "Rendering/VertexBufferObject.hpp"
+#include "Rendering/IndexBufferObject.hpp"
+#include "Primitives/Primitive.hpp"
+
+#include <vector>
+
+/**
+   \brief Number of vertex buffers used by each stream
+
+   The simulation writes vertices for the next frame while the renderer
+   may still be uploading the previous ones, so buffers are rotated.
+ */
+#ifndef CRIMILD_PARTICLE_VERTEX_STREAM_RING_SIZE
+#define CRIMILD_PARTICLE_VERTEX_STREAM_RING_SIZE 3
+#endif
+
+namespace crimild {
+
+	/**
+	   \brief Persistent vertex storage for particle renderers
+
+	   Instead of creating new buffers every frame, a ring of vertex
+	   buffers is reused and only grows when the number of particles
+	   exceeds the current capacity. The index buffer only depends on
+	   the capacity, so it is built once every time the stream grows.
+
+	   Usage:
+	   \code
+	   auto vbo = stream->beginFrame( particles->getAliveCount() );
+	   for ( auto i = 0; i < stream->getParticleCount(); i++ ) {
+	       // fill vertices for particle i
+	   }
+	   stream->endFrame( primitive );
+	   \endcode
+	 */
+	class ParticleVertexStream : public SharedObject {
+	public:
+		/**
+		   \param indexPattern Indices for the first particle, relative to
+		   its first vertex. They are repeated for every other particle.
+		 */
+		ParticleVertexStream( const VertexFormat &format, crimild::Size verticesPerParticle, std::vector< IndexPrecision > const &indexPattern );
+		virtual ~ParticleVertexStream( void );
+
+		inline const VertexFormat &getVertexFormat( void ) const { return _format; }
+
+		/**
+		   \brief Max number of particles that can be rendered
+
+		   Limited by the precision of indices
+		 */
+		crimild::Size getMaxParticleCount( void ) const;
+
+		/**
+		   \brief Number of particles that fit in the current buffers
+		 */
+		inline crimild::Size getCapacity( void ) const { return _capacity; }
+
+		/**
+		   \brief Number of vertex and index buffers created so far
+
+		   Once the stream reaches its working capacity, this value
+		   does not change anymore
+		 */
+		inline crimild::Size getBufferAllocationCount( void ) const { return _bufferAllocationCount; }
+
+		/**
+		   \brief Gets the vertex buffer to be filled in this frame
+
+		   Buffers are created or grown if needed. Only the first
+		   getParticleCount() particles are rendered.
+		 */
+		VertexBufferObject *beginFrame( crimild::Size particleCount );
+
+		/**
+		   \brief Number of particles to be rendered in the current frame
+		 */
+		inline crimild::Size getParticleCount( void ) const { return _particleCount; }
+
+		/**
+		   \brief Flags modified vertices and hands buffers to the primitive
+
+		   Buffers are assigned during the next frame sync if the job
+		   scheduler is running. Otherwise, they are assigned immediately.
+		 */
+		void endFrame( SharedPointer< Primitive > const &primitive );
+
+	private:
+		void grow( crimild::Size particleCount );
+
+	private:
+		VertexFormat _format;
+		crimild::Size _verticesPerParticle;
+		std::vector< IndexPrecision > _indexPattern;
+
+		crimild::Size _capacity = 0;
+		crimild::Size _particleCount = 0;
+		crimild::Size _bufferAllocationCount = 0;
+
+		VertexBufferObjectPtr _vertexBuffers[ CRIMILD_PARTICLE_VERTEX_STREAM_RING_SIZE ];
+		crimild::Size _currentVertexBuffer = 0;
+		IndexBufferObjectPtr _indexBuffer;
+	};
+
+	using ParticleVertexStreamPtr = SharedPointer< ParticleVertexStream >;
+
+}
+
+#endif
+
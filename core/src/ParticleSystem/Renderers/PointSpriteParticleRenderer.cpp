@@ -30,7 +30,6 @@
 #include "Simulation/AssetManager.hpp"
 #include "Rendering/Renderer.hpp"
 #include "Components/MaterialComponent.hpp"
-#include "Concurrency/Async.hpp"
 
 using namespace crimild;
 
@@ -63,17 +62,20 @@ void PointSpriteParticleRenderer::configure( Node *node, ParticleData *particles
 
     _primitive = crimild::alloc< Primitive >( Primitive::Type::POINTS );
 
+	// one point per particle
+	_vertexStream = crimild::alloc< ParticleVertexStream >( VertexFormat::VF_P3_C4_UV2, 1, std::vector< IndexPrecision > { 0 } );
+
 	_geometry->attachPrimitive( _primitive );
 }
 
 void PointSpriteParticleRenderer::update( Node *node, crimild::Real64 dt, ParticleData *particles )
 {
-    const auto pCount = particles->getAliveCount();
-    if ( pCount == 0 ) {
+    if ( particles->getAliveCount() == 0 ) {
         return;
     }
-    
-    auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_C4_UV2, pCount );
+
+    auto vbo = _vertexStream->beginFrame( particles->getAliveCount() );
+    const auto pCount = _vertexStream->getParticleCount();
 
 	const auto ps = _positions->getData< Vector3f >();
 	const auto ss = _sizes->getData< crimild::Real32 >();
@@ -103,13 +105,6 @@ void PointSpriteParticleRenderer::update( Node *node, crimild::Real64 dt, Partic
 		vbo->setRGBAColorAt( i, cs[ i ] );
 	}
 
-    auto ibo = crimild::alloc< IndexBufferObject >( pCount );
-    ibo->generateIncrementalIndices();
-    
-    crimild::concurrency::sync_frame( [this, vbo, ibo] {
-        _primitive->setVertexBuffer( vbo );
-        _primitive->setIndexBuffer( ibo );
-    });
+	_vertexStream->endFrame( _primitive );
 }
 
-
@@ -29,6 +29,7 @@
 #define CRIMILD_PARTICLE_RENDERER_POINT_SPRITE_
 
 #include "../ParticleSystemComponent.hpp"
+#include "ParticleVertexStream.hpp"
 
 #include "Rendering/Material.hpp"
 #include "SceneGraph/Geometry.hpp"
@@ -49,6 +50,7 @@ namespace crimild {
 	private:
 		MaterialPtr _material;
 		PrimitivePtr _primitive;
+		ParticleVertexStreamPtr _vertexStream;
 		GeometryPtr _geometry;
 		
 		ParticleAttribArray *_positions = nullptr;
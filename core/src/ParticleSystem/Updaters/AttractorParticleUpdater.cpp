@@ -26,6 +26,7 @@
  */
 
 #include "AttractorParticleUpdater.hpp"
+#include "ParticleSystem/ParticleKernels.hpp"
 
 using namespace crimild;
 
@@ -47,26 +48,14 @@ void AttractorParticleUpdater::configure( Node *node, ParticleData *particles )
 	_accelerations = particles->createAttribArray< Vector3f >( ParticleAttrib::ACCELERATION );
 }
 
-void AttractorParticleUpdater::update( Node *node, crimild::Real64 dt, ParticleData *particles )
+void AttractorParticleUpdater::updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end )
 {
 	const auto center = _attractor.getCenter();
 	const auto radius = _attractor.getRadius();
-	const auto count = particles->getAliveCount();
 
-	const auto ps = _positions->getData< Vector3f >();
-	auto as = _accelerations->getData< Vector3f >();
-	
-	for ( crimild::Size i = 0; i < count; i++ ) {
-		const auto p = ps[ i ];
+	const auto ps = _positions->getData< Vector3f >() + begin;
+	auto as = _accelerations->getData< Vector3f >() + begin;
 
-		auto direction = center - p;
-		auto d = direction.getMagnitude();
-		if ( d > 0.0 && d <= radius ) {
-			direction /= d;
-			const auto pct = 1.0 - ( d / radius );
-			
-			as[ i ] += dt * pct * _strength * direction;
-		}
-	}
+	ParticleKernels::attract( ps, as, center, radius, static_cast< crimild::Real32 >( dt ) * _strength, end - begin );
 }
 
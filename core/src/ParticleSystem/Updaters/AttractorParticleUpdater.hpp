@@ -39,7 +39,7 @@ namespace crimild {
 
 	   \remarks Use it before a position updater
 	 */
-    class AttractorParticleUpdater : public ParticleSystemComponent::ParticleUpdater {
+    class AttractorParticleUpdater : public ParticleSystemComponent::DataParallelParticleUpdater {
     public:
         AttractorParticleUpdater( void );
         virtual ~AttractorParticleUpdater( void );
@@ -51,7 +51,7 @@ namespace crimild {
 		inline crimild::Real32 getStrength( void ) const { return _strength; }
 
 		virtual void configure( Node *node, ParticleData *particles ) override;
-        virtual void update( Node *node, crimild::Real64 dt, ParticleData *particles ) override;
+        virtual void updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end ) override;
 
 	private:
 		Sphere3f _attractor;
@@ -60,14 +60,13 @@ void CameraSortParticleUpdater::update( Node *node, double dt, ParticleData *par
 
 	const auto ps = _positions->getData< Vector3f >();
 
-	// TODO: I know, bubble sort is slow...
-	// TODO: Also, precompute distances?
-	for ( int i = 1; i < pCount; i++ ) {
-		for ( int j = 0; j < pCount - i; j++ ) {
-			if ( Distance::computeSquared( ps[ j ], cameraPos ) < Distance::computeSquared( ps[ j + 1 ], cameraPos ) ) {
-				particles->swap( j, j + 1 );
-			}
-		}
+	// distances are computed only once per particle. Keys are negated
+	// so particles are sorted back to front
+	_keys.resize( pCount );
+	for ( crimild::Size i = 0; i < pCount; i++ ) {
+		_keys[ i ] = -Distance::computeSquared( ps[ i ], cameraPos );
 	}
+
+	particles->sort( _keys.data() );
 }
 
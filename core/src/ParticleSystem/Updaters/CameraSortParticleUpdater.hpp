@@ -50,6 +50,11 @@ namespace crimild {
         
     private:
         ParticleAttribArray *_positions = nullptr;
+
+        /**
+           \brief Sorting keys for alive particles
+         */
+        std::vector< crimild::Real32 > _keys;
     };
 
 }
@@ -26,8 +26,7 @@
  */
 
 #include "ColorParticleUpdater.hpp"
-
-#include "Mathematics/Interpolation.hpp"
+#include "ParticleSystem/ParticleKernels.hpp"
 
 using namespace crimild;
 
@@ -51,25 +50,14 @@ void ColorParticleUpdater::configure( Node *node, ParticleData *particles )
     
 }
 
-void ColorParticleUpdater::update( Node *node, double dt, ParticleData *particles )
+void ColorParticleUpdater::updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end )
 {
-	const auto count = particles->getAliveCount();
-
-	auto startData = _startColors->getData< RGBAColorf >();
-	auto endData = _endColors->getData< RGBAColorf >();
-	auto colorData = _colors->getData< RGBAColorf >();
-	auto timeData = _times->getData< crimild::Real32 >();
-	auto lifetimeData = _lifetimes->getData< crimild::Real32 >();
-
-	for ( crimild::Size i = 0; i < count; i++ ) {
-		const auto s0 = startData[ i ];
-		const auto s1 = endData[ i ];
-
-		const auto t = 1.0f - ( timeData[ i ] / lifetimeData[ i ] );
+	auto startData = _startColors->getData< RGBAColorf >() + begin;
+	auto endData = _endColors->getData< RGBAColorf >() + begin;
+	auto colorData = _colors->getData< RGBAColorf >() + begin;
+	auto timeData = _times->getData< crimild::Real32 >() + begin;
+	auto lifetimeData = _lifetimes->getData< crimild::Real32 >() + begin;
 
-		RGBAColorf c;
-		Interpolation::linear( s0, s1, t, c );
-		colorData[ i ] = c;
-	}
+	ParticleKernels::interpolateColors( colorData, startData, endData, timeData, lifetimeData, end - begin );
 }
 
@@ -32,13 +32,13 @@
 
 namespace crimild {
 
-    class ColorParticleUpdater : public ParticleSystemComponent::ParticleUpdater {
+    class ColorParticleUpdater : public ParticleSystemComponent::DataParallelParticleUpdater {
     public:
         ColorParticleUpdater( void );
         virtual ~ColorParticleUpdater( void );
 
         virtual void configure( Node *node, ParticleData *particles ) override;
-        virtual void update( Node *node, crimild::Real64 dt, ParticleData *particles ) override;
+        virtual void updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end ) override;
 		
 	private:
 		ParticleAttribArray *_startColors = nullptr;
@@ -26,6 +26,7 @@
  */
 
 #include "EulerParticleUpdater.hpp"
+#include "ParticleSystem/ParticleKernels.hpp"
 
 using namespace crimild;
 
@@ -47,34 +48,28 @@ void EulerParticleUpdater::configure( Node *node, ParticleData *particles )
 	_accelerations = particles->createAttribArray< Vector3f >( ParticleAttrib::ACCELERATION );
 }
 
-void EulerParticleUpdater::update( Node *node, crimild::Real64 dt, ParticleData *particles )
+void EulerParticleUpdater::updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end )
 {
-	const auto count = particles->getAliveCount();
+	const auto count = end - begin;
 
-	const auto g = dt * _globalAcceleration;
+	const auto t = static_cast< crimild::Real32 >( dt );
+	const auto g = t * _globalAcceleration;
 
-	auto as = _accelerations->getData< Vector3f >();
-	auto vs = _velocities->getData< Vector3f >();
-	auto ps = _positions->getData< Vector3f >();
+	auto as = _accelerations->getData< Vector3f >() + begin;
+	auto vs = _velocities->getData< Vector3f >() + begin;
+	auto ps = _positions->getData< Vector3f >() + begin;
 
 	// TODO: all the accelerations are the same value
 	// I think this could be optimized, but other
 	// updaters may need separated values
 	// Also, accelerations are handled in the same way
 	// regardless of the computation space (world or local)
-	for ( int i = 0; i < count; i++ ) {
-		as[ i ] += g;
-	}
+	ParticleKernels::add( as, g, count );
 
 	// Velocities are handled in the same way
 	// regardless of the computation space (world or local)
-	for ( int i = 0; i < count; i++ ) {
-		vs[ i ] += dt * as[ i ];
-	}
-	
-	for ( int i = 0; i < count; i++ ) {
-		auto v = dt * vs[ i ];
-		ps[ i ] += v;
-	}
+	ParticleKernels::addScaled( vs, as, t, count );
+
+	ParticleKernels::addScaled( ps, vs, t, count );
 }
 
@@ -32,7 +32,7 @@
 
 namespace crimild {
 
-    class EulerParticleUpdater : public ParticleSystemComponent::ParticleUpdater {
+    class EulerParticleUpdater : public ParticleSystemComponent::DataParallelParticleUpdater {
     public:
         EulerParticleUpdater( void );
         virtual ~EulerParticleUpdater( void );
@@ -41,7 +41,7 @@ namespace crimild {
 		inline const Vector3f &getGlobalAcceleration( void ) const { return _globalAcceleration; }
 
 		virtual void configure( Node *node, ParticleData *particles ) override;
-        virtual void update( Node *node, crimild::Real64 dt, ParticleData *particles ) override;
+        virtual void updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end ) override;
 
 	private:
 		Vector3f _globalAcceleration;
@@ -44,13 +44,11 @@ void FloorParticleUpdater::configure( Node *node, ParticleData *particles )
 	_positions = particles->createAttribArray< Vector3f >( ParticleAttrib::POSITION );
 }
 
-void FloorParticleUpdater::update( Node *node, double dt, ParticleData *particles )
+void FloorParticleUpdater::updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end )
 {
-    const auto count = particles->getAliveCount();
-
 	auto ps = _positions->getData< Vector3f >();
 
-    for ( int i = 0; i < count; i++ ) {
+    for ( auto i = begin; i < end; i++ ) {
         if ( ps[ i ].y() < 0.0f ) {
             ps[ i ].y() = 0.0f;
         }
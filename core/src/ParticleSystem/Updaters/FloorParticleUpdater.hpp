@@ -37,13 +37,13 @@ namespace crimild {
 
 	   \remarks Use it after a position updater
 	 */
-    class FloorParticleUpdater : public ParticleSystemComponent::ParticleUpdater {
+    class FloorParticleUpdater : public ParticleSystemComponent::DataParallelParticleUpdater {
     public:
         FloorParticleUpdater( void );
         virtual ~FloorParticleUpdater( void );
 
         virtual void configure( Node *node, ParticleData *particles ) override;
-        virtual void update( Node *node, crimild::Real64 dt, ParticleData *particles ) override;
+        virtual void updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end ) override;
         
     private:
         ParticleAttribArray *_positions = nullptr;
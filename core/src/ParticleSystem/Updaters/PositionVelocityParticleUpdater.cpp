@@ -45,14 +45,12 @@ void PositionVelocityParticleUpdater::configure( Node *node, ParticleData *parti
 	_velocities = particles->createAttribArray< Vector3f >( ParticleAttrib::VELOCITY );
 }
 
-void PositionVelocityParticleUpdater::update( Node *node, double dt, ParticleData *particles )
+void PositionVelocityParticleUpdater::updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end )
 {
-	const auto count = particles->getAliveCount();
-
 	auto vs = _velocities->getData< Vector3f >();
 	auto ps = _positions->getData< Vector3f >();
 
-	for ( int i = 0; i < count; i++ ) {
+	for ( auto i = begin; i < end; i++ ) {
 		auto v = dt * vs[ i ];
 		ps[ i ] += v;
 	}
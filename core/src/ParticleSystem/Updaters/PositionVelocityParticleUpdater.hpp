@@ -32,13 +32,13 @@
 
 namespace crimild {
 
-    class PositionVelocityParticleUpdater : public ParticleSystemComponent::ParticleUpdater {
+    class PositionVelocityParticleUpdater : public ParticleSystemComponent::DataParallelParticleUpdater {
     public:
         PositionVelocityParticleUpdater( void );
         virtual ~PositionVelocityParticleUpdater( void );
 
 		virtual void configure( Node *node, ParticleData *particles ) override;
-        virtual void update( Node *node, crimild::Real64 dt, ParticleData *particles ) override;
+        virtual void updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end ) override;
 
 	private:
 		ParticleAttribArray *_positions = nullptr;
@@ -38,7 +38,7 @@ namespace crimild {
 	   \remarks Useful for reseting values
 	 */
 	template< typename T >
-    class SetAttribValueParticleUpdater : public ParticleSystemComponent::ParticleUpdater {
+    class SetAttribValueParticleUpdater : public ParticleSystemComponent::DataParallelParticleUpdater {
     public:
         SetAttribValueParticleUpdater( void )
 		{
@@ -61,13 +61,11 @@ namespace crimild {
 			_attribData = particles->createAttribArray< T >( _attribType );
 		}
 		
-        virtual void update( Node *node, crimild::Real64 dt, ParticleData *particles ) override
+        virtual void updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end ) override
 		{
-			const auto count = particles->getAliveCount();
-
 			auto as = _attribData->getData< T >();
 
-			for ( int i = 0; i < count; i++ ) {
+			for ( auto i = begin; i < end; i++ ) {
 				as[ i ] = _value;
 			}
 		}
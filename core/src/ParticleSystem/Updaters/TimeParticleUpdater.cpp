@@ -26,6 +26,7 @@
  */
 
 #include "TimeParticleUpdater.hpp"
+#include "ParticleSystem/ParticleKernels.hpp"
 
 using namespace crimild;
 
@@ -45,17 +46,17 @@ void TimeParticleUpdater::configure( Node *node, ParticleData *particles )
 	assert( _times != nullptr );
 }
 
-void TimeParticleUpdater::update( Node *node, double dt, ParticleData *particles )
+void TimeParticleUpdater::updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end )
 {
-	const auto count = particles->getAliveCount();
-
 	auto ts = _times->getData< crimild::Real32 >();
 	assert( ts != nullptr );
 
-	for ( int i = 0; i < count; i++ ) {
-		ts[ i ] -= dt;
+	ParticleKernels::add( ts + begin, -static_cast< crimild::Real32 >( dt ), end - begin );
+
+	// expired particles are removed once all chunks are done
+	for ( auto i = begin; i < end; i++ ) {
 		if ( ts[ i ] <= 0.0f ) {
-			particles->kill( i );
+			particles->killDeferred( i );
 		}
 	}
 }
@@ -35,13 +35,13 @@ namespace crimild {
 	/**
 	   Updates the time of particle. Kills it if it's time is over
 	 */
-    class TimeParticleUpdater : public ParticleSystemComponent::ParticleUpdater {
+    class TimeParticleUpdater : public ParticleSystemComponent::DataParallelParticleUpdater {
     public:
         TimeParticleUpdater( void );
         virtual ~TimeParticleUpdater( void );
 
 		virtual void configure( Node *node, ParticleData *particles ) override;
-        virtual void update( Node *node, crimild::Real64 dt, ParticleData *particles ) override;
+        virtual void updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end ) override;
 
 	private:
 		ParticleAttribArray *_times = nullptr;
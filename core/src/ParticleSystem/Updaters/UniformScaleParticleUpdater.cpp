@@ -50,17 +50,15 @@ void UniformScaleParticleUpdater::configure( Node *node, ParticleData *particles
 	_lifetimes = particles->createAttribArray< crimild::Real32 >( ParticleAttrib::LIFE_TIME );
 }
 
-void UniformScaleParticleUpdater::update( Node *node, crimild::Real64 dt, ParticleData *particles )
+void UniformScaleParticleUpdater::updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end )
 {
-	const auto count = particles->getAliveCount();
-
 	auto startData = _startScales->getData< crimild::Real32 >();
 	auto endData = _endScales->getData< crimild::Real32 >();
 	auto scaleData = _scales->getData< crimild::Real32 >();
 	auto timeData = _times->getData< crimild::Real32 >();
 	auto lifetimeData = _lifetimes->getData< crimild::Real32 >();
 
-	for ( crimild::Size i = 0; i < count; i++ ) {
+	for ( auto i = begin; i < end; i++ ) {
 		const auto s0 = startData[ i ];
 		const auto s1 = endData[ i ];
 
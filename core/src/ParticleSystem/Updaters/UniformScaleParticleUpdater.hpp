@@ -32,13 +32,13 @@
 
 namespace crimild {
 
-    class UniformScaleParticleUpdater : public ParticleSystemComponent::ParticleUpdater {
+    class UniformScaleParticleUpdater : public ParticleSystemComponent::DataParallelParticleUpdater {
     public:
         UniformScaleParticleUpdater( void );
         virtual ~UniformScaleParticleUpdater( void );
 
 		virtual void configure( Node *node, ParticleData *particles ) override;
-        virtual void update( Node *node, crimild::Real64 dt, ParticleData *particles ) override;
+        virtual void updateRange( Node *node, crimild::Real64 dt, ParticleData *particles, ParticleId begin, ParticleId end ) override;
 
 	private:
 		ParticleAttribArray *_startScales = nullptr;
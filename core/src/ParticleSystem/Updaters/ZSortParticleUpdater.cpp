@@ -52,13 +52,12 @@ void ZSortParticleUpdater::update( Node *node, double dt, ParticleData *particle
 
 	const auto ps = _positions->getData< Vector3f >();
 
-	// TODO: I know, bubble sort is slow...
-	for ( int i = 1; i < pCount; i++ ) {
-		for ( int j = 0; j < pCount - i; j++ ) {
-			if ( ps[ j ].z() > ps[ j + 1 ].z() ) {
-				particles->swap( j, j + 1 );
-			}
-		}
+	// extract keys into a contiguous buffer and sort them all at once
+	_keys.resize( pCount );
+	for ( crimild::Size i = 0; i < pCount; i++ ) {
+		_keys[ i ] = ps[ i ].z();
 	}
+
+	particles->sort( _keys.data() );
 }
 
@@ -32,7 +32,9 @@
 #include "Foundation/Types.hpp"
 #include "Streaming/Stream.hpp"
 
+#include <algorithm>
 #include <memory>
+#include <cstdint>
 #include <cstring>
 #include <vector>
 
@@ -61,13 +63,18 @@ namespace crimild {
 
 		}
 
-		inline unsigned int getSize( void ) const { return _data.size(); }
+		inline unsigned int getSize( void ) const { return _mappedData != nullptr ? _mappedSize : _data.size(); }
         
         inline unsigned int getSizeInBytes( void ) const { return sizeof( T ) * getSize(); }
 
-		inline T *data( void ) { return &_data[ 0 ]; }
+		/**
+			\brief Gets the data for writing
 
-		inline const T *getData( void ) const { return &_data[ 0 ]; }
+			\remarks If the data is mapped, it is copied first
+		*/
+		inline T *data( void ) { unmap(); return &_data[ 0 ]; }
+
+		inline const T *getData( void ) const { return _mappedData != nullptr ? _mappedData : &_data[ 0 ]; }
 
 		inline crimild::Size getUsedCount( void ) const { return _usedCount; }
 
@@ -77,6 +84,114 @@ namespace crimild {
 		std::vector< T > _data;
 		crimild::Size _usedCount;
 
+		/**
+			\name Usage
+		*/
+		//@{
+
+	public:
+		/**
+			\brief Hints how often buffer data is expected to change
+
+			STATIC buffers are uploaded once. DYNAMIC buffers are modified
+			from time to time and STREAM buffers are rewritten every frame.
+		*/
+		enum class Usage {
+			STATIC,
+			DYNAMIC,
+			STREAM,
+		};
+
+		inline Usage getUsage( void ) const { return _usage; }
+
+		inline void setUsage( Usage usage ) { _usage = usage; }
+
+	private:
+		Usage _usage = Usage::STATIC;
+
+		//@}
+
+		/**
+			\name Dirty range
+
+			Keeps track of elements modified since the last upload, so
+			renderers only need to transfer that range instead of creating
+			a new buffer whenever data changes. Buffers that have never
+			been uploaded are always sent as a whole.
+		*/
+		//@{
+
+	public:
+		/**
+			\brief Flags count elements starting at begin as modified
+
+			Successive calls are merged into a single range
+		*/
+		void markDirty( crimild::Size begin, crimild::Size count )
+		{
+			if ( count == 0 ) {
+				return;
+			}
+
+			if ( !isDirty() ) {
+				_dirtyBegin = begin;
+				_dirtyEnd = begin + count;
+			}
+			else {
+				_dirtyBegin = std::min( _dirtyBegin, begin );
+				_dirtyEnd = std::max( _dirtyEnd, begin + count );
+			}
+		}
+
+		inline bool isDirty( void ) const { return _dirtyEnd > _dirtyBegin; }
+
+		inline crimild::Size getDirtyBegin( void ) const { return _dirtyBegin; }
+
+		inline crimild::Size getDirtyCount( void ) const { return _dirtyEnd - _dirtyBegin; }
+
+		inline void clearDirty( void ) { _dirtyBegin = _dirtyEnd = 0; }
+
+	private:
+		crimild::Size _dirtyBegin = 0;
+		crimild::Size _dirtyEnd = 0;
+
+		//@}
+
+		/**
+			\name Mapped data
+
+			When loaded from a stream that references its storage (i.e. a
+			memory mapped file), data is not copied. Instead, the buffer
+			references the stream storage and keeps it alive until data
+			is modified.
+		*/
+		//@{
+
+	public:
+		inline bool isMapped( void ) const { return _mappedData != nullptr; }
+
+		/**
+			\brief Copies the mapped data, if any, releasing the stream storage
+		*/
+		void unmap( void )
+		{
+			if ( _mappedData == nullptr ) {
+				return;
+			}
+
+			_data.assign( _mappedData, _mappedData + _mappedSize );
+			_mappedData = nullptr;
+			_mappedSize = 0;
+			_mappedStorage = nullptr;
+		}
+
+	private:
+		const T *_mappedData = nullptr;
+		unsigned int _mappedSize = 0;
+		SharedPointer< void > _mappedStorage;
+
+		//@}
+
 	public:
 		BufferObject( void ) { }
 
@@ -95,7 +210,8 @@ namespace crimild {
 			s.write( _usedCount );
 			
 			if ( size > 0 ) {
-				s.writeRawBytes( &_data[ 0 ], getSizeInBytes() );
+				s.writeAlignment( alignof( T ) );
+				s.writeRawBytes( getData(), getSizeInBytes() );
 			}
 		}
 
@@ -108,9 +224,29 @@ namespace crimild {
 
 			s.read( _usedCount );
 
+			_mappedData = nullptr;
+			_mappedSize = 0;
+			_mappedStorage = nullptr;
+
 			if ( size > 0 ) {
-				_data.resize( size );
-				s.readRawBytes( &_data[ 0 ], getSizeInBytes() );
+				s.readAlignment( alignof( T ) );
+
+				SharedPointer< void > storage;
+				auto bytes = s.readRawBytesInPlace( sizeof( T ) * size, storage );
+				if ( bytes != nullptr && reinterpret_cast< std::uintptr_t >( bytes ) % alignof( T ) == 0 ) {
+					_data.clear();
+					_mappedData = reinterpret_cast< const T * >( bytes );
+					_mappedSize = size;
+					_mappedStorage = storage;
+				}
+				else if ( bytes != nullptr ) {
+					_data.resize( size );
+					memcpy( &_data[ 0 ], bytes, sizeof( T ) * size );
+				}
+				else {
+					_data.resize( size );
+					s.readRawBytes( &_data[ 0 ], sizeof( T ) * size );
+				}
 			}
 		}
 	};
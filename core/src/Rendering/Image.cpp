@@ -57,6 +57,9 @@ void Image::setData( int width, int height, int bpp, const unsigned char *data,
 	_bpp = bpp;
     _pixelFormat = format;
 
+    _mappedData = nullptr;
+    _mappedStorage = nullptr;
+
 	int size = _width * _height * _bpp;
 	if ( size > 0 ) {
         if ( _data.size() != size ) _data.resize( size );
@@ -84,6 +87,19 @@ void Image::unload( void )
 	_height = 0;
 	_bpp = 0;
     _data.resize( 0 );
+    _mappedData = nullptr;
+    _mappedStorage = nullptr;
+}
+
+void Image::unmap( void )
+{
+	if ( _mappedData == nullptr ) {
+		return;
+	}
+
+	_data.assign( _mappedData, _mappedData + _width * _height * _bpp );
+	_mappedData = nullptr;
+	_mappedStorage = nullptr;
 }
 
 bool Image::registerInStream( Stream &s )
@@ -102,7 +118,9 @@ void Image::save( Stream &s )
 	s.write( _width );
 	s.write( _height );
 	s.write( _bpp );
-	s.writeRawBytes( &_data[ 0 ], _width * _height * _bpp * sizeof( unsigned char ) );
+
+	const Image *image = this;
+	s.writeRawBytes( image->getData(), _width * _height * _bpp * sizeof( unsigned char ) );
 }
 
 void Image::load( Stream &s )
@@ -112,7 +130,18 @@ void Image::load( Stream &s )
 	s.read( _width );
 	s.read( _height );
 	s.read( _bpp );
-	_data.resize( _width * _height * _bpp );
-	s.readRawBytes( &_data[ 0 ], _data.size() * sizeof( unsigned char ) );
+
+	_mappedData = nullptr;
+	_mappedStorage = nullptr;
+
+	size_t size = _width * _height * _bpp * sizeof( unsigned char );
+	_mappedData = s.readRawBytesInPlace( size, _mappedStorage );
+	if ( _mappedData != nullptr ) {
+		_data.clear();
+	}
+	else {
+		_data.resize( size );
+		s.readRawBytes( &_data[ 0 ], size );
+	}
 }
 
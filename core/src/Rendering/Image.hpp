@@ -54,12 +54,18 @@ namespace crimild {
 		int getHeight( void ) const { return _height; }
 		int getBpp( void ) const { return _bpp; }
         PixelFormat getPixelFormat( void ) const { return _pixelFormat; }
-		unsigned char *getData( void ) { return &_data[ 0 ]; }
-		const unsigned char *getData( void ) const { return &_data[ 0 ]; }
+
+		/**
+			\brief Gets the pixel data for writing
+
+			\remarks If the pixel data is mapped, it is copied first
+		*/
+		unsigned char *getData( void ) { unmap(); return &_data[ 0 ]; }
+		const unsigned char *getData( void ) const { return _mappedData != nullptr ? _mappedData : &_data[ 0 ]; }
 
 		void setData( int width, int height, int bpp, const unsigned char *data, PixelFormat format = PixelFormat::RGBA );
 
-		bool isLoaded( void ) const { return _data.size() > 0; }
+		bool isLoaded( void ) const { return _mappedData != nullptr || _data.size() > 0; }
 		virtual void load( void );
 		virtual void unload( void );
 
@@ -70,6 +76,28 @@ namespace crimild {
         PixelFormat _pixelFormat;
         std::vector< unsigned char > _data;
 
+        /**
+            \name Mapped data
+
+            Pixel data loaded from a stream may reference the stream 
+            storage instead of being copied. See BufferObject
+        */
+        //@{
+
+    public:
+        bool isMapped( void ) const { return _mappedData != nullptr; }
+
+        /**
+            \brief Copies the mapped pixel data, if any, releasing the stream storage
+        */
+        void unmap( void );
+
+    private:
+        const unsigned char *_mappedData = nullptr;
+        SharedPointer< void > _mappedStorage;
+
+        //@}
+
         /**
         	\name Streaming
         */
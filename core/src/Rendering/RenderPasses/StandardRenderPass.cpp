@@ -133,7 +133,7 @@ void StandardRenderPass::computeShadowMaps( Renderer *renderer, RenderQueue *ren
         renderQueue->each( renderables, [this, renderer, program]( RenderQueue::Renderable *renderable ) {
             renderStandardGeometry(
                 renderer,
-                crimild::get_ptr( renderable->geometry ),
+                renderable->geometry,
                 program,
                 nullptr, // no material
                 renderable->modelTransform );
@@ -148,80 +148,107 @@ void StandardRenderPass::computeShadowMaps( Renderer *renderer, RenderQueue *ren
 
 void StandardRenderPass::renderOccluders( Renderer *renderer, RenderQueue *renderQueue, Camera *camera )
 {
-    CRIMILD_PROFILE( "Render Translucent Objects" )
-    
-    auto renderables = renderQueue->getRenderables( RenderQueue::RenderableType::OCCLUDER );
+    CRIMILD_PROFILE( "Render Occluders" )
     
-    if ( renderables->size() == 0 ) {
-        return;
-    }
-    
-    renderQueue->each( renderables, [this, renderer, renderQueue]( RenderQueue::Renderable *renderable ) {
-        auto material = crimild::get_ptr( renderable->material );
-        auto program = material->getProgram();
-        if ( program == nullptr ) {
-            program = getStandardProgram();
-        }
-        
-        renderer->bindProgram( program );
-        
-        auto projection = renderQueue->getProjectionMatrix();
-        renderer->bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::PROJECTION_MATRIX_UNIFORM ), projection );
-        
-        auto view = renderQueue->getViewMatrix();
-        renderer->bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::VIEW_MATRIX_UNIFORM ), view );
-        
-        renderStandardGeometry( renderer, crimild::get_ptr( renderable->geometry ), program, material, renderable->modelTransform );
-        
-        renderer->unbindProgram( program );
-    });
+    renderObjects( renderer, renderQueue, RenderQueue::RenderableType::OCCLUDER, false );
 }
 
 void StandardRenderPass::renderOpaqueObjects( Renderer *renderer, RenderQueue *renderQueue, Camera *camera )
 {
     CRIMILD_PROFILE( "Render Opaque Objects" )
     
-    auto renderables = renderQueue->getRenderables( RenderQueue::RenderableType::OPAQUE );
+    renderObjects( renderer, renderQueue, RenderQueue::RenderableType::OPAQUE, true );
+}
+
+void StandardRenderPass::renderTranslucentObjects( Renderer *renderer, RenderQueue *renderQueue, Camera *camera )
+{
+    CRIMILD_PROFILE( "Render Translucent Objects" )
     
+    renderObjects( renderer, renderQueue, RenderQueue::RenderableType::TRANSLUCENT, false );
+}
+
+void StandardRenderPass::renderObjects( Renderer *renderer, RenderQueue *renderQueue, RenderQueue::RenderableType type, bool useLights )
+{
+    auto renderables = renderQueue->getRenderables( type );
     if ( renderables->size() == 0 ) {
         return;
     }
-    
-    renderQueue->each( renderables, [this, renderer, renderQueue]( RenderQueue::Renderable *renderable ) {
-        auto material = crimild::get_ptr( renderable->material );
+
+    // renderables are sorted by state, so programs and materials
+    // are only bound when they actually change
+    ShaderProgram *currentProgram = nullptr;
+    Material *currentMaterial = nullptr;
+
+    for ( auto &batch : *renderQueue->getInstanceBatches( type ) ) {
+        auto renderable = &( *renderables )[ batch.first ];
+        auto material = renderable->material;
         auto program = material->getProgram();
         if ( program == nullptr ) {
             program = getStandardProgram();
         }
-        
-        renderer->bindProgram( program );
-        
-        auto projection = renderQueue->getProjectionMatrix();
-        renderer->bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::PROJECTION_MATRIX_UNIFORM ), projection );
-        
-        auto view = renderQueue->getViewMatrix();
-        renderer->bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::VIEW_MATRIX_UNIFORM ), view );
-        
-        if ( isShadowMappingEnabled() ) {
-            renderer->bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::USE_SHADOW_MAP_UNIFORM ), _shadowMaps.size() > 0 );
-            for ( auto it : _shadowMaps ) {
-                if ( it.second != nullptr ) {
-                    renderer->bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::LIGHT_SOURCE_PROJECTION_MATRIX_UNIFORM ), it.second->getLightProjectionMatrix() );
-                    renderer->bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::LIGHT_SOURCE_VIEW_MATRIX_UNIFORM ), it.second->getLightViewMatrix() );
-                    renderer->bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::LINEAR_DEPTH_CONSTANT_UNIFORM ), it.second->getLinearDepthConstant() );
-                    renderer->bindTexture( program->getStandardLocation( ShaderProgram::StandardLocation::SHADOW_MAP_UNIFORM ), it.second->getTexture() );
-                }
+
+        if ( program != currentProgram ) {
+            if ( currentProgram != nullptr ) {
+                renderer->unbindMaterial( currentProgram, currentMaterial );
+                unbindProgramState( renderer, renderQueue, currentProgram, useLights );
             }
+            bindProgramState( renderer, renderQueue, program, useLights );
+            currentProgram = program;
+            currentMaterial = nullptr;
         }
-        
-        if ( isLightingEnabled() ) {
-            renderQueue->each( [renderer, program]( Light *light, int ) {
-                renderer->bindLight( program, light );
-            });
+
+        if ( material != currentMaterial ) {
+            renderer->bindMaterial( program, material );
+            currentMaterial = material;
         }
-        
-        renderStandardGeometry( renderer, crimild::get_ptr( renderable->geometry ), program, material, renderable->modelTransform );
-        
+
+        if ( batch.instanceCount > 1 ) {
+            renderInstancedGeometry( renderer, program, renderable->primitive, renderQueue->getInstanceTransforms( batch ), batch.instanceCount );
+        }
+        else {
+            renderStandardGeometry( renderer, renderable->geometry, program, nullptr, renderable->modelTransform );
+        }
+    }
+
+    if ( currentProgram != nullptr ) {
+        renderer->unbindMaterial( currentProgram, currentMaterial );
+        unbindProgramState( renderer, renderQueue, currentProgram, useLights );
+    }
+}
+
+void StandardRenderPass::bindProgramState( Renderer *renderer, RenderQueue *renderQueue, ShaderProgram *program, bool useLights )
+{
+    renderer->bindProgram( program );
+    
+    renderer->bindCachedUniform( program->getStandardLocation( ShaderProgram::StandardLocation::PROJECTION_MATRIX_UNIFORM ), renderQueue->getProjectionMatrix() );
+    renderer->bindCachedUniform( program->getStandardLocation( ShaderProgram::StandardLocation::VIEW_MATRIX_UNIFORM ), renderQueue->getViewMatrix() );
+
+    if ( !useLights ) {
+        return;
+    }
+    
+    if ( isShadowMappingEnabled() ) {
+        renderer->bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::USE_SHADOW_MAP_UNIFORM ), _shadowMaps.size() > 0 );
+        for ( auto it : _shadowMaps ) {
+            if ( it.second != nullptr ) {
+                renderer->bindCachedUniform( program->getStandardLocation( ShaderProgram::StandardLocation::LIGHT_SOURCE_PROJECTION_MATRIX_UNIFORM ), it.second->getLightProjectionMatrix() );
+                renderer->bindCachedUniform( program->getStandardLocation( ShaderProgram::StandardLocation::LIGHT_SOURCE_VIEW_MATRIX_UNIFORM ), it.second->getLightViewMatrix() );
+                renderer->bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::LINEAR_DEPTH_CONSTANT_UNIFORM ), it.second->getLinearDepthConstant() );
+                renderer->bindTexture( program->getStandardLocation( ShaderProgram::StandardLocation::SHADOW_MAP_UNIFORM ), it.second->getTexture() );
+            }
+        }
+    }
+    
+    if ( isLightingEnabled() ) {
+        renderQueue->each( [ renderer, program ]( Light *light, int ) {
+            renderer->bindLight( program, light );
+        });
+    }
+}
+
+void StandardRenderPass::unbindProgramState( Renderer *renderer, RenderQueue *renderQueue, ShaderProgram *program, bool useLights )
+{
+    if ( useLights ) {
         if ( isLightingEnabled() ) {
             renderQueue->each( [ renderer, program ]( Light *light, int ) {
                 renderer->unbindLight( program, light );
@@ -235,40 +262,29 @@ void StandardRenderPass::renderOpaqueObjects( Renderer *renderer, RenderQueue *r
                 }
             }
         }
-        
-        renderer->unbindProgram( program );
-    });
+    }
+
+    renderer->unbindProgram( program );
 }
 
-void StandardRenderPass::renderTranslucentObjects( Renderer *renderer, RenderQueue *renderQueue, Camera *camera )
+void StandardRenderPass::renderInstancedGeometry( Renderer *renderer, ShaderProgram *program, Primitive *primitive, const Matrix4f *modelTransforms, crimild::Size instanceCount )
 {
-    CRIMILD_PROFILE( "Render Translucent Objects" )
-    
-    auto renderables = renderQueue->getRenderables( RenderQueue::RenderableType::TRANSLUCENT );
-    
-    if ( renderables->size() == 0 ) {
+    auto vbo = primitive->getVertexBuffer();
+    auto ibo = primitive->getIndexBuffer();
+    if ( vbo == nullptr || ibo == nullptr ) {
         return;
     }
-    
-    renderQueue->each( renderables, [this, renderer, renderQueue]( RenderQueue::Renderable *renderable ) {
-        auto material = crimild::get_ptr( renderable->material );
-        auto program = material->getProgram();
-        if ( program == nullptr ) {
-            program = getStandardProgram();
-        }
-        
-        renderer->bindProgram( program );
-        
-        auto projection = renderQueue->getProjectionMatrix();
-        renderer->bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::PROJECTION_MATRIX_UNIFORM ), projection );
-        
-        auto view = renderQueue->getViewMatrix();
-        renderer->bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::VIEW_MATRIX_UNIFORM ), view );
-        
-        renderStandardGeometry( renderer, crimild::get_ptr( renderable->geometry ), program, material, renderable->modelTransform );
-        
-        renderer->unbindProgram( program );
-    });
+
+    // instanced geometries are never skinned
+    renderer->bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::SKINNED_MESH_JOINT_COUNT_UNIFORM ), 0 );
+
+    renderer->bindVertexBuffer( program, vbo );
+    renderer->bindIndexBuffer( program, ibo );
+
+    renderer->drawPrimitiveInstanced( program, primitive, modelTransforms, instanceCount );
+
+    renderer->unbindVertexBuffer( program, vbo );
+    renderer->unbindIndexBuffer( program, ibo );
 }
 
 void StandardRenderPass::renderStandardGeometry( Renderer *renderer, Geometry *geometry, ShaderProgram *program, Material *material, const Matrix4f &modelTransform )
@@ -56,7 +56,20 @@ namespace crimild {
         virtual void renderOpaqueObjects( Renderer *renderer, RenderQueue *renderQueue, Camera *camera );
         virtual void renderTranslucentObjects( Renderer *renderer, RenderQueue *renderQueue, Camera *camera );
         
+        /**
+            \brief Renders all objects of a given type, sorted by state
+
+            Programs and materials are bound only when they change
+            between consecutive renderables. Instance batches are
+            drawn with a single call.
+         */
+        void renderObjects( Renderer *renderer, RenderQueue *renderQueue, RenderQueue::RenderableType type, bool useLights );
+
+        void bindProgramState( Renderer *renderer, RenderQueue *renderQueue, ShaderProgram *program, bool useLights );
+        void unbindProgramState( Renderer *renderer, RenderQueue *renderQueue, ShaderProgram *program, bool useLights );
+
         void renderStandardGeometry( Renderer *renderer, Geometry *geometry, ShaderProgram *program, Material *material, const Matrix4f &modelTransform );
+        void renderInstancedGeometry( Renderer *renderer, ShaderProgram *program, Primitive *primitive, const Matrix4f *modelTransforms, crimild::Size instanceCount );
 
     protected:
         inline ShaderProgram *getStandardProgram( void );
@@ -28,12 +28,38 @@
 #include "Rendering/RenderQueue.hpp"
 #include "Primitives/Primitive.hpp"
 #include "Components/RenderStateComponent.hpp"
+#include "Foundation/RadixSort.hpp"
+
+#include <algorithm>
 
 using namespace crimild;
 
-RenderQueue::RenderQueue( void )
+constexpr crimild::Size RenderQueue::RENDERABLE_TYPE_COUNT;
+
+RenderQueue::RenderQueue( LinearArenaPtr const &arena )
+    : _arena( arena ),
+      _lights( ArenaAllocator< SharedPointer< Light >>( crimild::get_ptr( arena ) ) ),
+      _geometries( ArenaAllocator< SharedPointer< Geometry >>( crimild::get_ptr( arena ) ) ),
+      _materials( ArenaAllocator< SharedPointer< Material >>( crimild::get_ptr( arena ) ) ),
+      _primitives( ArenaAllocator< SharedPointer< Primitive >>( crimild::get_ptr( arena ) ) ),
+      _instanceTransforms( ArenaAllocator< Matrix4f >( crimild::get_ptr( arena ) ) ),
+      _sortEntries( ArenaAllocator< SortEntry >( crimild::get_ptr( arena ) ) ),
+      _sortScratch( ArenaAllocator< SortEntry >( crimild::get_ptr( arena ) ) ),
+      _sortedRenderables( ArenaAllocator< Renderable >( crimild::get_ptr( arena ) ) ),
+      _programIds( 0, StateIds::hasher(), StateIds::key_equal(), StateIds::allocator_type( crimild::get_ptr( arena ) ) ),
+      _materialIds( 0, StateIds::hasher(), StateIds::key_equal(), StateIds::allocator_type( crimild::get_ptr( arena ) ) ),
+      _primitiveIds( 0, StateIds::hasher(), StateIds::key_equal(), StateIds::allocator_type( crimild::get_ptr( arena ) ) )
 {
+    for ( crimild::Size i = 0; i < RENDERABLE_TYPE_COUNT; i++ ) {
+        _renderables[ i ] = Renderables( Renderables::allocator_type( crimild::get_ptr( arena ) ) );
+        _instanceBatches[ i ] = InstanceBatches( InstanceBatches::allocator_type( crimild::get_ptr( arena ) ) );
+    }
+
     setTimestamp( ( unsigned long ) std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::system_clock::now().time_since_epoch() ).count() );
+
+    for ( auto &sorted : _sorted ) {
+        sorted = true;
+    }
 }
 
 RenderQueue::~RenderQueue( void )
@@ -46,11 +72,21 @@ void RenderQueue::reset( void )
     setCamera( nullptr );
 
     _lights.clear();
+    _geometries.clear();
+    _materials.clear();
+    _primitives.clear();
 
-    for ( auto &it : _renderables ) {
-        it.second.clear();
+    for ( crimild::Size i = 0; i < RENDERABLE_TYPE_COUNT; i++ ) {
+        _renderables[ i ].clear();
+        _instanceBatches[ i ].clear();
+        _sorted[ i ] = true;
     }
-    _renderables.clear();
+
+    _instanceTransforms.clear();
+
+    _programIds.clear();
+    _materialIds.clear();
+    _primitiveIds.clear();
 }
 
 void RenderQueue::setCamera( Camera *camera )
@@ -67,20 +103,89 @@ void RenderQueue::setCamera( Camera *camera )
     }
 }
 
+crimild::UInt16 RenderQueue::getStateId( StateIds &ids, const void *state )
+{
+    if ( state == nullptr ) {
+        return 0;
+    }
+
+    auto it = ids.find( state );
+    if ( it != ids.end() ) {
+        return it->second;
+    }
+
+    // ids are assigned in order of appearance. If we run out of them,
+    // the remaining states will share the last one
+    auto id = static_cast< crimild::UInt16 >( std::min< crimild::Size >( ids.size() + 1, 0xFFFF ) );
+    ids[ state ] = id;
+    return id;
+}
+
+void RenderQueue::pushRenderable( RenderableType type, Geometry *geometry, Material *material, Primitive *primitive, const Matrix4f &modelTransform, double distanceFromCamera, SortKey sortKey )
+{
+    auto index = static_cast< crimild::Size >( type );
+    _renderables[ index ].push_back( Renderable {
+        geometry,
+        material,
+        primitive,
+        modelTransform,
+        distanceFromCamera,
+        sortKey,
+    });
+    _sorted[ index ] = false;
+}
+
 void RenderQueue::push( Geometry *geometry )
 {
     auto rs = geometry->getComponent< RenderStateComponent >();
-    if ( rs == nullptr ) {
+    if ( rs == nullptr || !rs->hasMaterials() ) {
         return;
     }
+
+    _geometries.push_back( crimild::retain( geometry ) );
+
+    // values shared by all materials. They are packed together so the
+    // callback below is small enough to avoid heap allocations
+    struct {
+        Geometry *geometry;
+        bool renderOnScreen;
+        Matrix4f modelTransform;
+        double distanceFromCamera;
+        SortKey depthKey;
+        Primitive *primitive;
+        SortKey primitiveId;
+    } params;
+
+    params.geometry = geometry;
+    params.renderOnScreen = rs->renderOnScreen();
+    params.modelTransform = geometry->getWorld().computeModelMatrix();
+
+    // we use the squared distance to avoid performance penalties
+    params.distanceFromCamera = Distance::computeSquared( geometry->getWorld().getTranslate(), getCamera()->getWorld().getTranslate() );
+
+    params.depthKey = RadixSort::toKey( static_cast< float >( params.distanceFromCamera ) );
+
+    // only geometries with a single primitive can be instanced
+    Primitive *primitive = nullptr;
+    if ( geometry->getPrimitiveCount() == 1 && rs->getSkinnedMesh() == nullptr ) {
+        geometry->forEachPrimitive( [ &primitive ]( Primitive *p ) {
+            primitive = p;
+        });
+    }
+    if ( primitive != nullptr ) {
+        _primitives.push_back( crimild::retain( primitive ) );
+    }
+    params.primitive = primitive;
+    params.primitiveId = getStateId( _primitiveIds, primitive );
     
-    bool renderOnScreen = rs->renderOnScreen();
-    
-    rs->forEachMaterial( [this, geometry, renderOnScreen]( Material *material ) {
+    rs->forEachMaterial( [ this, &params ]( Material *material ) {
+        // materials may be detached from the geometry before the queue is rendered
+        _materials.push_back( crimild::retain( material ) );
+
         auto renderableType = RenderQueue::RenderableType::OPAQUE;
         bool castShadows = false;
         
-        if ( renderOnScreen ) {
+        if ( params.renderOnScreen ) {
             renderableType = RenderQueue::RenderableType::SCREEN;
         }
         else if ( material->getColorMaskState()->isEnabled() &&
@@ -100,45 +205,26 @@ void RenderQueue::push( Geometry *geometry )
             castShadows = material->castShadows();
             renderableType = RenderQueue::RenderableType::OPAQUE;
         }
-        
-        auto renderable = RenderQueue::Renderable {
-            crimild::retain( geometry ),
-            crimild::retain( material ),
-            
-            geometry->getWorld().computeModelMatrix(),
-            
-            // we use the squared distance to avoid performance penalties
-            Distance::computeSquared( geometry->getWorld().getTranslate(), getCamera()->getWorld().getTranslate() ),
-        };
-        
-        auto queue = &_renderables[ renderableType ];
-        
+
+        const SortKey programId = getStateId( _programIds, material->getProgram() );
+        const SortKey materialId = getStateId( _materialIds, material );
+
+        SortKey sortKey;
         if ( renderableType == RenderQueue::RenderableType::TRANSLUCENT ) {
             // order BACK_TO_FRONT for translucent objects
-            auto it = queue->begin();
-            while ( it != queue->end() && ( *it ).distanceFromCamera >= renderable.distanceFromCamera ) {
-                it++;
-            }
-            queue->insert( it, renderable );
+            sortKey = ( ( ~params.depthKey & 0xFFFFFFFF ) << 32 ) | ( programId << 16 ) | materialId;
         }
         else {
-            // order FRONT_TO_BACK for everything else
-            auto it = queue->begin();
-            while ( it != queue->end() && ( *it ).distanceFromCamera <= renderable.distanceFromCamera ) {
-                it++;
-            }
-            queue->insert( it, renderable );
+            // group by state first, then order FRONT_TO_BACK
+            sortKey = ( programId << 48 ) | ( materialId << 32 ) | ( params.primitiveId << 16 ) | ( params.depthKey >> 16 );
         }
+
+        pushRenderable( renderableType, params.geometry, material, params.primitive, params.modelTransform, params.distanceFromCamera, sortKey );
         
         if ( castShadows ) {
-            // if the geometry is supposed to cast shadows, we also add it to that queue
-            // order FRONT_TO_BACK
-            auto casters = &_renderables[ RenderQueue::RenderableType::SHADOW_CASTER ];
-            auto it = casters->begin();
-            while ( it != casters->end() && ( *it ).distanceFromCamera <= renderable.distanceFromCamera ) {
-                it++;
-            }
-            casters->insert( it, renderable );
+            // if the geometry is supposed to cast shadows, we also add it to that queue.
+            // All casters are rendered with the same program, so only depth matters (FRONT_TO_BACK)
+            pushRenderable( RenderQueue::RenderableType::SHADOW_CASTER, params.geometry, material, params.primitive, params.modelTransform, params.distanceFromCamera, params.depthKey );
         }
     });
 }
@@ -148,6 +234,88 @@ void RenderQueue::push( Light *light )
     _lights.push_back( crimild::retain( light ) );
 }
 
+void RenderQueue::sort( void )
+{
+    for ( crimild::Size i = 0; i < RENDERABLE_TYPE_COUNT; i++ ) {
+        sort( static_cast< RenderableType >( i ) );
+    }
+}
+
+void RenderQueue::sort( RenderableType type )
+{
+    auto index = static_cast< crimild::Size >( type );
+    if ( _sorted[ index ] ) {
+        return;
+    }
+
+    _sorted[ index ] = true;
+
+    auto &renderables = _renderables[ index ];
+    auto count = renderables.size();
+
+    // sort small (key, index) pairs instead of moving renderables around on every pass
+    _sortEntries.resize( count );
+    for ( crimild::Size i = 0; i < count; i++ ) {
+        _sortEntries[ i ] = SortEntry { renderables[ i ].sortKey, static_cast< crimild::UInt32 >( i ) };
+    }
+
+    RadixSort::sort( _sortEntries, _sortScratch, []( SortEntry const &entry ) { return entry.key; } );
+
+    _sortedRenderables.clear();
+    _sortedRenderables.reserve( count );
+    for ( auto &entry : _sortEntries ) {
+        _sortedRenderables.push_back( renderables[ entry.index ] );
+    }
+
+    std::swap( renderables, _sortedRenderables );
+
+    computeInstanceBatches( type );
+}
+
+void RenderQueue::computeInstanceBatches( RenderableType type )
+{
+    auto index = static_cast< crimild::Size >( type );
+    auto &renderables = _renderables[ index ];
+    auto &batches = _instanceBatches[ index ];
+
+    batches.clear();
+
+    crimild::Size i = 0;
+    while ( i < renderables.size() ) {
+        auto &first = renderables[ i ];
+
+        auto end = i + 1;
+        if ( first.primitive != nullptr ) {
+            while ( end < renderables.size() && renderables[ end ].primitive == first.primitive && renderables[ end ].material == first.material ) {
+                end++;
+            }
+        }
+
+        auto batch = InstanceBatch { i, end - i, 0 };
+        if ( batch.instanceCount > 1 ) {
+            batch.firstTransform = _instanceTransforms.size();
+            for ( auto j = i; j < end; j++ ) {
+                _instanceTransforms.push_back( renderables[ j ].modelTransform );
+            }
+        }
+        batches.push_back( batch );
+
+        i = end;
+    }
+}
+
+RenderQueue::Renderables *RenderQueue::getRenderables( RenderableType type )
+{
+    sort( type );
+    return &_renderables[ static_cast< crimild::Size >( type ) ];
+}
+
+RenderQueue::InstanceBatches *RenderQueue::getInstanceBatches( RenderableType type )
+{
+    sort( type );
+    return &_instanceBatches[ static_cast< crimild::Size >( type ) ];
+}
+
 void RenderQueue::each( Renderables *renderables, std::function< void( Renderable * ) > callback )
 {
     for ( auto &r : *renderables ) {
@@ -165,4 +333,3 @@ void RenderQueue::each( std::function< void ( Light *, int ) > callback )
         }
     }
 }
-
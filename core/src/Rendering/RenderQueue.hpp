@@ -30,6 +30,8 @@
 
 #include "Foundation/SharedObject.hpp"
 #include "Foundation/SharedObjectList.hpp"
+#include "Foundation/Types.hpp"
+#include "Foundation/LinearArena.hpp"
 
 #include "SceneGraph/Geometry.hpp"
 #include "SceneGraph/Camera.hpp"
@@ -40,6 +42,7 @@
 #include <functional>
 #include <vector>
 #include <chrono>
+#include <unordered_map>
 
 namespace crimild {
     
@@ -47,13 +50,68 @@ namespace crimild {
 
     using RenderQueuePtr = SharedPointer< RenderQueue >;
 
+    /**
+        \brief Visible objects for a given camera, grouped by type
+
+        Renderables are appended to contiguous arrays while the scene is
+        traversed and then sorted once using a 64-bit key. For all types
+        except translucent objects the key is composed of (from most to
+        least significant bits):
+
+        [ program: 16 bits ][ material: 16 bits ][ primitive: 16 bits ][ depth: 16 bits ]
+
+        so consecutive renderables share state whenever possible and are
+        ordered front to back otherwise. Translucent objects must be
+        rendered back to front, so depth is the most significant part of
+        their keys instead.
+
+        After sorting, consecutive renderables sharing both primitive and
+        material are grouped into instance batches, which can be drawn
+        with a single call using one model matrix per instance.
+
+        \remarks Renderables do not retain their geometries, materials or
+        primitives. The queue retains each of them once instead, since a
+        geometry may replace its materials (i.e. when updating render
+        states) before the queue is rendered.
+
+        \remarks If an arena is provided, all internal buffers are allocated
+        from it. Queues are rebuilt every frame, so this avoids hitting the
+        heap once the arena has grown enough. The queue keeps a reference
+        to the arena, preventing it from being reset while in use.
+     */
     class RenderQueue : public SharedObject {
     public:
+        using SortKey = crimild::UInt64;
+
         struct Renderable {
-            SharedPointer< Geometry > geometry;
-            SharedPointer< Material > material;
+            Geometry *geometry;
+            Material *material;
+
+            /**
+                \brief The only primitive in the geometry, if it can be instanced
+
+                Null for geometries with several primitives or skinned meshes
+             */
+            Primitive *primitive;
+
             Matrix4f modelTransform;
             double distanceFromCamera;
+            SortKey sortKey;
+        };
+
+        struct InstanceBatch {
+            /**
+                \brief Index of the first renderable in the batch
+             */
+            crimild::Size first;
+            crimild::Size instanceCount;
+
+            /**
+                \brief Index of the first model matrix in the instance transforms buffer
+
+                Only valid when instanceCount > 1
+             */
+            crimild::Size firstTransform;
         };
         
         enum class RenderableType {
@@ -63,11 +121,14 @@ namespace crimild {
             TRANSLUCENT,
             SCREEN, // deprecated
         };
+
+        static constexpr crimild::Size RENDERABLE_TYPE_COUNT = static_cast< crimild::Size >( RenderableType::SCREEN ) + 1;
         
-        using Renderables = std::list< Renderable >;
+        using Renderables = std::vector< Renderable, ArenaAllocator< Renderable >>;
+        using InstanceBatches = std::vector< InstanceBatch, ArenaAllocator< InstanceBatch >>;
 
     public:
-        explicit RenderQueue( void );
+        explicit RenderQueue( LinearArenaPtr const &arena = nullptr );
         virtual ~RenderQueue( void );
 
     public:
@@ -82,20 +143,85 @@ namespace crimild {
         void push( Geometry *geometry );
         void push( Light *light );
 
-        Renderables *getRenderables( RenderableType type ) { return &_renderables[ type ]; }
+        /**
+            \brief Sorts all pending renderables
+
+            This is invoked automatically when accessing renderables, but
+            it can be called in advance (i.e. when computing the queue in
+            a worker thread) to avoid stalling the rendering thread.
+         */
+        void sort( void );
+
+        Renderables *getRenderables( RenderableType type );
+
+        InstanceBatches *getInstanceBatches( RenderableType type );
+        const Matrix4f *getInstanceTransforms( const InstanceBatch &batch ) const { return &_instanceTransforms[ batch.firstTransform ]; }
         
         void each( Renderables *renderables, std::function< void( Renderable * ) > callback );
         void each( std::function< void( Light *, int ) > callback );
 
     private:
+        using StateIds = std::unordered_map<
+            const void *,
+            crimild::UInt16,
+            std::hash< const void * >,
+            std::equal_to< const void * >,
+            ArenaAllocator< std::pair< const void *const, crimild::UInt16 >>
+        >;
+
+        crimild::UInt16 getStateId( StateIds &ids, const void *state );
+        void pushRenderable( RenderableType type, Geometry *geometry, Material *material, Primitive *primitive, const Matrix4f &modelTransform, double distanceFromCamera, SortKey sortKey );
+        void sort( RenderableType type );
+        void computeInstanceBatches( RenderableType type );
+
+    private:
+        /**
+            \brief Backing memory for all containers
+
+            Must be declared first so it's released last
+         */
+        LinearArenaPtr _arena;
+
         SharedPointer< Camera > _camera;
         
         Matrix4f _viewMatrix;
         Matrix4f _projectionMatrix;
         
-        std::vector< SharedPointer< Light >> _lights;
+        std::vector< SharedPointer< Light >, ArenaAllocator< SharedPointer< Light >>> _lights;
+        std::vector< SharedPointer< Geometry >, ArenaAllocator< SharedPointer< Geometry >>> _geometries;
+        std::vector< SharedPointer< Material >, ArenaAllocator< SharedPointer< Material >>> _materials;
+        std::vector< SharedPointer< Primitive >, ArenaAllocator< SharedPointer< Primitive >>> _primitives;
+
+        Renderables _renderables[ RENDERABLE_TYPE_COUNT ];
+        InstanceBatches _instanceBatches[ RENDERABLE_TYPE_COUNT ];
+        bool _sorted[ RENDERABLE_TYPE_COUNT ];
+
+        std::vector< Matrix4f, ArenaAllocator< Matrix4f >> _instanceTransforms;
+
+        /**
+            \name Sorting
+         */
+        //@{
+
+        struct SortEntry {
+            SortKey key;
+            crimild::UInt32 index;
+        };
+
+        using SortEntries = std::vector< SortEntry, ArenaAllocator< SortEntry >>;
+
+        SortEntries _sortEntries;
+        SortEntries _sortScratch;
+        Renderables _sortedRenderables;
+
+        /**
+            \brief Dense ids for programs and materials, used to build sort keys
+         */
+        StateIds _programIds;
+        StateIds _materialIds;
+        StateIds _primitiveIds;
 
-        std::map< RenderableType, Renderables > _renderables;
+        //@}
         
     public:
         unsigned long getTimestamp( void ) const { return _timestamp; }
@@ -126,6 +126,9 @@ SharedPointer< FrameBufferObject > Renderer::generateAuxFBO( std::string name, i
 
 void Renderer::beginRender( void )
 {
+    resetRenderStats();
+    invalidateRenderStateCache();
+
     static const Rectf VIEWPORT( 0.0f, 0.0f, 1.0f, 1.0f );
     setViewport( VIEWPORT );
 }
@@ -170,8 +173,31 @@ void Renderer::unbindFrameBuffer( FrameBufferObject *fbo )
 	getFrameBufferObjectCatalog()->unbind( fbo );
 }
 
+void Renderer::invalidateRenderStateCache( void )
+{
+    // cached state is only forgotten. Anything still bound must be unbound by its owner
+    _boundProgram = nullptr;
+    _boundMaterial = nullptr;
+    _boundTextures.clear();
+    _boundLights.clear();
+    _cachedUniforms.clear();
+}
+
 void Renderer::bindProgram( ShaderProgram *program )
 {
+    if ( program == _boundProgram ) {
+        _renderStats.programs.skipped++;
+        return;
+    }
+
+    if ( _boundMaterial != nullptr && _boundProgram != nullptr ) {
+        // material bindings belong to the previous program
+        unbindMaterial( _boundProgram, _boundMaterial );
+    }
+
+    _renderStats.programs.issued++;
+    _boundProgram = program;
+
 	getShaderProgramCatalog()->bind( program );
 
     auto self = this;
@@ -184,11 +210,31 @@ void Renderer::bindProgram( ShaderProgram *program )
 
 void Renderer::unbindProgram( ShaderProgram *program )
 {	
+    if ( _boundMaterial != nullptr && program == _boundProgram ) {
+        unbindMaterial( program, _boundMaterial );
+    }
+
+    if ( program == _boundProgram ) {
+        _boundProgram = nullptr;
+    }
+
 	getShaderProgramCatalog()->unbind( program );
 }
 
 void Renderer::bindMaterial( ShaderProgram *program, Material *material )
 {
+    if ( material == _boundMaterial && program == _boundProgram ) {
+        _renderStats.materials.skipped++;
+        return;
+    }
+
+    if ( _boundMaterial != nullptr ) {
+        unbindMaterial( program, _boundMaterial );
+    }
+
+    _renderStats.materials.issued++;
+    _boundMaterial = material;
+
 	bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::MATERIAL_USE_COLOR_MAP_UNIFORM ), material->getColorMap() != nullptr );
 	if ( material->getColorMap() != nullptr ) {
 		auto loc = program->getStandardLocation( ShaderProgram::StandardLocation::MATERIAL_COLOR_MAP_UNIFORM );
@@ -227,6 +273,10 @@ void Renderer::bindMaterial( ShaderProgram *program, Material *material )
 
 void Renderer::unbindMaterial( ShaderProgram *program, Material *material )
 {
+    if ( material == _boundMaterial ) {
+        _boundMaterial = nullptr;
+    }
+
 	unbindTexture( program->getStandardLocation( ShaderProgram::StandardLocation::MATERIAL_COLOR_MAP_UNIFORM ), material->getColorMap() );
 	unbindTexture( program->getStandardLocation( ShaderProgram::StandardLocation::MATERIAL_NORMAL_MAP_UNIFORM ), material->getNormalMap() );
 	unbindTexture( program->getStandardLocation( ShaderProgram::StandardLocation::MATERIAL_SPECULAR_MAP_UNIFORM ), material->getSpecularMap() );
@@ -235,14 +285,59 @@ void Renderer::unbindMaterial( ShaderProgram *program, Material *material )
 
 void Renderer::bindTexture( ShaderLocation *location, Texture *texture )
 {
+    if ( location != nullptr ) {
+        auto it = _boundTextures.find( location );
+        if ( it != _boundTextures.end() && it->second.texture == texture ) {
+            // already bound. Keep count so only the last unbind is issued
+            it->second.count++;
+            _renderStats.textures.skipped++;
+            return;
+        }
+        _boundTextures[ location ] = BoundTexture { texture, 1 };
+    }
+
+    _renderStats.textures.issued++;
+
 	getTextureCatalog()->bind( location, texture );
 }
 
 void Renderer::unbindTexture( ShaderLocation *location, Texture *texture )
 {
+    if ( texture == nullptr ) {
+        return;
+    }
+
+    if ( location != nullptr ) {
+        auto it = _boundTextures.find( location );
+        if ( it != _boundTextures.end() && it->second.texture == texture ) {
+            if ( --it->second.count > 0 ) {
+                return;
+            }
+            _boundTextures.erase( it );
+        }
+    }
+
 	getTextureCatalog()->unbind( location, texture );
 }
 
+void Renderer::bindCachedUniform( ShaderLocation *location, const Matrix4f &matrix )
+{
+    if ( location == nullptr ) {
+        return;
+    }
+
+    auto it = _cachedUniforms.find( location );
+    if ( it != _cachedUniforms.end() && it->second == matrix ) {
+        _renderStats.uniforms.skipped++;
+        return;
+    }
+
+    _renderStats.uniforms.issued++;
+    _cachedUniforms[ location ] = matrix;
+
+    bindUniform( location, matrix );
+}
+
 void Renderer::bindLight( ShaderProgram *program, Light *light )
 {
 	float lightType = 0;
@@ -260,6 +355,22 @@ void Renderer::bindLight( ShaderProgram *program, Light *light )
 			break;
 	}
 
+	auto &boundLights = _boundLights[ program ];
+	if ( boundLights.size() <= ( size_t ) _lightCount ) {
+		boundLights.resize( _lightCount + 1, nullptr );
+	}
+
+	if ( boundLights[ _lightCount ] == light ) {
+		// this light was already bound to the same slot in this frame
+		_renderStats.lights.skipped++;
+		++_lightCount;
+		bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::LIGHT_COUNT_UNIFORM ), _lightCount );
+		return;
+	}
+
+	_renderStats.lights.issued++;
+	boundLights[ _lightCount ] = light;
+
 	bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::LIGHT_TYPE_UNIFORM + _lightCount ), lightType );
 	bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::LIGHT_POSITION_UNIFORM + _lightCount ), light->getPosition() );
 	bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::LIGHT_ATTENUATION_UNIFORM + _lightCount ), light->getAttenuation() );
@@ -336,6 +447,15 @@ void Renderer::restoreTransformations( ShaderProgram *program, Geometry* geometr
 
 }
 
+void Renderer::drawPrimitiveInstanced( ShaderProgram *program, Primitive *primitive, const Matrix4f *modelTransforms, crimild::Size instanceCount )
+{
+    auto location = program->getStandardLocation( ShaderProgram::StandardLocation::MODEL_MATRIX_UNIFORM );
+    for ( crimild::Size i = 0; i < instanceCount; i++ ) {
+        bindUniform( location, modelTransforms[ i ] );
+        drawPrimitive( program, primitive );
+    }
+}
+
 void Renderer::drawScreenPrimitive( ShaderProgram *program )
 {
     // bind vertex and index buffers
@@ -38,6 +38,8 @@
 #include "Mathematics/Rect.hpp"
 
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace crimild {
     
@@ -130,6 +132,66 @@ namespace crimild {
 	private:
 		int _lightCount;
 
+	public:
+		/**
+		   \name Render state cache
+
+		   The renderer keeps track of bound programs, materials, textures and
+		   lights, skipping any bind that would not change the current state.
+		   Light and matrix uniforms are kept per program (just like uniform
+		   values are stored in program objects) so switching back to a program
+		   does not require uploading them again.
+
+		   The cache is invalidated at the beginning of each frame, when
+		   render stats are reset too.
+		 */
+		//@{
+
+		struct BindCount {
+			crimild::Size issued = 0;
+			crimild::Size skipped = 0;
+		};
+
+		struct RenderStats {
+			BindCount programs;
+			BindCount materials;
+			BindCount textures;
+			BindCount lights;
+			BindCount uniforms;
+		};
+
+		const RenderStats &getRenderStats( void ) const { return _renderStats; }
+		void resetRenderStats( void ) { _renderStats = RenderStats(); }
+
+		void invalidateRenderStateCache( void );
+
+		/**
+		   \brief Binds a matrix uniform only if its value changed since the last bind
+
+		   Intended for values that stay the same for many draw calls,
+		   like camera or light matrices.
+
+		   \remarks Binding the same location with bindUniform() is not
+		   tracked by the cache. Avoid mixing both for a given location.
+		 */
+		void bindCachedUniform( ShaderLocation *location, const Matrix4f &matrix );
+
+	private:
+		RenderStats _renderStats;
+
+		ShaderProgram *_boundProgram = nullptr;
+		Material *_boundMaterial = nullptr;
+
+		struct BoundTexture {
+			Texture *texture;
+			crimild::Size count;
+		};
+		std::unordered_map< ShaderLocation *, BoundTexture > _boundTextures;
+		std::unordered_map< ShaderProgram *, std::vector< Light * >> _boundLights;
+		std::unordered_map< ShaderLocation *, Matrix4f > _cachedUniforms;
+
+		//@}
+
 	public:
 		virtual void bindVertexBuffer( ShaderProgram *program, VertexBufferObject *vbo );
 		virtual void unbindVertexBuffer( ShaderProgram *program, VertexBufferObject *vbo );
@@ -146,6 +208,15 @@ namespace crimild {
 	public:
 		virtual void drawPrimitive( ShaderProgram *program, Primitive *primitive ) = 0;
 
+		/**
+			\brief Draws several instances of a primitive, each one with its own model matrix
+
+			Backends supporting hardware instancing should upload all transforms
+			at once and issue a single draw call. The default implementation
+			binds the model matrix and draws each instance separately.
+		 */
+		virtual void drawPrimitiveInstanced( ShaderProgram *program, Primitive *primitive, const Matrix4f *modelTransforms, crimild::Size instanceCount );
+
 		/**
 			\brief optional
 		 */
@@ -55,6 +55,7 @@ namespace crimild {
 				COLOR_ATTRIBUTE,
 				BONE_IDS_ATTRIBUTE,
 				BONE_WEIGHTS_ATTRIBUTE,
+				INSTANCE_MODEL_MATRIX_ATTRIBUTE,
 
 				PROJECTION_MATRIX_UNIFORM = 100,
 				VIEW_MATRIX_UNIFORM,
@@ -109,6 +110,8 @@ namespace crimild {
 
                 SKINNED_MESH_JOINT_COUNT_UNIFORM = 6000,
                 SKINNED_MESH_JOINT_POSE_UNIFORM,
+
+                USE_INSTANCING_UNIFORM = 7000,
                 
                 LINEAR_DEPTH_CONSTANT_UNIFORM = 8000,
                 
@@ -174,3 +174,29 @@ bool Camera::culled( const BoundingVolume *volume ) const
 	return false;
 }
 
+bool Camera::culled( const BoundingVolume *volume, crimild::UInt32 &planeMask ) const
+{
+    if ( !isCullingEnabled() ) {
+        return false;
+    }
+
+	for ( crimild::UInt32 i = 0; i < 6 && planeMask != 0; i++ ) {
+		const crimild::UInt32 bit = 1 << i;
+		if ( ( planeMask & bit ) == 0 ) {
+			continue;
+		}
+
+		auto side = volume->whichSide( _cullingPlanes[ i ] );
+		if ( side < 0 ) {
+			return true;
+		}
+
+		if ( side > 0 ) {
+			// volume is completely in front of this plane
+			planeMask &= ~bit;
+		}
+	}
+
+	return false;
+}
+
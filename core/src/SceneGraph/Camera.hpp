@@ -119,6 +119,21 @@ namespace crimild {
 
 		bool culled( const BoundingVolume *volume ) const;
 
+		/**
+		   \brief Mask with all culling planes enabled
+		 */
+		static constexpr crimild::UInt32 CULLING_PLANES_ALL = 0x3F;
+
+		/**
+		   \brief Test a volume against the planes enabled in the mask
+
+		   Bit i of the mask indicates that plane i still needs to be
+		   tested. Planes that the volume lies completely in front of are
+		   removed from the mask, so children of that volume can skip
+		   them. An empty mask means the volume is fully inside the frustum.
+		 */
+		bool culled( const BoundingVolume *volume, crimild::UInt32 &planeMask ) const;
+
 	private:
         bool _cullingEnabled = true;
 		Plane3f _cullingPlanes[ 6 ];
@@ -46,6 +46,7 @@ namespace crimild {
 		virtual ~Geometry( void );
 
 		bool hasPrimitives( void ) const { return _primitives.size(); }
+		crimild::Size getPrimitiveCount( void ) const { return _primitives.size(); }
         
         void attachPrimitive( Primitive *primitive );
 		void attachPrimitive( SharedPointer< Primitive > const &primitive );
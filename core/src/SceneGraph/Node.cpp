@@ -30,6 +30,9 @@
 
 #include "Boundings/AABBBoundingVolume.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 CRIMILD_REGISTER_STREAM_OBJECT_BUILDER( crimild::Node )
 
 using namespace crimild;
@@ -100,11 +103,20 @@ void Node::attachComponent( SharedPointer< NodeComponent > const &component )
 		return;
 	}
 
+    auto name = component->getComponentName();
+    auto typeId = NodeComponent::getTypeIdForName( name );
+
     // ignore return?
-	detachComponentWithName( component->getComponentName() );
+	detachComponentWithTypeId( typeId );
     
 	component->setNode( this );
-	_components[ component->getComponentName() ] = component;
+    component->setComponentTypeId( typeId );
+
+    auto it = std::find_if( _components.begin(), _components.end(), [ name ]( ComponentEntry const &entry ) {
+        return std::strcmp( entry.component->getComponentName(), name ) > 0;
+    });
+    _components.insert( it, ComponentEntry { typeId, component } );
+
 	component->onAttach();
 }
 
@@ -125,20 +137,34 @@ void Node::detachComponent( SharedPointer< NodeComponent > const &component )
 
 SharedPointer< NodeComponent > Node::detachComponentWithName( std::string name )
 {
-	if ( _components.find( name ) != _components.end() ) {
-        auto current = _components[ name ];
-        if ( current != nullptr ) {
-            current->onDetach();
-            current->setNode( nullptr );
-        }
+    return detachComponentWithTypeId( NodeComponent::findTypeIdForName( name ) );
+}
 
-        _components[ name ] = nullptr;
-		_components.erase( name );
-        
-        return current;
-	}
+SharedPointer< NodeComponent > Node::detachComponentWithTypeId( NodeComponent::TypeId typeId )
+{
+    auto it = std::find_if( _components.begin(), _components.end(), [ typeId ]( ComponentEntry const &entry ) {
+        return entry.typeId == typeId;
+    });
+
+	if ( it == _components.end() ) {
+        return nullptr;
+    }
+
+    auto current = it->component;
+    if ( current != nullptr ) {
+        current->onDetach();
+        current->setNode( nullptr );
+    }
+
+    // onDetach() may have modified the component array
+    _components.erase(
+        std::remove_if( _components.begin(), _components.end(), [ &current ]( ComponentEntry const &entry ) {
+            return entry.component == current;
+        }),
+        _components.end()
+    );
     
-    return nullptr;
+    return current;
 }
 
 void Node::detachAllComponents( void )
@@ -168,9 +194,9 @@ void Node::forEachComponent( std::function< void ( NodeComponent * ) > callback
 	// components during an update pass
     // TODO: should we lock this instead?
 	auto cs = _components;
-	for ( auto cmp : cs ) {
-		if ( cmp.second != nullptr ) {
-            callback( crimild::get_ptr( cmp.second ) );
+	for ( auto &entry : cs ) {
+		if ( entry.component != nullptr ) {
+            callback( crimild::get_ptr( entry.component ) );
 		}
 	}
 }
@@ -197,9 +223,9 @@ void Node::save( Stream &s )
     s.write( _local );
 
     std::vector< SharedPointer< NodeComponent >> cs;
-    for ( auto &it : _components ) {
-        if ( it.second != nullptr ) {
-            cs.push_back( it.second );
+    for ( auto &entry : _components ) {
+        if ( entry.component != nullptr ) {
+            cs.push_back( entry.component );
         }
     }
     s.write( cs );
@@ -36,7 +36,7 @@
 #include "Mathematics/Transformation.hpp"
 #include "Boundings/BoundingVolume.hpp"
 
-#include <map>
+#include <vector>
 
 namespace crimild {
     
@@ -91,15 +91,32 @@ namespace crimild {
 		virtual void accept( NodeVisitor &visitor );
 
 	public:
+        /**
+            \brief Get a component by its name
+         
+            This is the slow path. Prefer getComponent<T>() when the
+            component class is known
+         */
         NodeComponent *getComponentWithName( std::string name )
         {
-            return crimild::get_ptr( _components[ name ] );
+            return getComponentWithTypeId( NodeComponent::findTypeIdForName( name ) );
+        }
+        
+        NodeComponent *getComponentWithTypeId( NodeComponent::TypeId typeId )
+        {
+            for ( auto &entry : _components ) {
+                if ( entry.typeId == typeId ) {
+                    return crimild::get_ptr( entry.component );
+                }
+            }
+            
+            return nullptr;
         }
         
         template< class NODE_COMPONENT_CLASS >
         NODE_COMPONENT_CLASS *getComponent( void )
         {
-            return static_cast< NODE_COMPONENT_CLASS * >( getComponentWithName( NODE_COMPONENT_CLASS::__CLASS_NAME ) );
+            return static_cast< NODE_COMPONENT_CLASS * >( getComponentWithTypeId( NodeComponent::getTypeId< NODE_COMPONENT_CLASS >() ) );
         }
         
         bool hasComponent( SharedPointer< NodeComponent > const &component )
@@ -109,8 +126,13 @@ namespace crimild {
         
         bool hasComponent( NodeComponent *component )
         {
-            auto it = _components.find( component->getComponentName() );
-            return ( it != _components.end() && crimild::get_ptr( it->second ) == component );
+            for ( auto &entry : _components ) {
+                if ( crimild::get_ptr( entry.component ) == component ) {
+                    return true;
+                }
+            }
+            
+            return false;
         }
         
 		void attachComponent( NodeComponent *component );
@@ -128,6 +150,8 @@ namespace crimild {
 		void detachComponent( SharedPointer< NodeComponent > const &component );
 		
         SharedPointer< NodeComponent > detachComponentWithName( std::string name );
+        
+        SharedPointer< NodeComponent > detachComponentWithTypeId( NodeComponent::TypeId typeId );
 		
         void detachAllComponents( void );
 
@@ -138,7 +162,20 @@ namespace crimild {
 		void forEachComponent( std::function< void ( NodeComponent * ) > callback );
 
 	private:
-		std::map< std::string, SharedPointer< NodeComponent >> _components;
+        struct ComponentEntry {
+            NodeComponent::TypeId typeId;
+            SharedPointer< NodeComponent > component;
+        };
+        
+        /**
+            \brief Attached components, at most one per type id
+         
+            Nodes usually have very few components, so a linear search
+            over a flat array is faster than any associative container.
+            Entries are kept sorted by component name so components are
+            updated and saved in a stable order.
+         */
+		std::vector< ComponentEntry > _components;
 
 	public:
 		void setLocal( const Transformation &t ) { _local = t; }
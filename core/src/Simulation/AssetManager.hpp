@@ -93,21 +93,116 @@ namespace crimild {
             return shallowCopy.getResult< T >();
         }
 
+        /**
+            \brief Removes cached assets
+
+            Resident assets are kept unless clearAll is true
+
+            \see acquire()
+        */
         void clear( bool clearAll = false )
         {
             ScopedLock lock( _mutex );
             
-            _assets.clear();
-            
             if ( clearAll ) {
+                _assets.clear();
                 _persistentAssets.clear();
+                _residency.clear();
+                return;
+            }
+
+            for ( auto it = _assets.begin(); it != _assets.end(); ) {
+                if ( _residency.find( it->first ) == _residency.end() ) {
+                    it = _assets.erase( it );
+                }
+                else {
+                    it++;
+                }
             }
         }
 
     private:
         std::map< std::string, SharedPointer< SharedObject > > _assets;
         std::map< std::string, SharedPointer< SharedObject > > _persistentAssets;
-        
+
+        /**
+            \name Residency
+
+            Assets can be acquired by several clients (like streamed world
+            chunks sharing textures). Acquired assets remain resident until
+            every client releases them.
+        */
+        //@{
+
+    public:
+        /**
+            \brief Adds an asset to the cache and increases its reference count
+        */
+        void acquire( std::string name, SharedPointer< SharedObject > const &asset, unsigned int count = 1 )
+        {
+            ScopedLock lock( _mutex );
+
+            _assets[ name ] = asset;
+            _residency[ name ] += count;
+        }
+
+        /**
+            \brief Increases the reference count of an asset already in the cache
+
+            \returns false if there is no asset with that name
+        */
+        bool acquire( std::string name )
+        {
+            ScopedLock lock( _mutex );
+
+            auto it = _assets.find( name );
+            if ( it == _assets.end() || it->second == nullptr ) {
+                return false;
+            }
+
+            _residency[ name ]++;
+            return true;
+        }
+
+        /**
+            \brief Decreases the reference count of an asset
+
+            The asset is removed from the cache once it is no longer referenced
+
+            \returns true if the asset was removed
+        */
+        bool release( std::string name )
+        {
+            ScopedLock lock( _mutex );
+
+            auto it = _residency.find( name );
+            if ( it == _residency.end() ) {
+                return false;
+            }
+
+            if ( --it->second > 0 ) {
+                return false;
+            }
+
+            _residency.erase( it );
+            _assets.erase( name );
+            return true;
+        }
+
+        unsigned int getReferenceCount( std::string name )
+        {
+            ScopedLock lock( _mutex );
+
+            auto it = _residency.find( name );
+            return it != _residency.end() ? it->second : 0;
+        }
+
+    private:
+        std::map< std::string, unsigned int > _residency;
+
+        //@}
+
+    private:
         Mutex _mutex;
 
     public:
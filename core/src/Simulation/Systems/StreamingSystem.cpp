@@ -29,21 +29,49 @@
 
 #include "Simulation/Simulation.hpp"
 #include "Simulation/FileSystem.hpp"
+#include "Simulation/AssetManager.hpp"
+
+#include "Streaming/MappedFileStream.hpp"
+#include "Foundation/StringUtils.hpp"
  
 #include "Concurrency/Async.hpp"
 
+#include <algorithm>
+
 using namespace crimild;
 
+template< class MessageType >
+void StreamingSystem::postAssetMessage( MessageType const &message )
+{
+	if ( !crimild::concurrency::JobScheduler::hasInstance() ) {
+		return;
+	}
+
+	crimild::concurrency::sync_frame( [ message ] {
+		MessageQueue::getInstance()->broadcastMessage( message );
+	});
+}
+
 StreamingSystem::StreamingSystem( void )
     : System( "Streaming System" )
 {
 	CRIMILD_BIND_MEMBER_MESSAGE_HANDLER( messaging::LoadScene, StreamingSystem, onLoadScene );
 	CRIMILD_BIND_MEMBER_MESSAGE_HANDLER( messaging::ReloadScene, StreamingSystem, onReloadScene );
+
+	setAssetLoader( ".crimild", []( std::string const &path ) -> SharedPointer< SharedObject > {
+		MappedFileStream is( path );
+		is.setLoadMode( Stream::LoadMode::PARALLEL );
+		if ( !is.load() || is.getObjectCount() == 0 ) {
+			return nullptr;
+		}
+		return is.getObjectAt< StreamObject >( 0 );
+	});
 }
 
 StreamingSystem::~StreamingSystem( void )
 {
-
+	cancelAllAssetRequests();
+	waitForAssetLoads();
 }
 
 bool StreamingSystem::start( void )
@@ -53,7 +81,8 @@ bool StreamingSystem::start( void )
 
 void StreamingSystem::stop( void )
 {
-
+	cancelAllAssetRequests();
+	waitForAssetLoads();
 }
 
 void StreamingSystem::onLoadScene( messaging::LoadScene const &message )
@@ -97,6 +126,7 @@ void StreamingSystem::loadScene( std::string filename, SceneBuilder *builder )
 	// Then, once the scene is completely loaded, we set it as the current 
 	// scene again in main thread to avoid changing scenes when rendering or updating
     crimild::concurrency::async_frame( [sceneBuilder, filename] {
+        // assets acquired using requestAsset() remain resident
         AssetManager::getInstance()->clear();
     
         sceneBuilder->reset();
@@ -110,3 +140,264 @@ void StreamingSystem::loadScene( std::string filename, SceneBuilder *builder )
     });
 }
 
+void StreamingSystem::setAssetLoader( std::string extension, AssetLoader const &loader )
+{
+	std::lock_guard< std::mutex > lock( _assetMutex );
+
+	_assetLoaders[ extension ] = loader;
+}
+
+StreamingSystem::AssetLoader StreamingSystem::getAssetLoader( std::string const &filename )
+{
+	std::lock_guard< std::mutex > lock( _assetMutex );
+
+	auto it = _assetLoaders.find( StringUtils::getFileExtension( filename ) );
+	return it != _assetLoaders.end() ? it->second : nullptr;
+}
+
+void StreamingSystem::setMaxConcurrentAssetLoads( size_t count )
+{
+	{
+		std::lock_guard< std::mutex > lock( _assetMutex );
+		_maxConcurrentAssetLoads = count > 0 ? count : 1;
+	}
+
+	dispatchAssetLoads();
+}
+
+AssetRequestId StreamingSystem::requestAsset( std::string filename, crimild::Int32 priority )
+{
+	AssetRequestId requestId;
+	bool resident = false;
+	messaging::AssetStreamingProgress progress;
+
+	{
+		std::lock_guard< std::mutex > lock( _assetMutex );
+
+		requestId = _nextAssetRequestId++;
+
+		auto it = _assetLoads.find( filename );
+		if ( it != _assetLoads.end() ) {
+			// merge with a pending or in-progress load
+			auto load = it->second;
+			if ( load->job == nullptr && priority > load->priority ) {
+				_pendingAssetLoads.erase( load );
+				load->priority = priority;
+				_pendingAssetLoads.insert( load );
+			}
+			load->requestIds.push_back( requestId );
+			_assetRequests[ requestId ] = load;
+			_requestedAssetCount++;
+		}
+		else if ( AssetManager::getInstance()->acquire( filename ) ) {
+			resident = true;
+		}
+		else {
+			auto load = crimild::alloc< AssetLoad >();
+			load->filename = filename;
+			load->priority = priority;
+			load->sequence = _nextAssetSequence++;
+			load->requestIds.push_back( requestId );
+
+			_assetLoads[ filename ] = load;
+			_assetRequests[ requestId ] = load;
+			_pendingAssetLoads.insert( load );
+			_requestedAssetCount++;
+		}
+
+		progress = computeAssetStreamingProgress();
+	}
+
+	if ( resident ) {
+		postAssetMessage( messaging::AssetLoaded { requestId, filename } );
+		return requestId;
+	}
+
+	postAssetMessage( progress );
+
+	dispatchAssetLoads();
+
+	return requestId;
+}
+
+bool StreamingSystem::cancelAssetRequest( AssetRequestId requestId )
+{
+	std::string filename;
+	messaging::AssetStreamingProgress progress;
+
+	{
+		std::lock_guard< std::mutex > lock( _assetMutex );
+
+		auto it = _assetRequests.find( requestId );
+		if ( it == _assetRequests.end() ) {
+			return false;
+		}
+
+		auto load = it->second;
+		_assetRequests.erase( it );
+
+		auto &ids = load->requestIds;
+		ids.erase( std::remove( ids.begin(), ids.end(), requestId ), ids.end() );
+
+		if ( ids.empty() && load->job == nullptr ) {
+			// nobody is waiting for this asset anymore
+			_pendingAssetLoads.erase( load );
+			_assetLoads.erase( load->filename );
+		}
+
+		filename = load->filename;
+		_completedAssetCount++;
+		progress = computeAssetStreamingProgress();
+	}
+
+	postAssetMessage( messaging::AssetLoadCancelled { requestId, filename } );
+	postAssetMessage( progress );
+
+	return true;
+}
+
+void StreamingSystem::cancelAllAssetRequests( void )
+{
+	std::vector< AssetRequestId > requestIds;
+
+	{
+		std::lock_guard< std::mutex > lock( _assetMutex );
+
+		requestIds.reserve( _assetRequests.size() );
+		for ( auto &it : _assetRequests ) {
+			requestIds.push_back( it.first );
+		}
+	}
+
+	std::sort( requestIds.begin(), requestIds.end() );
+	for ( auto requestId : requestIds ) {
+		cancelAssetRequest( requestId );
+	}
+}
+
+void StreamingSystem::releaseAsset( std::string filename )
+{
+	AssetManager::getInstance()->release( filename );
+}
+
+size_t StreamingSystem::getPendingAssetCount( void )
+{
+	std::lock_guard< std::mutex > lock( _assetMutex );
+
+	return _pendingAssetLoads.size();
+}
+
+size_t StreamingSystem::getLoadingAssetCount( void )
+{
+	std::lock_guard< std::mutex > lock( _assetMutex );
+
+	return _loadingAssetCount;
+}
+
+void StreamingSystem::waitForAssetLoads( void )
+{
+	while ( true ) {
+		std::vector< concurrency::JobPtr > jobs;
+
+		{
+			std::lock_guard< std::mutex > lock( _assetMutex );
+
+			for ( auto &it : _assetLoads ) {
+				if ( it.second->job != nullptr ) {
+					jobs.push_back( it.second->job );
+				}
+			}
+		}
+
+		if ( jobs.empty() ) {
+			break;
+		}
+
+		for ( auto &job : jobs ) {
+			crimild::concurrency::wait( job );
+		}
+	}
+}
+
+void StreamingSystem::dispatchAssetLoads( void )
+{
+	std::lock_guard< std::mutex > lock( _assetMutex );
+
+	while ( _loadingAssetCount < _maxConcurrentAssetLoads && !_pendingAssetLoads.empty() ) {
+		auto load = *_pendingAssetLoads.begin();
+		_pendingAssetLoads.erase( _pendingAssetLoads.begin() );
+		_loadingAssetCount++;
+
+		load->job = crimild::concurrency::async( [ this, load ] {
+			loadAsset( load );
+		});
+	}
+}
+
+void StreamingSystem::loadAsset( AssetLoadPtr const &load )
+{
+	SharedPointer< SharedObject > asset;
+
+	auto loader = getAssetLoader( load->filename );
+	if ( loader != nullptr ) {
+		asset = loader( FileSystem::getInstance().pathForResource( load->filename ) );
+	}
+	else {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "No loader for asset ", load->filename );
+	}
+
+	std::vector< AssetRequestId > requestIds;
+	messaging::AssetStreamingProgress progress;
+
+	{
+		std::lock_guard< std::mutex > lock( _assetMutex );
+
+		requestIds = load->requestIds;
+		for ( auto requestId : requestIds ) {
+			_assetRequests.erase( requestId );
+		}
+
+		// assets whose requests were all cancelled are discarded
+		if ( asset != nullptr && !requestIds.empty() ) {
+			AssetManager::getInstance()->acquire( load->filename, asset, requestIds.size() );
+		}
+
+		_assetLoads.erase( load->filename );
+		_loadingAssetCount--;
+		_completedAssetCount += requestIds.size();
+		progress = computeAssetStreamingProgress();
+
+		// break the cycle between the load and its job
+		load->job = nullptr;
+	}
+
+	for ( auto requestId : requestIds ) {
+		if ( asset != nullptr ) {
+			postAssetMessage( messaging::AssetLoaded { requestId, load->filename } );
+		}
+		else {
+			postAssetMessage( messaging::AssetLoadFailed { requestId, load->filename } );
+		}
+	}
+	postAssetMessage( progress );
+
+	dispatchAssetLoads();
+}
+
+messaging::AssetStreamingProgress StreamingSystem::computeAssetStreamingProgress( void )
+{
+	messaging::AssetStreamingProgress progress {
+		_pendingAssetLoads.size(),
+		_loadingAssetCount,
+		_completedAssetCount,
+		_requestedAssetCount,
+	};
+
+	if ( progress.pendingCount == 0 && progress.loadingCount == 0 ) {
+		// start a new batch
+		_completedAssetCount = 0;
+		_requestedAssetCount = 0;
+	}
+
+	return progress;
+}
@@ -32,8 +32,20 @@
 
 #include "Streaming/SceneBuilder.hpp"
 
+#include "Foundation/Types.hpp"
+#include "Concurrency/Job.hpp"
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
 namespace crimild {
 
+	using AssetRequestId = crimild::UInt64;
+
 	namespace messaging {
 
 		struct LoadScene {
@@ -42,6 +54,40 @@ namespace crimild {
 		};
 
 		struct ReloadScene { };
+
+		/**
+			\brief An asset requested with StreamingSystem::requestAsset() is available
+
+			The asset can be retrieved from the AssetManager using its filename
+		*/
+		struct AssetLoaded {
+			AssetRequestId requestId;
+			std::string filename;
+		};
+
+		struct AssetLoadFailed {
+			AssetRequestId requestId;
+			std::string filename;
+		};
+
+		struct AssetLoadCancelled {
+			AssetRequestId requestId;
+			std::string filename;
+		};
+
+		/**
+			\brief Reports the progress of asset streaming
+
+			Counters are reset once there are no pending or loading assets,
+			so completedCount / requestedCount can be used as the progress
+			of the current batch of requests
+		*/
+		struct AssetStreamingProgress {
+			size_t pendingCount;
+			size_t loadingCount;
+			size_t completedCount;
+			size_t requestedCount;
+		};
 		
 	}
 
@@ -67,6 +113,135 @@ namespace crimild {
 	private:
 		SharedPointer< SceneBuilder > _sceneBuilder;
 		std::string _lastSceneFileName;
+
+		/**
+			\name Asset streaming
+
+			Assets are loaded in background, highest priority first, and 
+			only a limited number of them are loaded at the same time so 
+			streaming never takes over every worker. Requests for an asset
+			that is already pending or loading are merged.
+
+			Loaded assets are stored in the AssetManager and acquired once 
+			per request. Invoke releaseAsset() for every AssetLoaded message 
+			received, so unused assets are evicted.
+
+			Messages are broadcasted from the main thread at the start of 
+			the next simulation step.
+		*/
+		//@{
+
+	public:
+		/**
+			\brief Loads an asset given its full path
+		*/
+		using AssetLoader = std::function< SharedPointer< SharedObject >( std::string const &path ) >;
+
+		/**
+			\brief Sets the loader used for files with the given extension (i.e. ".crimild")
+
+			Files with extension ".crimild" are loaded using a MappedFileStream 
+			by default
+		*/
+		void setAssetLoader( std::string extension, AssetLoader const &loader );
+
+		/**
+			\brief Sets how many assets can be loaded at the same time
+		*/
+		void setMaxConcurrentAssetLoads( size_t count );
+		size_t getMaxConcurrentAssetLoads( void ) const { return _maxConcurrentAssetLoads; }
+
+		/**
+			\brief Requests an asset to be loaded in background
+
+			\param priority Assets with higher priority are loaded first.
+			Requests with the same priority are served in order.
+		*/
+		AssetRequestId requestAsset( std::string filename, crimild::Int32 priority = 0 );
+
+		/**
+			\brief Cancels a request
+
+			Pending assets are never loaded if all of their requests are 
+			cancelled. Assets that are already being loaded are discarded 
+			once loaded.
+
+			\returns false if the request is already completed
+		*/
+		bool cancelAssetRequest( AssetRequestId requestId );
+
+		void cancelAllAssetRequests( void );
+
+		/**
+			\brief Releases an asset acquired by a completed request
+		*/
+		void releaseAsset( std::string filename );
+
+		size_t getPendingAssetCount( void );
+		size_t getLoadingAssetCount( void );
+
+		/**
+			\brief Blocks until all assets being loaded are completed
+
+			Pending assets are not loaded. Use with cancelAllAssetRequests() 
+			to stop streaming.
+		*/
+		void waitForAssetLoads( void );
+
+	private:
+		struct AssetLoad {
+			std::string filename;
+			crimild::Int32 priority;
+			crimild::UInt64 sequence;
+			std::vector< AssetRequestId > requestIds;
+			concurrency::JobPtr job;
+		};
+
+		using AssetLoadPtr = SharedPointer< AssetLoad >;
+
+		struct PendingAssetOrder {
+			bool operator()( AssetLoadPtr const &a, AssetLoadPtr const &b ) const
+			{
+				if ( a->priority != b->priority ) {
+					return a->priority > b->priority;
+				}
+				return a->sequence < b->sequence;
+			}
+		};
+
+		void dispatchAssetLoads( void );
+		void loadAsset( AssetLoadPtr const &load );
+		AssetLoader getAssetLoader( std::string const &filename );
+
+		/**
+			\brief Must be called while holding _assetMutex
+		*/
+		messaging::AssetStreamingProgress computeAssetStreamingProgress( void );
+
+		/**
+			\brief Broadcasts a message from the main thread
+		*/
+		template< class MessageType >
+		void postAssetMessage( MessageType const &message );
+
+	private:
+		std::mutex _assetMutex;
+		std::map< std::string, AssetLoader > _assetLoaders;
+		size_t _maxConcurrentAssetLoads = 2;
+		AssetRequestId _nextAssetRequestId = 1;
+		crimild::UInt64 _nextAssetSequence = 0;
+
+		/**
+			\brief Loads that are either pending or in progress, by filename
+		*/
+		std::unordered_map< std::string, AssetLoadPtr > _assetLoads;
+		std::unordered_map< AssetRequestId, AssetLoadPtr > _assetRequests;
+		std::set< AssetLoadPtr, PendingAssetOrder > _pendingAssetLoads;
+		size_t _loadingAssetCount = 0;
+		size_t _completedAssetCount = 0;
+		size_t _requestedAssetCount = 0;
+
+		//@}
 	};
 
 }
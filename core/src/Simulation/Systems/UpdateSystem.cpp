@@ -5,21 +5,30 @@
 
 #include "Visitors/UpdateWorldState.hpp"
 #include "Visitors/ComputeRenderQueue.hpp"
+#include "Visitors/FetchLights.hpp"
 #include "Visitors/UpdateComponents.hpp"
 #include "Visitors/ParallelApply.hpp"
 
 #include "Rendering/RenderQueue.hpp"
 
+#include "Foundation/FrameArena.hpp"
+
 #include "SceneGraph/Node.hpp"
 
 #include "Simulation/Simulation.hpp"
 
+#include <algorithm>
+
 using namespace crimild;
 
+constexpr const char *UpdateSystem::STAGE_UPDATE_COMPONENTS;
+constexpr const char *UpdateSystem::STAGE_UPDATE_WORLD_STATE;
+constexpr const char *UpdateSystem::STAGE_COMPUTE_RENDER_QUEUES;
+
 UpdateSystem::UpdateSystem( void )
 	: System( "Update System" )
 {
-
+	buildFrameGraph();
 }
 
 UpdateSystem::~UpdateSystem( void )
@@ -34,12 +43,30 @@ bool UpdateSystem::start( void )
 	}
     
     _accumulator = 0.0;
-    
+
     crimild::concurrency::sync_frame( std::bind( &UpdateSystem::update, this ) );
 
 	return true;
 }
 
+void UpdateSystem::buildFrameGraph( void )
+{
+	_frameGraph.addTask( STAGE_UPDATE_COMPONENTS, [ this ] {
+		updateBehaviors( _frameScene );
+	});
+
+	_frameGraph.addTask( STAGE_UPDATE_WORLD_STATE, [ this ] {
+		updateWorldState( _frameScene );
+	});
+
+	_frameGraph.addTask( STAGE_COMPUTE_RENDER_QUEUES, [ this ] {
+		computeRenderQueues( _frameScene );
+	});
+
+	_frameGraph.addDependency( STAGE_UPDATE_WORLD_STATE, STAGE_UPDATE_COMPONENTS );
+	_frameGraph.addDependency( STAGE_COMPUTE_RENDER_QUEUES, STAGE_UPDATE_WORLD_STATE );
+}
+
 void UpdateSystem::update( void )
 {
     CRIMILD_PROFILE( "Update System" )
@@ -61,9 +88,17 @@ void UpdateSystem::update( void )
     // prevent integration errors when delta is too big (i.e. after loading a new scene)
     _accumulator += Numericd::min( 4 * Clock::getScaledTickTime(), c.getDeltaTime() );
 
-	updateBehaviors( crimild::get_ptr( scene ) );
+	// transient data from three frames ago is no longer in use
+	FrameArena::getInstance()->beginFrame();
+
+	// scene notifications are broadcast from this thread, never from frame stages
+	broadcastMessage( messaging::WillUpdateScene { crimild::get_ptr( scene ) } );
+
+	_frameScene = crimild::get_ptr( scene );
+	_frameGraph.execute();
+	_frameScene = nullptr;
 
-    computeRenderQueues( crimild::get_ptr( scene ) );
+	broadcastMessage( messaging::DidUpdateScene { crimild::get_ptr( scene ) } );
     
     // schedule next update
     crimild::concurrency::sync_frame( std::bind( &UpdateSystem::update, this ) );
@@ -71,33 +106,72 @@ void UpdateSystem::update( void )
 
 void UpdateSystem::updateBehaviors( Node *scene )
 {
-    broadcastMessage( messaging::WillUpdateScene { scene } );
-
 	// const double FIXED_TIME = Clock::getScaledTickTime();
     // const Clock FIXED_CLOCK( FIXED_TIME );
     const auto FIXED_CLOCK = Simulation::getInstance()->getSimulationClock();
 
     // while ( _accumulator >= FIXED_TIME ) {
 		CRIMILD_PROFILE( "Updating Components" )
-		
-        auto job = crimild::concurrency::async();
-
-        scene->perform( Apply( [ &FIXED_CLOCK, job ]( Node *node ) {
-            node->forEachComponent( [ node, &FIXED_CLOCK, job ] ( NodeComponent *component ) {
-                crimild::concurrency::async( job, [ component, &FIXED_CLOCK ] {
-                    component->update( FIXED_CLOCK );
-                });
+
+        for ( auto &batch : _componentBatches ) {
+            batch.components.clear();
+        }
+        _unbatchedComponents.components.clear();
+
+        scene->perform( Apply( [ this ]( Node *node ) {
+            node->forEachComponent( [ this ] ( NodeComponent *component ) {
+                getComponentBatch( component->getComponentTypeId() ).components.push_back( component );
             });
         }));
 
-        crimild::concurrency::wait( job );
+        // split every batch into chunks, so all component types are
+        // updated by a single parallel loop
+        _componentChunks.clear();
+        auto addChunks = [ this ]( ComponentBatch &batch ) {
+            auto count = batch.components.size();
+            auto grain = crimild::concurrency::computeGrainSize( count );
+            for ( size_t begin = 0; begin < count; begin += grain ) {
+                _componentChunks.push_back( ComponentChunk { &batch, begin, std::min( begin + grain, count ) } );
+            }
+        };
+        for ( auto &batch : _componentBatches ) {
+            addChunks( batch );
+        }
+        addChunks( _unbatchedComponents );
+
+        auto &chunks = _componentChunks;
+        crimild::concurrency::parallel_for( size_t( 0 ), chunks.size(), size_t( 1 ), [ &chunks, &FIXED_CLOCK ]( size_t i ) {
+            auto &chunk = chunks[ i ];
+            auto components = chunk.batch->components.data();
+            if ( chunk.batch->updater != nullptr ) {
+                chunk.batch->updater( components + chunk.begin, chunk.end - chunk.begin, FIXED_CLOCK );
+            }
+            else {
+                for ( auto j = chunk.begin; j < chunk.end; j++ ) {
+                    components[ j ]->update( FIXED_CLOCK );
+                }
+            }
+        });
 
         // _accumulator -= FIXED_TIME;
     // }
-    
-    updateWorldState( scene );
+}
 
-    broadcastMessage( messaging::DidUpdateScene { scene } );	
+UpdateSystem::ComponentBatch &UpdateSystem::getComponentBatch( NodeComponent::TypeId typeId )
+{
+    if ( _componentBatches.size() <= typeId ) {
+        _componentBatches.resize( typeId + 1 );
+    }
+
+    auto &batch = _componentBatches[ typeId ];
+    if ( !batch.resolved ) {
+        // updaters are usually registered during static initialization,
+        // so they're resolved only once for each type
+        batch.updater = NodeComponent::getBatchUpdater( typeId );
+        batch.resolved = true;
+    }
+
+    return batch.updater != nullptr ? batch : _unbatchedComponents;
 }
 
 void UpdateSystem::updateWorldState( Node *scene )
@@ -109,19 +183,38 @@ void UpdateSystem::updateWorldState( Node *scene )
 
 void UpdateSystem::computeRenderQueues( Node *scene )
 {
-	auto renderQueueCollection = crimild::alloc< RenderQueueCollection >();
+	CRIMILD_PROFILE( "Compute Render Queue" )
+
+	_cameras.clear();
+	Simulation::getInstance()->forEachCamera( [ this ]( Camera *camera ) {
+		if ( camera != nullptr && camera->isEnabled() ) {
+			_cameras.push_back( camera );
+		}
+	});
+
+	// lights are gathered only once since they are not affected by culling
+	_lights.clear();
+	FetchLights fetchLights;
+	scene->perform( fetchLights );
+	fetchLights.forEachLight( [ this ]( Light *light ) {
+		_lights.push_back( light );
+	});
+
+	// render queues for different cameras are independent from each other
+	// queue buffers live in the frame arena, avoiding heap allocations every frame
+	auto arena = FrameArena::getInstance()->getCurrentArena();
+	_renderQueues.resize( _cameras.size() );
+	crimild::concurrency::parallel_for( size_t( 0 ), _cameras.size(), size_t( 1 ), [ this, scene, &arena ]( size_t i ) {
+		_renderQueues[ i ] = crimild::alloc< RenderQueue >( arena );
+		scene->perform( ComputeRenderQueue( _cameras[ i ], crimild::get_ptr( _renderQueues[ i ] ), &_lights ) );
+	});
+	_lights.clear();
 
-	{
-		CRIMILD_PROFILE( "Compute Render Queue" )
-	
-		Simulation::getInstance()->forEachCamera( [ this, &renderQueueCollection, scene ]( Camera *camera ) {
-			if ( camera != nullptr && camera->isEnabled() ) {
-				auto renderQueue = crimild::alloc< RenderQueue >();
-				scene->perform( ComputeRenderQueue( camera, crimild::get_ptr( renderQueue ) ) );
-				renderQueueCollection->add( renderQueue );
-			}
-		});
+	auto renderQueueCollection = crimild::alloc< RenderQueueCollection >();
+	for ( auto &renderQueue : _renderQueues ) {
+		renderQueueCollection->add( renderQueue );
 	}
+	_renderQueues.clear();
     
     crimild::concurrency::sync_frame( [this, renderQueueCollection]() {
         broadcastMessage( messaging::RenderQueueAvailable { renderQueueCollection } );
@@ -33,9 +33,15 @@
 #include "SceneGraph/Node.hpp"
 #include "SceneGraph/Camera.hpp"
 
+#include "Concurrency/TaskGraph.hpp"
+
+#include <vector>
+
 namespace crimild {
     
 	class UpdateSystem;
+	class RenderQueue;
+	class Light;
 
 	namespace messaging {
 
@@ -61,6 +67,54 @@ namespace crimild {
 		virtual void update( void );
 
 		virtual void stop( void ) override;
+
+	public:
+		/**
+		   \name Frame graph
+
+		   Each frame is executed as a graph of stages, with independent
+		   stages running concurrently. By default, stages are executed
+		   in this order:
+
+		   updateComponents -> updateWorldState -> computeRenderQueues
+
+		   Other systems may register their own stages and dependencies
+		   (i.e. a physics stage that runs after updateWorldState and must
+		   complete before computeRenderQueues) using the names below.
+		   Default stages are created when the system is constructed and
+		   are never removed.
+
+		   \remarks Stages are executed in worker threads. WillUpdateScene
+		   and DidUpdateScene are broadcast from the thread calling update(),
+		   right before and after the whole graph is executed, so handlers
+		   for those messages never run concurrently with any stage. Since
+		   render queues are already computed by the time DidUpdateScene is
+		   broadcast, changes made to the scene by its handlers are visible
+		   starting the next frame. Work that must be reflected in the current
+		   frame (i.e. physics) should be registered as a stage instead.
+		   Stages can only be added while the graph is not being executed
+		   (i.e. when starting a system), never from within another stage
+		 */
+		//@{
+
+		static constexpr const char *STAGE_UPDATE_COMPONENTS = "updateComponents";
+		static constexpr const char *STAGE_UPDATE_WORLD_STATE = "updateWorldState";
+		static constexpr const char *STAGE_COMPUTE_RENDER_QUEUES = "computeRenderQueues";
+
+		concurrency::TaskGraph &getFrameGraph( void ) { return _frameGraph; }
+
+	private:
+		void buildFrameGraph( void );
+
+	private:
+		concurrency::TaskGraph _frameGraph;
+
+		/**
+		   \brief Scene being updated by the current frame
+		 */
+		Node *_frameScene = nullptr;
+
+		//@}
         
     private:
         void updateBehaviors( Node *scene );
@@ -69,6 +123,55 @@ namespace crimild {
 
 	private:
 		double _accumulator = 0.0;
+
+		std::vector< Camera * > _cameras;
+		std::vector< SharedPointer< RenderQueue >> _renderQueues;
+
+		/**
+		   \brief Lights in the scene, shared by all render queues in the current frame
+		 */
+		std::vector< Light * > _lights;
+
+		/**
+		   \name Component updates
+
+		   Components are grouped by type id. Types with a registered batch
+		   updater are updated in chunks using that function. The rest are
+		   updated individually through the virtual update() method.
+
+		   All containers are reused between frames to avoid allocations.
+
+		   \see NodeComponent::BatchUpdater
+		 */
+		//@{
+
+		struct ComponentBatch {
+			bool resolved = false;
+			NodeComponent::BatchUpdater updater = nullptr;
+			std::vector< NodeComponent * > components;
+		};
+
+		struct ComponentChunk {
+			ComponentBatch *batch;
+			size_t begin;
+			size_t end;
+		};
+
+		/**
+		   \brief Components in the current frame, indexed by type id
+		 */
+		std::vector< ComponentBatch > _componentBatches;
+
+		/**
+		   \brief Components without a batch updater
+		 */
+		ComponentBatch _unbatchedComponents;
+
+		std::vector< ComponentChunk > _componentChunks;
+
+		ComponentBatch &getComponentBatch( NodeComponent::TypeId typeId );
+
+		//@}
 	};
     
 }
@@ -47,7 +47,7 @@ bool FileStream::open( void )
 {
 	close();
 
-	_file = fopen( _path.c_str(), _openMode == FileStream::OpenMode::WRITE ? "w" : "r" );
+	_file = fopen( _path.c_str(), _openMode == FileStream::OpenMode::WRITE ? "wb" : "rb" );
 	if ( _file == nullptr ) {
         Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid file path " );
 		return false;
@@ -90,12 +90,12 @@ bool FileStream::load( void )
 	return result;
 }
 
-void FileStream::writeRawBytes( const void *bytes, size_t size )
+void FileStream::writeBytes( const void *bytes, size_t size )
 {
 	fwrite( bytes, 1, size, _file );
 }
 
-void FileStream::readRawBytes( void *bytes, size_t size )
+void FileStream::readBytes( void *bytes, size_t size )
 {
 	fread( bytes, 1, size, _file );
 }
@@ -57,8 +57,9 @@ namespace crimild {
 
         bool close( void );
 
-        virtual void writeRawBytes( const void *bytes, size_t size ) override;
-        virtual void readRawBytes( void *bytes, size_t size ) override;
+    protected:
+        virtual void writeBytes( const void *bytes, size_t size ) override;
+        virtual void readBytes( void *bytes, size_t size ) override;
 
     private:
         std::string _path;
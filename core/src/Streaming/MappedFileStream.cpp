@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "MappedFileStream.hpp"
+#include "Foundation/Log.hpp"
+#include "Foundation/Macros.hpp"
+#include "Foundation/NonCopyable.hpp"
+
+#include <cstring>
+
+#ifdef CRIMILD_PLATFORM_WIN32
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace crimild;
+
+namespace crimild {
+
+	/**
+		\brief Owns the contents of a file in memory
+
+		Shared by the stream and any object referencing the file 
+		contents, so the memory is released once nobody uses it
+	*/
+	class MappedFile : public NonCopyable {
+	public:
+		MappedFile( void *data, size_t size )
+			: _data( data ),
+			  _size( size )
+		{
+
+		}
+
+		~MappedFile( void )
+		{
+			if ( _data == nullptr ) {
+				return;
+			}
+#ifdef CRIMILD_PLATFORM_WIN32
+			delete [] static_cast< unsigned char * >( _data );
+#else
+			munmap( _data, _size );
+#endif
+		}
+
+		const unsigned char *getData( void ) const { return static_cast< const unsigned char * >( _data ); }
+
+		size_t getSize( void ) const { return _size; }
+
+	private:
+		void *_data;
+		size_t _size;
+	};
+
+	static SharedPointer< MappedFile > mapFile( std::string const &path )
+	{
+#ifdef CRIMILD_PLATFORM_WIN32
+		auto file = fopen( path.c_str(), "rb" );
+		if ( file == nullptr ) {
+			return nullptr;
+		}
+
+		fseek( file, 0, SEEK_END );
+		auto size = ftell( file );
+		fseek( file, 0, SEEK_SET );
+		if ( size < 0 ) {
+			fclose( file );
+			return nullptr;
+		}
+
+		auto data = size > 0 ? new unsigned char[ size ] : nullptr;
+		if ( size > 0 && fread( data, 1, size, file ) != size_t( size ) ) {
+			delete [] data;
+			fclose( file );
+			return nullptr;
+		}
+		fclose( file );
+
+		return crimild::alloc< MappedFile >( data, size );
+#else
+		auto fd = ::open( path.c_str(), O_RDONLY );
+		if ( fd < 0 ) {
+			return nullptr;
+		}
+
+		struct stat info;
+		if ( fstat( fd, &info ) != 0 ) {
+			::close( fd );
+			return nullptr;
+		}
+
+		size_t size = info.st_size;
+		if ( size == 0 ) {
+			::close( fd );
+			return crimild::alloc< MappedFile >( nullptr, 0 );
+		}
+
+		// private mappings are copy-on-write, so the file is never modified
+		auto data = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+		// the mapping remains valid after closing the file descriptor
+		::close( fd );
+
+		if ( data == MAP_FAILED ) {
+			return nullptr;
+		}
+
+		return crimild::alloc< MappedFile >( data, size );
+#endif
+	}
+
+}
+
+MappedFileStream::MappedFileStream( std::string path )
+	: _path( path )
+{
+
+}
+
+MappedFileStream::~MappedFileStream( void )
+{
+	close();
+}
+
+bool MappedFileStream::open( void )
+{
+	close();
+
+	auto mapping = mapFile( _path );
+	if ( mapping == nullptr ) {
+        Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot map file ", _path );
+		return false;
+	}
+
+	_data = mapping->getData();
+	_size = mapping->getSize();
+	_offset = 0;
+	_mapping = mapping;
+
+	return true;
+}
+
+bool MappedFileStream::close( void )
+{
+	// objects referencing the mapping keep it alive
+	_mapping = nullptr;
+	_data = nullptr;
+	_size = 0;
+	_offset = 0;
+
+	return true;
+}
+
+bool MappedFileStream::flush( void )
+{
+	Log::error( CRIMILD_CURRENT_CLASS_NAME, "Mapped file streams are read-only" );
+	return false;
+}
+
+bool MappedFileStream::load( void )
+{
+	if ( !open() ) {
+		return false;
+	}
+
+	auto result = Stream::load();
+	close();
+
+	return result;
+}
+
+void MappedFileStream::writeBytes( const void *bytes, size_t size )
+{
+	// read-only stream
+}
+
+void MappedFileStream::readBytes( void *bytes, size_t size )
+{
+	if ( size > _size - _offset ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Attempting to read past the end of the file" );
+		memset( bytes, 0, size );
+		_offset = _size;
+		return;
+	}
+
+	memcpy( bytes, _data + _offset, size );
+	_offset += size;
+}
+
+const unsigned char *MappedFileStream::mapBytes( size_t size, SharedPointer< void > &storage )
+{
+	if ( size > _size - _offset ) {
+		return nullptr;
+	}
+
+	auto bytes = _data + _offset;
+	_offset += size;
+	storage = _mapping;
+	return bytes;
+}
+
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRIMILD_CORE_STREAMING_STREAM_MAPPED_FILE_
+#define CRIMILD_CORE_STREAMING_STREAM_MAPPED_FILE_
+
+#include "Stream.hpp"
+
+namespace crimild {
+    
+    /**
+        \brief Implements a read-only stream that maps a file into memory
+
+        Objects are read directly from the mapping instead of using a 
+        syscall for each field. Large blocks of raw data, like the ones
+        in buffer objects or images, may reference the mapping instead 
+        of being copied. Such objects keep the mapping alive after the
+        stream is closed, until they are modified or destroyed.
+
+        On platforms without memory mapped files, the whole file is
+        read into memory at once.
+    */
+    class MappedFileStream : public Stream {
+    public:
+    	explicit MappedFileStream( std::string path );
+    	virtual ~MappedFileStream( void );
+
+    	virtual bool load( void ) override;
+
+        /**
+            \brief Not supported. Use FileStream for writing
+        */
+    	virtual bool flush( void ) override;
+
+    public:
+        bool open( void );
+
+        bool isOpen( void ) const { return _mapping != nullptr; }
+
+        bool close( void );
+
+    protected:
+        virtual void writeBytes( const void *bytes, size_t size ) override;
+        virtual void readBytes( void *bytes, size_t size ) override;
+        virtual const unsigned char *mapBytes( size_t size, SharedPointer< void > &storage ) override;
+
+    private:
+        std::string _path;
+        SharedPointer< void > _mapping;
+        const unsigned char *_data = nullptr;
+        size_t _size = 0;
+        size_t _offset = 0;
+    };
+
+}
+
+#endif
+
@@ -26,6 +26,9 @@
  */
 
 #include "MemoryStream.hpp"
+#include "Foundation/Log.hpp"
+
+#include <cstring>
 
 using namespace crimild;
 
@@ -34,6 +37,12 @@ MemoryStream::MemoryStream( void )
 
 }
 
+MemoryStream::MemoryStream( std::vector< unsigned char > const &buffer )
+	: _buffer( buffer )
+{
+
+}
+
 MemoryStream::~MemoryStream( void )
 {
 
@@ -54,13 +63,22 @@ bool MemoryStream::load( void )
 	return Stream::load();
 }
 
-void MemoryStream::writeRawBytes( const void *bytes, size_t size )
+void MemoryStream::writeBytes( const void *bytes, size_t size )
 {
-	// fwrite( bytes, 1, size, _file );
+	auto data = static_cast< const unsigned char * >( bytes );
+	_buffer.insert( _buffer.end(), data, data + size );
 }
 
-void MemoryStream::readRawBytes( void *bytes, size_t size )
+void MemoryStream::readBytes( void *bytes, size_t size )
 {
-	// fread( bytes, 1, size, _file );
+	if ( _offset + size > _buffer.size() ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Attempting to read past the end of the buffer" );
+		memset( bytes, 0, size );
+		_offset = _buffer.size();
+		return;
+	}
+
+	memcpy( bytes, &_buffer[ _offset ], size );
+	_offset += size;
 }
 
@@ -38,15 +38,23 @@ namespace crimild {
     class MemoryStream : public Stream {
     public:
     	MemoryStream( void );
+
+        /**
+            \brief Creates a stream for loading objects from an existing buffer
+        */
+        explicit MemoryStream( std::vector< unsigned char > const &buffer );
+
     	virtual ~MemoryStream( void );
 
     	virtual bool load( void ) override;
 
     	virtual bool flush( void ) override;
 
-    public:
-        virtual void writeRawBytes( const void *bytes, size_t size ) override;
-        virtual void readRawBytes( void *bytes, size_t size ) override;
+        const std::vector< unsigned char > &getBuffer( void ) const { return _buffer; }
+
+    protected:
+        virtual void writeBytes( const void *bytes, size_t size ) override;
+        virtual void readBytes( void *bytes, size_t size ) override;
 
     private:
         std::vector< unsigned char > _buffer;
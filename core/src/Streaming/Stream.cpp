@@ -30,11 +30,30 @@
 #include "Foundation/Version.hpp"
 #include "Foundation/Log.hpp"
 #include "Rendering/VertexFormat.hpp"
+#include "Concurrency/Async.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 
 using namespace crimild;
 
+/**
+	\brief Number of bytes required to move offset to the next multiple of alignment
+*/
+static size_t computePadding( crimild::UInt64 offset, size_t alignment )
+{
+	if ( alignment <= 1 ) {
+		return 0;
+	}
+
+	return ( alignment - ( offset % alignment ) ) % alignment;
+}
+
+constexpr crimild::UInt32 Stream::MAGIC;
+constexpr crimild::UInt32 Stream::VERSION_LEGACY;
+constexpr crimild::UInt32 Stream::VERSION_CURRENT;
+constexpr crimild::UInt32 Stream::PAYLOAD_ALIGNMENT;
 constexpr const char *Stream::FLAG_STREAM_START;
 constexpr const char *Stream::FLAG_STREAM_END;
 constexpr const char *Stream::FLAG_TOP_LEVEL_OBJECT;
@@ -49,8 +68,7 @@ bool StreamObject::registerInStream( Stream &s )
 
 void StreamObject::save( Stream &s )
 {
-	s.write( getClassName() );
-	s.write( getUniqueIdentifier() );
+
 }
 
 void StreamObject::load( Stream &s )
@@ -80,14 +98,7 @@ Stream::~Stream( void )
 
 bool Stream::isTopLevel( SharedPointer< StreamObject > const &obj ) const 
 {
-	for ( const auto &other : _topLevelObjects ) {
-		// double check
-		if ( other == obj && other->getUniqueIdentifier() == obj->getUniqueIdentifier() ) {
-			return true;
-		}
-	}
-
-	return false;
+	return obj != nullptr && _topLevelIds.find( obj->getUniqueIdentifier() ) != _topLevelIds.end();
 }
 
 bool Stream::registerObject( StreamObject *obj )
@@ -97,13 +108,17 @@ bool Stream::registerObject( StreamObject *obj )
 
 bool Stream::registerObject( StreamObject::StreamObjectId objId, SharedPointer< StreamObject > const &obj )
 {
-	if ( _objects[ objId ] != nullptr ) {
+	auto it = _objectSlots.find( objId );
+	if ( it != _objectSlots.end() ) {
 		// object already register, remove it so it will be reinserted
 		// again with a higher priority
-		_orderedObjects.remove( obj );
+		_orderedObjects[ it->second ] = nullptr;
+		it->second = _orderedObjects.size();
+	}
+	else {
+		_objectSlots[ objId ] = _orderedObjects.size();
 	}
 
-	_objects[ objId ] = obj;
 	_orderedObjects.push_back( obj );
 
 	return true;
@@ -111,54 +126,368 @@ bool Stream::registerObject( StreamObject::StreamObjectId objId, SharedPointer<
 
 void Stream::addObject( SharedPointer< StreamObject > const &obj )
 {
-	if ( isTopLevel( obj ) ) {
+	if ( obj == nullptr || isTopLevel( obj ) ) {
 		return;
 	}
 
+	_topLevelIds.insert( obj->getUniqueIdentifier() );
 	_topLevelObjects.push_back( obj );
 }
 
 bool Stream::flush( void )
 {
-	write( Stream::FLAG_STREAM_START );
-	write( Version::getDescription() );
+	_storageOffset = 0;
+	_orderedObjects.clear();
+	_objectSlots.clear();
+	_objectIndices.clear();
 
 	for ( auto &obj : _topLevelObjects ) {
-		if ( obj != nullptr ) {
-			obj->registerInStream( *this );
-		}
+		obj->registerInStream( *this );
 	}
 
+	// objects registered last are saved first, so dependencies
+	// are always loaded before the objects referencing them
+	std::vector< StreamObject * > objects;
+	objects.reserve( _objectSlots.size() );
 	for ( auto it = _orderedObjects.rbegin(); it != _orderedObjects.rend(); it++ ) {
-		auto &obj = *it;
-		if ( obj != nullptr ) {
-			if ( isTopLevel( obj ) ) {
-				write( Stream::FLAG_TOP_LEVEL_OBJECT );
-			}
-			else {
-				write( Stream::FLAG_INNER_OBJECT );
-			}
+		if ( *it != nullptr ) {
+			objects.push_back( crimild::get_ptr( *it ) );
+			_objectIndices[ ( *it )->getUniqueIdentifier() ] = objects.size();
+		}
+	}
+
+	std::vector< std::string > classNames;
+	std::unordered_map< std::string, crimild::UInt64 > classIndices;
+
+	std::vector< DirectoryEntry > directory;
+	directory.reserve( objects.size() );
+
+	// directory indices start at 1, since 0 is used for null references
+	_objectLevels.assign( objects.size() + 1, 0 );
+
+	std::vector< unsigned char > payload;
+	_writeBuffer = &payload;
+	for ( auto obj : objects ) {
+		_currentObjectIndex = directory.size() + 1;
+		_forwardReferences.clear();
+
+		std::string className = obj->getClassName();
+		auto it = classIndices.find( className );
+		if ( it == classIndices.end() ) {
+			it = classIndices.insert( std::make_pair( className, classNames.size() ) ).first;
+			classNames.push_back( className );
+		}
 
-			write( Stream::FLAG_OBJECT_START );
-			obj->save( *this );
-			write( Stream::FLAG_OBJECT_END );
+		DirectoryEntry entry;
+		entry.classIndex = it->second;
+		entry.offset = payload.size();
+		obj->save( *this );
+		entry.size = payload.size() - entry.offset;
+		entry.level = _objectLevels[ _currentObjectIndex ];
+		directory.push_back( entry );
+
+		// objects referenced before they are saved must not be loaded
+		// at the same time as this one
+		for ( auto index : _forwardReferences ) {
+			_objectLevels[ index ] = std::max( _objectLevels[ index ], entry.level + 1 );
 		}
 	}
+	_writeBuffer = nullptr;
+	_currentObjectIndex = 0;
+	_forwardReferences.clear();
+	_objectLevels.clear();
+
+	write( Stream::MAGIC );
+	write( Stream::VERSION_CURRENT );
+	write( ( crimild::UInt32 ) classNames.size() );
+	write( ( crimild::UInt32 ) objects.size() );
+	write( ( crimild::UInt32 ) _topLevelObjects.size() );
+	write( ( crimild::UInt64 ) payload.size() );
+
+	write( Version::getDescription() );
 
-	write( Stream::FLAG_STREAM_END );
+	for ( auto &className : classNames ) {
+		write( className );
+	}
+
+	for ( auto &obj : _topLevelObjects ) {
+		writeVarUInt( _objectIndices[ obj->getUniqueIdentifier() ] );
+	}
+
+	for ( auto &entry : directory ) {
+		writeVarUInt( entry.classIndex );
+		writeVarUInt( entry.level );
+		writeVarUInt( entry.offset );
+		writeVarUInt( entry.size );
+	}
+
+	auto padding = computePadding( _storageOffset, Stream::PAYLOAD_ALIGNMENT );
+	if ( padding > 0 ) {
+		unsigned char zeros[ Stream::PAYLOAD_ALIGNMENT ] = { 0 };
+		writeRawBytes( zeros, padding );
+	}
+
+	if ( payload.size() > 0 ) {
+		writeRawBytes( &payload[ 0 ], payload.size() );
+	}
+
+	_orderedObjects.clear();
+	_objectSlots.clear();
+	_objectIndices.clear();
 
 	return true;
 }
 
 bool Stream::load( void )
 {
-	std::string flag;
-	read( flag );
-	if ( flag != Stream::FLAG_STREAM_START ) {
-        Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid file format" );
+	_objects.clear();
+	_loadedObjects.clear();
+	_storageOffset = 0;
+
+	crimild::UInt32 magic = 0;
+	read( magic );
+	if ( magic != Stream::MAGIC ) {
+		// legacy streams start with a flag string, prefixed by its length
+		std::string flag;
+		if ( magic == strlen( Stream::FLAG_STREAM_START ) ) {
+			flag.resize( magic );
+			readRawBytes( &flag[ 0 ], magic );
+		}
+
+		if ( flag != Stream::FLAG_STREAM_START ) {
+			Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid file format" );
+			return false;
+		}
+
+		_version = Stream::VERSION_LEGACY;
+		return loadLegacy();
+	}
+
+	read( _version );
+	if ( _version != Stream::VERSION_CURRENT ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Unsupported stream version ", _version );
 		return false;
 	}
 
+	return loadObjects();
+}
+
+bool Stream::loadObjects( void )
+{
+	crimild::UInt32 classCount;
+	read( classCount );
+
+	crimild::UInt32 objectCount;
+	read( objectCount );
+
+	crimild::UInt32 topLevelCount;
+	read( topLevelCount );
+
+	crimild::UInt64 payloadSize;
+	read( payloadSize );
+
+	std::string version;
+	read( version );
+
+	std::vector< std::string > classNames( classCount );
+	for ( auto &className : classNames ) {
+		read( className );
+	}
+
+	std::vector< crimild::UInt64 > topLevelIndices( topLevelCount );
+	for ( auto &index : topLevelIndices ) {
+		readVarUInt( index );
+	}
+
+	std::vector< DirectoryEntry > directory( objectCount );
+	for ( auto &entry : directory ) {
+		readVarUInt( entry.classIndex );
+		readVarUInt( entry.level );
+		readVarUInt( entry.offset );
+		readVarUInt( entry.size );
+		if ( entry.classIndex >= classCount || entry.offset + entry.size > payloadSize ) {
+			Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid object directory" );
+			return false;
+		}
+	}
+
+	auto padding = computePadding( _storageOffset, Stream::PAYLOAD_ALIGNMENT );
+	if ( padding > 0 ) {
+		unsigned char zeros[ Stream::PAYLOAD_ALIGNMENT ];
+		readRawBytes( zeros, padding );
+	}
+
+	// reference the payload in place if the underlying storage allows it
+	// otherwise, read it into a buffer
+	std::vector< unsigned char > payload;
+	_payload = nullptr;
+	_payloadStorage = nullptr;
+	if ( payloadSize > 0 ) {
+		_payload = mapBytes( payloadSize, _payloadStorage );
+		if ( _payload != nullptr ) {
+			_storageOffset += payloadSize;
+		}
+		else {
+			_payloadStorage = nullptr;
+			payload.resize( payloadSize );
+			readRawBytes( &payload[ 0 ], payloadSize );
+			_payload = payload.data();
+		}
+	}
+
+	// build all objects first, so references can be resolved regardless of their order
+	_loadedObjects.reserve( objectCount );
+	for ( auto &entry : directory ) {
+		auto &className = classNames[ entry.classIndex ];
+		auto obj = StreamObjectFactory::getInstance()->buildObject( className );
+		if ( obj == nullptr ) {
+			Log::debug( CRIMILD_CURRENT_CLASS_NAME, "Cannot build object of type ", className, " with index ", _loadedObjects.size() + 1 );
+			_loadedObjects.clear();
+			return false;
+		}
+		_loadedObjects.push_back( obj );
+	}
+
+	bool result = true;
+	auto parallel = _loadMode == LoadMode::PARALLEL
+		&& concurrency::JobScheduler::hasInstance()
+		&& concurrency::JobScheduler::getInstance()->isRunning();
+	if ( parallel ) {
+		result = loadObjectsInParallel( directory, classNames );
+	}
+	else {
+		for ( crimild::UInt32 i = 0; i < objectCount; i++ ) {
+			if ( !loadObject( crimild::get_ptr( _loadedObjects[ i ] ), directory[ i ] ) ) {
+				Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid object data for ", classNames[ directory[ i ].classIndex ] );
+				result = false;
+				break;
+			}
+		}
+	}
+	_payload = nullptr;
+	_payloadStorage = nullptr;
+
+	if ( !result ) {
+		_loadedObjects.clear();
+		return false;
+	}
+
+	for ( auto index : topLevelIndices ) {
+		if ( index == 0 || index > _loadedObjects.size() ) {
+			Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid top-level object index ", index );
+			return false;
+		}
+		addObject( _loadedObjects[ index - 1 ] );
+	}
+
+	return true;
+}
+
+bool Stream::loadObject( StreamObject *obj, DirectoryEntry const &entry )
+{
+	_readCursor = _payload + entry.offset;
+	_readEnd = _readCursor + entry.size;
+
+	obj->load( *this );
+
+	auto result = ( _readCursor == _readEnd );
+
+	_readCursor = nullptr;
+	_readEnd = nullptr;
+
+	return result;
+}
+
+class Stream::ObjectReader : public Stream {
+public:
+	explicit ObjectReader( Stream const &source )
+	{
+		_objectSource = &source;
+		_version = source._version;
+		_payload = source._payload;
+		_payloadStorage = source._payloadStorage;
+	}
+
+	virtual ~ObjectReader( void )
+	{
+
+	}
+
+	bool read( StreamObject *obj, DirectoryEntry const &entry )
+	{
+		return loadObject( obj, entry );
+	}
+
+protected:
+	virtual void writeBytes( const void *bytes, size_t size ) override
+	{
+		// read-only stream
+	}
+
+	virtual void readBytes( void *bytes, size_t size ) override
+	{
+		// object data is always read from the payload
+		memset( bytes, 0, size );
+	}
+};
+
+bool Stream::loadObjectsInParallel( std::vector< DirectoryEntry > const &directory, std::vector< std::string > const &classNames )
+{
+	// sort objects by dependency level, keeping directory order within each level
+	crimild::UInt64 levelCount = 0;
+	for ( auto &entry : directory ) {
+		levelCount = std::max( levelCount, entry.level + 1 );
+	}
+
+	std::vector< size_t > levelOffsets( levelCount + 1, 0 );
+	for ( auto &entry : directory ) {
+		levelOffsets[ entry.level + 1 ]++;
+	}
+	for ( size_t i = 1; i < levelOffsets.size(); i++ ) {
+		levelOffsets[ i ] += levelOffsets[ i - 1 ];
+	}
+
+	std::vector< size_t > sorted( directory.size() );
+	auto cursors = levelOffsets;
+	for ( size_t i = 0; i < directory.size(); i++ ) {
+		sorted[ cursors[ directory[ i ].level ]++ ] = i;
+	}
+
+	std::atomic< bool > result( true );
+
+	for ( crimild::UInt64 level = 0; level < levelCount && result; level++ ) {
+		auto begin = levelOffsets[ level ];
+		auto end = levelOffsets[ level + 1 ];
+		auto count = end - begin;
+		if ( count == 0 ) {
+			continue;
+		}
+
+		// objects are loaded in chunks, each one with its own reader
+		auto grain = concurrency::computeGrainSize( count );
+		auto chunkCount = ( count + grain - 1 ) / grain;
+		concurrency::parallel_for( size_t( 0 ), chunkCount, size_t( 1 ), [ & ]( size_t chunk ) {
+			ObjectReader reader( *this );
+			auto chunkBegin = begin + chunk * grain;
+			auto chunkEnd = std::min( chunkBegin + grain, end );
+			for ( auto i = chunkBegin; i < chunkEnd && result; i++ ) {
+				auto index = sorted[ i ];
+				auto &entry = directory[ index ];
+				if ( !reader.read( crimild::get_ptr( _loadedObjects[ index ] ), entry ) ) {
+					Log::error( CRIMILD_CURRENT_CLASS_NAME, "Invalid object data for ", classNames[ entry.classIndex ] );
+					result = false;
+				}
+			}
+		});
+	}
+
+	return result;
+}
+
+bool Stream::loadLegacy( void )
+{
+	std::string flag;
+
 	std::string version;
 	read( version );
 
@@ -194,7 +523,7 @@ bool Stream::load( void )
 			addObject( obj );
 		}
 
-		registerObject( objId, obj );
+		_objects[ objId ] = obj;
 
 		read( flag );
 		if ( flag != Stream::FLAG_OBJECT_END ) {
@@ -206,6 +535,173 @@ bool Stream::load( void )
 	return true;
 }
 
+void Stream::writeObjectReference( const StreamObject *obj )
+{
+	if ( obj == nullptr ) {
+		writeVarUInt( 0 );
+		return;
+	}
+
+	auto it = _objectIndices.find( obj->getUniqueIdentifier() );
+	if ( it == _objectIndices.end() ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Object of type ", obj->getClassName(), " was not registered in stream" );
+		writeVarUInt( 0 );
+		return;
+	}
+
+	auto index = it->second;
+	if ( index < _currentObjectIndex ) {
+		auto &level = _objectLevels[ _currentObjectIndex ];
+		level = std::max( level, _objectLevels[ index ] + 1 );
+	}
+	else if ( index > _currentObjectIndex && _currentObjectIndex > 0 ) {
+		_forwardReferences.push_back( index );
+	}
+
+	writeVarUInt( index );
+}
+
+SharedPointer< StreamObject > Stream::readObjectReference( void )
+{
+	if ( _version == Stream::VERSION_LEGACY ) {
+		StreamObject::StreamObjectId objId;
+		read( objId );
+
+		auto it = _objects.find( objId );
+		if ( it == _objects.end() ) {
+			Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot find object with id ", objId );
+			return nullptr;
+		}
+
+		return it->second;
+	}
+
+	crimild::UInt64 index;
+	readVarUInt( index );
+
+	if ( index == 0 ) {
+		return nullptr;
+	}
+
+	auto &objects = _objectSource->_loadedObjects;
+	if ( index > objects.size() ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot find object with index ", index );
+		return nullptr;
+	}
+
+	return objects[ index - 1 ];
+}
+
+void Stream::writeVarUInt( crimild::UInt64 value )
+{
+	unsigned char bytes[ 10 ];
+	size_t count = 0;
+	do {
+		unsigned char byte = value & 0x7F;
+		value >>= 7;
+		if ( value != 0 ) {
+			byte |= 0x80;
+		}
+		bytes[ count++ ] = byte;
+	} while ( value != 0 );
+
+	writeRawBytes( bytes, count );
+}
+
+void Stream::readVarUInt( crimild::UInt64 &value )
+{
+	value = 0;
+	for ( unsigned int shift = 0; shift < 64; shift += 7 ) {
+		unsigned char byte = 0;
+		readRawBytes( &byte, 1 );
+		value |= crimild::UInt64( byte & 0x7F ) << shift;
+		if ( ( byte & 0x80 ) == 0 ) {
+			break;
+		}
+	}
+}
+
+crimild::UInt64 Stream::readCount( void )
+{
+	if ( _version == Stream::VERSION_LEGACY ) {
+		unsigned int count = 0;
+		read( count );
+		return count;
+	}
+
+	crimild::UInt64 count = 0;
+	readVarUInt( count );
+	return count;
+}
+
+void Stream::writeRawBytes( const void *bytes, size_t size )
+{
+	if ( _writeBuffer != nullptr ) {
+		auto data = static_cast< const unsigned char * >( bytes );
+		_writeBuffer->insert( _writeBuffer->end(), data, data + size );
+		return;
+	}
+
+	writeBytes( bytes, size );
+	_storageOffset += size;
+}
+
+void Stream::writeAlignment( size_t alignment )
+{
+	if ( _writeBuffer == nullptr ) {
+		return;
+	}
+
+	_writeBuffer->resize( _writeBuffer->size() + computePadding( _writeBuffer->size(), alignment ), 0 );
+}
+
+void Stream::readRawBytes( void *bytes, size_t size )
+{
+	if ( _readCursor == nullptr ) {
+		readBytes( bytes, size );
+		_storageOffset += size;
+		return;
+	}
+
+	if ( size > ( size_t )( _readEnd - _readCursor ) ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Attempting to read past the end of object data" );
+		memset( bytes, 0, size );
+		_readCursor = _readEnd;
+		return;
+	}
+
+	memcpy( bytes, _readCursor, size );
+	_readCursor += size;
+}
+
+void Stream::readAlignment( size_t alignment )
+{
+	if ( _readCursor == nullptr ) {
+		return;
+	}
+
+	auto padding = computePadding( _readCursor - _payload, alignment );
+	if ( padding > ( size_t )( _readEnd - _readCursor ) ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Attempting to read past the end of object data" );
+		_readCursor = _readEnd;
+		return;
+	}
+
+	_readCursor += padding;
+}
+
+const unsigned char *Stream::readRawBytesInPlace( size_t size, SharedPointer< void > &storage )
+{
+	if ( _readCursor == nullptr || _payloadStorage == nullptr || size > ( size_t )( _readEnd - _readCursor ) ) {
+		return nullptr;
+	}
+
+	auto bytes = _readCursor;
+	_readCursor += size;
+	storage = _payloadStorage;
+	return bytes;
+}
+
 void Stream::write( const std::string &str )
 {
 	write( str.c_str() );
@@ -213,8 +709,9 @@ void Stream::write( const std::string &str )
 
 void Stream::write( const char *str )
 {
-	write( ( unsigned int ) strlen( str ) );
-	writeRawBytes( str, strlen( str ) );
+	auto length = strlen( str );
+	writeVarUInt( length );
+	writeRawBytes( str, length );
 }
 
 void Stream::write( const VertexFormat &vf )
@@ -280,6 +777,18 @@ void Stream::write( unsigned long long ll )
 	writeRawBytes( &ll, sizeof( unsigned long long ) );
 }
 
+void Stream::write( long l )
+{
+	long long ll = l;
+	write( ll );
+}
+
+void Stream::write( unsigned long l )
+{
+	unsigned long long ll = l;
+	write( ll );
+}
+
 void Stream::write( float f )
 {
 	writeRawBytes( &f, sizeof( float ) );
@@ -287,18 +796,14 @@ void Stream::write( float f )
 
 void Stream::read( std::string &str )
 {
-	unsigned int count = 0;
-	read( count );
+	auto count = readCount();
 	if ( count == 0 ) {
 		str = "";
 		return;
 	}
 
-	std::vector< char > buffer( count + 1 );
-	readRawBytes( &buffer[ 0 ], count );
-	buffer[ count ] = '\0';
-
-	str = std::string( ( const char * ) &buffer[ 0 ] );
+	str.resize( count );
+	readRawBytes( &str[ 0 ], count );
 }
 
 void Stream::read( VertexFormat &vf )
@@ -381,6 +886,20 @@ void Stream::read( unsigned long long &i )
 	readRawBytes( &i, sizeof( unsigned long long ) );
 }
 
+void Stream::read( long &l )
+{
+	long long ll;
+	read( ll );
+	l = ll;
+}
+
+void Stream::read( unsigned long &l )
+{
+	unsigned long long ll;
+	read( ll );
+	l = ll;
+}
+
 void Stream::read( float &f )
 {
 	readRawBytes( &f, sizeof( float ) );
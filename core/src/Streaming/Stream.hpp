@@ -33,6 +33,7 @@
 #include "Foundation/Memory.hpp"
 #include "Foundation/RTTI.hpp"
 #include "Foundation/Log.hpp"
+#include "Foundation/Types.hpp"
 
 #include "Mathematics/Transformation.hpp"
 
@@ -41,6 +42,8 @@
 #include <list>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace crimild {
     
@@ -107,7 +110,8 @@ namespace crimild {
         /**
             \briefs Writes an object into the stream
 
-            \remarks Subclases must invoke this method
+            \remarks Subclases must invoke this method. The class name
+            and identifier are stored by the stream itself
         */
         virtual void save( Stream &s );
 
@@ -165,9 +169,50 @@ namespace crimild {
       
     /**
         \brief Base class for streams
+
+        Streams are written using a compact binary container:
+
+        \code
+            header:      magic, version, class name count, object count,
+                         top-level object count, payload size
+            version:     engine version description
+            class names: string table
+            top-level:   object indices
+            directory:   class index, dependency level, payload offset and
+                         payload size per object
+            padding:     so the payload starts at PAYLOAD_ALIGNMENT
+            payload:     serialized objects, dependencies first
+        \endcode
+
+        Object references, string lengths and array counts are stored as
+        varints, and objects are referenced by their index in the directory
+        instead of their memory address.
+
+        Objects only reference objects in lower dependency levels, so all
+        objects in the same level can be loaded concurrently (see LoadMode).
+
+        Streams written by previous versions of the engine, which used text
+        flags around each object, can still be loaded.
     */  
     class Stream : public NonCopyable {
     public:
+        static constexpr crimild::UInt32 MAGIC = 0x444D5243; // "CRMD"
+
+        static constexpr crimild::UInt32 VERSION_LEGACY = 1;
+        static constexpr crimild::UInt32 VERSION_CURRENT = 2;
+
+        /**
+            \brief Alignment of the payload, relative to the start of the stream
+
+            Bounds the alignment that can be requested for raw data
+        */
+        static constexpr crimild::UInt32 PAYLOAD_ALIGNMENT = 16;
+
+        /**
+            \brief Legacy flags
+
+            Only used when loading streams with version VERSION_LEGACY
+        */
         static constexpr const char *FLAG_STREAM_START = "___CRIMILD_STREAM_START___";
         static constexpr const char *FLAG_STREAM_END = "___CRIMILD_STREAM_END___";
         static constexpr const char *FLAG_TOP_LEVEL_OBJECT = "___CRIMILD_TOP_LEVEL_OBJECT___";
@@ -210,6 +255,34 @@ namespace crimild {
     public:
         virtual bool load( void );
 
+        /**
+            \brief Format version of the last loaded stream
+        */
+        crimild::UInt32 getVersion( void ) const { return _version; }
+
+        enum class LoadMode {
+            /**
+                \brief Load objects one after another, in the order they were saved
+            */
+            SEQUENTIAL,
+
+            /**
+                \brief Load objects on the JobScheduler workers
+
+                Objects are loaded one dependency level at a time and objects
+                in the same level are loaded concurrently. Results are the same
+                as when loading sequentially, as long as objects only modify 
+                themselves and the objects they reference in their load() method.
+
+                Falls back to SEQUENTIAL if the scheduler is not running or
+                when loading legacy streams.
+            */
+            PARALLEL,
+        };
+
+        void setLoadMode( LoadMode mode ) { _loadMode = mode; }
+        LoadMode getLoadMode( void ) const { return _loadMode; }
+
         unsigned int getObjectCount( void ) const { return _topLevelObjects.size(); }
 
         template< class T >
@@ -223,17 +296,128 @@ namespace crimild {
     private:
         bool isTopLevel( SharedPointer< StreamObject > const &obj ) const;
 
+        bool loadLegacy( void );
+        bool loadObjects( void );
+
+        struct DirectoryEntry {
+            crimild::UInt64 classIndex;
+            crimild::UInt64 level;
+            crimild::UInt64 offset;
+            crimild::UInt64 size;
+        };
+
+        /**
+            \brief Loads an object from its payload data
+        */
+        bool loadObject( StreamObject *obj, DirectoryEntry const &entry );
+
+        bool loadObjectsInParallel( std::vector< DirectoryEntry > const &directory, std::vector< std::string > const &classNames );
+
+        /**
+            \brief Reads objects from the payload of another stream
+
+            Each reader has its own read cursor, so objects can be loaded
+            from multiple threads at the same time
+        */
+        class ObjectReader;
+
     private:
         std::vector< SharedPointer< StreamObject >> _topLevelObjects;
+        std::unordered_set< StreamObject::StreamObjectId > _topLevelIds;
+        crimild::UInt32 _version = VERSION_CURRENT;
+        LoadMode _loadMode = LoadMode::SEQUENTIAL;
 
     public:
         bool registerObject( StreamObject *obj );
         bool registerObject( StreamObject::StreamObjectId, SharedPointer< StreamObject > const &obj );
 
     private:
-        // TODO: replace this for crimild::Map<>
-        std::map< StreamObject::StreamObjectId, SharedPointer< StreamObject >> _objects;
-        std::list< SharedPointer< StreamObject >> _orderedObjects;
+        /**
+            \brief Objects in registration order
+
+            Re-registering an object leaves an empty slot behind and
+            appends the object again, giving it a higher priority
+        */
+        std::vector< SharedPointer< StreamObject >> _orderedObjects;
+
+        /**
+            \brief Maps an object identifier to its slot in _orderedObjects
+        */
+        std::unordered_map< StreamObject::StreamObjectId, size_t > _objectSlots;
+
+        /**
+            \brief Maps an object identifier to its directory index while saving
+        */
+        std::unordered_map< StreamObject::StreamObjectId, crimild::UInt64 > _objectIndices;
+
+        /**
+            \brief Objects loaded from a legacy stream, indexed by their original identifier
+        */
+        std::unordered_map< StreamObject::StreamObjectId, SharedPointer< StreamObject >> _objects;
+
+        /**
+            \brief Objects loaded from the stream, in directory order
+        */
+        std::vector< SharedPointer< StreamObject >> _loadedObjects;
+
+        /**
+            \brief Stream owning the objects used to resolve references
+
+            Object readers resolve references using the stream they read from
+        */
+        const Stream *_objectSource = this;
+
+        /**
+            \brief Dependency level of each object while saving, by directory index
+        */
+        std::vector< crimild::UInt64 > _objectLevels;
+
+        /**
+            \brief Directory index of the object being saved
+        */
+        crimild::UInt64 _currentObjectIndex = 0;
+
+        /**
+            \brief Objects referenced by the object being saved that are saved after it
+        */
+        std::vector< crimild::UInt64 > _forwardReferences;
+
+        /**
+            \name Object references
+        */
+        //@{
+    private:
+        void writeObjectReference( const StreamObject *obj );
+        SharedPointer< StreamObject > readObjectReference( void );
+
+        //@}
+
+        /**
+            \name Buffering
+
+            While flushing, objects are serialized into a memory buffer
+            so their offsets and sizes are known before writing the
+            directory. While loading, objects are read from the payload
+            buffer using their directory entry.
+        */
+        //@{
+    private:
+        std::vector< unsigned char > *_writeBuffer = nullptr;
+        const unsigned char *_readCursor = nullptr;
+        const unsigned char *_readEnd = nullptr;
+        const unsigned char *_payload = nullptr;
+
+        /**
+            \brief Keeps the payload alive when it references the underlying storage
+        */
+        SharedPointer< void > _payloadStorage;
+
+        /**
+            \brief Number of bytes written to or read from the underlying storage
+        */
+        crimild::UInt64 _storageOffset = 0;
+
+        //@}
 
         /**
             \name Writing properites
@@ -262,17 +446,15 @@ namespace crimild {
         template< class T >
         void write( SharedPointer< T > &obj )
         {
-            StreamObject::StreamObjectId objId = ( obj != nullptr ? obj->getUniqueIdentifier() : 0 );
-            write( objId );
+            writeObjectReference( crimild::get_ptr( obj ) );
         }
 
         template< class T >
         void write( std::vector< SharedPointer< T >> &os )
         {
-            unsigned int count = os.size();
-            write( count );
+            writeVarUInt( os.size() );
             for ( auto &o : os ) {
-                write( o->getUniqueIdentifier() );
+                writeObjectReference( crimild::get_ptr( o ) );
             }
         }
 
@@ -284,9 +466,30 @@ namespace crimild {
         void write( unsigned int i );
         void write( long long ll );
         void write( unsigned long long ll );
+        void write( long l );
+        void write( unsigned long l );
         void write( float f );
 
-        virtual void writeRawBytes( const void *bytes, size_t size ) = 0;
+        /**
+            \brief Writes an unsigned integer using a variable number of bytes
+        */
+        void writeVarUInt( crimild::UInt64 value );
+
+        void writeRawBytes( const void *bytes, size_t size );
+
+        /**
+            \brief Pads the payload so the next bytes are aligned
+
+            Use it before writing raw data that may be referenced
+            directly when loading. See readAlignment()
+        */
+        void writeAlignment( size_t alignment );
+
+    protected:
+        /**
+            \brief Writes bytes into the underlying storage
+        */
+        virtual void writeBytes( const void *bytes, size_t size ) = 0;
 
         //@}
 
@@ -321,16 +524,8 @@ namespace crimild {
         template< class T >
         void read( SharedPointer< T > &ptr )
         {
-            StreamObject::StreamObjectId objId;
-            read( objId );
-
-            if ( objId == 0 ) {
-                return;
-            }
-
-            auto obj = _objects[ objId ];
+            auto obj = readObjectReference();
             if ( obj == nullptr ) {
-                Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot find object with id ", objId );
                 return;
             }
 
@@ -340,15 +535,12 @@ namespace crimild {
         template< class T >
         void read( std::vector< SharedPointer< T >> &objs )
         {
-            unsigned int count;
-            read( count );
+            crimild::UInt64 count = readCount();
+            objs.reserve( objs.size() + count );
 
-            for ( int i = 0; i < count; i++ ) {
-                StreamObject::StreamObjectId objId;
-                read( objId );
-                auto obj = _objects[ objId ];
+            for ( crimild::UInt64 i = 0; i < count; i++ ) {
+                auto obj = readObjectReference();
                 if ( obj == nullptr ) {
-                    Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot find object with id ", objId );
                     continue;
                 }
                 objs.push_back( crimild::cast_ptr< T >( obj ) );
@@ -363,9 +555,53 @@ namespace crimild {
         void read( unsigned int &i );
         void read( long long &ll );
         void read( unsigned long long &ll );
+        void read( long &l );
+        void read( unsigned long &l );
         void read( float &f );
 
-        virtual void readRawBytes( void *bytes, size_t size ) = 0;
+        void readVarUInt( crimild::UInt64 &value );
+
+        void readRawBytes( void *bytes, size_t size );
+
+        /**
+            \brief Skips the padding written by writeAlignment()
+        */
+        void readAlignment( size_t alignment );
+
+        /**
+            \brief Gets a pointer to the next bytes without copying them
+
+            Only succeeds if the stream references its underlying storage,
+            like memory mapped files do. In that case, the read cursor is
+            advanced and storage will keep the returned bytes alive.
+            Otherwise, nullptr is returned and the read cursor is left
+            untouched so bytes can be read with readRawBytes() instead.
+        */
+        const unsigned char *readRawBytesInPlace( size_t size, SharedPointer< void > &storage );
+
+    private:
+        /**
+            \brief Reads a string length or an array count
+        */
+        crimild::UInt64 readCount( void );
+
+    protected:
+        /**
+            \brief Reads bytes from the underlying storage
+        */
+        virtual void readBytes( void *bytes, size_t size ) = 0;
+
+        /**
+            \brief Provides direct access to bytes in the underlying storage
+
+            Streams that keep their storage in memory may override this
+            method to avoid copying the payload. The returned bytes must
+            remain valid for as long as storage is alive.
+
+            \returns nullptr by default, in which case bytes are copied
+            using readBytes()
+        */
+        virtual const unsigned char *mapBytes( size_t size, SharedPointer< void > &storage ) { return nullptr; }
 
         //@}
     };
@@ -26,6 +26,7 @@
  */
 
 #include "Visitors/ComputeRenderQueue.hpp"
+#include "Visitors/FetchLights.hpp"
 #include "Components/RenderStateComponent.hpp"
 #include "Rendering/RenderQueue.hpp"
 
@@ -35,9 +36,11 @@
 
 using namespace crimild;
 
-ComputeRenderQueue::ComputeRenderQueue( Camera *camera, RenderQueue *result )
+ComputeRenderQueue::ComputeRenderQueue( Camera *camera, RenderQueue *result, std::vector< Light * > const *lights )
     : _camera( camera ),
-      _result( result )
+      _result( result ),
+      _lights( lights ),
+      _planeMask( Camera::CULLING_PLANES_ALL )
 {
 }
 
@@ -55,21 +58,50 @@ void ComputeRenderQueue::traverse( Node *scene )
         _camera->computeCullingPlanes();
     }
 
+    // lights are not affected by culling
+    if ( _lights != nullptr ) {
+        for ( auto light : *_lights ) {
+            _result->push( light );
+        }
+    }
+    else {
+        FetchLights fetchLights;
+        scene->perform( fetchLights );
+        fetchLights.forEachLight( [ this ]( Light *light ) {
+            _result->push( light );
+        });
+    }
+
+    _planeMask = Camera::CULLING_PLANES_ALL;
+
     NodeVisitor::traverse( scene );
+
+    // sort now, while we are still in the same thread that computed the queue
+    _result->sort();
 }
 
 void ComputeRenderQueue::visitGroup( Group *group )
 {
-    // we should not discard groups based on culling
-    // since there could be lights or other nodes
-    // that affect the scene even if they are not visible
+    auto parentMask = _planeMask;
+
+    if ( _planeMask != 0 && _camera != nullptr && _camera->culled( group->getWorldBound(), _planeMask ) ) {
+        // the whole subtree is outside the frustum
+        _planeMask = parentMask;
+        return;
+    }
+
     NodeVisitor::visitGroup( group );
+
+    _planeMask = parentMask;
 }
 
 void ComputeRenderQueue::visitGeometry( Geometry *geometry )
 {
-    if ( _camera != nullptr && _camera->culled( geometry->getWorldBound() ) ) {
-        return;
+    if ( _planeMask != 0 && _camera != nullptr ) {
+        auto mask = _planeMask;
+        if ( _camera->culled( geometry->getWorldBound(), mask ) ) {
+            return;
+        }
     }
 
     _result->push( geometry );
@@ -77,6 +109,6 @@ void ComputeRenderQueue::visitGeometry( Geometry *geometry )
 
 void ComputeRenderQueue::visitLight( Light *light )
 {
-    _result->push( light );
+    // lights have already been collected in traverse()
 }
 
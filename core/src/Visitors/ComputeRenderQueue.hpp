@@ -29,15 +29,33 @@
 #define CRIMILD_CORE_VISITORS_COMPUTE_RENDER_QUEUE_
 
 #include "Visitors/NodeVisitor.hpp"
+#include "Foundation/Types.hpp"
+
+#include <vector>
 
 namespace crimild {
     
     class Camera;
+    class Light;
     class RenderQueue;
     
+    /**
+       \brief Fills a render queue with the nodes visible from a camera
+
+       Culling is hierarchical: a group whose world bound lies outside
+       the frustum is discarded together with all of its descendants.
+       Frustum planes that a group is completely in front of are not
+       tested again for any node below it.
+
+       Since lights may affect visible geometries even when they are
+       culled, they are gathered separately. If no list of lights is
+       provided, the visitor collects them from the scene itself before
+       performing the culling traversal. A precomputed list can be shared
+       when computing render queues for several cameras in the same frame.
+     */
     class ComputeRenderQueue : public NodeVisitor {
     public:
-        ComputeRenderQueue( Camera *camera, RenderQueue *result );
+        ComputeRenderQueue( Camera *camera, RenderQueue *result, std::vector< Light * > const *lights = nullptr );
         virtual ~ComputeRenderQueue( void );
         
         virtual void traverse( Node *scene ) override;
@@ -49,6 +67,12 @@ namespace crimild {
     private:
         Camera *_camera = nullptr;
         RenderQueue *_result = nullptr;
+        std::vector< Light * > const *_lights = nullptr;
+
+        /**
+           \brief Frustum planes that still need to be tested for the current subtree
+         */
+        crimild::UInt32 _planeMask;
     };
     
 }
@@ -54,7 +54,7 @@ void ParallelApply::visitGroup( Group *group )
 	_callback( group );
 
 	auto job = crimild::concurrency::async();
-	group->forEachNode( [ this, job ]( Node *node ) { 
+	group->forEachNode( [ this, &job ]( Node *node ) { 
 		crimild::concurrency::async( job, [ this, node ] {
 			node->accept( *this ); 
 		});
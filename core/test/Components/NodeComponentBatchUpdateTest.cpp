@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Components/RotationComponent.hpp"
+#include "Components/OrbitComponent.hpp"
+#include "Components/MaterialComponent.hpp"
+#include "SceneGraph/Node.hpp"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace crimild;
+
+TEST( NodeComponentBatchUpdateTest, registeredUpdaters )
+{
+	EXPECT_NE( nullptr, NodeComponent::getBatchUpdater( NodeComponent::getTypeId< RotationComponent >() ) );
+	EXPECT_NE( nullptr, NodeComponent::getBatchUpdater( NodeComponent::getTypeId< OrbitComponent >() ) );
+	EXPECT_EQ( nullptr, NodeComponent::getBatchUpdater( NodeComponent::getTypeId< MaterialComponent >() ) );
+	EXPECT_EQ( nullptr, NodeComponent::getBatchUpdater( NodeComponent::INVALID_TYPE_ID ) );
+}
+
+TEST( NodeComponentBatchUpdateTest, componentTypeId )
+{
+	auto node = crimild::alloc< Node >();
+	auto cmp = node->attachComponent< RotationComponent >( Vector3f( 0.0f, 1.0f, 0.0f ), 0.5f );
+
+	EXPECT_EQ( NodeComponent::getTypeId< RotationComponent >(), cmp->getComponentTypeId() );
+}
+
+TEST( NodeComponentBatchUpdateTest, batchMatchesIndividualUpdates )
+{
+	const size_t NODE_COUNT = 10;
+	const Clock clock( 0.1 );
+
+	std::vector< SharedPointer< Node >> nodes;
+	std::vector< SharedPointer< Node >> expected;
+	std::vector< NodeComponent * > rotations;
+	std::vector< NodeComponent * > orbits;
+
+	for ( size_t i = 0; i < NODE_COUNT; i++ ) {
+		auto axis = Vector3f( 1.0f, i, 0.0f ).getNormalized();
+		auto speed = 0.1f * i;
+
+		auto node = crimild::alloc< Node >();
+		rotations.push_back( node->attachComponent< RotationComponent >( axis, speed ) );
+		orbits.push_back( node->attachComponent< OrbitComponent >( 0.0f, 1.0f, 2.0f, 1.0f, speed, 0.1f * i ) );
+		nodes.push_back( node );
+
+		auto other = crimild::alloc< Node >();
+		other->attachComponent< RotationComponent >( axis, speed );
+		other->attachComponent< OrbitComponent >( 0.0f, 1.0f, 2.0f, 1.0f, speed, 0.1f * i );
+		expected.push_back( other );
+	}
+
+	for ( int step = 0; step < 3; step++ ) {
+		RotationComponent::updateBatch( rotations.data(), rotations.size(), clock );
+		OrbitComponent::updateBatch( orbits.data(), orbits.size(), clock );
+
+		for ( auto &node : expected ) {
+			node->updateComponents( clock );
+		}
+	}
+
+	for ( size_t i = 0; i < NODE_COUNT; i++ ) {
+		auto &a = nodes[ i ]->getLocal();
+		auto &b = expected[ i ]->getLocal();
+		for ( int j = 0; j < 3; j++ ) {
+			EXPECT_FLOAT_EQ( b.getTranslate()[ j ], a.getTranslate()[ j ] );
+		}
+		for ( int j = 0; j < 3; j++ ) {
+			EXPECT_FLOAT_EQ( b.getRotate().getImaginary()[ j ], a.getRotate().getImaginary()[ j ] );
+		}
+		EXPECT_FLOAT_EQ( b.getRotate().getReal(), a.getRotate().getReal() );
+	}
+}
+
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Concurrency/Async.hpp"
+#include "Concurrency/JobScheduler.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <vector>
+
+using namespace crimild;
+using namespace crimild::concurrency;
+
+TEST( AsyncTest, parallelFor )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 3 );
+	scheduler.start();
+
+	for ( int grain : { 0, 1, 7, 100, 5000 } ) {
+		std::vector< std::atomic< int >> visits( 1000 );
+		for ( auto &v : visits ) {
+			v = 0;
+		}
+
+		parallel_for( 0, 1000, grain, [ &visits ]( int i ) {
+			visits[ i ]++;
+		});
+
+		for ( auto &v : visits ) {
+			EXPECT_EQ( 1, v );
+		}
+	}
+
+	scheduler.stop();
+}
+
+TEST( AsyncTest, parallelForEmptyRange )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 1 );
+	scheduler.start();
+
+	int count = 0;
+	parallel_for( 10, 10, [ &count ]( int ) { count++; } );
+	parallel_for( 10, 5, [ &count ]( int ) { count++; } );
+
+	EXPECT_EQ( 0, count );
+
+	scheduler.stop();
+}
+
+TEST( AsyncTest, parallelForWithoutScheduler )
+{
+	ASSERT_FALSE( JobScheduler::hasInstance() );
+
+	EXPECT_LT( 0, computeGrainSize( 1000 ) );
+
+	std::vector< int > visits( 1000, 0 );
+	parallel_for( 0, 1000, [ &visits ]( int i ) {
+		visits[ i ]++;
+	});
+
+	for ( auto v : visits ) {
+		EXPECT_EQ( 1, v );
+	}
+
+	auto count = parallel_reduce( 0, 1000, 0, 0, []( int begin, int end, int init ) {
+		return init + ( end - begin );
+	}, []( int a, int b ) { return a + b; } );
+	EXPECT_EQ( 1000, count );
+}
+
+TEST( AsyncTest, parallelReduce )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 3 );
+	scheduler.start();
+
+	std::vector< double > values( 10000 );
+	for ( size_t i = 0; i < values.size(); i++ ) {
+		values[ i ] = 1.0 / ( i + 1 );
+	}
+
+	auto sum = [ &values ]( size_t begin, size_t end, double init ) {
+		for ( auto i = begin; i < end; i++ ) {
+			init += values[ i ];
+		}
+		return init;
+	};
+
+	auto add = []( double a, double b ) { return a + b; };
+
+	auto expected = parallel_reduce( size_t( 0 ), values.size(), size_t( 64 ), 0.0, sum, add );
+	EXPECT_NEAR( sum( 0, values.size(), 0.0 ), expected, 1e-9 );
+
+	// results must not depend on how jobs are scheduled
+	for ( int i = 0; i < 10; i++ ) {
+		EXPECT_EQ( expected, parallel_reduce( size_t( 0 ), values.size(), size_t( 64 ), 0.0, sum, add ) );
+	}
+
+	scheduler.stop();
+}
+
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Concurrency/JobScheduler.hpp"
+#include "Concurrency/Async.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <set>
+#include <thread>
+
+using namespace crimild;
+using namespace crimild::concurrency;
+
+TEST( JobSchedulerTest, workerIds )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 3 );
+
+	EXPECT_EQ( JobScheduler::INVALID_WORKER_ID, scheduler.getWorkerId() );
+
+	scheduler.start();
+
+	EXPECT_EQ( JobScheduler::MAIN_WORKER_ID, scheduler.getWorkerId() );
+	EXPECT_TRUE( scheduler.isMainWorker() );
+
+	std::mutex mutex;
+	std::set< JobScheduler::WorkerId > ids;
+
+	auto parent = async();
+	for ( int i = 0; i < 1000; i++ ) {
+		async( parent, [ &mutex, &ids ] {
+			std::lock_guard< std::mutex > lock( mutex );
+			ids.insert( JobScheduler::getInstance()->getWorkerId() );
+		});
+	}
+	wait( parent );
+
+	for ( auto id : ids ) {
+		EXPECT_LE( JobScheduler::MAIN_WORKER_ID, id );
+		EXPECT_GE( scheduler.getNumWorkers(), id );
+	}
+
+	size_t jobCount = 0;
+	int statCount = 0;
+	scheduler.eachWorkerStat( [ &jobCount, &statCount ]( JobScheduler::WorkerId, const JobScheduler::WorkerStat &stat ) {
+		jobCount += stat.jobCount;
+		statCount++;
+	});
+	EXPECT_EQ( 1000, jobCount );
+	EXPECT_EQ( 4, statCount );
+
+	scheduler.stop();
+
+	EXPECT_EQ( JobScheduler::INVALID_WORKER_ID, scheduler.getWorkerId() );
+}
+
+TEST( JobSchedulerTest, nestedJobs )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 2 );
+	scheduler.start();
+
+	std::atomic< int > count( 0 );
+
+	auto parent = async();
+	for ( int i = 0; i < 10; i++ ) {
+		async( parent, [ parent, &count ] {
+			for ( int j = 0; j < 10; j++ ) {
+				async( parent, [ &count ] {
+					count++;
+				});
+			}
+		});
+	}
+	wait( parent );
+
+	EXPECT_EQ( 100, count );
+
+	scheduler.stop();
+}
+
+TEST( JobSchedulerTest, scheduleFromExternalThread )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 1 );
+	scheduler.start();
+
+	std::atomic< bool > executed( false );
+
+	JobPtr job;
+	std::thread t( [ &job, &executed ] {
+		job = async( [ &executed ] {
+			executed = true;
+		});
+	});
+	t.join();
+
+	wait( job );
+
+	EXPECT_TRUE( executed );
+
+	scheduler.stop();
+}
+
+TEST( JobSchedulerTest, idleWorkersAreParked )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 4 );
+	scheduler.setIdleStrategy( JobScheduler::IdleStrategy::SPIN_THEN_PARK );
+	scheduler.start();
+
+	// deadlines only prevent the test from hanging. They are not expected to be reached
+	auto waitUntil = []( std::function< bool( void ) > const &condition ) {
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds( 10 );
+		while ( !condition() && std::chrono::steady_clock::now() < deadline ) {
+			std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+		}
+		return condition();
+	};
+
+	// workers run out of work and park
+	EXPECT_TRUE( waitUntil( [ &scheduler ] { return scheduler.getParkedWorkerCount() == 4; } ) );
+
+	// nothing wakes them up until there is work to do
+	std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+	EXPECT_EQ( 4, scheduler.getParkedWorkerCount() );
+
+	// scheduling a job from the main thread must wake up a worker
+	std::atomic< bool > executed( false );
+	async( [ &executed ] {
+		executed = true;
+	});
+	EXPECT_TRUE( waitUntil( [ &executed ] { return executed.load(); } ) );
+
+	// and workers park again once the job is done
+	EXPECT_TRUE( waitUntil( [ &scheduler ] { return scheduler.getParkedWorkerCount() == 4; } ) );
+
+	scheduler.stop();
+}
+
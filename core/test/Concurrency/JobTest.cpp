@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Concurrency/Async.hpp"
+#include "Concurrency/Job.hpp"
+#include "Concurrency/JobFunction.hpp"
+#include "Concurrency/JobPool.hpp"
+#include "Concurrency/JobScheduler.hpp"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <atomic>
+
+using namespace crimild;
+using namespace crimild::concurrency;
+
+TEST( JobTest, inlineCallback )
+{
+	int count = 0;
+
+	JobFunction fn;
+	EXPECT_FALSE( static_cast< bool >( fn ) );
+
+	fn.assign( [ &count ] { count++; } );
+	EXPECT_TRUE( static_cast< bool >( fn ) );
+	EXPECT_TRUE( fn.isStoredInline() );
+
+	fn();
+	EXPECT_EQ( 1, count );
+
+	fn.reset();
+	EXPECT_FALSE( static_cast< bool >( fn ) );
+}
+
+TEST( JobTest, bigCallback )
+{
+	std::array< char, 2 * JobFunction::STORAGE_SIZE > data;
+	data[ 0 ] = 42;
+
+	int result = 0;
+
+	JobFunction fn;
+	fn.assign( [ data, &result ] { result = data[ 0 ]; } );
+	EXPECT_FALSE( fn.isStoredInline() );
+
+	fn();
+	EXPECT_EQ( 42, result );
+}
+
+TEST( JobTest, emptyCallback )
+{
+	JobFunction fn;
+	fn.assign( JobCallback() );
+	EXPECT_FALSE( static_cast< bool >( fn ) );
+
+	auto job = Job::create();
+	job->reset( JobCallback() );
+	EXPECT_FALSE( job->isCompleted() );
+
+	job->execute();
+
+	EXPECT_TRUE( job->isCompleted() );
+}
+
+TEST( JobTest, callbackIsReleasedAfterExecution )
+{
+	auto obj = crimild::alloc< int >( 0 );
+	EXPECT_EQ( 1, obj.use_count() );
+
+	auto job = Job::create();
+	job->reset( [ obj ] { ( *obj )++; } );
+	EXPECT_EQ( 2, obj.use_count() );
+	EXPECT_FALSE( job->isCompleted() );
+
+	job->execute();
+
+	EXPECT_TRUE( job->isCompleted() );
+	EXPECT_EQ( 1, *obj );
+	EXPECT_EQ( 1, obj.use_count() );
+}
+
+TEST( JobTest, parentCompletesWithChildren )
+{
+	auto parent = Job::create();
+	parent->reset();
+
+	auto child0 = Job::create();
+	child0->reset( parent, [] { } );
+
+	auto child1 = Job::create();
+	child1->reset( parent, [] { } );
+
+	EXPECT_EQ( 2, parent->getChildCount() );
+	EXPECT_FALSE( parent->isCompleted() );
+
+	child0->execute();
+	EXPECT_FALSE( parent->isCompleted() );
+
+	child1->execute();
+	EXPECT_TRUE( parent->isCompleted() );
+}
+
+TEST( JobTest, poolIsReused )
+{
+	// warm up
+	for ( int i = 0; i < 1000; i++ ) {
+		Job::create();
+	}
+
+	auto chunkCount = JobPool::getTotalChunkCount();
+
+	for ( int i = 0; i < 1000; i++ ) {
+		auto job = Job::create();
+		job->reset( [ i ] { } );
+		job->execute();
+	}
+
+	EXPECT_EQ( chunkCount, JobPool::getTotalChunkCount() );
+}
+
+TEST( JobTest, noAllocationsOnceWarm )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 2 );
+	scheduler.start();
+
+	std::atomic< int > count( 0 );
+
+	auto frame = [ &count ] {
+		auto parent = crimild::concurrency::async();
+		for ( int i = 0; i < 1000; i++ ) {
+			crimild::concurrency::async( parent, [ &count ] {
+				count++;
+			});
+		}
+		crimild::concurrency::wait( parent );
+	};
+
+	// warm up pools
+	for ( int i = 0; i < 10; i++ ) {
+		frame();
+	}
+
+	auto chunkCount = JobPool::getTotalChunkCount();
+
+	for ( int i = 0; i < 10; i++ ) {
+		frame();
+	}
+
+	EXPECT_EQ( 20000, count );
+
+	// jobs may be released by any worker, so allow a few extra chunks
+	// while blocks settle back into their owner's free lists
+	EXPECT_GE( chunkCount + 2, JobPool::getTotalChunkCount() );
+
+	scheduler.stop();
+}
+
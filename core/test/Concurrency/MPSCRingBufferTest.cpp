@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Concurrency/MPSCRingBuffer.hpp"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+
+TEST( MPSCRingBufferTest, construction )
+{
+	MPSCRingBuffer< int > queue( 100 );
+
+	EXPECT_TRUE( queue.empty() );
+	EXPECT_EQ( 0, queue.size() );
+	EXPECT_EQ( 128, queue.getCapacity() );
+
+	int value = 0;
+	EXPECT_FALSE( queue.tryPop( value ) );
+}
+
+TEST( MPSCRingBufferTest, popIsFIFO )
+{
+	MPSCRingBuffer< std::string > queue( 4 );
+	EXPECT_TRUE( queue.tryPush( std::string( "a" ) ) );
+	EXPECT_TRUE( queue.tryPush( std::string( "b" ) ) );
+	EXPECT_TRUE( queue.tryPush( std::string( "c" ) ) );
+	EXPECT_EQ( 3, queue.size() );
+
+	std::string value;
+	EXPECT_TRUE( queue.tryPop( value ) );
+	EXPECT_EQ( "a", value );
+	EXPECT_TRUE( queue.tryPop( value ) );
+	EXPECT_EQ( "b", value );
+	EXPECT_TRUE( queue.tryPop( value ) );
+	EXPECT_EQ( "c", value );
+	EXPECT_FALSE( queue.tryPop( value ) );
+	EXPECT_TRUE( queue.empty() );
+}
+
+TEST( MPSCRingBufferTest, full )
+{
+	MPSCRingBuffer< int > queue( 4 );
+
+	for ( int i = 0; i < 4; i++ ) {
+		EXPECT_TRUE( queue.tryPush( i ) );
+	}
+	EXPECT_FALSE( queue.tryPush( 4 ) );
+
+	int value = 0;
+	EXPECT_TRUE( queue.tryPop( value ) );
+	EXPECT_EQ( 0, value );
+
+	// slot is released once consumed
+	EXPECT_TRUE( queue.tryPush( 4 ) );
+
+	for ( int i = 1; i <= 4; i++ ) {
+		EXPECT_TRUE( queue.tryPop( value ) );
+		EXPECT_EQ( i, value );
+	}
+	EXPECT_TRUE( queue.empty() );
+}
+
+TEST( MPSCRingBufferTest, clear )
+{
+	MPSCRingBuffer< int > queue( 4 );
+	queue.tryPush( 1 );
+	queue.tryPush( 2 );
+
+	queue.clear();
+
+	EXPECT_TRUE( queue.empty() );
+	EXPECT_TRUE( queue.tryPush( 3 ) );
+	EXPECT_EQ( 1, queue.size() );
+}
+
+TEST( MPSCRingBufferTest, concurrentPush )
+{
+	const int PRODUCER_COUNT = 4;
+	const int VALUES_PER_PRODUCER = 10000;
+
+	MPSCRingBuffer< int > queue( 64 );
+
+	std::vector< std::thread > producers;
+	for ( int p = 0; p < PRODUCER_COUNT; p++ ) {
+		producers.push_back( std::thread( [ &queue, p, VALUES_PER_PRODUCER ] {
+			for ( int i = 0; i < VALUES_PER_PRODUCER; i++ ) {
+				while ( !queue.tryPush( p * VALUES_PER_PRODUCER + i ) ) {
+					std::this_thread::yield();
+				}
+			}
+		}));
+	}
+
+	// values from each producer must arrive in order and exactly once
+	std::vector< int > next( PRODUCER_COUNT, 0 );
+	int consumed = 0;
+	while ( consumed < PRODUCER_COUNT * VALUES_PER_PRODUCER ) {
+		int value;
+		if ( queue.tryPop( value ) ) {
+			auto p = value / VALUES_PER_PRODUCER;
+			EXPECT_EQ( next[ p ], value % VALUES_PER_PRODUCER );
+			next[ p ]++;
+			consumed++;
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+
+	for ( auto &t : producers ) {
+		t.join();
+	}
+
+	EXPECT_TRUE( queue.empty() );
+	for ( auto n : next ) {
+		EXPECT_EQ( VALUES_PER_PRODUCER, n );
+	}
+}
+
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Concurrency/TaskGraph.hpp"
+#include "Concurrency/JobScheduler.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+using namespace crimild::concurrency;
+
+TEST( TaskGraphTest, dependenciesDefineExecutionOrder )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 3 );
+	scheduler.start();
+
+	std::mutex mutex;
+	std::vector< std::string > order;
+	auto record = [ &mutex, &order ]( std::string const &name ) {
+		return [ &mutex, &order, name ] {
+			std::lock_guard< std::mutex > lock( mutex );
+			order.push_back( name );
+		};
+	};
+
+	TaskGraph graph;
+	graph.addTask( "c", record( "c" ) );
+	graph.addTask( "b", record( "b" ) );
+	graph.addTask( "a", record( "a" ) );
+	graph.addDependency( "b", "a" );
+	graph.addDependency( "c", "b" );
+
+	for ( int i = 0; i < 10; i++ ) {
+		order.clear();
+		EXPECT_TRUE( graph.execute() );
+		ASSERT_EQ( 3, order.size() );
+		EXPECT_EQ( "a", order[ 0 ] );
+		EXPECT_EQ( "b", order[ 1 ] );
+		EXPECT_EQ( "c", order[ 2 ] );
+	}
+
+	scheduler.stop();
+}
+
+TEST( TaskGraphTest, independentTasks )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 3 );
+	scheduler.start();
+
+	std::atomic< int > count( 0 );
+	std::atomic< bool > joinedAfterAll( false );
+
+	// a -> { b0, ..., b9 } -> c
+	TaskGraph graph;
+	auto a = graph.addTask( "a", [] { } );
+	auto c = graph.addTask( "c", [ &count, &joinedAfterAll ] { joinedAfterAll = ( count == 10 ); } );
+	for ( int i = 0; i < 10; i++ ) {
+		auto b = graph.addTask( "b" + std::to_string( i ), [ &count ] { count++; } );
+		graph.addDependency( b, a );
+		graph.addDependency( c, b );
+	}
+
+	EXPECT_TRUE( graph.execute() );
+	EXPECT_EQ( 10, count );
+	EXPECT_TRUE( joinedAfterAll );
+
+	scheduler.stop();
+}
+
+TEST( TaskGraphTest, continuations )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 1 );
+	scheduler.start();
+
+	std::vector< int > values;
+
+	TaskGraph graph;
+	graph.addTask( "first", [ &values ] { values.push_back( 1 ); } );
+	graph.addTask( "second", [ &values ] { values.push_back( 3 ); } );
+	graph.addDependency( "second", "first" );
+	graph.attachContinuation( "first", [ &values ] { values.push_back( 2 ); } );
+
+	EXPECT_TRUE( graph.execute() );
+	ASSERT_EQ( 3, values.size() );
+	EXPECT_EQ( 1, values[ 0 ] );
+	EXPECT_EQ( 2, values[ 1 ] );
+	EXPECT_EQ( 3, values[ 2 ] );
+
+	scheduler.stop();
+}
+
+TEST( TaskGraphTest, invalidTasks )
+{
+	TaskGraph graph;
+	EXPECT_NE( TaskGraph::INVALID_TASK_ID, graph.addTask( "a", nullptr ) );
+	EXPECT_EQ( TaskGraph::INVALID_TASK_ID, graph.addTask( "a", nullptr ) );
+	EXPECT_EQ( TaskGraph::INVALID_TASK_ID, graph.getTaskId( "b" ) );
+	EXPECT_FALSE( graph.addDependency( "a", "a" ) );
+	EXPECT_FALSE( graph.addDependency( "a", "b" ) );
+	EXPECT_FALSE( graph.attachContinuation( "b", nullptr ) );
+}
+
+TEST( TaskGraphTest, removeTask )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 3 );
+	scheduler.start();
+
+	std::mutex mutex;
+	std::vector< std::string > order;
+	auto record = [ &mutex, &order ]( std::string const &name ) {
+		return [ &mutex, &order, name ] {
+			std::lock_guard< std::mutex > lock( mutex );
+			order.push_back( name );
+		};
+	};
+
+	// a -> b -> c -> d
+	TaskGraph graph;
+	graph.addTask( "d", record( "d" ) );
+	graph.addTask( "b", record( "b" ) );
+	graph.addTask( "c", record( "c" ) );
+	graph.addTask( "a", record( "a" ) );
+	graph.addDependency( "b", "a" );
+	graph.addDependency( "c", "b" );
+	graph.addDependency( "d", "c" );
+
+	EXPECT_TRUE( graph.removeTask( "b" ) );
+	EXPECT_FALSE( graph.removeTask( "b" ) );
+	EXPECT_EQ( 3, graph.getTaskCount() );
+	EXPECT_EQ( TaskGraph::INVALID_TASK_ID, graph.getTaskId( "b" ) );
+
+	for ( int i = 0; i < 10; i++ ) {
+		order.clear();
+		EXPECT_TRUE( graph.execute() );
+		ASSERT_EQ( 3, order.size() );
+		EXPECT_EQ( "a", order[ 0 ] );
+		EXPECT_EQ( "c", order[ 1 ] );
+		EXPECT_EQ( "d", order[ 2 ] );
+	}
+
+	scheduler.stop();
+}
+
+TEST( TaskGraphTest, cannotModifyWhileExecuting )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 1 );
+	scheduler.start();
+
+	bool added = true;
+	bool continuationAdded = true;
+
+	TaskGraph graph;
+	graph.addTask( "a", [ &graph, &added, &continuationAdded ] {
+		EXPECT_TRUE( graph.isExecuting() );
+		added = graph.addTask( "b", nullptr ) != TaskGraph::INVALID_TASK_ID;
+		continuationAdded = graph.attachContinuation( "a", [] { } );
+	});
+
+	EXPECT_TRUE( graph.execute() );
+	EXPECT_FALSE( graph.isExecuting() );
+	EXPECT_FALSE( added );
+	EXPECT_FALSE( continuationAdded );
+	EXPECT_EQ( 1, graph.getTaskCount() );
+
+	EXPECT_NE( TaskGraph::INVALID_TASK_ID, graph.addTask( "b", nullptr ) );
+
+	scheduler.stop();
+}
+
+TEST( TaskGraphTest, cyclesAreNotExecuted )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 1 );
+	scheduler.start();
+
+	bool executed = false;
+
+	TaskGraph graph;
+	graph.addTask( "a", [ &executed ] { executed = true; } );
+	graph.addTask( "b", [ &executed ] { executed = true; } );
+	graph.addDependency( "a", "b" );
+	graph.addDependency( "b", "a" );
+
+	EXPECT_FALSE( graph.execute() );
+	EXPECT_FALSE( executed );
+
+	scheduler.stop();
+}
+
+TEST( TaskGraphTest, criticalPath )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 1 );
+	scheduler.start();
+
+	auto sleep = []( int ms ) {
+		return [ ms ] { std::this_thread::sleep_for( std::chrono::milliseconds( ms ) ); };
+	};
+
+	// a -> b (long) -> d
+	// a -> c (short) -> d
+	TaskGraph graph;
+	auto a = graph.addTask( "a", sleep( 1 ) );
+	auto b = graph.addTask( "b", sleep( 20 ) );
+	auto c = graph.addTask( "c", sleep( 1 ) );
+	auto d = graph.addTask( "d", sleep( 1 ) );
+	graph.addDependency( b, a );
+	graph.addDependency( c, a );
+	graph.addDependency( d, b );
+	graph.addDependency( d, c );
+
+	EXPECT_TRUE( graph.execute() );
+
+	auto path = graph.computeCriticalPath();
+	ASSERT_EQ( 3, path.size() );
+	EXPECT_EQ( a, path[ 0 ] );
+	EXPECT_EQ( b, path[ 1 ] );
+	EXPECT_EQ( d, path[ 2 ] );
+
+	EXPECT_GE( graph.getTaskStat( b ).getDuration(), 0.015 );
+	EXPECT_LE( graph.getTaskStat( a ).endTime, graph.getTaskStat( b ).startTime );
+
+	scheduler.stop();
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Concurrency/WorkStealingDeque.hpp"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+
+TEST( WorkStealingQueueTest, construction )
+{
+	WorkStealingQueue< int * > queue;
+
+	EXPECT_TRUE( queue.empty() );
+	EXPECT_EQ( 0, queue.size() );
+	EXPECT_EQ( nullptr, queue.pop() );
+	EXPECT_EQ( nullptr, queue.steal() );
+}
+
+TEST( WorkStealingQueueTest, popIsLIFO )
+{
+	int values[ 3 ];
+
+	WorkStealingQueue< int * > queue;
+	queue.push( &values[ 0 ] );
+	queue.push( &values[ 1 ] );
+	queue.push( &values[ 2 ] );
+
+	EXPECT_EQ( 3, queue.size() );
+	EXPECT_EQ( &values[ 2 ], queue.pop() );
+	EXPECT_EQ( &values[ 1 ], queue.pop() );
+	EXPECT_EQ( &values[ 0 ], queue.pop() );
+	EXPECT_EQ( nullptr, queue.pop() );
+	EXPECT_TRUE( queue.empty() );
+}
+
+TEST( WorkStealingQueueTest, stealIsFIFO )
+{
+	int values[ 3 ];
+
+	WorkStealingQueue< int * > queue;
+	queue.push( &values[ 0 ] );
+	queue.push( &values[ 1 ] );
+	queue.push( &values[ 2 ] );
+
+	EXPECT_EQ( &values[ 0 ], queue.steal() );
+	EXPECT_EQ( &values[ 1 ], queue.steal() );
+	EXPECT_EQ( &values[ 2 ], queue.pop() );
+	EXPECT_EQ( nullptr, queue.steal() );
+	EXPECT_TRUE( queue.empty() );
+}
+
+TEST( WorkStealingQueueTest, grow )
+{
+	std::vector< int > values( 100 );
+
+	WorkStealingQueue< int * > queue( 4 );
+	EXPECT_EQ( 4, queue.getCapacity() );
+
+	for ( auto &v : values ) {
+		queue.push( &v );
+	}
+
+	EXPECT_EQ( 100, queue.size() );
+	EXPECT_LE( 100, queue.getCapacity() );
+
+	EXPECT_EQ( &values[ 0 ], queue.steal() );
+	for ( int i = 99; i > 0; i-- ) {
+		EXPECT_EQ( &values[ i ], queue.pop() );
+	}
+	EXPECT_TRUE( queue.empty() );
+}
+
+TEST( WorkStealingQueueTest, clear )
+{
+	int values[ 3 ];
+
+	WorkStealingQueue< int * > queue;
+	queue.push( &values[ 0 ] );
+	queue.push( &values[ 1 ] );
+	queue.push( &values[ 2 ] );
+	queue.clear();
+
+	EXPECT_TRUE( queue.empty() );
+	EXPECT_EQ( nullptr, queue.pop() );
+}
+
+TEST( WorkStealingQueueTest, concurrentSteal )
+{
+	const int ELEM_COUNT = 100000;
+	const int THIEF_COUNT = 4;
+
+	std::vector< int > values( ELEM_COUNT, 0 );
+	std::atomic< int > consumed( 0 );
+
+	WorkStealingQueue< int * > queue( 16 );
+
+	std::vector< std::thread > thieves;
+	for ( int i = 0; i < THIEF_COUNT; i++ ) {
+		thieves.push_back( std::thread( [ &queue, &consumed ]() {
+			while ( consumed < ELEM_COUNT ) {
+				auto v = queue.steal();
+				if ( v != nullptr ) {
+					( *v )++;
+					consumed++;
+				}
+			}
+		}));
+	}
+
+	for ( int i = 0; i < ELEM_COUNT; i++ ) {
+		queue.push( &values[ i ] );
+		if ( i % 3 == 0 ) {
+			auto v = queue.pop();
+			if ( v != nullptr ) {
+				( *v )++;
+				consumed++;
+			}
+		}
+	}
+
+	while ( consumed < ELEM_COUNT ) {
+		auto v = queue.pop();
+		if ( v != nullptr ) {
+			( *v )++;
+			consumed++;
+		}
+	}
+
+	for ( auto &t : thieves ) {
+		t.join();
+	}
+
+	// every element must be consumed exactly once
+	for ( auto &v : values ) {
+		EXPECT_EQ( 1, v );
+	}
+	EXPECT_TRUE( queue.empty() );
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Foundation/FrameArena.hpp"
+
+#include "gtest/gtest.h"
+
+#include <set>
+#include <vector>
+
+using namespace crimild;
+
+TEST( FrameArenaTest, arenasAreRecycled )
+{
+	FrameArena frameArena;
+
+	std::vector< LinearArena * > arenas;
+	for ( int i = 0; i < CRIMILD_FRAME_ARENA_COUNT; i++ ) {
+		frameArena.beginFrame();
+		arenas.push_back( crimild::get_ptr( frameArena.getCurrentArena() ) );
+	}
+
+	std::set< LinearArena * > unique( arenas.begin(), arenas.end() );
+	EXPECT_EQ( CRIMILD_FRAME_ARENA_COUNT, unique.size() );
+
+	// ring wraps around
+	for ( int i = 0; i < CRIMILD_FRAME_ARENA_COUNT; i++ ) {
+		frameArena.beginFrame();
+		EXPECT_EQ( arenas[ i ], crimild::get_ptr( frameArena.getCurrentArena() ) );
+	}
+}
+
+TEST( FrameArenaTest, lastFrameStats )
+{
+	FrameArena frameArena;
+
+	for ( int frame = 0; frame < 3 * CRIMILD_FRAME_ARENA_COUNT; frame++ ) {
+		auto arena = frameArena.getCurrentArena();
+		for ( int i = 0; i < 10; i++ ) {
+			arena->allocate( 1024 );
+		}
+		arena = nullptr;
+
+		frameArena.beginFrame();
+
+		if ( frame >= CRIMILD_FRAME_ARENA_COUNT - 1 ) {
+			EXPECT_EQ( 10, frameArena.getLastFrameAllocationCount() );
+			EXPECT_EQ( 10240, frameArena.getLastFrameAllocatedBytes() );
+		}
+
+		if ( frame >= 2 * CRIMILD_FRAME_ARENA_COUNT - 1 ) {
+			// arenas have grown enough already
+			EXPECT_EQ( 0, frameArena.getLastFrameHeapAllocationCount() );
+		}
+	}
+}
+
+TEST( FrameArenaTest, arenasInUseAreNotReset )
+{
+	FrameArena frameArena;
+
+	auto arena = frameArena.getCurrentArena();
+	auto value = static_cast< int * >( arena->allocate( sizeof( int ), alignof( int ) ) );
+	*value = 42;
+
+	for ( int i = 0; i < 2 * CRIMILD_FRAME_ARENA_COUNT; i++ ) {
+		frameArena.beginFrame();
+		auto current = frameArena.getCurrentArena();
+		EXPECT_NE( arena, current );
+		for ( int j = 0; j < 10; j++ ) {
+			current->allocate( 1024 );
+		}
+	}
+
+	EXPECT_EQ( 42, *value );
+	EXPECT_EQ( 1, arena->getAllocationCount() );
+}
+
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Foundation/LinearArena.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+
+TEST( LinearArenaTest, allocateAligned )
+{
+	auto arena = crimild::alloc< LinearArena >( 1024 );
+
+	auto a = arena->allocate( 3, 1 );
+	auto b = arena->allocate( 8, 8 );
+	auto c = arena->allocate( 16, 16 );
+
+	ASSERT_NE( nullptr, a );
+	EXPECT_EQ( 0, reinterpret_cast< std::uintptr_t >( b ) % 8 );
+	EXPECT_EQ( 0, reinterpret_cast< std::uintptr_t >( c ) % 16 );
+	EXPECT_LT( a, b );
+	EXPECT_LT( b, c );
+
+	EXPECT_EQ( 3, arena->getAllocationCount() );
+	EXPECT_EQ( 27, arena->getAllocatedBytes() );
+	EXPECT_EQ( 1, arena->getHeapAllocationCount() );
+}
+
+TEST( LinearArenaTest, growWhenFull )
+{
+	auto arena = crimild::alloc< LinearArena >( 64 );
+
+	for ( int i = 0; i < 10; i++ ) {
+		EXPECT_NE( nullptr, arena->allocate( 32 ) );
+	}
+
+	// requests bigger than the block size are supported too
+	EXPECT_NE( nullptr, arena->allocate( 1000 ) );
+
+	EXPECT_LT( 1, arena->getHeapAllocationCount() );
+	EXPECT_LE( 1320, arena->getCapacity() );
+}
+
+TEST( LinearArenaTest, resetMergesBlocks )
+{
+	auto arena = crimild::alloc< LinearArena >( 64 );
+
+	auto first = arena->allocate( 32 );
+	for ( int i = 0; i < 10; i++ ) {
+		arena->allocate( 32 );
+	}
+	auto capacity = arena->getCapacity();
+
+	arena->reset();
+
+	EXPECT_EQ( 0, arena->getAllocationCount() );
+	EXPECT_EQ( 0, arena->getAllocatedBytes() );
+	EXPECT_EQ( 0, arena->getHeapAllocationCount() );
+	EXPECT_EQ( capacity, arena->getCapacity() );
+
+	// same workload fits now in a single block
+	for ( int i = 0; i < 11; i++ ) {
+		arena->allocate( 32 );
+	}
+	EXPECT_EQ( 0, arena->getHeapAllocationCount() );
+
+	// once there's only one block, it's just rewound
+	arena->reset();
+	EXPECT_EQ( capacity, arena->getCapacity() );
+	auto p = arena->allocate( 32 );
+	EXPECT_NE( first, p );
+	arena->reset();
+	EXPECT_EQ( p, arena->allocate( 32 ) );
+}
+
+TEST( LinearArenaTest, concurrentAllocations )
+{
+	const int THREAD_COUNT = 4;
+	const int ALLOCATION_COUNT = 1000;
+
+	auto arena = crimild::alloc< LinearArena >( 256 );
+
+	std::vector< std::vector< void * >> results( THREAD_COUNT );
+	std::vector< std::thread > threads;
+	for ( int t = 0; t < THREAD_COUNT; t++ ) {
+		threads.push_back( std::thread( [ &arena, &results, t ] {
+			for ( int i = 0; i < ALLOCATION_COUNT; i++ ) {
+				auto p = static_cast< int * >( arena->allocate( sizeof( int ), alignof( int ) ) );
+				*p = t;
+				results[ t ].push_back( p );
+			}
+		}));
+	}
+	for ( auto &t : threads ) {
+		t.join();
+	}
+
+	std::set< void * > unique;
+	for ( int t = 0; t < THREAD_COUNT; t++ ) {
+		for ( auto p : results[ t ] ) {
+			EXPECT_EQ( t, *static_cast< int * >( p ) );
+			unique.insert( p );
+		}
+	}
+	EXPECT_EQ( THREAD_COUNT * ALLOCATION_COUNT, unique.size() );
+	EXPECT_EQ( THREAD_COUNT * ALLOCATION_COUNT, arena->getAllocationCount() );
+}
+
+TEST( LinearArenaTest, allocatorWithContainers )
+{
+	auto arena = crimild::alloc< LinearArena >();
+
+	std::vector< int, ArenaAllocator< int >> values( ( ArenaAllocator< int >( crimild::get_ptr( arena ) ) ) );
+	for ( int i = 0; i < 100; i++ ) {
+		values.push_back( i );
+	}
+
+	EXPECT_EQ( crimild::get_ptr( arena ), values.get_allocator().getArena() );
+	EXPECT_LT( 0, arena->getAllocationCount() );
+	EXPECT_EQ( 1, arena->getHeapAllocationCount() );
+	for ( int i = 0; i < 100; i++ ) {
+		EXPECT_EQ( i, values[ i ] );
+	}
+
+	// moving a container carries its arena along
+	std::vector< int, ArenaAllocator< int >> other;
+	EXPECT_EQ( nullptr, other.get_allocator().getArena() );
+	other = std::move( values );
+	EXPECT_EQ( crimild::get_ptr( arena ), other.get_allocator().getArena() );
+	EXPECT_EQ( 100, other.size() );
+}
+
+TEST( LinearArenaTest, allocatorWithoutArena )
+{
+	std::vector< int, ArenaAllocator< int >> values;
+	for ( int i = 0; i < 100; i++ ) {
+		values.push_back( i );
+	}
+
+	EXPECT_EQ( nullptr, values.get_allocator().getArena() );
+	EXPECT_EQ( 100, values.size() );
+	EXPECT_EQ( ArenaAllocator< float >(), ArenaAllocator< int >() );
+}
+
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Foundation/RadixSort.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace crimild;
+
+TEST( RadixSortTest, sort )
+{
+	std::mt19937_64 rng( 1234 );
+
+	std::vector< crimild::UInt64 > values( 1000 );
+	for ( auto &v : values ) {
+		v = rng();
+	}
+
+	auto expected = values;
+	std::sort( expected.begin(), expected.end() );
+
+	std::vector< crimild::UInt64 > scratch;
+	RadixSort::sort( values, scratch, []( crimild::UInt64 v ) { return v; } );
+
+	EXPECT_EQ( expected, values );
+}
+
+TEST( RadixSortTest, stable )
+{
+	struct Entry {
+		crimild::UInt32 key;
+		int order;
+	};
+
+	std::vector< Entry > entries;
+	for ( int i = 0; i < 100; i++ ) {
+		entries.push_back( Entry { crimild::UInt32( ( 100 - i ) % 3 ) << 16, i } );
+	}
+
+	std::vector< Entry > scratch;
+	RadixSort::sort( entries, scratch, []( Entry const &e ) { return e.key; } );
+
+	for ( size_t i = 1; i < entries.size(); i++ ) {
+		ASSERT_LE( entries[ i - 1 ].key, entries[ i ].key );
+		if ( entries[ i - 1 ].key == entries[ i ].key ) {
+			EXPECT_LT( entries[ i - 1 ].order, entries[ i ].order );
+		}
+	}
+}
+
+TEST( RadixSortTest, floatKeys )
+{
+	std::vector< float > values = { 3.5f, -1.0f, 0.0f, -100.0f, 2.0f, 1e10f, -0.5f };
+
+	auto expected = values;
+	std::sort( expected.begin(), expected.end() );
+
+	std::vector< float > scratch;
+	RadixSort::sort( values, scratch, []( float v ) { return RadixSort::toKey( v ); } );
+
+	EXPECT_EQ( expected, values );
+}
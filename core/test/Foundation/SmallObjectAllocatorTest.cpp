@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Foundation/SmallObjectAllocator.hpp"
+#include "Foundation/SharedObject.hpp"
+
+#include "gtest/gtest.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+
+TEST( SmallObjectAllocatorTest, allocateAndDeallocate )
+{
+	SmallObjectAllocator allocator;
+
+	std::vector< std::pair< void *, std::size_t >> blocks;
+	std::set< void * > unique;
+	for ( std::size_t size = 1; size <= 256; size++ ) {
+		auto p = allocator.allocate( size );
+		ASSERT_NE( nullptr, p );
+		std::memset( p, 0xAB, size );
+		blocks.push_back( std::make_pair( p, size ) );
+		unique.insert( p );
+	}
+
+	EXPECT_EQ( blocks.size(), unique.size() );
+
+	for ( auto &b : blocks ) {
+		allocator.deallocate( b.first, b.second );
+	}
+}
+
+TEST( SmallObjectAllocatorTest, reuseCachedBlocks )
+{
+	SmallObjectAllocator allocator;
+
+	auto p = allocator.allocate( 32 );
+	allocator.deallocate( p, 32 );
+
+	// served by the thread's magazine
+	EXPECT_EQ( p, allocator.allocate( 32 ) );
+	allocator.deallocate( p, 32 );
+
+	allocator.flushThreadCache();
+	auto q = allocator.allocate( 32 );
+	EXPECT_NE( nullptr, q );
+	allocator.deallocate( q, 32 );
+}
+
+TEST( SmallObjectAllocatorTest, largeObjects )
+{
+	SmallObjectAllocator allocator;
+
+	auto size = allocator.getMaxObjectSize() + 1;
+	auto p = allocator.allocate( size );
+	ASSERT_NE( nullptr, p );
+	std::memset( p, 0xAB, size );
+	allocator.deallocate( p, size );
+}
+
+TEST( SmallObjectAllocatorTest, magazineCapacity )
+{
+	SmallObjectAllocator allocator;
+
+	EXPECT_EQ( CRIMILD_MAX_SMALL_OBJECT_MAGAZINE_SIZE, allocator.getMagazineCapacity( 4 ) );
+	EXPECT_EQ( 4, allocator.getMagazineCapacity( allocator.getMaxObjectSize() ) );
+}
+
+TEST( SmallObjectAllocatorTest, deallocateFromAnotherThread )
+{
+	const std::size_t BLOCK_COUNT = 1000;
+
+	SmallObjectAllocator allocator;
+
+	std::vector< void * > blocks;
+	std::thread producer( [ &allocator, &blocks, BLOCK_COUNT ] {
+		for ( std::size_t i = 0; i < BLOCK_COUNT; i++ ) {
+			blocks.push_back( allocator.allocate( 16 + i % 64 ) );
+		}
+	});
+	producer.join();
+
+	std::thread consumer( [ &allocator, &blocks ] {
+		for ( std::size_t i = 0; i < blocks.size(); i++ ) {
+			allocator.deallocate( blocks[ i ], 16 + i % 64 );
+		}
+	});
+	consumer.join();
+
+	// blocks returned when the consumer thread exited must be available again
+	std::set< void * > reused;
+	for ( std::size_t i = 0; i < BLOCK_COUNT; i++ ) {
+		reused.insert( allocator.allocate( 16 + i % 64 ) );
+	}
+	EXPECT_EQ( BLOCK_COUNT, reused.size() );
+}
+
+TEST( SmallObjectAllocatorTest, concurrentAllocations )
+{
+	const int THREAD_COUNT = 4;
+	const int ITERATION_COUNT = 10000;
+
+	SmallObjectAllocator allocator;
+
+	std::vector< std::thread > threads;
+	for ( int t = 0; t < THREAD_COUNT; t++ ) {
+		threads.push_back( std::thread( [ &allocator, t, ITERATION_COUNT ] {
+			std::vector< std::pair< unsigned char *, std::size_t >> live;
+			for ( int i = 0; i < ITERATION_COUNT; i++ ) {
+				std::size_t size = 8 + ( i * 7 + t ) % 120;
+				auto p = static_cast< unsigned char * >( allocator.allocate( size ) );
+				std::memset( p, t, size );
+				live.push_back( std::make_pair( p, size ) );
+
+				if ( live.size() > 100 ) {
+					// make sure no other thread touched our blocks
+					for ( auto &b : live ) {
+						EXPECT_EQ( t, b.first[ b.second - 1 ] );
+						allocator.deallocate( b.first, b.second );
+					}
+					live.clear();
+				}
+			}
+
+			for ( auto &b : live ) {
+				allocator.deallocate( b.first, b.second );
+			}
+		}));
+	}
+
+	for ( auto &t : threads ) {
+		t.join();
+	}
+}
+
+TEST( SmallObjectAllocatorTest, destroyAllocatorBeforeThreadExits )
+{
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool allocatorDestroyed = false;
+	bool blockCached = false;
+
+	auto allocator = new SmallObjectAllocator();
+
+	std::thread worker( [ & ] {
+		auto p = allocator->allocate( 16 );
+		allocator->deallocate( p, 16 );
+
+		std::unique_lock< std::mutex > lock( mutex );
+		blockCached = true;
+		condition.notify_all();
+		condition.wait( lock, [ & ] { return allocatorDestroyed; } );
+
+		// thread cache is released on exit, after its allocator is gone
+	});
+
+	{
+		std::unique_lock< std::mutex > lock( mutex );
+		condition.wait( lock, [ & ] { return blockCached; } );
+		delete allocator;
+		allocatorDestroyed = true;
+		condition.notify_all();
+	}
+
+	worker.join();
+}
+
+TEST( SmallObjectAllocatorTest, sharedObjectsFromManyThreads )
+{
+	const int THREAD_COUNT = 4;
+	const int OBJECT_COUNT = 1000;
+
+	class TestObject : public SharedObject {
+	public:
+		int value[ 8 ];
+	};
+
+	std::vector< SharedPointer< TestObject >> objects( THREAD_COUNT * OBJECT_COUNT );
+
+	std::vector< std::thread > threads;
+	for ( int t = 0; t < THREAD_COUNT; t++ ) {
+		threads.push_back( std::thread( [ &objects, t, OBJECT_COUNT ] {
+			for ( int i = 0; i < OBJECT_COUNT; i++ ) {
+				objects[ t * OBJECT_COUNT + i ] = crimild::alloc< TestObject >();
+			}
+		}));
+	}
+
+	for ( auto &t : threads ) {
+		t.join();
+	}
+
+	std::set< TestObject * > unique;
+	for ( auto &obj : objects ) {
+		unique.insert( crimild::get_ptr( obj ) );
+	}
+	EXPECT_EQ( objects.size(), unique.size() );
+
+	// release objects from a different thread than the one that created them
+	std::thread releaser( [ &objects ] {
+		objects.clear();
+	});
+	releaser.join();
+}
+
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Mathematics/Random.hpp"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+using namespace crimild;
+
+TEST( Random, explicitSeed )
+{
+	Random::Generator a( 42 );
+	Random::Generator b( 42 );
+
+	for ( int i = 0; i < 1000; i++ ) {
+		ASSERT_EQ( a.nextUInt32(), b.nextUInt32() );
+	}
+
+	// reseeding restarts the sequence
+	Random::Generator c( 42 );
+	auto first = c.nextUInt32();
+	c.nextUInt32();
+	c.seed( 42 );
+	EXPECT_EQ( first, c.nextUInt32() );
+}
+
+TEST( Random, streams )
+{
+	Random::Generator a( 42, 0 );
+	Random::Generator b( 42, 1 );
+	Random::Generator c( 43, 0 );
+
+	int equalB = 0;
+	int equalC = 0;
+	for ( int i = 0; i < 1000; i++ ) {
+		auto x = a.nextUInt32();
+		equalB += ( x == b.nextUInt32() ) ? 1 : 0;
+		equalC += ( x == c.nextUInt32() ) ? 1 : 0;
+	}
+
+	EXPECT_EQ( 0, equalB );
+	EXPECT_EQ( 0, equalC );
+}
+
+TEST( Random, defaultGeneratorsAreUnique )
+{
+	Random::Generator a;
+	Random::Generator b;
+
+	EXPECT_NE( a.nextUInt32(), b.nextUInt32() );
+}
+
+TEST( Random, range )
+{
+	Random::Generator random( 7 );
+
+	crimild::Real64 sum = 0.0;
+	const int COUNT = 10000;
+	for ( int i = 0; i < COUNT; i++ ) {
+		auto f = random.nextReal32();
+		EXPECT_LE( 0.0f, f );
+		EXPECT_GT( 1.0f, f );
+
+		auto d = random.nextReal64();
+		EXPECT_LE( 0.0, d );
+		EXPECT_GT( 1.0, d );
+
+		auto r = Random::generate< crimild::Real32 >( random, -5.0f, 5.0f );
+		EXPECT_LE( -5.0f, r );
+		EXPECT_GT( 5.0f, r );
+
+		sum += f;
+	}
+
+	// roughly uniform
+	EXPECT_NEAR( 0.5, sum / COUNT, 0.02 );
+}
+
+TEST( Random, fill )
+{
+	const crimild::Size COUNT = 37;
+
+	Random::Generator a( 1234 );
+	Random::Generator b( 1234 );
+
+	std::vector< crimild::Real32 > values( COUNT );
+	a.fill( values.data(), COUNT, -1.0f, 3.0f );
+	for ( crimild::Size i = 0; i < COUNT; i++ ) {
+		EXPECT_EQ( Random::generate< crimild::Real32 >( b, -1.0f, 3.0f ), values[ i ] );
+	}
+
+	const auto minValue = Vector3f( -1.0f, 0.0f, 10.0f );
+	const auto maxValue = Vector3f( 1.0f, 5.0f, 20.0f );
+
+	std::vector< Vector3f > vectors( COUNT );
+	a.fill( vectors.data(), COUNT, minValue, maxValue );
+	for ( crimild::Size i = 0; i < COUNT; i++ ) {
+		// components are generated in order
+		for ( int j = 0; j < 3; j++ ) {
+			EXPECT_EQ( Random::generate< crimild::Real32 >( b, minValue[ j ], maxValue[ j ] ), vectors[ i ][ j ] );
+		}
+	}
+}
+
+TEST( Random, threadGenerators )
+{
+	Random::setSeed( 99 );
+	auto expected = Random::generate< crimild::Real32 >( 0.0f, 1.0f );
+
+	crimild::Real32 value = 0.0f;
+	std::thread worker( [ &value ] {
+		Random::setSeed( 99 );
+		value = Random::generate< crimild::Real32 >( 0.0f, 1.0f );
+	});
+	worker.join();
+
+	// each thread has its own generator, so both get the same value
+	EXPECT_EQ( expected, value );
+	EXPECT_NE( &Random::getThreadGenerator(), nullptr );
+}
+
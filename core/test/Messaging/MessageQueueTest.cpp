@@ -30,6 +30,9 @@
 
 #include "gtest/gtest.h"
 
+#include <thread>
+#include <vector>
+
 using namespace crimild;
 
 TEST( MessageQueueTest, broadcastMessage )
@@ -50,6 +53,42 @@ TEST( MessageQueueTest, broadcastMessageWithoutHandler )
 	MessageQueue::getInstance()->broadcastMessage( MockMessage {} );
 }
 
+namespace crimild {
+
+	/**
+	   \brief A message that cannot be deferred, since it has no default constructor
+	 */
+	struct BroadcastOnlyMessage {
+		explicit BroadcastOnlyMessage( int v ) : value( v ) { }
+		BroadcastOnlyMessage &operator=( BroadcastOnlyMessage const & ) = delete;
+
+		int value;
+	};
+
+}
+
+TEST( MessageQueueTest, broadcastOnlyMessage )
+{
+	int value = 0;
+
+	MockMessenger m;
+	m.registerMessageHandler< BroadcastOnlyMessage >( [ &value ]( BroadcastOnlyMessage const &message ) {
+		value = message.value;
+	});
+
+	m.broadcastMessage( BroadcastOnlyMessage( 42 ) );
+	EXPECT_EQ( 42, value );
+
+	auto dispatcher = MessageQueueDispatcherImpl< BroadcastOnlyMessage >::getInstance();
+	EXPECT_FALSE( dispatcher->hasPendingMessages() );
+	EXPECT_EQ( MessageQueueDispatcherImpl< BroadcastOnlyMessage >::DEFAULT_DEFERRED_MESSAGE_CAPACITY, dispatcher->getDeferredMessageCapacity() );
+
+	MessageQueue::getInstance()->dispatchDeferredMessages();
+	MessageQueue::getInstance()->clear();
+
+	m.unregisterMessageHandler< BroadcastOnlyMessage >();
+}
+
 TEST( MessageQueueTest, unregisterMessageHandler )
 {
 	MockMessenger m;
@@ -128,3 +167,159 @@ TEST( MessageQueueTest, pushMessageWithoutHandlers )
 	MessageQueue::getInstance()->pushMessage( MockMessage { } );
 }
 
+TEST( MessageQueueTest, registerHandlerWhileBroadcasting )
+{
+	int count = 0;
+	Messenger m1;
+	Messenger m2;
+
+	m1.registerMessageHandler< MockMessage >( [&]( MockMessage const & ) {
+		count++;
+		m2.registerMessageHandler< MockMessage >( [&]( MockMessage const & ) {
+			count += 10;
+		});
+	});
+
+	// m2's handler is registered during the broadcast and must not be invoked until the next one
+	m1.broadcastMessage( MockMessage {} );
+	EXPECT_EQ( 1, count );
+
+	m1.broadcastMessage( MockMessage {} );
+	EXPECT_EQ( 12, count );
+}
+
+TEST( MessageQueueTest, unregisterHandlerWhileBroadcasting )
+{
+	MockMessenger m;
+
+	auto dispatcher = MessageQueueDispatcherImpl< MockMessage >::getInstance();
+	auto handlerCount = dispatcher->getHandlerCount();
+
+	{
+		Messenger m1;
+		m1.registerMessageHandler< MockMessage >( [&]( MockMessage const & ) {
+			m1.unregisterMessageHandler< MockMessage >();
+		});
+		EXPECT_EQ( handlerCount + 1, dispatcher->getHandlerCount() );
+
+		m.broadcastMessage( MockMessage {} );
+		EXPECT_EQ( 1, m.getCallCount() );
+		EXPECT_EQ( handlerCount, dispatcher->getHandlerCount() );
+	}
+
+	m.broadcastMessage( MockMessage {} );
+	EXPECT_EQ( 2, m.getCallCount() );
+}
+
+TEST( MessageQueueTest, hasPendingMessages )
+{
+	MockMessenger m;
+
+	// discard messages left by other tests
+	MessageQueue::getInstance()->clear();
+
+	auto dispatcher = MessageQueueDispatcherImpl< MockMessage >::getInstance();
+	EXPECT_FALSE( dispatcher->hasPendingMessages() );
+
+	MessageQueue::getInstance()->pushMessage( MockMessage { } );
+	EXPECT_TRUE( dispatcher->hasPendingMessages() );
+
+	MessageQueue::getInstance()->dispatchDeferredMessages();
+	EXPECT_FALSE( dispatcher->hasPendingMessages() );
+	EXPECT_EQ( 1, m.getCallCount() );
+
+	MessageQueue::getInstance()->pushMessage( MockMessage { } );
+	MessageQueue::getInstance()->clear();
+	EXPECT_FALSE( dispatcher->hasPendingMessages() );
+
+	MessageQueue::getInstance()->dispatchDeferredMessages();
+	EXPECT_EQ( 1, m.getCallCount() );
+}
+
+TEST( MessageQueueTest, pushMessageOverflowSpill )
+{
+	MockMessenger m;
+
+	auto queue = MessageQueue::getInstance();
+	queue->configureDeferredMessages< MockMessage >( 4, DeferredMessageOverflowPolicy::SPILL );
+
+	for ( int i = 0; i < 10; i++ ) {
+		EXPECT_TRUE( queue->pushMessage( MockMessage { } ) );
+	}
+
+	queue->dispatchDeferredMessages();
+	EXPECT_EQ( 10, m.getCallCount() );
+
+	queue->configureDeferredMessages< MockMessage >( MessageQueueDispatcherImpl< MockMessage >::DEFAULT_DEFERRED_MESSAGE_CAPACITY, DeferredMessageOverflowPolicy::SPILL );
+}
+
+TEST( MessageQueueTest, pushMessageOverflowDiscard )
+{
+	MockMessenger m;
+
+	auto queue = MessageQueue::getInstance();
+	queue->configureDeferredMessages< MockMessage >( 4, DeferredMessageOverflowPolicy::DISCARD );
+
+	auto dispatcher = MessageQueueDispatcherImpl< MockMessage >::getInstance();
+	auto discarded = dispatcher->getDiscardedMessageCount();
+
+	for ( int i = 0; i < 4; i++ ) {
+		EXPECT_TRUE( queue->pushMessage( MockMessage { } ) );
+	}
+	EXPECT_FALSE( queue->pushMessage( MockMessage { } ) );
+	EXPECT_EQ( discarded + 1, dispatcher->getDiscardedMessageCount() );
+
+	queue->dispatchDeferredMessages();
+	EXPECT_EQ( 4, m.getCallCount() );
+
+	queue->configureDeferredMessages< MockMessage >( MessageQueueDispatcherImpl< MockMessage >::DEFAULT_DEFERRED_MESSAGE_CAPACITY, DeferredMessageOverflowPolicy::SPILL );
+}
+
+TEST( MessageQueueTest, pushMessageFromHandler )
+{
+	int count = 0;
+	Messenger m;
+	m.registerMessageHandler< MockMessage >( [&]( MockMessage const & ) {
+		count++;
+		MessageQueue::getInstance()->pushMessage( MockMessage { } );
+	});
+
+	MessageQueue::getInstance()->clear();
+	MessageQueue::getInstance()->pushMessage( MockMessage { } );
+
+	// messages pushed during dispatch are delivered on the next one
+	MessageQueue::getInstance()->dispatchDeferredMessages();
+	EXPECT_EQ( 1, count );
+
+	MessageQueue::getInstance()->dispatchDeferredMessages();
+	EXPECT_EQ( 2, count );
+
+	MessageQueue::getInstance()->clear();
+}
+
+TEST( MessageQueueTest, pushMessageFromManyThreads )
+{
+	const int THREAD_COUNT = 4;
+	const int MESSAGES_PER_THREAD = 1000;
+
+	MockMessenger m;
+
+	MessageQueue::getInstance()->clear();
+
+	std::vector< std::thread > threads;
+	for ( int i = 0; i < THREAD_COUNT; i++ ) {
+		threads.push_back( std::thread( [ MESSAGES_PER_THREAD ] {
+			for ( int j = 0; j < MESSAGES_PER_THREAD; j++ ) {
+				MessageQueue::getInstance()->pushMessage( MockMessage { } );
+			}
+		}));
+	}
+
+	for ( auto &t : threads ) {
+		t.join();
+	}
+
+	MessageQueue::getInstance()->dispatchDeferredMessages();
+	EXPECT_EQ( THREAD_COUNT * MESSAGES_PER_THREAD, m.getCallCount() );
+}
+
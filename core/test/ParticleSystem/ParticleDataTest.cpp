@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ParticleSystem/ParticleData.hpp"
+#include "ParticleSystem/Updaters/ZSortParticleUpdater.hpp"
+#include "ParticleSystem/Updaters/CameraSortParticleUpdater.hpp"
+#include "SceneGraph/Camera.hpp"
+#include "SceneGraph/Group.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace test {
+
+		static SharedPointer< ParticleData > createParticles( std::vector< float > const &zs, crimild::Size maxParticles )
+		{
+			auto particles = crimild::alloc< ParticleData >( maxParticles );
+			particles->createAttribArray< Vector3f >( ParticleAttrib::POSITION );
+			particles->createAttribArray< crimild::Real32 >( ParticleAttrib::TIME );
+			particles->generate();
+
+			auto ps = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+			auto ts = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+			for ( crimild::Size i = 0; i < zs.size(); i++ ) {
+				particles->wake( i );
+				ps[ i ] = Vector3f( 0.0f, 0.0f, zs[ i ] );
+				ts[ i ] = static_cast< crimild::Real32 >( i );
+			}
+
+			return particles;
+		}
+
+	}
+
+}
+
+TEST( ParticleDataTest, reorder )
+{
+	auto particles = test::createParticles( { 1.0f, 2.0f, 3.0f, 4.0f }, 5 );
+
+	ParticleId permutation[] = { 3, 1, 0, 2 };
+	particles->reorder( permutation );
+
+	auto ps = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	auto ts = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+	for ( crimild::Size i = 0; i < 4; i++ ) {
+		EXPECT_EQ( float( permutation[ i ] + 1 ), ps[ i ].z() );
+		EXPECT_EQ( float( permutation[ i ] ), ts[ i ] );
+	}
+
+	EXPECT_EQ( 4, particles->getAliveCount() );
+	EXPECT_FALSE( particles->isAlive( 4 ) );
+}
+
+TEST( ParticleDataTest, sortIsStable )
+{
+	auto particles = test::createParticles( { 0.0f, 0.0f, 0.0f, 0.0f }, 4 );
+
+	std::vector< crimild::Real32 > keys = { 2.0f, -1.0f, 2.0f, -1.0f };
+	particles->sort( keys.data() );
+
+	auto ts = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+	EXPECT_EQ( 1.0f, ts[ 0 ] );
+	EXPECT_EQ( 3.0f, ts[ 1 ] );
+	EXPECT_EQ( 0.0f, ts[ 2 ] );
+	EXPECT_EQ( 2.0f, ts[ 3 ] );
+}
+
+TEST( ParticleDataTest, zSort )
+{
+	auto particles = test::createParticles( { 3.0f, -5.0f, 0.5f, 10.0f, -1.0f }, 8 );
+
+	auto node = crimild::alloc< Group >();
+	auto updater = crimild::alloc< ZSortParticleUpdater >();
+	updater->configure( crimild::get_ptr( node ), crimild::get_ptr( particles ) );
+	updater->update( crimild::get_ptr( node ), 0.0, crimild::get_ptr( particles ) );
+
+	auto ps = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+	auto ts = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+	std::vector< float > expected = { 1.0f, 4.0f, 2.0f, 0.0f, 3.0f };
+	for ( crimild::Size i = 0; i < expected.size(); i++ ) {
+		EXPECT_EQ( expected[ i ], ts[ i ] );
+		if ( i > 0 ) {
+			EXPECT_LE( ps[ i - 1 ].z(), ps[ i ].z() );
+		}
+	}
+}
+
+TEST( ParticleDataTest, cameraSort )
+{
+	auto particles = test::createParticles( { 3.0f, -5.0f, 0.5f, 10.0f, -1.0f }, 8 );
+	particles->setComputeInWorldSpace( true );
+
+	auto camera = crimild::alloc< Camera >();
+	camera->local().setTranslate( 0.0f, 0.0f, 2.0f );
+	camera->world() = camera->local();
+	auto previousMainCamera = Camera::getMainCamera();
+	Camera::setMainCamera( camera );
+
+	auto node = crimild::alloc< Group >();
+	auto updater = crimild::alloc< CameraSortParticleUpdater >();
+	updater->configure( crimild::get_ptr( node ), crimild::get_ptr( particles ) );
+	updater->update( crimild::get_ptr( node ), 0.0, crimild::get_ptr( particles ) );
+
+	Camera::setMainCamera( previousMainCamera );
+
+	// back to front
+	auto ts = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+	std::vector< float > expected = { 3.0f, 1.0f, 4.0f, 2.0f, 0.0f };
+	for ( crimild::Size i = 0; i < expected.size(); i++ ) {
+		EXPECT_EQ( expected[ i ], ts[ i ] );
+	}
+}
+
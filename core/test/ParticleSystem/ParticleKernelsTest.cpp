@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ParticleSystem/ParticleKernels.hpp"
+#include "ParticleSystem/ParticleData.hpp"
+#include "ParticleSystem/Updaters/TimeParticleUpdater.hpp"
+#include "Mathematics/SIMD.hpp"
+#include "SceneGraph/Group.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace test {
+
+		// odd count, so both vectorized and scalar paths are executed
+		static const crimild::Size KERNEL_TEST_COUNT = 37;
+
+		static std::vector< simd::InstructionSet > getInstructionSets( void )
+		{
+			return { simd::InstructionSet::SCALAR, simd::InstructionSet::SSE, simd::InstructionSet::AVX };
+		}
+
+		static float value( crimild::Size i, float offset = 0.0f )
+		{
+			return offset + 0.25f * static_cast< float >( ( i * 7 ) % 13 ) - 1.5f;
+		}
+
+	}
+
+}
+
+TEST( ParticleKernelsTest, addScaled )
+{
+	const auto count = test::KERNEL_TEST_COUNT;
+
+	for ( auto instructionSet : test::getInstructionSets() ) {
+		simd::setInstructionSet( instructionSet );
+
+		std::vector< Vector3f > dst( count ), src( count );
+		for ( crimild::Size i = 0; i < count; i++ ) {
+			dst[ i ] = Vector3f( test::value( i ), test::value( i, 1.0f ), test::value( i, 2.0f ) );
+			src[ i ] = Vector3f( test::value( i, 3.0f ), test::value( i, 4.0f ), test::value( i, 5.0f ) );
+		}
+
+		ParticleKernels::addScaled( &dst[ 0 ], &src[ 0 ], 0.5f, count );
+
+		for ( crimild::Size i = 0; i < count; i++ ) {
+			auto expected = Vector3f( test::value( i ), test::value( i, 1.0f ), test::value( i, 2.0f ) ) + 0.5f * src[ i ];
+			for ( int j = 0; j < 3; j++ ) {
+				EXPECT_FLOAT_EQ( expected[ j ], dst[ i ][ j ] ) << simd::getInstructionSetName( instructionSet ) << " at " << i;
+			}
+		}
+	}
+
+	simd::setInstructionSet( simd::getSupportedInstructionSet() );
+}
+
+TEST( ParticleKernelsTest, add )
+{
+	const auto count = test::KERNEL_TEST_COUNT;
+
+	for ( auto instructionSet : test::getInstructionSets() ) {
+		simd::setInstructionSet( instructionSet );
+
+		std::vector< Vector3f > vs( count );
+		std::vector< crimild::Real32 > fs( count );
+		for ( crimild::Size i = 0; i < count; i++ ) {
+			vs[ i ] = Vector3f( test::value( i ), test::value( i, 1.0f ), test::value( i, 2.0f ) );
+			fs[ i ] = test::value( i );
+		}
+
+		ParticleKernels::add( &vs[ 0 ], Vector3f( 1.0f, 2.0f, 3.0f ), count );
+		ParticleKernels::add( &fs[ 0 ], -0.5f, count );
+
+		for ( crimild::Size i = 0; i < count; i++ ) {
+			EXPECT_FLOAT_EQ( test::value( i ) + 1.0f, vs[ i ][ 0 ] ) << simd::getInstructionSetName( instructionSet ) << " at " << i;
+			EXPECT_FLOAT_EQ( test::value( i, 1.0f ) + 2.0f, vs[ i ][ 1 ] ) << simd::getInstructionSetName( instructionSet ) << " at " << i;
+			EXPECT_FLOAT_EQ( test::value( i, 2.0f ) + 3.0f, vs[ i ][ 2 ] ) << simd::getInstructionSetName( instructionSet ) << " at " << i;
+			EXPECT_FLOAT_EQ( test::value( i ) - 0.5f, fs[ i ] ) << simd::getInstructionSetName( instructionSet ) << " at " << i;
+		}
+	}
+
+	simd::setInstructionSet( simd::getSupportedInstructionSet() );
+}
+
+TEST( ParticleKernelsTest, attract )
+{
+	const auto count = test::KERNEL_TEST_COUNT;
+	const auto center = Vector3f( 0.5f, -0.25f, 0.0f );
+	const auto radius = 2.0f;
+	const auto scale = 0.1f;
+
+	std::vector< Vector3f > ps( count );
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		ps[ i ] = Vector3f( test::value( i ), test::value( i, -0.5f ), test::value( i, 0.5f ) );
+	}
+	// one particle exactly at the center is never affected
+	ps[ 5 ] = center;
+
+	for ( auto instructionSet : test::getInstructionSets() ) {
+		simd::setInstructionSet( instructionSet );
+
+		std::vector< Vector3f > as( count, Vector3f( 1.0f, 1.0f, 1.0f ) );
+		ParticleKernels::attract( &ps[ 0 ], &as[ 0 ], center, radius, scale, count );
+
+		for ( crimild::Size i = 0; i < count; i++ ) {
+			auto expected = Vector3f( 1.0f, 1.0f, 1.0f );
+			auto direction = center - ps[ i ];
+			auto d = direction.getMagnitude();
+			if ( d > 0.0f && d <= radius ) {
+				expected += scale * ( 1.0f - d / radius ) * ( direction / d );
+			}
+			for ( int j = 0; j < 3; j++ ) {
+				EXPECT_NEAR( expected[ j ], as[ i ][ j ], 1e-5f ) << simd::getInstructionSetName( instructionSet ) << " at " << i;
+			}
+		}
+	}
+
+	simd::setInstructionSet( simd::getSupportedInstructionSet() );
+}
+
+TEST( ParticleKernelsTest, interpolateColors )
+{
+	const auto count = test::KERNEL_TEST_COUNT;
+
+	std::vector< RGBAColorf > start( count ), end( count );
+	std::vector< crimild::Real32 > times( count ), lifetimes( count );
+	for ( crimild::Size i = 0; i < count; i++ ) {
+		start[ i ] = RGBAColorf( test::value( i ), test::value( i, 1.0f ), test::value( i, 2.0f ), 1.0f );
+		end[ i ] = RGBAColorf( test::value( i, 3.0f ), test::value( i, 4.0f ), test::value( i, 5.0f ), 0.0f );
+		lifetimes[ i ] = 2.0f;
+		times[ i ] = 2.0f * static_cast< float >( i ) / count;
+	}
+
+	for ( auto instructionSet : test::getInstructionSets() ) {
+		simd::setInstructionSet( instructionSet );
+
+		std::vector< RGBAColorf > colors( count );
+		ParticleKernels::interpolateColors( &colors[ 0 ], &start[ 0 ], &end[ 0 ], &times[ 0 ], &lifetimes[ 0 ], count );
+
+		for ( crimild::Size i = 0; i < count; i++ ) {
+			const auto t = 1.0f - times[ i ] / lifetimes[ i ];
+			auto expected = start[ i ] + t * ( end[ i ] - start[ i ] );
+			for ( int j = 0; j < 4; j++ ) {
+				EXPECT_NEAR( expected[ j ], colors[ i ][ j ], 1e-5f ) << simd::getInstructionSetName( instructionSet ) << " at " << i;
+			}
+		}
+	}
+
+	simd::setInstructionSet( simd::getSupportedInstructionSet() );
+}
+
+TEST( ParticleKernelsTest, unsupportedInstructionSetsAreClamped )
+{
+	simd::setInstructionSet( simd::InstructionSet::AVX );
+	EXPECT_LE( static_cast< int >( simd::getInstructionSet() ), static_cast< int >( simd::getSupportedInstructionSet() ) );
+
+	simd::setInstructionSet( simd::InstructionSet::SCALAR );
+	EXPECT_EQ( simd::InstructionSet::SCALAR, simd::getInstructionSet() );
+
+	simd::setInstructionSet( simd::getSupportedInstructionSet() );
+}
+
+TEST( ParticleKernelsTest, attribArraysAreAlignedAndPadded )
+{
+	auto particles = crimild::alloc< ParticleData >( 13 );
+	auto positions = particles->createAttribArray< Vector3f >( ParticleAttrib::POSITION );
+	auto times = particles->createAttribArray< crimild::Real32 >( ParticleAttrib::TIME );
+	particles->generate();
+
+	EXPECT_EQ( 13, positions->getCount() );
+	EXPECT_EQ( 13, times->getCount() );
+	EXPECT_EQ( 0, reinterpret_cast< std::uintptr_t >( positions->getRawData() ) % CRIMILD_SIMD_ALIGNMENT );
+	EXPECT_EQ( 0, reinterpret_cast< std::uintptr_t >( times->getRawData() ) % CRIMILD_SIMD_ALIGNMENT );
+}
+
+TEST( ParticleKernelsTest, timeUpdaterKillsExpiredParticles )
+{
+	auto particles = crimild::alloc< ParticleData >( 10 );
+	particles->createAttribArray< crimild::Real32 >( ParticleAttrib::TIME );
+	particles->generate();
+
+	auto ts = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+	for ( crimild::Size i = 0; i < 8; i++ ) {
+		particles->wake( i );
+		// every other particle expires
+		ts[ i ] = ( i % 2 == 0 ) ? 0.5f : 2.0f;
+	}
+
+	auto node = crimild::alloc< Group >();
+	auto updater = crimild::alloc< TimeParticleUpdater >();
+	updater->configure( crimild::get_ptr( node ), crimild::get_ptr( particles ) );
+	updater->update( crimild::get_ptr( node ), 1.0, crimild::get_ptr( particles ) );
+
+	ASSERT_EQ( 4, particles->getAliveCount() );
+	for ( crimild::Size i = 0; i < 4; i++ ) {
+		EXPECT_TRUE( particles->isAlive( i ) );
+		EXPECT_FLOAT_EQ( 1.0f, ts[ i ] );
+	}
+	for ( crimild::Size i = 4; i < 10; i++ ) {
+		EXPECT_FALSE( particles->isAlive( i ) );
+	}
+}
+
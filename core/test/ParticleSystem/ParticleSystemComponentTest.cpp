@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ParticleSystem/ParticleSystemComponent.hpp"
+#include "ParticleSystem/Updaters/EulerParticleUpdater.hpp"
+#include "ParticleSystem/Updaters/AttractorParticleUpdater.hpp"
+#include "ParticleSystem/Updaters/TimeParticleUpdater.hpp"
+#include "ParticleSystem/Updaters/ColorParticleUpdater.hpp"
+#include "ParticleSystem/Updaters/ZSortParticleUpdater.hpp"
+#include "ParticleSystem/Generators/BoxPositionParticleGenerator.hpp"
+#include "ParticleSystem/Generators/SphereVelocityParticleGenerator.hpp"
+#include "ParticleSystem/Generators/TimeParticleGenerator.hpp"
+#include "ParticleSystem/Generators/ColorParticleGenerator.hpp"
+#include "ParticleSystem/Generators/UniformScaleParticleGenerator.hpp"
+#include "Concurrency/JobScheduler.hpp"
+#include "SceneGraph/Group.hpp"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace crimild;
+using namespace crimild::concurrency;
+
+namespace crimild {
+
+	namespace test {
+
+		struct ParticleSnapshot {
+			std::vector< Vector3f > positions;
+			std::vector< crimild::Real32 > times;
+			std::vector< RGBAColorf > colors;
+		};
+
+		static ParticleSnapshot simulateParticles( crimild::Size count, int frames )
+		{
+			auto group = crimild::alloc< Group >();
+
+			auto ps = crimild::alloc< ParticleSystemComponent >( count + 1 );
+			ps->setEmitRate( 0 );
+
+			auto euler = crimild::alloc< EulerParticleUpdater >();
+			euler->setGlobalAcceleration( Vector3f( 0.0f, -9.8f, 0.0f ) );
+			ps->addUpdater( euler );
+
+			auto attractor = crimild::alloc< AttractorParticleUpdater >();
+			attractor->setAttractor( Sphere3f( Vector3f::ZERO, 5.0f ) );
+			ps->addUpdater( attractor );
+
+			ps->addUpdater( crimild::alloc< TimeParticleUpdater >() );
+
+			// not data-parallel. Splits updaters in two groups
+			ps->addUpdater( crimild::alloc< ZSortParticleUpdater >() );
+
+			ps->addUpdater( crimild::alloc< ColorParticleUpdater >() );
+
+			group->attachComponent( ps );
+			ps->start();
+
+			auto particles = ps->getParticles();
+			auto positions = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+			auto velocities = particles->getAttrib( ParticleAttrib::VELOCITY )->getData< Vector3f >();
+			auto accelerations = particles->getAttrib( ParticleAttrib::ACCELERATION )->getData< Vector3f >();
+			auto times = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+			auto lifetimes = particles->getAttrib( ParticleAttrib::LIFE_TIME )->getData< crimild::Real32 >();
+			auto startColors = particles->getAttrib( ParticleAttrib::START_COLOR )->getData< RGBAColorf >();
+			auto endColors = particles->getAttrib( ParticleAttrib::END_COLOR )->getData< RGBAColorf >();
+
+			// there are no generators, so every attribute must be initialized
+			// here (including dead particles) for results to be reproducible
+			for ( crimild::Size i = 0; i < particles->getParticleCount(); i++ ) {
+				auto x = static_cast< float >( i % 17 ) - 8.0f;
+				auto z = static_cast< float >( i % 23 ) - 11.0f;
+				positions[ i ] = Vector3f( x, 0.0f, z );
+				velocities[ i ] = Vector3f::ZERO;
+				accelerations[ i ] = Vector3f::ZERO;
+				// particles expire at different frames
+				times[ i ] = 0.05f * static_cast< float >( i % 29 );
+				lifetimes[ i ] = 2.0f;
+				startColors[ i ] = RGBAColorf( 0.0f, 0.0f, 0.0f, 1.0f );
+				endColors[ i ] = RGBAColorf( 1.0f, 1.0f, 1.0f, 1.0f );
+			}
+			for ( crimild::Size i = 0; i < count; i++ ) {
+				particles->wake( i );
+			}
+
+			Clock c( 0.01 );
+			for ( int frame = 0; frame < frames; frame++ ) {
+				ps->update( c );
+			}
+
+			ParticleSnapshot result;
+			const auto alive = particles->getAliveCount();
+			result.positions.assign( positions, positions + alive );
+			result.times.assign( times, times + alive );
+			auto colors = particles->getAttrib( ParticleAttrib::COLOR )->getData< RGBAColorf >();
+			result.colors.assign( colors, colors + alive );
+			return result;
+		}
+
+		static ParticleSnapshot emitParticles( crimild::UInt64 seed, crimild::Size emitterCount, int frames )
+		{
+			auto group = crimild::alloc< Group >();
+
+			std::vector< SharedPointer< ParticleSystemComponent >> emitters;
+			for ( crimild::Size e = 0; e < emitterCount; e++ ) {
+				auto node = crimild::alloc< Group >();
+				auto ps = crimild::alloc< ParticleSystemComponent >( 2000 );
+				ps->setEmitRate( 5000 );
+
+				auto positions = crimild::alloc< BoxPositionParticleGenerator >();
+				positions->setSize( Vector3f( 1.0f, 2.0f, 3.0f ) );
+				ps->addGenerator( positions );
+				auto velocities = crimild::alloc< SphereVelocityParticleGenerator >();
+				velocities->setMagnitude( Vector3f( 2.0f, 2.0f, 2.0f ) );
+				ps->addGenerator( velocities );
+				auto times = crimild::alloc< TimeParticleGenerator >();
+				times->setMinTime( 0.05f );
+				times->setMaxTime( 0.2f );
+				ps->addGenerator( times );
+				auto colors = crimild::alloc< ColorParticleGenerator >();
+				colors->setMinStartColor( RGBAColorf( 0.0f, 0.0f, 0.0f, 0.0f ) );
+				colors->setMaxStartColor( RGBAColorf( 1.0f, 1.0f, 1.0f, 1.0f ) );
+				colors->setMinEndColor( RGBAColorf( 0.0f, 0.0f, 0.0f, 0.0f ) );
+				colors->setMaxEndColor( RGBAColorf( 1.0f, 1.0f, 1.0f, 1.0f ) );
+				ps->addGenerator( colors );
+				auto scales = crimild::alloc< UniformScaleParticleGenerator >();
+				scales->setMinScale( 0.5f );
+				scales->setMaxScale( 1.5f );
+				ps->addGenerator( scales );
+
+				ps->addUpdater( crimild::alloc< TimeParticleUpdater >() );
+				ps->addUpdater( crimild::alloc< ColorParticleUpdater >() );
+
+				// one stream per emitter
+				ps->getParticles()->getRandom().seed( seed, e );
+
+				node->attachComponent( ps );
+				group->attachNode( node );
+				ps->start();
+				emitters.push_back( ps );
+			}
+
+			Clock c( 0.01 );
+			for ( int frame = 0; frame < frames; frame++ ) {
+				// emitters may be updated by any worker
+				parallel_for( crimild::Size( 0 ), emitters.size(), crimild::Size( 1 ), [ &emitters, &c ]( crimild::Size e ) {
+					emitters[ e ]->update( c );
+				});
+			}
+
+			ParticleSnapshot result;
+			for ( auto &ps : emitters ) {
+				auto particles = ps->getParticles();
+				const auto alive = particles->getAliveCount();
+				auto positions = particles->getAttrib( ParticleAttrib::POSITION )->getData< Vector3f >();
+				auto times = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+				auto colors = particles->getAttrib( ParticleAttrib::COLOR )->getData< RGBAColorf >();
+				result.positions.insert( result.positions.end(), positions, positions + alive );
+				result.times.insert( result.times.end(), times, times + alive );
+				result.colors.insert( result.colors.end(), colors, colors + alive );
+			}
+			return result;
+		}
+
+	}
+
+}
+
+TEST( ParticleSystemComponentTest, compactPreservesOrder )
+{
+	const crimild::Size COUNT = 3 * CRIMILD_PARTICLE_CHUNK_SIZE + 17;
+
+	JobScheduler scheduler;
+	scheduler.configure( 3 );
+	scheduler.start();
+
+	auto particles = crimild::alloc< ParticleData >( COUNT );
+	particles->createAttribArray< crimild::Real32 >( ParticleAttrib::TIME );
+	particles->generate();
+
+	auto ts = particles->getAttrib( ParticleAttrib::TIME )->getData< crimild::Real32 >();
+	for ( crimild::Size i = 0; i < COUNT; i++ ) {
+		particles->wake( i );
+		ts[ i ] = static_cast< crimild::Real32 >( i );
+	}
+
+	// nothing to do
+	particles->compact();
+	EXPECT_EQ( COUNT, particles->getAliveCount() );
+
+	particles->forEachAliveChunk( [ &particles ]( ParticleId begin, ParticleId end ) {
+		for ( auto i = begin; i < end; i++ ) {
+			if ( i % 3 == 0 ) {
+				particles->killDeferred( i );
+			}
+		}
+	});
+
+	// killed particles stay in place until compacted
+	EXPECT_EQ( COUNT, particles->getAliveCount() );
+	EXPECT_FALSE( particles->isAlive( 0 ) );
+
+	particles->compact();
+
+	scheduler.stop();
+
+	const auto expectedCount = COUNT - ( COUNT + 2 ) / 3;
+	ASSERT_EQ( expectedCount, particles->getAliveCount() );
+
+	crimild::Size expected = 1;
+	for ( crimild::Size i = 0; i < expectedCount; i++ ) {
+		EXPECT_TRUE( particles->isAlive( i ) );
+		EXPECT_EQ( static_cast< crimild::Real32 >( expected ), ts[ i ] );
+		expected += ( expected % 3 == 2 ) ? 2 : 1;
+	}
+	for ( auto i = expectedCount; i < COUNT; i++ ) {
+		EXPECT_FALSE( particles->isAlive( i ) );
+	}
+}
+
+TEST( ParticleSystemComponentTest, forEachAliveChunk )
+{
+	const crimild::Size COUNT = 2 * CRIMILD_PARTICLE_CHUNK_SIZE + 5;
+
+	auto particles = crimild::alloc< ParticleData >( COUNT );
+	particles->generate();
+	for ( crimild::Size i = 0; i < COUNT; i++ ) {
+		particles->wake( i );
+	}
+
+	std::vector< std::pair< ParticleId, ParticleId >> chunks;
+	particles->forEachAliveChunk( [ &chunks ]( ParticleId begin, ParticleId end ) {
+		chunks.push_back( std::make_pair( begin, end ) );
+	});
+
+	ASSERT_EQ( 3, chunks.size() );
+	EXPECT_EQ( 0, chunks[ 0 ].first );
+	EXPECT_EQ( CRIMILD_PARTICLE_CHUNK_SIZE, chunks[ 0 ].second );
+	EXPECT_EQ( CRIMILD_PARTICLE_CHUNK_SIZE, chunks[ 1 ].first );
+	EXPECT_EQ( 2 * CRIMILD_PARTICLE_CHUNK_SIZE, chunks[ 1 ].second );
+	EXPECT_EQ( 2 * CRIMILD_PARTICLE_CHUNK_SIZE, chunks[ 2 ].first );
+	EXPECT_EQ( COUNT, chunks[ 2 ].second );
+}
+
+TEST( ParticleSystemComponentTest, parallelUpdatesAreDeterministic )
+{
+	const crimild::Size COUNT = 4 * CRIMILD_PARTICLE_CHUNK_SIZE + 123;
+	const int FRAMES = 20;
+
+	// no scheduler, so all updates are performed in the calling thread
+	auto serial = test::simulateParticles( COUNT, FRAMES );
+
+	JobScheduler scheduler;
+	scheduler.configure( 3 );
+	scheduler.start();
+	auto parallel = test::simulateParticles( COUNT, FRAMES );
+	scheduler.stop();
+
+	// some particles must have died
+	EXPECT_LT( serial.positions.size(), COUNT );
+	EXPECT_LT( 0, serial.positions.size() );
+
+	ASSERT_EQ( serial.positions.size(), parallel.positions.size() );
+	for ( crimild::Size i = 0; i < serial.positions.size(); i++ ) {
+		for ( int j = 0; j < 3; j++ ) {
+			ASSERT_EQ( serial.positions[ i ][ j ], parallel.positions[ i ][ j ] ) << "at " << i;
+		}
+		ASSERT_EQ( serial.times[ i ], parallel.times[ i ] ) << "at " << i;
+		for ( int j = 0; j < 4; j++ ) {
+			ASSERT_EQ( serial.colors[ i ][ j ], parallel.colors[ i ][ j ] ) << "at " << i;
+		}
+	}
+}
+
+TEST( ParticleSystemComponentTest, seededEmittersAreReproducible )
+{
+	const crimild::Size EMITTERS = 4;
+	const int FRAMES = 20;
+
+	std::vector< test::ParticleSnapshot > snapshots;
+	for ( auto workers : { 0, 1, 3 } ) {
+		JobScheduler scheduler;
+		scheduler.configure( workers );
+		scheduler.start();
+
+		// emitters do not depend on the thread's generator
+		Random::generate< crimild::Real32 >( 0.0f, 1.0f );
+
+		snapshots.push_back( test::emitParticles( 1234, EMITTERS, FRAMES ) );
+		scheduler.stop();
+	}
+
+	// a different seed produces different particles
+	JobScheduler scheduler;
+	scheduler.configure( 1 );
+	scheduler.start();
+	auto other = test::emitParticles( 4321, EMITTERS, FRAMES );
+	scheduler.stop();
+
+	const auto &expected = snapshots[ 0 ];
+	EXPECT_LT( 0, expected.positions.size() );
+
+	for ( crimild::Size s = 1; s < snapshots.size(); s++ ) {
+		const auto &actual = snapshots[ s ];
+		ASSERT_EQ( expected.positions.size(), actual.positions.size() );
+		for ( crimild::Size i = 0; i < expected.positions.size(); i++ ) {
+			for ( int j = 0; j < 3; j++ ) {
+				ASSERT_EQ( expected.positions[ i ][ j ], actual.positions[ i ][ j ] ) << "at " << i;
+			}
+			ASSERT_EQ( expected.times[ i ], actual.times[ i ] ) << "at " << i;
+			for ( int j = 0; j < 4; j++ ) {
+				ASSERT_EQ( expected.colors[ i ][ j ], actual.colors[ i ][ j ] ) << "at " << i;
+			}
+		}
+	}
+
+	ASSERT_LT( 0, other.positions.size() );
+	EXPECT_NE( expected.positions[ 0 ][ 0 ], other.positions[ 0 ][ 0 ] );
+}
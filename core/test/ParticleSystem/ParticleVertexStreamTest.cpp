@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ParticleSystem/Renderers/ParticleVertexStream.hpp"
+
+#include "gtest/gtest.h"
+
+#include <set>
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace test {
+
+		static ParticleVertexStreamPtr createQuadStream( void )
+		{
+			return crimild::alloc< ParticleVertexStream >( VertexFormat::VF_P3_UV2, 4, std::vector< IndexPrecision > { 0, 1, 2, 0, 2, 3 } );
+		}
+
+	}
+
+}
+
+TEST( ParticleVertexStream, beginFrame )
+{
+	auto stream = test::createQuadStream();
+	EXPECT_EQ( 0, stream->getCapacity() );
+	EXPECT_EQ( 0, stream->getBufferAllocationCount() );
+
+	auto vbo = stream->beginFrame( 10 );
+	ASSERT_NE( nullptr, vbo );
+	EXPECT_EQ( 10, stream->getParticleCount() );
+	EXPECT_EQ( 10, stream->getCapacity() );
+	EXPECT_EQ( 40, vbo->getVertexCount() );
+	EXPECT_EQ( VertexBufferObject::Usage::STREAM, vbo->getUsage() );
+
+	// one vertex buffer and one index buffer
+	EXPECT_EQ( 2, stream->getBufferAllocationCount() );
+}
+
+TEST( ParticleVertexStream, endFrame )
+{
+	auto stream = test::createQuadStream();
+	auto primitive = crimild::alloc< Primitive >( Primitive::Type::TRIANGLES );
+
+	auto vbo = stream->beginFrame( 3 );
+	stream->endFrame( primitive );
+
+	// no job scheduler, so buffers are assigned immediately
+	EXPECT_EQ( vbo, primitive->getVertexBuffer() );
+
+	auto ibo = primitive->getIndexBuffer();
+	ASSERT_NE( nullptr, ibo );
+	ASSERT_EQ( 18, ibo->getIndexCount() );
+
+	IndexPrecision expected[] = {
+		0, 1, 2, 0, 2, 3,
+		4, 5, 6, 4, 6, 7,
+		8, 9, 10, 8, 10, 11,
+	};
+	for ( int i = 0; i < 18; i++ ) {
+		EXPECT_EQ( expected[ i ], ibo->getIndexAt( i ) );
+	}
+
+	// only vertices for alive particles need to be uploaded
+	const auto valueCount = 3 * 4 * VertexFormat::VF_P3_UV2.getVertexSize();
+	EXPECT_TRUE( vbo->isDirty() );
+	EXPECT_EQ( 0, vbo->getDirtyBegin() );
+	EXPECT_EQ( valueCount, vbo->getDirtyCount() );
+	EXPECT_EQ( valueCount, vbo->getUsedCount() );
+}
+
+TEST( ParticleVertexStream, growth )
+{
+	auto stream = test::createQuadStream();
+	auto primitive = crimild::alloc< Primitive >( Primitive::Type::TRIANGLES );
+
+	stream->beginFrame( 10 );
+	stream->endFrame( primitive );
+	EXPECT_EQ( 10, stream->getCapacity() );
+
+	// capacity is at least doubled
+	stream->beginFrame( 11 );
+	stream->endFrame( primitive );
+	EXPECT_EQ( 20, stream->getCapacity() );
+	EXPECT_EQ( 120, primitive->getIndexBuffer()->getSize() );
+	EXPECT_EQ( 66, primitive->getIndexBuffer()->getIndexCount() );
+
+	stream->beginFrame( 100 );
+	stream->endFrame( primitive );
+	EXPECT_EQ( 100, stream->getCapacity() );
+
+	// never shrinks
+	stream->beginFrame( 5 );
+	stream->endFrame( primitive );
+	EXPECT_EQ( 100, stream->getCapacity() );
+	EXPECT_EQ( 30, primitive->getIndexBuffer()->getIndexCount() );
+}
+
+TEST( ParticleVertexStream, clampsToIndexPrecision )
+{
+	auto stream = test::createQuadStream();
+	EXPECT_EQ( 16384, stream->getMaxParticleCount() );
+
+	stream->beginFrame( 100000 );
+	EXPECT_EQ( 16384, stream->getParticleCount() );
+	EXPECT_EQ( 16384, stream->getCapacity() );
+}
+
+TEST( ParticleVertexStream, noBufferAllocationsOnceWarm )
+{
+	auto stream = test::createQuadStream();
+	auto primitive = crimild::alloc< Primitive >( Primitive::Type::TRIANGLES );
+
+	// warm up, so every buffer in the ring reaches the working capacity
+	for ( int i = 0; i < CRIMILD_PARTICLE_VERTEX_STREAM_RING_SIZE; i++ ) {
+		stream->beginFrame( 500 );
+		stream->endFrame( primitive );
+	}
+
+	const auto allocationCount = stream->getBufferAllocationCount();
+	EXPECT_EQ( CRIMILD_PARTICLE_VERTEX_STREAM_RING_SIZE + 1, allocationCount );
+
+	auto ibo = primitive->getIndexBuffer();
+
+	std::set< VertexBufferObject * > vbos;
+	for ( int frame = 0; frame < 100; frame++ ) {
+		auto vbo = stream->beginFrame( 1 + ( frame * 37 ) % 500 );
+		stream->endFrame( primitive );
+		vbos.insert( vbo );
+
+		EXPECT_EQ( vbo, primitive->getVertexBuffer() );
+		EXPECT_EQ( ibo, primitive->getIndexBuffer() );
+	}
+
+	EXPECT_EQ( allocationCount, stream->getBufferAllocationCount() );
+
+	// vertex buffers are rotated
+	EXPECT_EQ( CRIMILD_PARTICLE_VERTEX_STREAM_RING_SIZE, vbos.size() );
+}
+
@@ -95,3 +95,28 @@ TEST( IndexBufferObject, iboStream )
 	}
 }
 
+
+TEST( IndexBufferObject, dirtyRange )
+{
+	auto ibo = crimild::alloc< IndexBufferObject >( 100 );
+	EXPECT_FALSE( ibo->isDirty() );
+	EXPECT_EQ( IndexBufferObject::Usage::STATIC, ibo->getUsage() );
+
+	ibo->markDirty( 10, 5 );
+	EXPECT_TRUE( ibo->isDirty() );
+	EXPECT_EQ( 10, ibo->getDirtyBegin() );
+	EXPECT_EQ( 5, ibo->getDirtyCount() );
+
+	// ranges are merged
+	ibo->markDirty( 40, 10 );
+	EXPECT_EQ( 10, ibo->getDirtyBegin() );
+	EXPECT_EQ( 40, ibo->getDirtyCount() );
+
+	ibo->markDirty( 0, 2 );
+	EXPECT_EQ( 0, ibo->getDirtyBegin() );
+	EXPECT_EQ( 50, ibo->getDirtyCount() );
+
+	ibo->clearDirty();
+	EXPECT_FALSE( ibo->isDirty() );
+	EXPECT_EQ( 0, ibo->getDirtyCount() );
+}
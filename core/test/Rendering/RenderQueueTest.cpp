@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Rendering/RenderQueue.hpp"
+#include "Rendering/AlphaState.hpp"
+#include "Components/RenderStateComponent.hpp"
+#include "Primitives/Primitive.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace test {
+
+		static SharedPointer< Geometry > createGeometry( float z, SharedPointer< Material > const &material )
+		{
+			auto geometry = crimild::alloc< Geometry >();
+			geometry->world().setTranslate( 0.0f, 0.0f, z );
+			auto rs = geometry->attachComponent< RenderStateComponent >();
+			rs->attachMaterial( material );
+			return geometry;
+		}
+
+	}
+
+}
+
+TEST( RenderQueueTest, opaqueObjectsAreSortedByStateThenFrontToBack )
+{
+	auto camera = crimild::alloc< Camera >();
+
+	auto m0 = crimild::alloc< Material >();
+	auto m1 = crimild::alloc< Material >();
+
+	std::vector< SharedPointer< Geometry >> geometries = {
+		test::createGeometry( -5.0f, m0 ),
+		test::createGeometry( -1.0f, m1 ),
+		test::createGeometry( -3.0f, m0 ),
+		test::createGeometry( -2.0f, m1 ),
+		test::createGeometry( -4.0f, m0 ),
+	};
+
+	auto renderQueue = crimild::alloc< RenderQueue >();
+	renderQueue->setCamera( crimild::get_ptr( camera ) );
+	for ( auto &g : geometries ) {
+		renderQueue->push( crimild::get_ptr( g ) );
+	}
+
+	auto renderables = renderQueue->getRenderables( RenderQueue::RenderableType::OPAQUE );
+	ASSERT_EQ( 5, renderables->size() );
+
+	std::vector< Geometry * > expected = {
+		crimild::get_ptr( geometries[ 2 ] ),
+		crimild::get_ptr( geometries[ 4 ] ),
+		crimild::get_ptr( geometries[ 0 ] ),
+		crimild::get_ptr( geometries[ 1 ] ),
+		crimild::get_ptr( geometries[ 3 ] ),
+	};
+
+	int i = 0;
+	renderQueue->each( renderables, [ &i, &expected ]( RenderQueue::Renderable *renderable ) {
+		EXPECT_EQ( expected[ i++ ], renderable->geometry );
+	});
+
+	// all opaque objects cast shadows by default. They are sorted front to back
+	auto casters = renderQueue->getRenderables( RenderQueue::RenderableType::SHADOW_CASTER );
+	ASSERT_EQ( 5, casters->size() );
+	for ( size_t i = 1; i < casters->size(); i++ ) {
+		EXPECT_LE( ( *casters )[ i - 1 ].distanceFromCamera, ( *casters )[ i ].distanceFromCamera );
+	}
+}
+
+TEST( RenderQueueTest, translucentObjectsAreSortedBackToFront )
+{
+	auto camera = crimild::alloc< Camera >();
+
+	auto m0 = crimild::alloc< Material >();
+	m0->setAlphaState( AlphaState::ENABLED );
+	auto m1 = crimild::alloc< Material >();
+	m1->setAlphaState( AlphaState::ENABLED );
+
+	std::vector< SharedPointer< Geometry >> geometries = {
+		test::createGeometry( -2.0f, m0 ),
+		test::createGeometry( -5.0f, m1 ),
+		test::createGeometry( -1.0f, m1 ),
+		test::createGeometry( -4.0f, m0 ),
+	};
+
+	auto renderQueue = crimild::alloc< RenderQueue >();
+	renderQueue->setCamera( crimild::get_ptr( camera ) );
+	for ( auto &g : geometries ) {
+		renderQueue->push( crimild::get_ptr( g ) );
+	}
+
+	EXPECT_EQ( 0, renderQueue->getRenderables( RenderQueue::RenderableType::OPAQUE )->size() );
+	EXPECT_EQ( 0, renderQueue->getRenderables( RenderQueue::RenderableType::SHADOW_CASTER )->size() );
+
+	auto renderables = renderQueue->getRenderables( RenderQueue::RenderableType::TRANSLUCENT );
+	ASSERT_EQ( 4, renderables->size() );
+	EXPECT_EQ( crimild::get_ptr( geometries[ 1 ] ), ( *renderables )[ 0 ].geometry );
+	EXPECT_EQ( crimild::get_ptr( geometries[ 3 ] ), ( *renderables )[ 1 ].geometry );
+	EXPECT_EQ( crimild::get_ptr( geometries[ 0 ] ), ( *renderables )[ 2 ].geometry );
+	EXPECT_EQ( crimild::get_ptr( geometries[ 2 ] ), ( *renderables )[ 3 ].geometry );
+}
+
+TEST( RenderQueueTest, reset )
+{
+	auto camera = crimild::alloc< Camera >();
+	auto geometry = test::createGeometry( -1.0f, crimild::alloc< Material >() );
+
+	auto renderQueue = crimild::alloc< RenderQueue >();
+	renderQueue->setCamera( crimild::get_ptr( camera ) );
+	renderQueue->push( crimild::get_ptr( geometry ) );
+	EXPECT_EQ( 2, geometry.use_count() );
+
+	renderQueue->reset();
+	EXPECT_EQ( 1, geometry.use_count() );
+	EXPECT_EQ( 0, renderQueue->getRenderables( RenderQueue::RenderableType::OPAQUE )->size() );
+}
+
+TEST( RenderQueueTest, materialsAreRetained )
+{
+	auto camera = crimild::alloc< Camera >();
+	auto material = crimild::alloc< Material >();
+	auto geometry = test::createGeometry( -1.0f, material );
+	EXPECT_EQ( 2, material.use_count() );
+
+	auto renderQueue = crimild::alloc< RenderQueue >();
+	renderQueue->setCamera( crimild::get_ptr( camera ) );
+	renderQueue->push( crimild::get_ptr( geometry ) );
+	EXPECT_EQ( 3, material.use_count() );
+
+	// materials are detached when updating render states
+	geometry->getComponent< RenderStateComponent >()->detachAllMaterials();
+	EXPECT_EQ( 2, material.use_count() );
+
+	auto renderables = renderQueue->getRenderables( RenderQueue::RenderableType::OPAQUE );
+	ASSERT_EQ( 1, renderables->size() );
+	EXPECT_EQ( crimild::get_ptr( material ), ( *renderables )[ 0 ].material );
+
+	renderQueue->reset();
+	EXPECT_EQ( 1, material.use_count() );
+}
+
+TEST( RenderQueueTest, instanceBatches )
+{
+	auto camera = crimild::alloc< Camera >();
+
+	auto m0 = crimild::alloc< Material >();
+	auto m1 = crimild::alloc< Material >();
+	auto p0 = crimild::alloc< Primitive >();
+	auto p1 = crimild::alloc< Primitive >();
+
+	std::vector< SharedPointer< Geometry >> geometries;
+	auto createGeometry = [ &geometries ]( float z, SharedPointer< Primitive > const &primitive, SharedPointer< Material > const &material ) {
+		auto geometry = test::createGeometry( z, material );
+		geometry->attachPrimitive( primitive );
+		geometries.push_back( geometry );
+	};
+
+	createGeometry( -1.0f, p0, m0 );
+	createGeometry( -2.0f, p1, m0 );
+	createGeometry( -3.0f, p0, m0 );
+	createGeometry( -4.0f, p0, m1 );
+	createGeometry( -5.0f, p0, m0 );
+
+	// geometries with several primitives are never instanced
+	createGeometry( -6.0f, p1, m1 );
+	geometries.back()->attachPrimitive( p0 );
+	createGeometry( -7.0f, p1, m1 );
+	geometries.back()->attachPrimitive( p0 );
+
+	auto renderQueue = crimild::alloc< RenderQueue >();
+	renderQueue->setCamera( crimild::get_ptr( camera ) );
+	for ( auto &g : geometries ) {
+		renderQueue->push( crimild::get_ptr( g ) );
+	}
+
+	auto renderables = renderQueue->getRenderables( RenderQueue::RenderableType::OPAQUE );
+	auto batches = renderQueue->getInstanceBatches( RenderQueue::RenderableType::OPAQUE );
+
+	// { p0, m0 } x 3, { p1, m0 }, { p0, m1 }, and two non-instanced geometries
+	ASSERT_EQ( 5, batches->size() );
+
+	crimild::Size total = 0;
+	for ( auto &batch : *batches ) {
+		auto &first = ( *renderables )[ batch.first ];
+		for ( crimild::Size i = 0; i < batch.instanceCount; i++ ) {
+			auto &r = ( *renderables )[ batch.first + i ];
+			EXPECT_EQ( first.material, r.material );
+			EXPECT_EQ( first.primitive, r.primitive );
+			if ( batch.instanceCount > 1 ) {
+				EXPECT_EQ( r.modelTransform, renderQueue->getInstanceTransforms( batch )[ i ] );
+			}
+		}
+		if ( first.primitive == crimild::get_ptr( p0 ) && first.material == crimild::get_ptr( m0 ) ) {
+			EXPECT_EQ( 3, batch.instanceCount );
+		}
+		else {
+			EXPECT_EQ( 1, batch.instanceCount );
+		}
+		total += batch.instanceCount;
+	}
+	EXPECT_EQ( renderables->size(), total );
+}
+
+TEST( RenderQueueTest, allocateFromArena )
+{
+	auto camera = crimild::alloc< Camera >();
+
+	auto m0 = crimild::alloc< Material >();
+	auto m1 = crimild::alloc< Material >();
+
+	std::vector< SharedPointer< Geometry >> geometries;
+	for ( int i = 0; i < 100; i++ ) {
+		geometries.push_back( test::createGeometry( -float( i ), i % 2 == 0 ? m0 : m1 ) );
+	}
+
+	auto arena = crimild::alloc< LinearArena >( 1024 );
+
+	for ( int frame = 0; frame < 3; frame++ ) {
+		{
+			auto renderQueue = crimild::alloc< RenderQueue >( arena );
+			renderQueue->setCamera( crimild::get_ptr( camera ) );
+			for ( auto &g : geometries ) {
+				renderQueue->push( crimild::get_ptr( g ) );
+			}
+
+			auto renderables = renderQueue->getRenderables( RenderQueue::RenderableType::OPAQUE );
+			ASSERT_EQ( 100, renderables->size() );
+			for ( size_t i = 1; i < renderables->size(); i++ ) {
+				EXPECT_LE( ( *renderables )[ i - 1 ].sortKey, ( *renderables )[ i ].sortKey );
+			}
+
+			EXPECT_LT( 0, arena->getAllocationCount() );
+			if ( frame > 0 ) {
+				// the arena is large enough after the first frame
+				EXPECT_EQ( 0, arena->getHeapAllocationCount() );
+			}
+		}
+
+		// queue released, so all of its memory can be discarded
+		EXPECT_EQ( 1, arena.use_count() );
+		arena->reset();
+	}
+}
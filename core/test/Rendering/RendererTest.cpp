@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Rendering/Renderer.hpp"
+#include "Rendering/RenderQueue.hpp"
+#include "Rendering/RenderPasses/StandardRenderPass.hpp"
+#include "Components/RenderStateComponent.hpp"
+#include "Primitives/QuadPrimitive.hpp"
+#include "Simulation/AssetManager.hpp"
+#include "Foundation/Profiler.hpp"
+
+#include "Utils/MockRenderer.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace test {
+
+		static SharedPointer< ShaderProgram > createProgram( void )
+		{
+			auto program = crimild::alloc< ShaderProgram >( crimild::alloc< VertexShader >( "vs" ), crimild::alloc< FragmentShader >( "fs" ) );
+			program->registerStandardLocation( ShaderLocation::Type::UNIFORM, ShaderProgram::StandardLocation::PROJECTION_MATRIX_UNIFORM, "uPMatrix" );
+			program->registerStandardLocation( ShaderLocation::Type::UNIFORM, ShaderProgram::StandardLocation::VIEW_MATRIX_UNIFORM, "uVMatrix" );
+			program->registerStandardLocation( ShaderLocation::Type::UNIFORM, ShaderProgram::StandardLocation::MODEL_MATRIX_UNIFORM, "uMMatrix" );
+			program->registerStandardLocation( ShaderLocation::Type::UNIFORM, ShaderProgram::StandardLocation::MATERIAL_COLOR_MAP_UNIFORM, "uColorMap" );
+			return program;
+		}
+
+	}
+
+}
+
+TEST( RendererTest, redundantProgramBindsAreSkipped )
+{
+	AssetManager assets;
+	MockRenderer renderer;
+
+	auto p0 = test::createProgram();
+	auto p1 = test::createProgram();
+
+	renderer.beginRender();
+
+	renderer.bindProgram( crimild::get_ptr( p0 ) );
+	renderer.bindProgram( crimild::get_ptr( p0 ) );
+	renderer.bindProgram( crimild::get_ptr( p1 ) );
+	renderer.unbindProgram( crimild::get_ptr( p1 ) );
+	renderer.bindProgram( crimild::get_ptr( p1 ) );
+	renderer.unbindProgram( crimild::get_ptr( p1 ) );
+
+	EXPECT_EQ( 3, renderer.getRenderStats().programs.issued );
+	EXPECT_EQ( 1, renderer.getRenderStats().programs.skipped );
+
+	renderer.beginRender();
+
+	EXPECT_EQ( 0, renderer.getRenderStats().programs.issued );
+	EXPECT_EQ( 0, renderer.getRenderStats().programs.skipped );
+}
+
+TEST( RendererTest, redundantMaterialBindsAreSkipped )
+{
+	AssetManager assets;
+	MockRenderer renderer;
+
+	auto program = test::createProgram();
+	auto m0 = crimild::alloc< Material >();
+	auto m1 = crimild::alloc< Material >();
+
+	renderer.beginRender();
+	renderer.bindProgram( crimild::get_ptr( program ) );
+
+	renderer.resetCounters();
+	renderer.bindMaterial( crimild::get_ptr( program ), crimild::get_ptr( m0 ) );
+	auto uniformsPerMaterial = renderer.uniformCount;
+	EXPECT_LT( 0, uniformsPerMaterial );
+
+	renderer.bindMaterial( crimild::get_ptr( program ), crimild::get_ptr( m0 ) );
+	renderer.bindMaterial( crimild::get_ptr( program ), crimild::get_ptr( m0 ) );
+	EXPECT_EQ( uniformsPerMaterial, renderer.uniformCount );
+
+	renderer.bindMaterial( crimild::get_ptr( program ), crimild::get_ptr( m1 ) );
+	EXPECT_EQ( 2 * uniformsPerMaterial, renderer.uniformCount );
+
+	EXPECT_EQ( 2, renderer.getRenderStats().materials.issued );
+	EXPECT_EQ( 2, renderer.getRenderStats().materials.skipped );
+
+	renderer.unbindProgram( crimild::get_ptr( program ) );
+}
+
+TEST( RendererTest, redundantTextureBindsAreSkipped )
+{
+	AssetManager assets;
+	MockRenderer renderer;
+
+	auto program = test::createProgram();
+	auto location = program->getStandardLocation( ShaderProgram::StandardLocation::MATERIAL_COLOR_MAP_UNIFORM );
+	auto texture = crimild::alloc< Texture >( crimild::alloc< Image >( 1, 1, 4, nullptr ) );
+
+	renderer.beginRender();
+
+	renderer.bindTexture( location, crimild::get_ptr( texture ) );
+	renderer.bindTexture( location, crimild::get_ptr( texture ) );
+	EXPECT_EQ( 1, renderer.getTextureCatalog()->getActiveResourceCount() );
+
+	// only the last unbind is actually issued
+	renderer.unbindTexture( location, crimild::get_ptr( texture ) );
+	EXPECT_EQ( 1, renderer.getTextureCatalog()->getActiveResourceCount() );
+	renderer.unbindTexture( location, crimild::get_ptr( texture ) );
+	EXPECT_EQ( 0, renderer.getTextureCatalog()->getActiveResourceCount() );
+
+	EXPECT_EQ( 1, renderer.getRenderStats().textures.issued );
+	EXPECT_EQ( 1, renderer.getRenderStats().textures.skipped );
+}
+
+TEST( RendererTest, cachedUniforms )
+{
+	AssetManager assets;
+	MockRenderer renderer;
+
+	auto program = test::createProgram();
+	auto location = program->getStandardLocation( ShaderProgram::StandardLocation::VIEW_MATRIX_UNIFORM );
+
+	Matrix4f m0;
+	m0.makeIdentity();
+	Matrix4f m1 = m0;
+	m1[ 12 ] = 5.0f;
+
+	renderer.beginRender();
+	renderer.resetCounters();
+
+	renderer.bindCachedUniform( location, m0 );
+	renderer.bindCachedUniform( location, m0 );
+	renderer.bindCachedUniform( location, m1 );
+
+	EXPECT_EQ( 2, renderer.uniformCount );
+	EXPECT_EQ( 2, renderer.getRenderStats().uniforms.issued );
+	EXPECT_EQ( 1, renderer.getRenderStats().uniforms.skipped );
+}
+
+TEST( RendererTest, stateSortedRenderPass )
+{
+	const int GEOMETRY_COUNT = 100;
+
+	Profiler profiler;
+	AssetManager assets;
+	MockRenderer renderer;
+
+	auto camera = crimild::alloc< Camera >();
+
+	auto program = test::createProgram();
+	SharedPointer< Material > materials[ 2 ];
+	for ( auto &m : materials ) {
+		m = crimild::alloc< Material >();
+		m->setProgram( program );
+	}
+
+	auto light = crimild::alloc< Light >();
+
+	std::vector< SharedPointer< Geometry >> geometries;
+	for ( int i = 0; i < GEOMETRY_COUNT; i++ ) {
+		auto geometry = crimild::alloc< Geometry >();
+		geometry->attachPrimitive( crimild::alloc< QuadPrimitive >( 1.0f, 1.0f ) );
+		geometry->world().setTranslate( 0.0f, 0.0f, -( float ) i );
+		geometry->attachComponent< RenderStateComponent >()->attachMaterial( materials[ i % 2 ] );
+		geometries.push_back( geometry );
+	}
+
+	auto renderQueue = crimild::alloc< RenderQueue >();
+	renderQueue->setCamera( crimild::get_ptr( camera ) );
+	renderQueue->push( crimild::get_ptr( light ) );
+	for ( auto &g : geometries ) {
+		renderQueue->push( crimild::get_ptr( g ) );
+	}
+
+	auto renderPass = crimild::alloc< StandardRenderPass >();
+	renderPass->setShadowMappingEnabled( false );
+
+	renderer.beginRender();
+	renderer.resetCounters();
+	renderPass->render( &renderer, crimild::get_ptr( renderQueue ), crimild::get_ptr( camera ) );
+
+	auto &stats = renderer.getRenderStats();
+	EXPECT_EQ( GEOMETRY_COUNT, renderer.drawCount );
+	EXPECT_EQ( 1, stats.programs.issued );
+	EXPECT_EQ( 2, stats.materials.issued );
+	EXPECT_EQ( 1, stats.lights.issued );
+
+	// render again within the same frame. Uniforms stored in the program are not uploaded twice
+	renderPass->render( &renderer, crimild::get_ptr( renderQueue ), crimild::get_ptr( camera ) );
+	EXPECT_EQ( 2, stats.programs.issued );
+	EXPECT_EQ( 1, stats.lights.issued );
+	EXPECT_EQ( 1, stats.lights.skipped );
+	EXPECT_EQ( 2, stats.uniforms.issued );
+	EXPECT_EQ( 2, stats.uniforms.skipped );
+}
+
+TEST( RendererTest, instancedRenderPass )
+{
+	const int GEOMETRY_COUNT = 100;
+
+	Profiler profiler;
+	AssetManager assets;
+	MockRenderer renderer;
+
+	auto camera = crimild::alloc< Camera >();
+
+	auto program = test::createProgram();
+	SharedPointer< Material > materials[ 2 ];
+	for ( auto &m : materials ) {
+		m = crimild::alloc< Material >();
+		m->setProgram( program );
+	}
+
+	// all geometries share the same primitive, like cloned objects do
+	auto primitive = crimild::alloc< QuadPrimitive >( 1.0f, 1.0f );
+
+	std::vector< SharedPointer< Geometry >> geometries;
+	for ( int i = 0; i < GEOMETRY_COUNT; i++ ) {
+		auto geometry = crimild::alloc< Geometry >();
+		geometry->attachPrimitive( primitive );
+		geometry->world().setTranslate( 0.0f, 0.0f, -( float ) i );
+		geometry->attachComponent< RenderStateComponent >()->attachMaterial( materials[ i % 2 ] );
+		geometries.push_back( geometry );
+	}
+
+	auto renderQueue = crimild::alloc< RenderQueue >();
+	renderQueue->setCamera( crimild::get_ptr( camera ) );
+	for ( auto &g : geometries ) {
+		renderQueue->push( crimild::get_ptr( g ) );
+	}
+
+	auto renderPass = crimild::alloc< StandardRenderPass >();
+	renderPass->setShadowMappingEnabled( false );
+
+	renderer.beginRender();
+	renderer.resetCounters();
+	renderPass->render( &renderer, crimild::get_ptr( renderQueue ), crimild::get_ptr( camera ) );
+
+	// one draw per material
+	EXPECT_EQ( 2, renderer.drawCount );
+	EXPECT_EQ( GEOMETRY_COUNT, renderer.instanceCount );
+}
@@ -27,6 +27,7 @@
 
 #include "Rendering/VertexBufferObject.hpp"
 #include "Streaming/FileStream.hpp"
+#include "Streaming/MappedFileStream.hpp"
  
 #include "gtest/gtest.h"
 
@@ -158,3 +159,42 @@ TEST( VertexBufferObject, vboStream )
 	}
 }
 
+TEST( VertexBufferObject, streamingMapped )
+{
+	VertexPrecision vertices[] = {
+		+1.0f, 0.0f, 0.0f,	0.0f, 0.0f, 1.0f,	0.0f, 1.0,
+		-1.0f, 0.0f, 0.0f,	0.0f, 0.0f, 1.0f,	1.0f, 0.0f,
+		+0.0f, 1.0f, 0.0f,	0.0f, 0.0f, 1.0f,	0.5f, 0.0f
+	};
+
+	auto vbo = crimild::alloc< VertexBufferObject >( VertexFormat::VF_P3_N3_UV2, 3, vertices );
+
+	{
+		FileStream os( "vboMapped.crimild", FileStream::OpenMode::WRITE );
+		os.addObject( vbo );
+		EXPECT_TRUE( os.flush() );
+	}
+
+	SharedPointer< VertexBufferObject > vbo1;
+
+	{
+		MappedFileStream is( "vboMapped.crimild" );
+		EXPECT_TRUE( is.load() );
+		EXPECT_EQ( 1, is.getObjectCount() );
+		vbo1 = is.getObjectAt< VertexBufferObject >( 0 );
+	}
+
+	// the mapping outlives the stream
+	ASSERT_TRUE( vbo1 != nullptr );
+	EXPECT_TRUE( vbo1->isMapped() );
+	EXPECT_EQ( 0, reinterpret_cast< std::uintptr_t >( vbo1->getData() ) % alignof( VertexPrecision ) );
+	EXPECT_EQ( vbo->getVertexCount(), vbo1->getVertexCount() );
+	EXPECT_EQ( 0, memcmp( vbo->getData(), vbo1->getData(), vbo1->getSizeInBytes() ) );
+
+	// writing copies the data
+	vbo1->data()[ 0 ] = 5.0f;
+	EXPECT_FALSE( vbo1->isMapped() );
+	EXPECT_EQ( vbo->getSize(), vbo1->getSize() );
+	EXPECT_EQ( 5.0f, vbo1->getData()[ 0 ] );
+	EXPECT_EQ( 0, memcmp( vbo->getData() + 1, vbo1->getData() + 1, vbo1->getSizeInBytes() - sizeof( VertexPrecision ) ) );
+}
@@ -28,6 +28,7 @@
 #include "SceneGraph/Node.hpp"
 #include "SceneGraph/Group.hpp"
 #include "Streaming/FileStream.hpp"
+#include "Components/MaterialComponent.hpp"
 
 #include "Utils/MockComponent.hpp"
 
@@ -255,6 +256,57 @@ TEST( NodeTest, detachAllComponents )
 	EXPECT_EQ( cmp1->getNode(), nullptr );
 }
 
+TEST( NodeTest, componentTypeIds )
+{
+	auto mockTypeId = NodeComponent::getTypeId< MockComponent >();
+	auto materialTypeId = NodeComponent::getTypeId< MaterialComponent >();
+
+	EXPECT_NE( NodeComponent::INVALID_TYPE_ID, mockTypeId );
+	EXPECT_NE( NodeComponent::INVALID_TYPE_ID, materialTypeId );
+	EXPECT_NE( mockTypeId, materialTypeId );
+
+	EXPECT_EQ( mockTypeId, NodeComponent::getTypeId< MockComponent >() );
+	EXPECT_EQ( mockTypeId, NodeComponent::getTypeIdForName( MockComponent::__CLASS_NAME ) );
+	EXPECT_EQ( mockTypeId, NodeComponent::findTypeIdForName( MockComponent::__CLASS_NAME ) );
+	EXPECT_EQ( NodeComponent::INVALID_TYPE_ID, NodeComponent::findTypeIdForName( "crimild::UnknownComponent" ) );
+}
+
+TEST( NodeTest, getComponentWithTypeId )
+{
+	auto node = crimild::alloc< Node >();
+
+	auto cmp = crimild::alloc< ::testing::NiceMock< MockComponent >>();
+	node->attachComponent( cmp );
+
+	EXPECT_EQ( crimild::get_ptr( cmp ), node->getComponentWithTypeId( NodeComponent::getTypeId< MockComponent >() ) );
+	EXPECT_EQ( nullptr, node->getComponentWithTypeId( NodeComponent::getTypeId< MaterialComponent >() ) );
+	EXPECT_EQ( nullptr, node->getComponentWithTypeId( NodeComponent::INVALID_TYPE_ID ) );
+
+	node->detachComponentWithTypeId( NodeComponent::getTypeId< MockComponent >() );
+	EXPECT_EQ( nullptr, node->getComponent< MockComponent >() );
+	EXPECT_EQ( nullptr, cmp->getNode() );
+}
+
+TEST( NodeTest, forEachComponentIsSortedByName )
+{
+	auto node = crimild::alloc< Node >();
+
+	auto mock = crimild::alloc< ::testing::NiceMock< MockComponent >>();
+	auto material = crimild::alloc< MaterialComponent >();
+
+	node->attachComponent( mock );
+	node->attachComponent( material );
+
+	std::vector< NodeComponent * > cmps;
+	node->forEachComponent( [ &cmps ]( NodeComponent *cmp ) {
+		cmps.push_back( cmp );
+	});
+
+	ASSERT_EQ( 2, cmps.size() );
+	EXPECT_EQ( crimild::get_ptr( material ), cmps[ 0 ] );
+	EXPECT_EQ( crimild::get_ptr( mock ), cmps[ 1 ] );
+}
+
 TEST( NodeTest, getRootParent )
 {
 	auto g1 = crimild::alloc< Group >();
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Simulation/Systems/StreamingSystem.hpp"
+#include "Simulation/AssetManager.hpp"
+#include "Concurrency/JobScheduler.hpp"
+#include "SceneGraph/Node.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace crimild;
+using namespace crimild::concurrency;
+
+namespace crimild {
+
+	namespace test {
+
+		class AssetMessageRecorder : public Messenger {
+		public:
+			AssetMessageRecorder( void )
+			{
+				registerMessageHandler< messaging::AssetLoaded >( [ this ]( messaging::AssetLoaded const &m ) {
+					loaded.push_back( m.filename );
+				});
+				registerMessageHandler< messaging::AssetLoadFailed >( [ this ]( messaging::AssetLoadFailed const &m ) {
+					failed.push_back( m.filename );
+				});
+				registerMessageHandler< messaging::AssetLoadCancelled >( [ this ]( messaging::AssetLoadCancelled const &m ) {
+					cancelled.push_back( m.filename );
+				});
+				registerMessageHandler< messaging::AssetStreamingProgress >( [ this ]( messaging::AssetStreamingProgress const &m ) {
+					progress.push_back( m );
+				});
+			}
+
+			virtual ~AssetMessageRecorder( void )
+			{
+
+			}
+
+			std::vector< std::string > loaded;
+			std::vector< std::string > failed;
+			std::vector< std::string > cancelled;
+			std::vector< messaging::AssetStreamingProgress > progress;
+		};
+
+	}
+
+}
+
+using namespace crimild::test;
+
+TEST( StreamingSystemTest, loadAssetsByPriority )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 1 );
+	scheduler.start();
+
+	AssetManager assetManager;
+	AssetMessageRecorder recorder;
+
+	std::atomic< bool > blocked( true );
+	std::mutex orderMutex;
+	std::vector< std::string > order;
+
+	{
+		StreamingSystem streaming;
+		streaming.setMaxConcurrentAssetLoads( 1 );
+		streaming.setAssetLoader( ".node", [ & ]( std::string const &path ) -> SharedPointer< SharedObject > {
+			while ( blocked ) {
+				std::this_thread::yield();
+			}
+
+			std::lock_guard< std::mutex > lock( orderMutex );
+			order.push_back( path.substr( path.find_last_of( "/" ) + 1 ) );
+			return crimild::alloc< Node >();
+		});
+
+		// the first asset keeps the only loading slot busy
+		streaming.requestAsset( "first.node" );
+		streaming.requestAsset( "low.node", -1 );
+		streaming.requestAsset( "normal.node" );
+		streaming.requestAsset( "high.node", 10 );
+		streaming.requestAsset( "normal.node", 20 );
+
+		EXPECT_EQ( 3, streaming.getPendingAssetCount() );
+		EXPECT_EQ( 1, streaming.getLoadingAssetCount() );
+
+		blocked = false;
+		streaming.waitForAssetLoads();
+
+		EXPECT_EQ( 0, streaming.getPendingAssetCount() );
+		EXPECT_EQ( 0, streaming.getLoadingAssetCount() );
+	}
+
+	ASSERT_EQ( 4, order.size() );
+	EXPECT_EQ( "first.node", order[ 0 ] );
+	EXPECT_EQ( "normal.node", order[ 1 ] );
+	EXPECT_EQ( "high.node", order[ 2 ] );
+	EXPECT_EQ( "low.node", order[ 3 ] );
+
+	// requests for the same asset are merged
+	EXPECT_EQ( 2, assetManager.getReferenceCount( "normal.node" ) );
+	EXPECT_EQ( 1, assetManager.getReferenceCount( "high.node" ) );
+
+	// messages are delivered in the main thread
+	EXPECT_TRUE( recorder.loaded.empty() );
+	scheduler.executeDelayedJobs();
+	EXPECT_EQ( 5, recorder.loaded.size() );
+	ASSERT_FALSE( recorder.progress.empty() );
+	EXPECT_EQ( 5, recorder.progress.back().requestedCount );
+	EXPECT_EQ( 5, recorder.progress.back().completedCount );
+
+	scheduler.stop();
+}
+
+TEST( StreamingSystemTest, cancelAssetRequest )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 1 );
+	scheduler.start();
+
+	AssetManager assetManager;
+	AssetMessageRecorder recorder;
+
+	std::atomic< bool > blocked( true );
+	std::atomic< int > loadCount( 0 );
+
+	{
+		StreamingSystem streaming;
+		streaming.setMaxConcurrentAssetLoads( 1 );
+		streaming.setAssetLoader( ".node", [ & ]( std::string const &path ) -> SharedPointer< SharedObject > {
+			while ( blocked ) {
+				std::this_thread::yield();
+			}
+
+			loadCount++;
+			return crimild::alloc< Node >();
+		});
+
+		auto loading = streaming.requestAsset( "loading.node" );
+		auto pending = streaming.requestAsset( "pending.node" );
+		auto shared = streaming.requestAsset( "shared.node" );
+		streaming.requestAsset( "shared.node" );
+
+		EXPECT_TRUE( streaming.cancelAssetRequest( loading ) );
+		EXPECT_TRUE( streaming.cancelAssetRequest( pending ) );
+		EXPECT_TRUE( streaming.cancelAssetRequest( shared ) );
+		EXPECT_FALSE( streaming.cancelAssetRequest( pending ) );
+
+		blocked = false;
+		streaming.waitForAssetLoads();
+	}
+
+	// pending assets are never loaded, while loading ones are discarded
+	EXPECT_EQ( 2, loadCount );
+	EXPECT_EQ( 0, assetManager.getReferenceCount( "loading.node" ) );
+	EXPECT_EQ( nullptr, assetManager.get< Node >( "loading.node" ) );
+	EXPECT_EQ( 0, assetManager.getReferenceCount( "pending.node" ) );
+	EXPECT_EQ( 1, assetManager.getReferenceCount( "shared.node" ) );
+
+	scheduler.executeDelayedJobs();
+	EXPECT_EQ( 3, recorder.cancelled.size() );
+	ASSERT_EQ( 1, recorder.loaded.size() );
+	EXPECT_EQ( "shared.node", recorder.loaded[ 0 ] );
+
+	scheduler.stop();
+}
+
+TEST( StreamingSystemTest, assetResidency )
+{
+	JobScheduler scheduler;
+	scheduler.configure( 1 );
+	scheduler.start();
+
+	AssetManager assetManager;
+	AssetMessageRecorder recorder;
+
+	std::atomic< int > loadCount( 0 );
+
+	StreamingSystem streaming;
+	streaming.setAssetLoader( ".node", [ & ]( std::string const &path ) -> SharedPointer< SharedObject > {
+		loadCount++;
+		return crimild::alloc< Node >();
+	});
+
+	streaming.requestAsset( "chunk.node" );
+	streaming.waitForAssetLoads();
+	EXPECT_EQ( 1, assetManager.getReferenceCount( "chunk.node" ) );
+
+	// resident assets are not loaded again
+	streaming.requestAsset( "chunk.node" );
+	streaming.waitForAssetLoads();
+	EXPECT_EQ( 1, loadCount );
+	EXPECT_EQ( 2, assetManager.getReferenceCount( "chunk.node" ) );
+
+	// resident assets survive clearing the cache
+	assetManager.clear();
+	EXPECT_NE( nullptr, assetManager.get< Node >( "chunk.node" ) );
+
+	streaming.releaseAsset( "chunk.node" );
+	EXPECT_NE( nullptr, assetManager.get< Node >( "chunk.node" ) );
+
+	streaming.releaseAsset( "chunk.node" );
+	EXPECT_EQ( 0, assetManager.getReferenceCount( "chunk.node" ) );
+	EXPECT_EQ( nullptr, assetManager.get< Node >( "chunk.node" ) );
+
+	// unknown file types fail
+	streaming.requestAsset( "unknown.xyz" );
+	streaming.waitForAssetLoads();
+
+	scheduler.executeDelayedJobs();
+	EXPECT_EQ( 2, recorder.loaded.size() );
+	ASSERT_EQ( 1, recorder.failed.size() );
+	EXPECT_EQ( "unknown.xyz", recorder.failed[ 0 ] );
+
+	scheduler.stop();
+}
+
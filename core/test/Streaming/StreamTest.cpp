@@ -27,6 +27,9 @@
 
 #include "Streaming/Stream.hpp"
 #include "Streaming/FileStream.hpp"
+#include "Streaming/MemoryStream.hpp"
+#include "Streaming/MappedFileStream.hpp"
+#include "Concurrency/JobScheduler.hpp"
 
 #include "Foundation/Memory.hpp"
 
@@ -384,3 +387,168 @@ TEST( StreamingTest, streamingSharedObjects )
 
 }
 
+
+TEST( StreamingTest, memoryStream )
+{
+	auto child = crimild::alloc< IntMockStreamObject >( 10 );
+	auto parent = crimild::alloc< CompositeMockStreamObject >( child );
+
+	MemoryStream os;
+	os.addObject( parent );
+	EXPECT_TRUE( os.flush() );
+
+	MemoryStream is( os.getBuffer() );
+	EXPECT_TRUE( is.load() );
+	EXPECT_EQ( Stream::VERSION_CURRENT, is.getVersion() );
+	EXPECT_EQ( 1, is.getObjectCount() );
+
+	auto p = is.getObjectAt< CompositeMockStreamObject >( 0 );
+	ASSERT_NE( nullptr, p );
+	ASSERT_NE( nullptr, p->getChild() );
+	EXPECT_EQ( 10, p->getChild()->get() );
+}
+
+TEST( StreamingTest, topLevelObjectsKeepTheirOrder )
+{
+	MemoryStream os;
+	for ( int i = 0; i < 10; i++ ) {
+		os.addObject( crimild::alloc< IntMockStreamObject >( i ) );
+	}
+	EXPECT_TRUE( os.flush() );
+
+	MemoryStream is( os.getBuffer() );
+	EXPECT_TRUE( is.load() );
+	ASSERT_EQ( 10, is.getObjectCount() );
+	for ( int i = 0; i < 10; i++ ) {
+		EXPECT_EQ( i, is.getObjectAt< IntMockStreamObject >( i )->get() );
+	}
+}
+
+TEST( StreamingTest, classNamesAreStoredOnce )
+{
+	MemoryStream os;
+	for ( int i = 0; i < 100; i++ ) {
+		os.addObject( crimild::alloc< IntMockStreamObject >( i ) );
+	}
+	EXPECT_TRUE( os.flush() );
+
+	std::string className = IntMockStreamObject().getClassName();
+	std::string buffer( os.getBuffer().begin(), os.getBuffer().end() );
+
+	auto first = buffer.find( className );
+	ASSERT_NE( std::string::npos, first );
+	EXPECT_EQ( std::string::npos, buffer.find( className, first + 1 ) );
+}
+
+TEST( StreamingTest, invalidStream )
+{
+	std::vector< unsigned char > buffer = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	MemoryStream is( buffer );
+	EXPECT_FALSE( is.load() );
+}
+
+TEST( StreamingTest, loadLegacyStream )
+{
+	auto writeLegacyString = []( Stream &s, std::string const &str ) {
+		unsigned int length = str.length();
+		s.write( length );
+		s.writeRawBytes( str.c_str(), length );
+	};
+
+	auto writeLegacyObject = [ writeLegacyString ]( Stream &s, bool topLevel, StreamObject *obj, std::function< void( void ) > const &body ) {
+		writeLegacyString( s, topLevel ? Stream::FLAG_TOP_LEVEL_OBJECT : Stream::FLAG_INNER_OBJECT );
+		writeLegacyString( s, Stream::FLAG_OBJECT_START );
+		writeLegacyString( s, obj->getClassName() );
+		s.write( obj->getUniqueIdentifier() );
+		body();
+		writeLegacyString( s, Stream::FLAG_OBJECT_END );
+	};
+
+	auto child = crimild::alloc< IntMockStreamObject >( 10 );
+	auto parent = crimild::alloc< CompositeMockStreamObject >( child );
+
+	MemoryStream os;
+	writeLegacyString( os, Stream::FLAG_STREAM_START );
+	writeLegacyString( os, "Crimild v4.x" );
+	writeLegacyObject( os, false, crimild::get_ptr( child ), [ &os ] {
+		os.write( 10 );
+	});
+	writeLegacyObject( os, true, crimild::get_ptr( parent ), [ &os, &child ] {
+		os.write( child->getUniqueIdentifier() );
+	});
+	writeLegacyString( os, Stream::FLAG_STREAM_END );
+
+	MemoryStream is( os.getBuffer() );
+	EXPECT_TRUE( is.load() );
+	EXPECT_EQ( Stream::VERSION_LEGACY, is.getVersion() );
+	ASSERT_EQ( 1, is.getObjectCount() );
+
+	auto p = is.getObjectAt< CompositeMockStreamObject >( 0 );
+	ASSERT_NE( nullptr, p );
+	ASSERT_NE( nullptr, p->getChild() );
+	EXPECT_EQ( 10, p->getChild()->get() );
+}
+
+TEST( StreamingTest, mappedFileStream )
+{
+	auto child = crimild::alloc< IntMockStreamObject >( 10 );
+	auto parent = crimild::alloc< CompositeMockStreamObject >( child );
+
+	{
+		FileStream os( "mappedFileStream.crimild", FileStream::OpenMode::WRITE );
+		os.addObject( parent );
+		EXPECT_TRUE( os.flush() );
+	}
+
+	{
+		MappedFileStream is( "mappedFileStream.crimild" );
+		EXPECT_TRUE( is.load() );
+		EXPECT_FALSE( is.isOpen() );
+		ASSERT_EQ( 1, is.getObjectCount() );
+
+		auto p = is.getObjectAt< CompositeMockStreamObject >( 0 );
+		ASSERT_NE( nullptr, p );
+		ASSERT_NE( nullptr, p->getChild() );
+		EXPECT_EQ( 10, p->getChild()->get() );
+	}
+
+	{
+		MappedFileStream is( "invalidPath.crimild" );
+		EXPECT_FALSE( is.load() );
+	}
+}
+
+TEST( StreamingTest, parallelLoad )
+{
+	concurrency::JobScheduler scheduler;
+	scheduler.configure( 3 );
+	scheduler.start();
+
+	auto array = crimild::alloc< MockStreamObjectArray >();
+	for ( int i = 0; i < 1000; i++ ) {
+		array->attachChild( crimild::alloc< CompositeMockStreamObject >( crimild::alloc< IntMockStreamObject >( i ) ) );
+	}
+
+	MemoryStream os;
+	os.addObject( array );
+	EXPECT_TRUE( os.flush() );
+
+	MemoryStream is( os.getBuffer() );
+	is.setLoadMode( Stream::LoadMode::PARALLEL );
+	EXPECT_TRUE( is.load() );
+	ASSERT_EQ( 1, is.getObjectCount() );
+
+	auto a = is.getObjectAt< MockStreamObjectArray >( 0 );
+	ASSERT_NE( nullptr, a );
+
+	int i = 0;
+	a->each( [ &i ]( StreamObject *obj ) {
+		auto composite = static_cast< CompositeMockStreamObject * >( obj );
+		ASSERT_NE( nullptr, composite->getChild() );
+		EXPECT_EQ( i, composite->getChild()->get() );
+		i++;
+	});
+	EXPECT_EQ( 1000, i );
+
+	scheduler.stop();
+}
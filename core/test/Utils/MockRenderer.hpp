@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRIMILD_TESTS_UTILS_MOCK_RENDERER_
+#define CRIMILD_TESTS_UTILS_MOCK_RENDERER_
+
+#include "Rendering/Renderer.hpp"
+
+namespace crimild {
+
+	/**
+	   \brief A renderer that does not talk to any GPU
+
+	   Counts state changes and draw calls instead, which is useful to
+	   measure how many API calls a render pass would issue.
+	 */
+	class MockRenderer : public Renderer {
+	public:
+		MockRenderer( void ) { }
+		virtual ~MockRenderer( void ) { }
+
+		virtual void configure( void ) override { }
+		virtual void clearBuffers( void ) override { }
+
+		virtual void bindUniform( ShaderLocation *location, int value ) override { uniformCount++; }
+		virtual void bindUniform( ShaderLocation *location, float value ) override { uniformCount++; }
+		virtual void bindUniform( ShaderLocation *location, const Vector3f &vector ) override { uniformCount++; }
+		virtual void bindUniform( ShaderLocation *location, const Vector2f &vector ) override { uniformCount++; }
+		virtual void bindUniform( ShaderLocation *location, const RGBAColorf &color ) override { uniformCount++; }
+		virtual void bindUniform( ShaderLocation *location, const Matrix4f &matrix ) override { uniformCount++; }
+
+		virtual void setDepthState( DepthState *state ) override { stateCount++; }
+		virtual void setAlphaState( AlphaState *state ) override { stateCount++; }
+		virtual void setCullFaceState( CullFaceState *state ) override { stateCount++; }
+		virtual void setColorMaskState( ColorMaskState *state ) override { stateCount++; }
+
+		virtual void drawPrimitive( ShaderProgram *program, Primitive *primitive ) override { drawCount++; instanceCount++; }
+
+		virtual void drawPrimitiveInstanced( ShaderProgram *program, Primitive *primitive, const Matrix4f *modelTransforms, crimild::Size count ) override
+		{
+			drawCount++;
+			instanceCount += count;
+		}
+
+		void resetCounters( void )
+		{
+			uniformCount = 0;
+			stateCount = 0;
+			drawCount = 0;
+			instanceCount = 0;
+		}
+
+	public:
+		crimild::Size uniformCount = 0;
+		crimild::Size stateCount = 0;
+		crimild::Size drawCount = 0;
+		crimild::Size instanceCount = 0;
+	};
+
+}
+
+#endif
+
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2013, Hernan Saez
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Visitors/ComputeRenderQueue.hpp"
+#include "Visitors/UpdateWorldState.hpp"
+#include "Rendering/RenderQueue.hpp"
+#include "Components/RenderStateComponent.hpp"
+#include "SceneGraph/Group.hpp"
+#include "SceneGraph/Geometry.hpp"
+#include "SceneGraph/Light.hpp"
+#include "SceneGraph/Camera.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace crimild;
+
+namespace crimild {
+
+	namespace test {
+
+		class CountingComputeRenderQueue : public ComputeRenderQueue {
+		public:
+			CountingComputeRenderQueue( Camera *camera, RenderQueue *result, std::vector< Light * > const *lights = nullptr )
+				: ComputeRenderQueue( camera, result, lights )
+			{
+			}
+
+			virtual void visitGroup( Group *group ) override
+			{
+				++visitedGroups;
+				ComputeRenderQueue::visitGroup( group );
+			}
+
+			virtual void visitGeometry( Geometry *geometry ) override
+			{
+				++visitedGeometries;
+				ComputeRenderQueue::visitGeometry( geometry );
+			}
+
+			int visitedGroups = 0;
+			int visitedGeometries = 0;
+		};
+
+		static SharedPointer< Geometry > createGeometry( float x, float y, float z )
+		{
+			auto geometry = crimild::alloc< Geometry >();
+			geometry->local().setTranslate( x, y, z );
+			geometry->localBound()->computeFrom( Vector3f( -1.0f, -1.0f, -1.0f ), Vector3f( 1.0f, 1.0f, 1.0f ) );
+			geometry->attachComponent< RenderStateComponent >()->attachMaterial( crimild::alloc< Material >() );
+			return geometry;
+		}
+
+	}
+
+}
+
+TEST( ComputeRenderQueueTest, culledGroupsArePruned )
+{
+	auto camera = crimild::alloc< Camera >();
+
+	auto scene = crimild::alloc< Group >();
+
+	auto visible = crimild::alloc< Group >();
+	visible->attachNode( test::createGeometry( 0.0f, 0.0f, -10.0f ) );
+	visible->attachNode( test::createGeometry( 1.0f, 0.0f, -10.0f ) );
+	scene->attachNode( visible );
+
+	// completely behind the camera
+	auto hidden = crimild::alloc< Group >();
+	hidden->attachNode( test::createGeometry( 0.0f, 0.0f, 50.0f ) );
+	hidden->attachNode( test::createGeometry( 1.0f, 0.0f, 50.0f ) );
+	auto hiddenChild = crimild::alloc< Group >();
+	hiddenChild->attachNode( test::createGeometry( 2.0f, 0.0f, 50.0f ) );
+	hidden->attachNode( hiddenChild );
+	scene->attachNode( hidden );
+
+	scene->perform( UpdateWorldState() );
+
+	auto renderQueue = crimild::alloc< RenderQueue >();
+	test::CountingComputeRenderQueue visitor( crimild::get_ptr( camera ), crimild::get_ptr( renderQueue ) );
+	scene->perform( visitor );
+
+	EXPECT_EQ( 2, renderQueue->getRenderables( RenderQueue::RenderableType::OPAQUE )->size() );
+
+	// root, visible and hidden groups are tested, but nothing below hidden
+	EXPECT_EQ( 3, visitor.visitedGroups );
+	EXPECT_EQ( 2, visitor.visitedGeometries );
+}
+
+TEST( ComputeRenderQueueTest, lightsInCulledGroupsAreKept )
+{
+	auto camera = crimild::alloc< Camera >();
+
+	auto scene = crimild::alloc< Group >();
+	scene->attachNode( test::createGeometry( 0.0f, 0.0f, -10.0f ) );
+
+	auto hidden = crimild::alloc< Group >();
+	hidden->attachNode( test::createGeometry( 0.0f, 0.0f, 50.0f ) );
+	hidden->attachNode( crimild::alloc< Light >() );
+	scene->attachNode( hidden );
+
+	scene->perform( UpdateWorldState() );
+
+	auto renderQueue = crimild::alloc< RenderQueue >();
+	scene->perform( ComputeRenderQueue( crimild::get_ptr( camera ), crimild::get_ptr( renderQueue ) ) );
+
+	EXPECT_EQ( 1, renderQueue->getRenderables( RenderQueue::RenderableType::OPAQUE )->size() );
+
+	int lightCount = 0;
+	renderQueue->each( [ &lightCount ]( Light *, int ) { ++lightCount; } );
+	EXPECT_EQ( 1, lightCount );
+}
+
+TEST( ComputeRenderQueueTest, sharedLights )
+{
+	auto camera = crimild::alloc< Camera >();
+
+	auto scene = crimild::alloc< Group >();
+	scene->attachNode( test::createGeometry( 0.0f, 0.0f, -10.0f ) );
+	scene->attachNode( crimild::alloc< Light >() );
+	scene->perform( UpdateWorldState() );
+
+	auto light0 = crimild::alloc< Light >();
+	auto light1 = crimild::alloc< Light >();
+	std::vector< Light * > lights = { crimild::get_ptr( light0 ), crimild::get_ptr( light1 ) };
+
+	auto renderQueue = crimild::alloc< RenderQueue >();
+	scene->perform( ComputeRenderQueue( crimild::get_ptr( camera ), crimild::get_ptr( renderQueue ), &lights ) );
+
+	// provided lights are used instead of the ones in the scene
+	std::vector< Light * > result;
+	renderQueue->each( [ &result ]( Light *light, int ) { result.push_back( light ); } );
+	EXPECT_EQ( lights, result );
+}
+
@@ -60,6 +60,15 @@ void IndexBufferObjectCatalog::bind( ShaderProgram *program, IndexBufferObject *
 	Catalog< IndexBufferObject >::bind( program, ibo );
 
 	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ibo->getCatalogId() );
+
+	if ( ibo->isDirty() ) {
+		// upload only what changed since the last time
+		glBufferSubData( GL_ELEMENT_ARRAY_BUFFER,
+			sizeof( IndexPrecision ) * ibo->getDirtyBegin(),
+			sizeof( IndexPrecision ) * ibo->getDirtyCount(),
+			ibo->getData() + ibo->getDirtyBegin() );
+		ibo->clearDirty();
+	}
     
     CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
 }
@@ -83,10 +92,13 @@ void IndexBufferObjectCatalog::load( IndexBufferObject *ibo )
 
 	int id = ibo->getCatalogId();
 	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, id );
+	// the whole buffer is allocated, since only some of the indices
+	// might be in use at the moment
 	glBufferData( GL_ELEMENT_ARRAY_BUFFER, 
-		sizeof( IndexPrecision ) * ibo->getIndexCount(), 
+		ibo->getSizeInBytes(), 
 		ibo->getData(), 
-		GL_STATIC_DRAW );
+		OpenGLUtils::BUFFER_USAGE[ static_cast< int >( ibo->getUsage() ) ] );
+	ibo->clearDirty();
     
     CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
 }
@@ -159,7 +159,7 @@ void TextureCatalog::load( Texture *texture )
     	texture->getImage()->getWidth(), texture->getImage()->getHeight(), 0, 
     	format, 
     	GL_UNSIGNED_BYTE,
-        ( GLvoid * ) texture->getImage()->getData() );
+        ( const GLvoid * ) static_cast< const Image * >( texture->getImage() )->getData() );
     
     CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
 }
@@ -99,6 +99,16 @@ void VertexBufferObjectCatalog::bind( ShaderProgram *program, VertexBufferObject
 #endif
 
     glBindBuffer( GL_ARRAY_BUFFER, vboId );
+
+    if ( vbo->isDirty() ) {
+        // upload only what changed since the last time
+        glBufferSubData( GL_ARRAY_BUFFER,
+            sizeof( VertexPrecision ) * vbo->getDirtyBegin(),
+            sizeof( VertexPrecision ) * vbo->getDirtyCount(),
+            vbo->getData() + vbo->getDirtyBegin() );
+        vbo->clearDirty();
+    }
+
     float *baseOffset = 0;
 
     const VertexFormat &format = vbo->getVertexFormat();
@@ -229,7 +239,8 @@ void VertexBufferObjectCatalog::load( VertexBufferObject *vbo )
     glBufferData( GL_ARRAY_BUFFER,
          vbo->getVertexFormat().getVertexSizeInBytes() * vbo->getVertexCount(),
          vbo->getData(),
-         GL_STATIC_DRAW );
+         OpenGLUtils::BUFFER_USAGE[ static_cast< int >( vbo->getUsage() ) ] );
+    vbo->clearDirty();
 
     CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
 }
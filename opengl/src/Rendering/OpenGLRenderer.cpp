@@ -93,7 +93,12 @@ OpenGLRenderer::OpenGLRenderer( SharedPointer< FrameBufferObject > const &screen
 
 OpenGLRenderer::~OpenGLRenderer( void )
 {
-
+#ifdef CRIMILD_PLATFORM_DESKTOP
+	if ( _instanceBufferId != 0 ) {
+		glDeleteBuffers( 1, &_instanceBufferId );
+		_instanceBufferId = 0;
+	}
+#endif
 }
 
 void OpenGLRenderer::configure( void )
@@ -260,6 +265,63 @@ void OpenGLRenderer::drawPrimitive( ShaderProgram *program, Primitive *primitive
 	CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
 }
 
+void OpenGLRenderer::drawPrimitiveInstanced( ShaderProgram *program, Primitive *primitive, const Matrix4f *modelTransforms, crimild::Size instanceCount )
+{
+#ifdef CRIMILD_PLATFORM_DESKTOP
+	auto instanceLocation = program->getStandardLocation( ShaderProgram::StandardLocation::INSTANCE_MODEL_MATRIX_ATTRIBUTE );
+	if ( instanceLocation == nullptr || !instanceLocation->isValid() ) {
+		// program does not support instancing
+		Renderer::drawPrimitiveInstanced( program, primitive, modelTransforms, instanceCount );
+		return;
+	}
+
+	CRIMILD_CHECK_GL_ERRORS_BEFORE_CURRENT_FUNCTION;
+
+	if ( _instanceBufferId == 0 ) {
+		glGenBuffers( 1, &_instanceBufferId );
+	}
+
+	glBindBuffer( GL_ARRAY_BUFFER, _instanceBufferId );
+	glBufferData( GL_ARRAY_BUFFER, instanceCount * sizeof( Matrix4f ), nullptr, GL_STREAM_DRAW );
+	glBufferSubData( GL_ARRAY_BUFFER, 0, instanceCount * sizeof( Matrix4f ), static_cast< const GLvoid * >( modelTransforms[ 0 ].getData() ) );
+
+	// a mat4 attribute takes four consecutive locations, one per column
+	GLuint baseLocation = instanceLocation->getLocation();
+	float *baseOffset = 0;
+	for ( GLuint i = 0; i < 4; i++ ) {
+		glEnableVertexAttribArray( baseLocation + i );
+		glVertexAttribPointer( baseLocation + i, 4, GL_FLOAT, GL_FALSE, sizeof( Matrix4f ), ( const GLvoid * )( baseOffset + 4 * i ) );
+		glVertexAttribDivisor( baseLocation + i, 1 );
+	}
+
+	bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::USE_INSTANCING_UNIFORM ), true );
+
+	GLenum type = OpenGLUtils::PRIMITIVE_TYPE[ ( uint8_t ) primitive->getType() ];
+
+	unsigned short *base = 0;
+	glDrawElementsInstanced( type,
+							 primitive->getIndexBuffer()->getIndexCount(),
+							 GL_UNSIGNED_SHORT,
+							 ( const GLvoid * ) base,
+							 instanceCount );
+
+	bindUniform( program->getStandardLocation( ShaderProgram::StandardLocation::USE_INSTANCING_UNIFORM ), false );
+
+	// restore vertex array state so regular draws are not affected
+	for ( GLuint i = 0; i < 4; i++ ) {
+		glVertexAttribDivisor( baseLocation + i, 0 );
+		glDisableVertexAttribArray( baseLocation + i );
+	}
+
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+	CRIMILD_CHECK_GL_ERRORS_AFTER_CURRENT_FUNCTION;
+#else
+	// instancing is not available in OpenGL ES 2
+	Renderer::drawPrimitiveInstanced( program, primitive, modelTransforms, instanceCount );
+#endif
+}
+
 void OpenGLRenderer::drawBuffers( ShaderProgram *program, Primitive::Type bufferType, VertexBufferObject *vbo, unsigned int count )
 {
 	CRIMILD_CHECK_GL_ERRORS_BEFORE_CURRENT_FUNCTION;
@@ -64,7 +64,14 @@ namespace crimild {
 			virtual void setColorMaskState( ColorMaskState *state ) override;
 
 			virtual void drawPrimitive( ShaderProgram *program, Primitive *primitive ) override;
+			virtual void drawPrimitiveInstanced( ShaderProgram *program, Primitive *primitive, const Matrix4f *modelTransforms, crimild::Size instanceCount ) override;
 			virtual void drawBuffers( ShaderProgram *program, Primitive::Type type, VertexBufferObject *vbo, unsigned int count ) override;
+
+		private:
+			/**
+			   \brief Streams per-instance model matrices for instanced draws
+			 */
+			GLuint _instanceBufferId = 0;
 		};
 
 	}
@@ -98,6 +98,12 @@ const GLenum OpenGLUtils::CULL_FACE_MODE[] = {
 	GL_FRONT_AND_BACK
 };
 
+const GLenum OpenGLUtils::BUFFER_USAGE[] = {
+	GL_STATIC_DRAW,
+	GL_DYNAMIC_DRAW,
+	GL_STREAM_DRAW
+};
+
 void OpenGLUtils::checkErrors( std::string prefix )
 {
     for ( GLint error = glGetError(); error; error = glGetError() ) {
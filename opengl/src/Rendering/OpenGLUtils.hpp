@@ -67,6 +67,7 @@ namespace crimild {
             static const GLenum ALPHA_DST_BLEND_FUNC[];
             static const GLenum DEPTH_COMPARE_FUNC[];
             static const GLenum CULL_FACE_MODE[];
+            static const GLenum BUFFER_USAGE[];
 		};
 
 	}
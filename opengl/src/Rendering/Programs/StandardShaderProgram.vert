@@ -9,10 +9,12 @@ CRIMILD_GLSL_ATTRIBUTE vec3 aTangent;
 CRIMILD_GLSL_ATTRIBUTE vec2 aTextureCoord;
 CRIMILD_GLSL_ATTRIBUTE vec4 aBoneIds;
 CRIMILD_GLSL_ATTRIBUTE vec4 aBoneWeights;
+CRIMILD_GLSL_ATTRIBUTE mat4 aInstanceModelMatrix;
    
 uniform mat4 uPMatrix;
 uniform mat4 uVMatrix;
 uniform mat4 uMMatrix;
+uniform bool uUseInstancing;
 uniform mat4 uLightSourceProjectionMatrix;
 uniform mat4 uLightSourceViewMatrix;
    
@@ -44,10 +46,11 @@ void main ()
 		}        
 	}
 	else {
-		vWorldVertex = uMMatrix * vec4( aPosition, 1.0 );
-	    vWorldNormal = normalize( mat3( uMMatrix ) * aNormal );
+		mat4 modelMatrix = uUseInstancing ? aInstanceModelMatrix : uMMatrix;
+		vWorldVertex = modelMatrix * vec4( aPosition, 1.0 );
+	    vWorldNormal = normalize( mat3( modelMatrix ) * aNormal );
 		if ( uUseNormalMap ) {
-		  	vWorldTangent = normalize( mat3( uMMatrix ) * aTangent );
+		  	vWorldTangent = normalize( mat3( modelMatrix ) * aTangent );
 		   	vWorldBiTangent = cross( vWorldNormal, vWorldTangent );
 		}
 	}
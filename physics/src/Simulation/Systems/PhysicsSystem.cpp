@@ -34,25 +34,56 @@ using namespace crimild::physics;
 
 #define CRIMILD_PHYSICS_STEP_DELTA 1.0 / 60.0
 
+constexpr const char *PhysicsSystem::STAGE_PHYSICS;
+
 PhysicsSystem::PhysicsSystem( void )
 	: System( "Physics" )
 {
-	auto self = this;
-	registerMessageHandler< messaging::DidUpdateScene >( [self]( messaging::DidUpdateScene const &msg ) {
-		self->update();
-	});
-
 	_context.setGravity( Vector3f( 0.0f, -9.8f, 0.0f ) );
 }
 
 PhysicsSystem::~PhysicsSystem( void )
 {
-
+	// the update system may outlive us, so it must not keep invoking this stage
+	removeStage();
 }
 
 bool PhysicsSystem::start( void )
 {
-	return System::start();
+	if ( !System::start() ) {
+		return false;
+	}
+
+	auto updateSystem = Simulation::getInstance()->getSystem< UpdateSystem >( "Update System" );
+	if ( updateSystem == nullptr ) {
+		Log::error( CRIMILD_CURRENT_CLASS_NAME, "Cannot find update system" );
+		return false;
+	}
+
+	// physics runs after world state is updated and before render queues are computed
+	auto &graph = updateSystem->getFrameGraph();
+	if ( graph.getTaskId( STAGE_PHYSICS ) == concurrency::TaskGraph::INVALID_TASK_ID ) {
+		auto self = this;
+		graph.addTask( STAGE_PHYSICS, [ self ] {
+			self->update();
+		});
+		graph.addDependency( STAGE_PHYSICS, UpdateSystem::STAGE_UPDATE_WORLD_STATE );
+		graph.addDependency( UpdateSystem::STAGE_COMPUTE_RENDER_QUEUES, STAGE_PHYSICS );
+	}
+
+	_updateSystem = updateSystem;
+
+	return true;
+}
+
+void PhysicsSystem::removeStage( void )
+{
+	auto updateSystem = _updateSystem.lock();
+	if ( updateSystem != nullptr ) {
+		updateSystem->getFrameGraph().removeTask( STAGE_PHYSICS );
+	}
+
+	_updateSystem.reset();
 }
 
 void PhysicsSystem::update( void )
@@ -73,6 +104,8 @@ void PhysicsSystem::update( void )
 
 void PhysicsSystem::stop( void )
 {
+	removeStage();
+
 	System::stop();
 	
 	PhysicsContext::getInstance()->cleanup();
@@ -32,11 +32,21 @@
 
 #include "Foundation/PhysicsContext.hpp"
 
+#include <memory>
+
 namespace crimild {
 
 	namespace physics {
 
 		class PhysicsSystem : public System { 
+		public:
+			/**
+			   \brief Name of the frame stage stepping the physics simulation
+
+			   \see UpdateSystem::getFrameGraph()
+			 */
+			static constexpr const char *STAGE_PHYSICS = "physics";
+
 		public:
 			PhysicsSystem( void );
 			virtual ~PhysicsSystem( void );
@@ -47,8 +57,19 @@ namespace crimild {
 			
 			virtual void stop( void ) override;
 		
+		private:
+			/**
+			   \brief Removes the physics stage from the update system's frame graph
+			 */
+			void removeStage( void );
+
 		private:
 			PhysicsContext _context;
+
+			/**
+			   \brief Owner of the frame graph where the physics stage was added
+			 */
+			std::weak_ptr< UpdateSystem > _updateSystem;
 		};
 
 	}
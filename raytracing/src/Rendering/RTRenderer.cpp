@@ -34,63 +34,53 @@ SharedPointer< Image > RTRenderer::render( SharedPointer< Node > const &scene, S
 	int bpp = 3;
 	std::vector< unsigned char > pixels( _width * _height * bpp );
 	
-    // this might be overkill, but we're going to create a job
-    // for each pixel in the image
-    size_t dx = 1;
-    size_t dy = 1;
-	
-	auto parentJob = crimild::concurrency::async();
-    
-    std::atomic< long > jobCount( 0 );
-    const int JOB_TOTAL = _height * _width;
-    
-	for ( size_t y = 0; y < _height; y += dy ) {
-		for ( size_t x = 0; x < _width; x += dx ) {
-			crimild::concurrency::async( parentJob, [this, &jobCount, JOB_TOTAL, camera, x, y, dx, dy, bpp, scene, &pixels ]( void ) {
-				for ( size_t t = y; t < y + dy; t++ ) {
-					for ( size_t s = x; s < x + dx; s++ ) {
-						RGBColorf c = RGBColorf::ZERO;
-						Ray3f ray;
-						if ( _samples > 1 ) {
-							for ( int sample = 0; sample < _samples; sample++ ) {
-								float u = ( float ) ( s + getRandom() ) / ( float ) _width;
-								float v = ( float ) ( t + getRandom() ) / ( float ) _height;
-								
-								camera->getPickRay( u, v, ray );
-								c += computeColor( scene, ray );							
-							}
-							c /= ( float ) _samples;
-						}
-						else {
-							float u = ( float ) s / ( float ) _width;
-							float v = ( float ) t / ( float ) _height;
-							camera->getPickRay( u, v, ray );
-							c = computeColor( scene, ray );
-						}
-						
-						// gamma correction
-						c = RGBColorf( Numericf::sqrt( c[ 0 ] ), Numericf::sqrt( c[ 1 ] ), Numericf::sqrt( c[ 2 ] ) );
-						
-						for ( int i = 0; i < bpp; i++ ) {
-							pixels[ ( t * _width + s ) * bpp + i ] = ( unsigned char )( 255.99f * c[ i ] );
-						}
-                        
-                        jobCount++;
-                        Log::debug( CRIMILD_CURRENT_CLASS_NAME, "Progress: ", jobCount, "/", JOB_TOTAL );
-					}
-				}
-			});
+    std::atomic< long > pixelCount( 0 );
+    const long PIXEL_TOTAL = _height * _width;
+
+	// pixels are split into ranges that are processed in parallel
+	crimild::concurrency::parallel_for( size_t( 0 ), size_t( PIXEL_TOTAL ), [ this, &pixelCount, PIXEL_TOTAL, &camera, bpp, &scene, &pixels ]( size_t pixel ) {
+		auto s = pixel % _width;
+		auto t = pixel / _width;
+
+		Random::Generator random( _seed, pixel );
+
+		RGBColorf c = RGBColorf::ZERO;
+		Ray3f ray;
+		if ( _samples > 1 ) {
+			for ( int sample = 0; sample < _samples; sample++ ) {
+				float u = ( float ) ( s + getRandom( random ) ) / ( float ) _width;
+				float v = ( float ) ( t + getRandom( random ) ) / ( float ) _height;
+				
+				camera->getPickRay( u, v, ray );
+				c += computeColor( scene, ray, random );							
+			}
+			c /= ( float ) _samples;
 		}
-	}
+		else {
+			float u = ( float ) s / ( float ) _width;
+			float v = ( float ) t / ( float ) _height;
+			camera->getPickRay( u, v, ray );
+			c = computeColor( scene, ray, random );
+		}
+		
+		// gamma correction
+		c = RGBColorf( Numericf::sqrt( c[ 0 ] ), Numericf::sqrt( c[ 1 ] ), Numericf::sqrt( c[ 2 ] ) );
+		
+		for ( int i = 0; i < bpp; i++ ) {
+			pixels[ ( t * _width + s ) * bpp + i ] = ( unsigned char )( 255.99f * c[ i ] );
+		}
+        
+        pixelCount++;
+        Log::debug( CRIMILD_CURRENT_CLASS_NAME, "Progress: ", pixelCount, "/", PIXEL_TOTAL );
+	});
 	
-	crimild::concurrency::wait( parentJob );
     Log::debug( CRIMILD_CURRENT_CLASS_NAME, "Done rendering frames" );
     
     auto result = crimild::alloc< Image >( _width, _height, bpp, &pixels[ 0 ], Image::PixelFormat::RGB );
     return result;
 }
 
-RGBColorf RTRenderer::computeColor( SharedPointer< Node > const &scene, const Ray3f &r, int depth ) const
+RGBColorf RTRenderer::computeColor( SharedPointer< Node > const &scene, const Ray3f &r, Random::Generator &random, int depth ) const
 {
 	RTRayCaster caster( r );
 	scene->perform( caster );
@@ -105,7 +95,7 @@ RGBColorf RTRenderer::computeColor( SharedPointer< Node > const &scene, const Ra
 		switch ( material->getType() ) {
 		case RTMaterial::Type::METALLIC: {
 			auto reflected = reflect( r.getDirection(), hit.normal );
-			reflected += material->getFuzz() * randomInUnitSphere();
+			reflected += material->getFuzz() * randomInUnitSphere( random );
 			reflected.normalize();
 			scattered = Ray3f( hit.position, reflected );
 			visible = ( scattered.getDirection() * hit.normal > 0 );
@@ -139,7 +129,7 @@ RGBColorf RTRenderer::computeColor( SharedPointer< Node > const &scene, const Ra
 				reflectProb = 1.0f;
 			}
 			
-			if ( getRandom() < reflectProb ) {
+			if ( getRandom( random ) < reflectProb ) {
 				scattered = Ray3f( hit.position, reflected );
 			}
 			else {
@@ -149,7 +139,7 @@ RGBColorf RTRenderer::computeColor( SharedPointer< Node > const &scene, const Ra
 		}
 		case RTMaterial::Type::LAMBERTIAN: 
 		default: {
-			Vector3f target = hit.normal + randomInUnitSphere();
+			Vector3f target = hit.normal + randomInUnitSphere( random );
 			scattered = Ray3f( hit.position, target.getNormalized() );
 			break;
 		}
@@ -157,7 +147,7 @@ RGBColorf RTRenderer::computeColor( SharedPointer< Node > const &scene, const Ra
 
 		// TODO: max depth as a setting?
 		if ( depth < 50 && visible ) {
-			auto color = computeColor( scene, scattered, depth + 1 );
+			auto color = computeColor( scene, scattered, random, depth + 1 );
 			color.times( attenuation );
 			return color;
 		}
@@ -175,22 +165,14 @@ RGBColorf RTRenderer::computeColor( SharedPointer< Node > const &scene, const Ra
 	return output;
 }
 
-float RTRenderer::getRandom() const
+float RTRenderer::getRandom( Random::Generator &random ) const
 {
-#if 1
-	return Random::generate< float >();
-#else
-	return drand48();
-#endif
+	return random.nextReal32();
 }
 
-Vector3f RTRenderer::randomInUnitSphere( void ) const
+Vector3f RTRenderer::randomInUnitSphere( Random::Generator &random ) const
 {
-	return Vector3f(
-		2.0f * getRandom() - 1.0f,
-		2.0f * getRandom() - 1.0f,
-		2.0f * getRandom() -1.0f )
-	.getNormalized();
+	return Random::generate< Vector3f >( random, -Vector3f::ONE, Vector3f::ONE ).getNormalized();
 }
 
 Vector3f RTRenderer::reflect( const Vector3f &v, const Vector3f &n ) const
@@ -17,13 +17,23 @@ namespace crimild {
 			virtual ~RTRenderer( void );
 			
 			SharedPointer< Image > render( SharedPointer< Node > const &scene, SharedPointer< Camera > camera ) const;
+
+			/**
+			   \brief Sets the seed for random samples
+
+			   Each pixel uses its own random stream derived from this seed,
+			   so the same image is produced regardless of how many workers
+			   are rendering it.
+			 */
+			inline void setSeed( crimild::UInt64 seed ) { _seed = seed; }
+			inline crimild::UInt64 getSeed( void ) const { return _seed; }
 			
 		private:
-			RGBColorf computeColor( SharedPointer< Node > const &scene, const Ray3f &r, int depth = 0 ) const;
+			RGBColorf computeColor( SharedPointer< Node > const &scene, const Ray3f &r, Random::Generator &random, int depth = 0 ) const;
 			
-			float getRandom() const;
+			float getRandom( Random::Generator &random ) const;
 			
-			Vector3f randomInUnitSphere( void ) const;
+			Vector3f randomInUnitSphere( Random::Generator &random ) const;
 			
 			Vector3f reflect( const Vector3f &v, const Vector3f &n ) const;
 			
@@ -36,6 +46,7 @@ namespace crimild {
 			int _width;
 			int _height;
 			int _samples;
+			crimild::UInt64 _seed = 0;
             
             Mutex _mutex;
 		};
@@ -220,7 +220,8 @@ LuaSceneBuilder::LuaSceneBuilder( std::string rootNodeName )
             if ( scene == nullptr ) {
                 SharedPointer< Group > tmp;
                 if ( StringUtils::getFileExtension( filename ) == ".crimild" ) {
-                    FileStream is( FileSystem::getInstance().pathForResource( filename ), FileStream::OpenMode::READ );
+                    MappedFileStream is( FileSystem::getInstance().pathForResource( filename ) );
+                    is.setLoadMode( Stream::LoadMode::PARALLEL );
                     is.load();
                     if ( is.getObjectCount() > 0 ) {
                         tmp = is.getObjectAt< Group >( 0 );